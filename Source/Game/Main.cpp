@@ -22,15 +22,149 @@
 #include "Model/Model.h"
 #include "Renderer/Skybox.h"
 #include "Scene/Scene.h"
+#include "Scene/SparseVoxelOctree.h"
+#include "Scene/TerrainGenerator.h"
 #include "Scene/Voxel.h"
+#include "Shader/PackedVoxelVertexShader.h"
 #include "Shader/SkyMapVertexShader.h"
 
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RunBenchmarks
+
+  Summary:  Runs the headless benchmarks on a generated map of
+            BENCHMARK_TERRAIN_DESC and on the bob lamp animation. Every
+            benchmark logs its results through OutputDebugString
+
+  Returns:  INT
+              Status code.
+-----------------------------------------------------------------F-F*/
+INT RunBenchmarks()
+{
+    constexpr const library::TerrainGenerationDesc BENCHMARK_TERRAIN_DESC =
+    {
+        .uWidth = 256u,
+        .uHeight = 64u,
+        .uDepth = 256u,
+        .uSeed = 0u,
+        .uNumOctaves = 4u,
+        .frequency = 0.1f,
+        .biomeThresholds = library::TerrainGenerator::DEFAULT_BIOME_THRESHOLDS,
+    };
+    library::TerrainGenerator terrainGenerator(BENCHMARK_TERRAIN_DESC);
+    if (FAILED(terrainGenerator.Generate()))
+    {
+        return 0;
+    }
+    const library::HeightMapDesc heightMap = terrainGenerator.GetDesc();
+
+    // Frustum and occlusion culling: the camera circles the map at
+    // eye level looking inwards, then looks outwards from its center
+    {
+        library::Scene scene(heightMap);
+
+        std::vector<XMMATRIX> aViews;
+        constexpr const UINT NUM_VIEWS_PER_PATH = 64u;
+        for (UINT i = 0u; i < NUM_VIEWS_PER_PATH; ++i)
+        {
+            FLOAT angle = XM_2PI * static_cast<FLOAT>(i) / static_cast<FLOAT>(NUM_VIEWS_PER_PATH);
+            XMVECTOR direction = XMVectorSet(cosf(angle), 0.0f, sinf(angle), 0.0f);
+            aViews.push_back(XMMatrixLookAtLH(XMVectorScale(direction, 200.0f) + XMVectorSet(0.0f, 40.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+            aViews.push_back(XMMatrixLookToLH(XMVectorSet(0.0f, 30.0f, 0.0f, 1.0f), direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+        }
+        const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 800.0f / 600.0f, library::Renderer::NEAR_PLANE, library::Renderer::FAR_PLANE);
+        scene.MeasureVoxelChunkCulling(projection, aViews);
+        scene.MeasureOcclusionCulling(projection, aViews);
+    }
+
+    // Perlin noise: scalar against batch sampling
+    library::Scene::MeasurePerlin2dThroughput(1024u, 1024u);
+
+    // Sparse voxel octree: memory and point lookups against a dense
+    // grid of block types
+    {
+        library::SparseVoxelOctree sparseVoxelOctree;
+        if (SUCCEEDED(sparseVoxelOctree.Build(heightMap)))
+        {
+            sparseVoxelOctree.MeasureAgainstFlat(heightMap, 1u << 20u);
+        }
+    }
+
+    library::VoxelColumnStore columnStore;
+    if (SUCCEEDED(columnStore.Create(heightMap)))
+    {
+        // Voxel raycasts: rays from above the center of the map out to
+        // the far plane, one after another and as one batch
+        library::VoxelRaycaster voxelRaycaster(columnStore);
+        voxelRaycaster.MeasureThroughput(XMFLOAT3(0.0f, 30.0f, 0.0f), 4096u, library::Renderer::FAR_PLANE);
+
+        // Voxel collision: boxes the size of a person moved around the
+        // center of the map
+        library::VoxelCollider voxelCollider(columnStore);
+        voxelCollider.MeasureThroughput(XMFLOAT3(0.0f, 0.0f, 0.0f), 8192u, 4.0f);
+    }
+
+    // Text height map parsing: the single threaded ifstream loop
+    // against LoadText on generated maps of 256^2, 1024^2 and 4096^2
+    // columns
+    constexpr const UINT aTextMapSizes[] = { 256u, 1024u, 4096u };
+    for (UINT uSize : aTextMapSizes)
+    {
+        library::TerrainGenerationDesc textMapDesc = BENCHMARK_TERRAIN_DESC;
+        textMapDesc.uWidth = uSize;
+        textMapDesc.uDepth = uSize;
+        library::TerrainGenerator textMapGenerator(textMapDesc);
+        if (SUCCEEDED(textMapGenerator.Generate()) && SUCCEEDED(textMapGenerator.ExportText(L"Benchmark.txt")))
+        {
+            library::HeightMap textHeightMap;
+            textHeightMap.MeasureTextParsing(L"Benchmark.txt");
+        }
+    }
+    std::error_code errorCode;
+    std::filesystem::remove(L"Benchmark.txt", errorCode);
+
+    library::Model bobLamp(L"Content/BobLampClean/boblampclean.md5mesh");
+    // The source animation is kept to measure against
+    if (SUCCEEDED(bobLamp.Load(library::CompressedAnimationClip::DEFAULT_COMPRESSION_DESC, TRUE)) && bobLamp.GetNumAnimationClips() > 0u)
+    {
+        // Skeleton evaluation: node tree walk against the flattened
+        // skeleton
+        bobLamp.MeasureSkeletonEvaluation(4096u);
+
+        // Animation sampling: one track at a time against four nodes
+        // at a time, without and with the slerp fallback
+        library::AnimationSampler animationSampler;
+        animationSampler.MeasureThroughput(*bobLamp.GetAnimationClip(0u), 4096u);
+        animationSampler.SetSlerpFallback(TRUE);
+        animationSampler.MeasureThroughput(*bobLamp.GetAnimationClip(0u), 4096u);
+
+        // Animation compression: resampling at 30 samples per second,
+        // then key reduction, then back to resampling for playback
+        bobLamp.MeasureAnimationCompression(4096u);
+        library::AnimationCompressionDesc reducedDesc = library::CompressedAnimationClip::DEFAULT_COMPRESSION_DESC;
+        reducedDesc.sampleRate = 0.0f;
+        if (SUCCEEDED(bobLamp.CompressAnimation(reducedDesc)))
+        {
+            bobLamp.MeasureAnimationCompression(4096u);
+        }
+        bobLamp.CompressAnimation(library::CompressedAnimationClip::DEFAULT_COMPRESSION_DESC);
+
+        // Animation blending: one clip against cross-fades and a
+        // masked additive layer
+        bobLamp.MeasureAnimationBlending(4096u);
+    }
+
+    return 0;
+}
+
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   Function: wWinMain
 
   Summary:  Entry point to the program. Initializes everything and
             goes into a message processing loop. Idle time is used to
-            render the scene.
+            render the scene. With -benchmark on the command line, the
+            benchmarks run instead and no window is opened. With
+            -stream, a larger map is streamed around the camera from
+            its cache file instead of being built whole.
 
   Args:     HINSTANCE hInstance
               Handle to an instance.
@@ -49,167 +183,51 @@
 INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ INT nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
-
-    std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
-
-    std::ofstream sceneFile;
-    sceneFile.open("HeightMap.txt");
-    constexpr const UINT MAP_WIDTH = 0;
-    constexpr const UINT MAP_HEIGHT = 0;
-    constexpr const UINT MAP_DEPTH = 0;
-    XMFLOAT4 aColors[] =
-    {
-        XMFLOAT4(0.0f,      0.666f, 0.0f,   1.0f),  // GRASSLAND
-        XMFLOAT4(1.0f,      1.0f,   1.0f,   1.0f),  // SNOW
-        XMFLOAT4(0.0f,      0.0f,   0.666f, 1.0f),  // OCEAN
-        XMFLOAT4(1.0f,      0.666f, 0.0f,   1.0f),  // SAND
-        XMFLOAT4(0.666f,    0.0f,   0.0f,   1.0f),  // SCORCHED
-        XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // BARE
-        XMFLOAT4(0.941f,    0.0f,   1.0f,   1.0f),  // TUNDRA
-        XMFLOAT4(0.803f,    0.521f, 0.247f, 1.0f),  // TEMPERATE_DESERT
-        XMFLOAT4(0.42f,     0.556f, 0.137f, 1.0f),  // SHRUBLAND
-        XMFLOAT4(0.0f,      0.392f, 0.0f,   1.0f),  // TAIGA
-        XMFLOAT4(1.0f,      0.55f,  0.0f,   1.0f),  // TEMPERATE_DECIDUOUS_FOREST
-        XMFLOAT4(0.0f,      0.5f,   0.0f,   1.0f),  // TEMPERATE_RAIN_FOREST
-        XMFLOAT4(0.956f,    0.643f, 0.376f, 1.0f),  // SUBTROPICAL_DESERT
-        XMFLOAT4(0.133f,    0.545f, 0.133f, 1.0f),  // TROPICAL_SEASONAL_FOREST
-        XMFLOAT4(0.15f,     0.372f, 0.15f,  1.0f),  // TROPICAL_RAIN_FOREST
-    };
 
-    sceneFile << MAP_WIDTH << " " << MAP_HEIGHT << " " << MAP_DEPTH << ' ' << ARRAYSIZE(aColors) << '\n';
-
-    for (UINT colorIdx = 0; colorIdx < ARRAYSIZE(aColors); ++colorIdx)
+    if (wcsstr(lpCmdLine, L"-benchmark"))
     {
-        sceneFile << aColors[colorIdx].x << ' ' <<
-            aColors[colorIdx].y << ' ' <<
-            aColors[colorIdx].z << '\n';
+        return RunBenchmarks();
     }
 
-    for (UINT z = 0u; z < MAP_DEPTH; ++z)
+    std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 3: Cube Mapping");
+
+    constexpr const BOOL EXPORT_HEIGHT_MAP_TEXT = FALSE;
+    constexpr const library::TerrainStreamingDesc STREAMING_DESC =
     {
-        for (UINT x = 0u; x < MAP_WIDTH; ++x)
+        .uChunkSize = library::VoxelBuilder::DEFAULT_CHUNK_SIZE,
+        .residencyRadius = 256.0f,
+        .ullMemoryBudget = 256ull * 1024ull * 1024ull,
+        .uMaxUploadsPerFrame = 4u,
+        .uMaxPendingBuilds = 16u,
+    };
+    const BOOL bStreamTerrain = wcsstr(lpCmdLine, L"-stream") != nullptr;
+    library::TerrainGenerator terrainGenerator(
+        library::TerrainGenerationDesc
         {
-            FLOAT height = 0.0f;
-
-            FLOAT frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                height += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            height /= frequencySum;
-            height = pow(height * 1.2f, 1.25f);
-
-            assert(height >= 0.0f);
-
-            FLOAT moisture = 0.0f;
-
-            frequencySum = 0.0f;
-            for (UINT i = 0; i < 4; ++i)
-            {
-                FLOAT frequency = pow(2.0f, static_cast<FLOAT>(i));
-                frequencySum += 1.0f / frequency;
-                moisture += library::Scene::GetPerlin2d(frequency * static_cast<FLOAT>(x), frequency * static_cast<FLOAT>(z), 0.1f, 4u) / frequency;
-            }
-            moisture /= frequencySum;
-            moisture = pow(moisture * 1.2f, 1.25f);
-
-            library::eBlockType blockType = library::eBlockType::GRASSLAND;
-
-            if (height < 0.1f)
-            {
-                blockType = library::eBlockType::OCEAN;
-            }
-            else if (height < 0.12f)
-            {
-                blockType = library::eBlockType::SAND;
-            }
-            else if (height > 0.8f)
-            {
-                if (moisture < 0.1f)
-                {
-                    blockType = library::eBlockType::SCORCHED;
-                }
-                else if (moisture < 0.2f)
-                {
-                    blockType = library::eBlockType::BARE;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::TUNDRA;
-                }
-                else
-                {
-                    blockType = library::eBlockType::SNOW;
-                }
-            }
-            else if (height > 0.6f)
-            {
-                if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::SHRUBLAND;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TAIGA;
-                }
-            }
-            else if (height > 0.3f)
-            {
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DESERT;
-                }
-                else if (moisture < 0.5f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.83f)
-                {
-                    blockType = library::eBlockType::TEMPERATE_DECIDUOUS_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TEMPERATE_RAIN_FOREST;
-                }
-            }
-            else
-            {
-
-                if (moisture < 0.16f)
-                {
-                    blockType = library::eBlockType::SUBTROPICAL_DESERT;
-                }
-                else if (moisture < 0.33f)
-                {
-                    blockType = library::eBlockType::GRASSLAND;
-                }
-                else if (moisture < 0.66f)
-                {
-                    blockType = library::eBlockType::TROPICAL_SEASONAL_FOREST;
-                }
-                else
-                {
-                    blockType = library::eBlockType::TROPICAL_RAIN_FOREST;
-                }
-            }
-
-            sceneFile << static_cast<CHAR>(blockType);
-
-            sceneFile << height << ' ';
+            .uWidth = bStreamTerrain ? 2048u : 0u,
+            .uHeight = bStreamTerrain ? 64u : 0u,
+            .uDepth = bStreamTerrain ? 2048u : 0u,
+            .uSeed = 0u,
+            .uNumOctaves = 4u,
+            .frequency = 0.1f,
+            .biomeThresholds = library::TerrainGenerator::DEFAULT_BIOME_THRESHOLDS,
         }
-        sceneFile << '\n';
+    );
+    // The text export needs the normalized heights, which the cache
+    // does not keep. The streaming scene opens the cache file itself
+    const BOOL bExportHeightMapText = EXPORT_HEIGHT_MAP_TEXT && !bStreamTerrain;
+    if (FAILED(bExportHeightMapText ? terrainGenerator.Generate() : terrainGenerator.GenerateCached(L"Cache")))
+    {
+        return 0;
+    }
+    if (bExportHeightMapText && FAILED(terrainGenerator.ExportText(L"HeightMap.txt")))
+    {
+        return 0;
     }
-    sceneFile << std::endl;
-    sceneFile.close();
 
-    std::shared_ptr<library::Scene> mainScene = std::make_shared<library::Scene>(L"HeightMap.txt");
+    std::shared_ptr<library::Scene> mainScene = bStreamTerrain
+        ? std::make_shared<library::Scene>(terrainGenerator.GetCacheFilePath(L"Cache"), STREAMING_DESC)
+        : std::make_shared<library::Scene>(terrainGenerator.GetDesc());
 
     // Phong
     std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
@@ -223,6 +241,18 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     {
         return 0;
     }
+    // Voxel chunk, packed instances
+    std::shared_ptr<library::PackedVoxelVertexShader> voxelPackedVertexShader = std::make_shared<library::PackedVoxelVertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelPacked", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"VoxelPackedShader", voxelPackedVertexShader)))
+    {
+        return 0;
+    }
+    // Voxel chunk mesh
+    std::shared_ptr<library::VertexShader> voxelMeshVertexShader = std::make_shared<library::VertexShader>(L"Shaders/VoxelShaders.fxh", "VSVoxelMesh", "vs_5_0");
+    if (FAILED(mainScene->AddVertexShader(L"VoxelMeshShader", voxelMeshVertexShader)))
+    {
+        return 0;
+    }
     // Light Cube
     std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
     if (FAILED(mainScene->AddVertexShader(L"LightShader", lightVertexShader)))
@@ -254,6 +284,12 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     {
         return 0;
     }
+    // Voxel chunks with baked light
+    std::shared_ptr<library::PixelShader> voxelLitPixelShader = std::make_shared<library::PixelShader>(L"Shaders/VoxelShaders.fxh", "PSVoxelLit", "ps_5_0");
+    if (FAILED(mainScene->AddPixelShader(L"VoxelLitShader", voxelLitPixelShader)))
+    {
+        return 0;
+    }
     // Light Cube
     std::shared_ptr<library::PixelShader> lightPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
     if (FAILED(mainScene->AddPixelShader(L"LightShader", lightPixelShader)))
@@ -283,6 +319,26 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         return 0;
     }
 
+    if (FAILED(mainScene->SetVertexShaderOfVoxelChunks(L"VoxelPackedShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetPixelShaderOfVoxelChunks(L"VoxelLitShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetVertexShaderOfVoxelChunkMesh(L"VoxelMeshShader")))
+    {
+        return 0;
+    }
+
+    if (FAILED(mainScene->SetPixelShaderOfVoxelChunkMesh(L"VoxelShader")))
+    {
+        return 0;
+    }
+
     std::shared_ptr<library::Skybox> skybox = std::make_shared<library::Skybox>(L"Content/Common/Maskonaive2_1024.dds", 1000.0f);
     skybox->SetVertexShader(cubeMapVertexShader);
     skybox->SetPixelShader(cubeMapPixelShader);
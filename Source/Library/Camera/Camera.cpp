@@ -95,6 +95,55 @@ namespace library
         return m_cbChangeOnCameraMovement;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::GetPickingRay
+
+      Summary:  Returns the world space ray from the near plane through
+                a point of the screen, such as the mouse cursor
+
+      Args:     FLOAT screenX
+                  Horizontal position in pixels from the left
+                FLOAT screenY
+                  Vertical position in pixels from the top
+                UINT uWidth
+                  Width of the viewport
+                UINT uHeight
+                  Height of the viewport
+                const XMMATRIX& projection
+                  Projection matrix of the viewport
+                XMFLOAT3& outOrigin
+                  Point of the ray on the near plane
+                XMFLOAT3& outDirection
+                  Normalized direction of the ray
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Camera::GetPickingRay(_In_ FLOAT screenX, _In_ FLOAT screenY, _In_ UINT uWidth, _In_ UINT uHeight, _In_ const XMMATRIX& projection, _Out_ XMFLOAT3& outOrigin, _Out_ XMFLOAT3& outDirection) const {
+        const FLOAT width = static_cast<FLOAT>(uWidth);
+        const FLOAT height = static_cast<FLOAT>(uHeight);
+        XMVECTOR nearPoint = XMVector3Unproject(XMVectorSet(screenX, screenY, 0.0f, 0.0f), 0.0f, 0.0f, width, height, 0.0f, 1.0f, projection, m_view, XMMatrixIdentity());
+        XMVECTOR farPoint = XMVector3Unproject(XMVectorSet(screenX, screenY, 1.0f, 0.0f), 0.0f, 0.0f, width, height, 0.0f, 1.0f, projection, m_view, XMMatrixIdentity());
+
+        XMStoreFloat3(&outOrigin, nearPoint);
+        XMStoreFloat3(&outDirection, XMVector3Normalize(XMVectorSubtract(farPoint, nearPoint)));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::SetEye
+
+      Summary:  Moves the eye to a position, such as where a collision
+                stopped it, and keeps the direction it looks at
+
+      Args:     const XMVECTOR& eye
+                  New position of the eye
+
+      Modifies: [m_eye, m_at, m_view].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Camera::SetEye(_In_ const XMVECTOR& eye) {
+        m_at = eye + (m_at - m_eye);
+        m_eye = eye;
+
+        m_view = XMMatrixLookAtLH(m_eye, m_at, m_cameraUp);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Camera::HandleInput
 
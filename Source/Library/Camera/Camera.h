@@ -33,6 +33,10 @@ namespace library
                   Getter for the view transform matrix
                 GetConstantBuffer
                   Get the constant buffer containing the view transform
+                GetPickingRay
+                  Get the world space ray through a point of the screen
+                SetEye
+                  Moves the eye without turning the camera
                 HandleInput
                   Handles the keyboard / mouse input
                 Initialize
@@ -60,6 +64,8 @@ namespace library
         const XMVECTOR& GetUp() const;
         const XMMATRIX& GetView() const;
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
+        void GetPickingRay(_In_ FLOAT screenX, _In_ FLOAT screenY, _In_ UINT uWidth, _In_ UINT uHeight, _In_ const XMMATRIX& projection, _Out_ XMFLOAT3& outOrigin, _Out_ XMFLOAT3& outDirection) const;
+        void SetEye(_In_ const XMVECTOR& eye);
 
         virtual void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
         virtual HRESULT Initialize(_In_ ID3D11Device* device);
@@ -30,6 +30,7 @@
 #include <d3d11_4.h>
 #include <d3dcompiler.h>
 #include <directxcolors.h>
+#include <DirectXCollision.h>
 
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
@@ -80,6 +81,21 @@ namespace library
         LONG Y;
     };
 
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   MouseClickInput
+
+        Summary:  Data structure that stores the mouse buttons pressed
+                  since the last frame and the cursor position in the
+                  client area at the last press
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MouseClickInput
+    {
+        BOOL bLeft;
+        BOOL bRight;
+        LONG X;
+        LONG Y;
+    };
+
     /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
         Enum:     eBlockType
 
@@ -98,6 +98,8 @@ namespace library
                     deltaTime
                     );
                 m_mainWindow->ResetMouseMovement(); // mouse input이 handle되면 reset
+                m_renderer->HandleMouseClick(m_mainWindow->GetMouseClick());
+                m_mainWindow->ResetMouseClick();
 
                 m_renderer->Update(deltaTime); // renderables update
                 m_renderer->Render();
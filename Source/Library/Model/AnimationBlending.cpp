@@ -0,0 +1,216 @@
+#include "Model/AnimationBlending.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: BlendPoses
+
+      Summary:  Blends a pose over another, four nodes at a time: by
+                the weight times the lane of the mask, translation and
+                scale are interpolated linearly and rotation along the
+                shorter arc, then normalized
+
+      Args:     const SoaTransform* pPose
+                  Pose to blend over the other
+                FLOAT weight
+                  Weight of the pose, 1 replaces the other
+                const XMVECTOR* pMask
+                  Weight of every node, null for all nodes fully
+                UINT uNumSoaTransforms
+                  Number of SoaTransforms of the poses
+                SoaTransform* pInOutPose
+                  Pose blended over
+
+      Modifies: [pInOutPose].
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void BlendPoses(
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pPose,
+        _In_ FLOAT weight,
+        _In_reads_opt_(uNumSoaTransforms) const XMVECTOR* pMask,
+        _In_ UINT uNumSoaTransforms,
+        _Inout_updates_(uNumSoaTransforms) SoaTransform* pInOutPose
+    )
+    {
+        for (UINT i = 0u; i < uNumSoaTransforms; ++i)
+        {
+            const SoaTransform& pose = pPose[i];
+            SoaTransform& outPose = pInOutPose[i];
+            const XMVECTOR weights = pMask ? XMVectorScale(pMask[i], weight) : XMVectorReplicate(weight);
+
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                outPose.Translation[j] = XMVectorMultiplyAdd(weights, XMVectorSubtract(pose.Translation[j], outPose.Translation[j]), outPose.Translation[j]);
+                outPose.Scale[j] = XMVectorMultiplyAdd(weights, XMVectorSubtract(pose.Scale[j], outPose.Scale[j]), outPose.Scale[j]);
+            }
+
+            XMVECTOR dot = XMVectorMultiply(outPose.Rotation[0], pose.Rotation[0]);
+            dot = XMVectorMultiplyAdd(outPose.Rotation[1], pose.Rotation[1], dot);
+            dot = XMVectorMultiplyAdd(outPose.Rotation[2], pose.Rotation[2], dot);
+            dot = XMVectorMultiplyAdd(outPose.Rotation[3], pose.Rotation[3], dot);
+            const XMVECTOR sign = XMVectorAndInt(dot, g_XMNegativeZero);
+
+            XMVECTOR lengthSquared = XMVectorZero();
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                const XMVECTOR shortRotation = XMVectorXorInt(pose.Rotation[j], sign);
+                outPose.Rotation[j] = XMVectorMultiplyAdd(weights, XMVectorSubtract(shortRotation, outPose.Rotation[j]), outPose.Rotation[j]);
+                lengthSquared = XMVectorMultiplyAdd(outPose.Rotation[j], outPose.Rotation[j], lengthSquared);
+            }
+            const XMVECTOR inverseLength = XMVectorReciprocalSqrt(lengthSquared);
+            for (UINT j = 0u; j < 4u; ++j)
+            {
+                outPose.Rotation[j] = XMVectorMultiply(outPose.Rotation[j], inverseLength);
+            }
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: AddPoses
+
+      Summary:  Adds the difference of a pose from a reference pose onto
+                another, four nodes at a time. By the weight times the
+                lane of the mask, the translation difference is added,
+                the scale is multiplied by the scale ratio, and the
+                rotation is followed by the rotation from the reference
+                to the pose, interpolated from identity along the
+                shorter arc. A pose equal to the reference changes
+                nothing
+
+      Args:     const SoaTransform* pPose
+                  Pose to add
+                const SoaTransform* pReferencePose
+                  Pose the difference is taken from
+                FLOAT weight
+                  Weight of the difference
+                const XMVECTOR* pMask
+                  Weight of every node, null for all nodes fully
+                UINT uNumSoaTransforms
+                  Number of SoaTransforms of the poses
+                SoaTransform* pInOutPose
+                  Pose added onto
+
+      Modifies: [pInOutPose].
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void AddPoses(
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pPose,
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pReferencePose,
+        _In_ FLOAT weight,
+        _In_reads_opt_(uNumSoaTransforms) const XMVECTOR* pMask,
+        _In_ UINT uNumSoaTransforms,
+        _Inout_updates_(uNumSoaTransforms) SoaTransform* pInOutPose
+    )
+    {
+        const XMVECTOR one = XMVectorSplatOne();
+
+        for (UINT i = 0u; i < uNumSoaTransforms; ++i)
+        {
+            const SoaTransform& pose = pPose[i];
+            const SoaTransform& referencePose = pReferencePose[i];
+            SoaTransform& outPose = pInOutPose[i];
+            const XMVECTOR weights = pMask ? XMVectorScale(pMask[i], weight) : XMVectorReplicate(weight);
+
+            for (UINT j = 0u; j < 3u; ++j)
+            {
+                outPose.Translation[j] = XMVectorMultiplyAdd(weights, XMVectorSubtract(pose.Translation[j], referencePose.Translation[j]), outPose.Translation[j]);
+
+                const XMVECTOR ratio = XMVectorDivide(pose.Scale[j], referencePose.Scale[j]);
+                outPose.Scale[j] = XMVectorMultiply(outPose.Scale[j], XMVectorMultiplyAdd(weights, XMVectorSubtract(ratio, one), one));
+            }
+
+            // Difference is the conjugate of the reference times the
+            // pose, so that the reference followed by it is the pose
+            const XMVECTOR rx = referencePose.Rotation[0];
+            const XMVECTOR ry = referencePose.Rotation[1];
+            const XMVECTOR rz = referencePose.Rotation[2];
+            const XMVECTOR rw = referencePose.Rotation[3];
+            const XMVECTOR px = pose.Rotation[0];
+            const XMVECTOR py = pose.Rotation[1];
+            const XMVECTOR pz = pose.Rotation[2];
+            const XMVECTOR pw = pose.Rotation[3];
+
+            XMVECTOR dw = XMVectorMultiplyAdd(rw, pw, XMVectorMultiplyAdd(rx, px, XMVectorMultiplyAdd(ry, py, XMVectorMultiply(rz, pz))));
+            XMVECTOR dx = XMVectorSubtract(XMVectorMultiplyAdd(rw, px, XMVectorMultiply(rz, py)), XMVectorMultiplyAdd(rx, pw, XMVectorMultiply(ry, pz)));
+            XMVECTOR dy = XMVectorSubtract(XMVectorMultiplyAdd(rw, py, XMVectorMultiply(rx, pz)), XMVectorMultiplyAdd(ry, pw, XMVectorMultiply(rz, px)));
+            XMVECTOR dz = XMVectorSubtract(XMVectorMultiplyAdd(rw, pz, XMVectorMultiply(ry, px)), XMVectorMultiplyAdd(rz, pw, XMVectorMultiply(rx, py)));
+
+            const XMVECTOR sign = XMVectorAndInt(dw, g_XMNegativeZero);
+            dx = XMVectorMultiply(weights, XMVectorXorInt(dx, sign));
+            dy = XMVectorMultiply(weights, XMVectorXorInt(dy, sign));
+            dz = XMVectorMultiply(weights, XMVectorXorInt(dz, sign));
+            dw = XMVectorMultiplyAdd(weights, XMVectorSubtract(XMVectorXorInt(dw, sign), one), one);
+
+            const XMVECTOR inverseLength = XMVectorReciprocalSqrt(
+                XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiplyAdd(dz, dz, XMVectorMultiply(dw, dw))))
+            );
+            dx = XMVectorMultiply(dx, inverseLength);
+            dy = XMVectorMultiply(dy, inverseLength);
+            dz = XMVectorMultiply(dz, inverseLength);
+            dw = XMVectorMultiply(dw, inverseLength);
+
+            const XMVECTOR ax = outPose.Rotation[0];
+            const XMVECTOR ay = outPose.Rotation[1];
+            const XMVECTOR az = outPose.Rotation[2];
+            const XMVECTOR aw = outPose.Rotation[3];
+
+            outPose.Rotation[0] = XMVectorSubtract(XMVectorMultiplyAdd(aw, dx, XMVectorMultiplyAdd(ax, dw, XMVectorMultiply(ay, dz))), XMVectorMultiply(az, dy));
+            outPose.Rotation[1] = XMVectorSubtract(XMVectorMultiplyAdd(aw, dy, XMVectorMultiplyAdd(ay, dw, XMVectorMultiply(az, dx))), XMVectorMultiply(ax, dz));
+            outPose.Rotation[2] = XMVectorSubtract(XMVectorMultiplyAdd(aw, dz, XMVectorMultiplyAdd(az, dw, XMVectorMultiply(ax, dy))), XMVectorMultiply(ay, dx));
+            outPose.Rotation[3] = XMVectorSubtract(
+                XMVectorMultiply(aw, dw),
+                XMVectorMultiplyAdd(ax, dx, XMVectorMultiplyAdd(ay, dy, XMVectorMultiply(az, dz)))
+            );
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: LoadPose
+
+      Summary:  Decomposes local matrices into a pose. Lanes past the
+                last node repeat it, as sampled poses do
+
+      Args:     const XMMATRIX* pMatrices
+                  Local matrix of every node
+                UINT uNumNodes
+                  Number of nodes
+                SoaTransform* pOutPose
+                  Pose of the nodes
+
+      Modifies: [pOutPose].
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void LoadPose(_In_reads_(uNumNodes) const XMMATRIX* pMatrices, _In_ UINT uNumNodes, _Out_ SoaTransform* pOutPose)
+    {
+        for (UINT uFirstNode = 0u; uFirstNode < uNumNodes; uFirstNode += AnimationSampler::SOA_WIDTH)
+        {
+            XMMATRIX aTransforms[3];
+
+            for (UINT uLane = 0u; uLane < AnimationSampler::SOA_WIDTH; ++uLane)
+            {
+                XMVECTOR scale;
+                XMVECTOR rotation;
+                XMVECTOR translation;
+                XMMatrixDecompose(&scale, &rotation, &translation, pMatrices[std::min<UINT>(uFirstNode + uLane, uNumNodes - 1u)]);
+
+                aTransforms[0].r[uLane] = translation;
+                aTransforms[1].r[uLane] = rotation;
+                aTransforms[2].r[uLane] = scale;
+            }
+
+            SoaTransform& pose = pOutPose[uFirstNode / AnimationSampler::SOA_WIDTH];
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                aTransforms[i] = XMMatrixTranspose(aTransforms[i]);
+            }
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                pose.Translation[i] = aTransforms[0].r[i];
+                pose.Scale[i] = aTransforms[2].r[i];
+            }
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                pose.Rotation[i] = aTransforms[1].r[i];
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*+===================================================================
+  File:      ANIMATIONBLENDING.H
+
+  Summary:   AnimationBlending header file contains declarations of
+             the functions that blend sampled poses four nodes at a
+             time in local space for the lab samples of Game Graphics
+             Programming course.
+
+  Functions: BlendPoses, AddPoses, LoadPose
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/AnimationSampler.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eAnimationBlendMode
+
+      Summary:  How an animation layer is blended over the layers below
+                it: its pose replaces theirs by its weight, or the
+                difference of its pose from the reference pose of its
+                clip is added onto theirs by its weight
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eAnimationBlendMode : BYTE
+    {
+        OVERRIDE = 0,
+        ADDITIVE = 1,
+    };
+
+    void BlendPoses(
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pPose,
+        _In_ FLOAT weight,
+        _In_reads_opt_(uNumSoaTransforms) const XMVECTOR* pMask,
+        _In_ UINT uNumSoaTransforms,
+        _Inout_updates_(uNumSoaTransforms) SoaTransform* pInOutPose
+    );
+    void AddPoses(
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pPose,
+        _In_reads_(uNumSoaTransforms) const SoaTransform* pReferencePose,
+        _In_ FLOAT weight,
+        _In_reads_opt_(uNumSoaTransforms) const XMVECTOR* pMask,
+        _In_ UINT uNumSoaTransforms,
+        _Inout_updates_(uNumSoaTransforms) SoaTransform* pInOutPose
+    );
+    void LoadPose(_In_reads_(uNumNodes) const XMMATRIX* pMatrices, _In_ UINT uNumNodes, _Out_ SoaTransform* pOutPose);
+}
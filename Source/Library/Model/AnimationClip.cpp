@@ -0,0 +1,419 @@
+#include "Model/AnimationClip.h"
+
+#include <algorithm>
+
+#include "assimp/scene.h"
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ConvertKeyValue
+
+      Summary:  Converts the value of a vector key to four floats with
+                w of zero
+
+      Returns:  XMFLOAT4
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMFLOAT4 ConvertKeyValue(_In_ const aiVector3D& value)
+    {
+        return XMFLOAT4(value.x, value.y, value.z, 0.0f);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ConvertKeyValue
+
+      Summary:  Converts the value of a quaternion key to four floats
+                in x, y, z, w order
+
+      Returns:  XMFLOAT4
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMFLOAT4 ConvertKeyValue(_In_ const aiQuaternion& value)
+    {
+        return XMFLOAT4(value.x, value.y, value.z, value.w);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: AppendTrack
+
+      Summary:  Appends the keys of a track of a channel to the key
+                arrays of its kind, or a single key of the bind value
+                if the track has none
+
+      Args:     const Key* aKeys
+                  Keys of the track, or nullptr
+                UINT uNumKeys
+                  Number of keys
+                FXMVECTOR bindValue
+                  Value of the node in its bind transform
+                AnimationTrack& outTrack
+                  Track to point at the appended keys
+                std::vector<FLOAT>& aTimes
+                  Key times of the kind
+                std::vector<XMFLOAT4>& aValues
+                  Key values of the kind
+
+      Modifies: [outTrack, aTimes, aValues].
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    template <class Key>
+    void AppendTrack(
+        _In_reads_opt_(uNumKeys) const Key* aKeys,
+        _In_ UINT uNumKeys,
+        _In_ FXMVECTOR bindValue,
+        _Out_ AnimationTrack& outTrack,
+        _Inout_ std::vector<FLOAT>& aTimes,
+        _Inout_ std::vector<XMFLOAT4>& aValues
+    )
+    {
+        outTrack.uFirstKey = static_cast<UINT>(aValues.size());
+
+        if (aKeys && uNumKeys > 0u)
+        {
+            for (UINT i = 0u; i < uNumKeys; ++i)
+            {
+                aTimes.push_back(static_cast<FLOAT>(aKeys[i].mTime));
+                aValues.push_back(ConvertKeyValue(aKeys[i].mValue));
+            }
+        }
+        else
+        {
+            XMFLOAT4 value;
+            XMStoreFloat4(&value, bindValue);
+            aTimes.push_back(0.0f);
+            aValues.push_back(value);
+        }
+
+        outTrack.uNumKeys = static_cast<UINT>(aValues.size()) - outTrack.uFirstKey;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::AnimationClip
+
+      Summary:  Constructor
+
+      Modifies: [m_duration, m_ticksPerSecond, m_uNumNodes, m_aaTracks,
+                 m_aaKeyTimes, m_aaKeyValues].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationClip::AnimationClip()
+        : m_duration(0.0f)
+        , m_ticksPerSecond(25.0f)
+        , m_uNumNodes(0u)
+        , m_aaTracks()
+        , m_aaKeyTimes()
+        , m_aaKeyValues()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::Create
+
+      Summary:  Copies the keys of the channels of an animation to the
+                tracks of the skeleton nodes they animate. Tracks of
+                nodes without a channel, and empty tracks of a channel,
+                get one key of the bind transform of their node
+
+      Args:     const aiAnimation* pAnimation
+                  Animation to copy
+                const std::unordered_map<std::string, UINT>& nodeNameToIndexMap
+                  Index of every skeleton node by its name
+                const XMMATRIX* pBindTransforms
+                  Local transform of every skeleton node
+                UINT uNumNodes
+                  Number of skeleton nodes
+
+      Modifies: [m_duration, m_ticksPerSecond, m_uNumNodes, m_aaTracks,
+                 m_aaKeyTimes, m_aaKeyValues].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AnimationClip::Create(
+        _In_ const aiAnimation* pAnimation,
+        _In_ const std::unordered_map<std::string, UINT>& nodeNameToIndexMap,
+        _In_reads_(uNumNodes) const XMMATRIX* pBindTransforms,
+        _In_ UINT uNumNodes
+    )
+    {
+        if (!pAnimation || (uNumNodes > 0u && !pBindTransforms))
+        {
+            return E_INVALIDARG;
+        }
+
+        m_duration = static_cast<FLOAT>(pAnimation->mDuration);
+        m_ticksPerSecond = pAnimation->mTicksPerSecond != 0.0 ? static_cast<FLOAT>(pAnimation->mTicksPerSecond) : 25.0f;
+        m_uNumNodes = uNumNodes;
+
+        std::vector<const aiNodeAnim*> apChannels(uNumNodes, nullptr);
+        for (UINT i = 0u; i < pAnimation->mNumChannels; ++i)
+        {
+            const aiNodeAnim* pNodeAnim = pAnimation->mChannels[i];
+            auto node = nodeNameToIndexMap.find(pNodeAnim->mNodeName.C_Str());
+            if (node != nodeNameToIndexMap.end() && node->second < uNumNodes)
+            {
+                apChannels[node->second] = pNodeAnim;
+            }
+        }
+
+        for (UINT uType = 0u; uType < NUM_TRACK_TYPES; ++uType)
+        {
+            m_aaTracks[uType].resize(uNumNodes);
+            m_aaKeyTimes[uType].clear();
+            m_aaKeyValues[uType].clear();
+        }
+
+        for (UINT uNode = 0u; uNode < uNumNodes; ++uNode)
+        {
+            const aiNodeAnim* pNodeAnim = apChannels[uNode];
+
+            XMVECTOR bindScale;
+            XMVECTOR bindRotation;
+            XMVECTOR bindTranslation;
+            if (!XMMatrixDecompose(&bindScale, &bindRotation, &bindTranslation, pBindTransforms[uNode]))
+            {
+                bindScale = XMVectorSplatOne();
+                bindRotation = XMQuaternionIdentity();
+                bindTranslation = pBindTransforms[uNode].r[3];
+            }
+
+            const UINT uTranslation = static_cast<UINT>(eAnimationTrackType::TRANSLATION);
+            const UINT uRotation = static_cast<UINT>(eAnimationTrackType::ROTATION);
+            const UINT uScale = static_cast<UINT>(eAnimationTrackType::SCALE);
+            AppendTrack(
+                pNodeAnim ? pNodeAnim->mPositionKeys : nullptr,
+                pNodeAnim ? pNodeAnim->mNumPositionKeys : 0u,
+                XMVectorSetW(bindTranslation, 0.0f),
+                m_aaTracks[uTranslation][uNode],
+                m_aaKeyTimes[uTranslation],
+                m_aaKeyValues[uTranslation]
+            );
+            AppendTrack(
+                pNodeAnim ? pNodeAnim->mRotationKeys : nullptr,
+                pNodeAnim ? pNodeAnim->mNumRotationKeys : 0u,
+                bindRotation,
+                m_aaTracks[uRotation][uNode],
+                m_aaKeyTimes[uRotation],
+                m_aaKeyValues[uRotation]
+            );
+            AppendTrack(
+                pNodeAnim ? pNodeAnim->mScalingKeys : nullptr,
+                pNodeAnim ? pNodeAnim->mNumScalingKeys : 0u,
+                XMVectorSetW(bindScale, 0.0f),
+                m_aaTracks[uScale][uNode],
+                m_aaKeyTimes[uScale],
+                m_aaKeyValues[uScale]
+            );
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetDuration
+
+      Summary:  Returns the length of the clip
+
+      Returns:  FLOAT
+                  Length of the clip in ticks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT AnimationClip::GetDuration() const
+    {
+        return m_duration;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetTicksPerSecond
+
+      Summary:  Returns the ticks of the clip per second
+
+      Returns:  FLOAT
+                  Ticks per second, 25 if the file has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT AnimationClip::GetTicksPerSecond() const
+    {
+        return m_ticksPerSecond;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetNumNodes
+
+      Summary:  Returns the number of nodes of the skeleton
+
+      Returns:  UINT
+                  Number of nodes, and of tracks of every kind
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AnimationClip::GetNumNodes() const
+    {
+        return m_uNumNodes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetNumKeys
+
+      Summary:  Returns the number of keys of every track
+
+      Returns:  UINT
+                  Number of keys of all kinds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AnimationClip::GetNumKeys() const
+    {
+        size_t uNumKeys = 0u;
+        for (UINT uType = 0u; uType < NUM_TRACK_TYPES; ++uType)
+        {
+            uNumKeys += m_aaKeyValues[uType].size();
+        }
+
+        return static_cast<UINT>(uNumKeys);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetSizeInBytes
+
+      Summary:  Returns the memory of the tracks and keys
+
+      Returns:  size_t
+                  Bytes of the tracks, key times and key values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t AnimationClip::GetSizeInBytes() const
+    {
+        size_t uSizeInBytes = 0u;
+        for (UINT uType = 0u; uType < NUM_TRACK_TYPES; ++uType)
+        {
+            uSizeInBytes += m_aaTracks[uType].size() * sizeof(AnimationTrack)
+                + m_aaKeyTimes[uType].size() * sizeof(FLOAT)
+                + m_aaKeyValues[uType].size() * sizeof(XMFLOAT4);
+        }
+
+        return uSizeInBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::FindKeys
+
+      Summary:  Finds the keys of a track right before and after a
+                time, and how far between them the time is. A track of
+                a single key returns it twice
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                UINT uNode
+                  Node of the track
+                FLOAT time
+                  Time in ticks
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+                UINT& uOutStartKey
+                  Key right before the time
+                UINT& uOutEndKey
+                  Key right after the time
+                FLOAT& outFactor
+                  Interpolation factor, clamped to [0, 1]
+
+      Modifies: [uKeyCursor].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationClip::FindKeys(
+        _In_ eAnimationTrackType type,
+        _In_ UINT uNode,
+        _In_ FLOAT time,
+        _Inout_ UINT& uKeyCursor,
+        _Out_ UINT& uOutStartKey,
+        _Out_ UINT& uOutEndKey,
+        _Out_ FLOAT& outFactor
+    ) const
+    {
+        const AnimationTrack& track = m_aaTracks[static_cast<UINT>(type)][uNode];
+
+        if (track.uNumKeys == 1u)
+        {
+            uOutStartKey = track.uFirstKey;
+            uOutEndKey = track.uFirstKey;
+            outFactor = 0.0f;
+            return;
+        }
+
+        const FLOAT* aTrackTimes = m_aaKeyTimes[static_cast<UINT>(type)].data() + track.uFirstKey;
+        const UINT uKey = FindKey(
+            time,
+            track.uNumKeys,
+            [aTrackTimes](UINT uIndex)
+            {
+                return aTrackTimes[uIndex];
+            },
+            uKeyCursor
+        );
+
+        uOutStartKey = track.uFirstKey + uKey;
+        uOutEndKey = uOutStartKey + 1u;
+        outFactor = std::clamp((time - aTrackTimes[uKey]) / (aTrackTimes[uKey + 1u] - aTrackTimes[uKey]), 0.0f, 1.0f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::LoadKey
+
+      Summary:  Returns the value of a key
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                UINT uNode
+                  Node of the track
+                UINT uKey
+                  Key returned by FindKeys
+
+      Returns:  XMVECTOR
+                  Translation or scale with w of zero, or rotation
+                  quaternion
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR AnimationClip::LoadKey(_In_ eAnimationTrackType type, _In_ UINT uNode, _In_ UINT uKey) const
+    {
+        UNREFERENCED_PARAMETER(uNode);
+
+        return XMLoadFloat4(&m_aaKeyValues[static_cast<UINT>(type)][uKey]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetTracks
+
+      Summary:  Returns the tracks of a kind
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+
+      Returns:  const AnimationTrack*
+                  Track of every skeleton node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const AnimationTrack* AnimationClip::GetTracks(_In_ eAnimationTrackType type) const
+    {
+        return m_aaTracks[static_cast<UINT>(type)].data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetKeyTimes
+
+      Summary:  Returns the key times of a kind
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+
+      Returns:  const FLOAT*
+                  Key times in ticks, indexed by the tracks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FLOAT* AnimationClip::GetKeyTimes(_In_ eAnimationTrackType type) const
+    {
+        return m_aaKeyTimes[static_cast<UINT>(type)].data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationClip::GetKeyValues
+
+      Summary:  Returns the key values of a kind
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+
+      Returns:  const XMFLOAT4*
+                  Translations and scales with w of zero, or rotation
+                  quaternions, indexed by the tracks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4* AnimationClip::GetKeyValues(_In_ eAnimationTrackType type) const
+    {
+        return m_aaKeyValues[static_cast<UINT>(type)].data();
+    }
+}
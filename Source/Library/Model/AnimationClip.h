@@ -0,0 +1,201 @@
+/*+===================================================================
+  File:      ANIMATIONCLIP.H
+
+  Summary:   AnimationClip header file contains declarations of the
+             AnimationClip class that keeps the keys of an animation
+             in flat arrays laid out for sampling many nodes at once
+             for the lab samples of Game Graphics Programming course.
+
+  Classes: AnimationClip
+
+  Functions: FindKey
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+struct aiAnimation;
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eAnimationTrackType
+
+      Summary:  Kinds of tracks every node of a clip has
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eAnimationTrackType : BYTE
+    {
+        TRANSLATION = 0,
+        ROTATION = 1,
+        SCALE = 2,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationTrack
+
+      Summary:  Range of the keys of one track in the key arrays of its
+                kind
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationTrack
+    {
+        UINT uFirstKey;
+        UINT uNumKeys;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AnimationClip
+
+      Summary:  Keys of an animation resolved against a flattened
+                skeleton. Every node of the skeleton has a translation,
+                a rotation and a scale track; a node the animation does
+                not move gets a single key holding its bind pose, so
+                the sampler needs no special case for it. Key times and
+                key values of each kind live in their own flat arrays,
+                one track after another, and every value is four floats
+                so the keys of four nodes load into four vectors that
+                transpose into one component per vector
+
+      Methods:  Create
+                  Copies the keys of an animation for a skeleton
+                GetDuration
+                  Returns the length of the clip in ticks
+                GetTicksPerSecond
+                  Returns the ticks of the clip per second
+                GetNumNodes
+                  Returns the number of nodes of the skeleton
+                GetNumKeys
+                  Returns the number of keys of every track
+                GetSizeInBytes
+                  Returns the memory of the tracks and keys
+                FindKeys
+                  Finds the keys of a track around a time
+                LoadKey
+                  Returns the value of a key
+                GetTracks
+                  Returns the tracks of a kind, one per node
+                GetKeyTimes
+                  Returns the key times of a kind
+                GetKeyValues
+                  Returns the key values of a kind
+                AnimationClip
+                  Constructor.
+                ~AnimationClip
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AnimationClip final
+    {
+    public:
+        static constexpr const UINT NUM_TRACK_TYPES = 3u;
+        // Keys a track cursor steps over before it binary searches
+        static constexpr const UINT MAX_KEY_CURSOR_STEPS = 4u;
+
+        AnimationClip();
+        AnimationClip(const AnimationClip& other) = delete;
+        AnimationClip(AnimationClip&& other) = delete;
+        AnimationClip& operator=(const AnimationClip& other) = delete;
+        AnimationClip& operator=(AnimationClip&& other) = delete;
+        ~AnimationClip() = default;
+
+        HRESULT Create(
+            _In_ const aiAnimation* pAnimation,
+            _In_ const std::unordered_map<std::string, UINT>& nodeNameToIndexMap,
+            _In_reads_(uNumNodes) const XMMATRIX* pBindTransforms,
+            _In_ UINT uNumNodes
+        );
+
+        FLOAT GetDuration() const;
+        FLOAT GetTicksPerSecond() const;
+        UINT GetNumNodes() const;
+        UINT GetNumKeys() const;
+        size_t GetSizeInBytes() const;
+
+        void FindKeys(
+            _In_ eAnimationTrackType type,
+            _In_ UINT uNode,
+            _In_ FLOAT time,
+            _Inout_ UINT& uKeyCursor,
+            _Out_ UINT& uOutStartKey,
+            _Out_ UINT& uOutEndKey,
+            _Out_ FLOAT& outFactor
+        ) const;
+        XMVECTOR LoadKey(_In_ eAnimationTrackType type, _In_ UINT uNode, _In_ UINT uKey) const;
+
+        const AnimationTrack* GetTracks(_In_ eAnimationTrackType type) const;
+        const FLOAT* GetKeyTimes(_In_ eAnimationTrackType type) const;
+        const XMFLOAT4* GetKeyValues(_In_ eAnimationTrackType type) const;
+
+    private:
+        FLOAT m_duration;
+        FLOAT m_ticksPerSecond;
+        UINT m_uNumNodes;
+        std::vector<AnimationTrack> m_aaTracks[NUM_TRACK_TYPES];
+        std::vector<FLOAT> m_aaKeyTimes[NUM_TRACK_TYPES];
+        std::vector<XMFLOAT4> m_aaKeyValues[NUM_TRACK_TYPES];
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: FindKey
+
+      Summary:  Finds the index of the key right before a time, starting
+                from the key a track was last sampled at. Playing
+                forward only ever moves a few keys ahead, so up to
+                AnimationClip::MAX_KEY_CURSOR_STEPS keys are stepped
+                over; a seek or a wrap around to the start of the clip
+                falls back to a binary search. Times past the last key
+                stay on the last pair of keys
+
+      Args:     FLOAT time
+                  Time to find the key of
+                UINT uNumKeys
+                  Number of keys, at least two
+                GetKeyTime getKeyTime
+                  Returns the time of a key by its index, keys sorted
+                  by time
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+
+      Modifies: [uKeyCursor].
+
+      Returns:  UINT
+                  Index of the key
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    template <class GetKeyTime>
+    UINT FindKey(_In_ FLOAT time, _In_ UINT uNumKeys, _In_ const GetKeyTime& getKeyTime, _Inout_ UINT& uKeyCursor)
+    {
+        assert(uNumKeys > 1u);
+
+        const UINT uLastSegment = uNumKeys - 2u;
+        if (uKeyCursor <= uLastSegment && getKeyTime(uKeyCursor) <= time)
+        {
+            for (UINT uStep = 0u; uStep <= AnimationClip::MAX_KEY_CURSOR_STEPS; ++uStep)
+            {
+                if (uKeyCursor == uLastSegment || time < getKeyTime(uKeyCursor + 1u))
+                {
+                    return uKeyCursor;
+                }
+                ++uKeyCursor;
+            }
+        }
+
+        // Number of keys 1 to n - 1 at or before the time
+        UINT uLow = 1u;
+        UINT uHigh = uNumKeys;
+        while (uLow < uHigh)
+        {
+            const UINT uMiddle = uLow + (uHigh - uLow) / 2u;
+            if (time < getKeyTime(uMiddle))
+            {
+                uHigh = uMiddle;
+            }
+            else
+            {
+                uLow = uMiddle + 1u;
+            }
+        }
+        uKeyCursor = uLow - 1u < uLastSegment ? uLow - 1u : uLastSegment;
+
+        return uKeyCursor;
+    }
+}
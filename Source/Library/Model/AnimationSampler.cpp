@@ -0,0 +1,492 @@
+#include "Model/AnimationSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::AnimationSampler
+
+      Summary:  Constructor
+
+      Modifies: [m_bSlerpFallback, m_auKeyCursors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationSampler::AnimationSampler()
+        : m_bSlerpFallback(FALSE)
+        , m_auKeyCursors()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::Sample
+
+      Summary:  Samples every track of a clip at a time
+
+      Args:     const AnimationClip& clip
+                  Clip to sample
+                FLOAT time
+                  Time in ticks
+                SoaTransform* pOutPose
+                  Local transforms of the nodes of the clip
+
+      Modifies: [m_auKeyCursors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationSampler::Sample(_In_ const AnimationClip& clip, _In_ FLOAT time, _Out_writes_(GetNumSoaTransforms(clip.GetNumNodes())) SoaTransform* pOutPose)
+    {
+        sample(clip, time, pOutPose);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::Sample
+
+      Summary:  Samples every track of a compressed clip at a time,
+                decompressing the keys as they are loaded
+
+      Args:     const CompressedAnimationClip& clip
+                  Clip to sample
+                FLOAT time
+                  Time in ticks
+                SoaTransform* pOutPose
+                  Local transforms of the nodes of the clip
+
+      Modifies: [m_auKeyCursors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationSampler::Sample(_In_ const CompressedAnimationClip& clip, _In_ FLOAT time, _Out_writes_(GetNumSoaTransforms(clip.GetNumNodes())) SoaTransform* pOutPose)
+    {
+        sample(clip, time, pOutPose);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::SetSlerpFallback
+
+      Summary:  Turns the slerp fallback on or off
+
+      Args:     BOOL bSlerpFallback
+                  Whether rotation keys far apart are spherically
+                  interpolated
+
+      Modifies: [m_bSlerpFallback].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationSampler::SetSlerpFallback(_In_ BOOL bSlerpFallback)
+    {
+        m_bSlerpFallback = bSlerpFallback;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::GetNumSoaTransforms
+
+      Summary:  Returns the SoaTransforms a pose of nodes needs
+
+      Args:     UINT uNumNodes
+                  Number of nodes
+
+      Returns:  UINT
+                  Number of nodes divided by SOA_WIDTH, rounded up
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AnimationSampler::GetNumSoaTransforms(_In_ UINT uNumNodes)
+    {
+        return (uNumNodes + SOA_WIDTH - 1u) / SOA_WIDTH;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::ComposeMatrices
+
+      Summary:  Composes the scaling, then rotation, then translation
+                matrices of a pose four nodes at a time. Each row of
+                the rotation matrix of XMMatrixRotationQuaternion is
+                built for all four nodes and scaled by their scale on
+                that axis, and one transpose per row turns the four
+                nodes back into one row of each of their matrices
+
+      Args:     const SoaTransform* pPose
+                  Local transforms of the nodes
+                UINT uNumNodes
+                  Number of nodes
+                XMMATRIX* pOutMatrices
+                  Local matrix of every node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AnimationSampler::ComposeMatrices(_In_ const SoaTransform* pPose, _In_ UINT uNumNodes, _Out_writes_(uNumNodes) XMMATRIX* pOutMatrices)
+    {
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR zero = XMVectorZero();
+
+        for (UINT uFirstNode = 0u; uFirstNode < uNumNodes; uFirstNode += SOA_WIDTH)
+        {
+            const SoaTransform& pose = pPose[uFirstNode / SOA_WIDTH];
+            const UINT uNumLanes = std::min<UINT>(SOA_WIDTH, uNumNodes - uFirstNode);
+
+            const XMVECTOR x = pose.Rotation[0];
+            const XMVECTOR y = pose.Rotation[1];
+            const XMVECTOR z = pose.Rotation[2];
+            const XMVECTOR w = pose.Rotation[3];
+            const XMVECTOR x2 = XMVectorAdd(x, x);
+            const XMVECTOR y2 = XMVectorAdd(y, y);
+            const XMVECTOR z2 = XMVectorAdd(z, z);
+            const XMVECTOR xx = XMVectorMultiply(x, x2);
+            const XMVECTOR yy = XMVectorMultiply(y, y2);
+            const XMVECTOR zz = XMVectorMultiply(z, z2);
+            const XMVECTOR xy = XMVectorMultiply(x, y2);
+            const XMVECTOR xz = XMVectorMultiply(x, z2);
+            const XMVECTOR yz = XMVectorMultiply(y, z2);
+            const XMVECTOR wx = XMVectorMultiply(w, x2);
+            const XMVECTOR wy = XMVectorMultiply(w, y2);
+            const XMVECTOR wz = XMVectorMultiply(w, z2);
+
+            const XMMATRIX aRows[4] =
+            {
+                XMMatrixTranspose(XMMATRIX(
+                    XMVectorMultiply(pose.Scale[0], XMVectorSubtract(one, XMVectorAdd(yy, zz))),
+                    XMVectorMultiply(pose.Scale[0], XMVectorAdd(xy, wz)),
+                    XMVectorMultiply(pose.Scale[0], XMVectorSubtract(xz, wy)),
+                    zero
+                )),
+                XMMatrixTranspose(XMMATRIX(
+                    XMVectorMultiply(pose.Scale[1], XMVectorSubtract(xy, wz)),
+                    XMVectorMultiply(pose.Scale[1], XMVectorSubtract(one, XMVectorAdd(xx, zz))),
+                    XMVectorMultiply(pose.Scale[1], XMVectorAdd(yz, wx)),
+                    zero
+                )),
+                XMMatrixTranspose(XMMATRIX(
+                    XMVectorMultiply(pose.Scale[2], XMVectorAdd(xz, wy)),
+                    XMVectorMultiply(pose.Scale[2], XMVectorSubtract(yz, wx)),
+                    XMVectorMultiply(pose.Scale[2], XMVectorSubtract(one, XMVectorAdd(xx, yy))),
+                    zero
+                )),
+                XMMatrixTranspose(XMMATRIX(pose.Translation[0], pose.Translation[1], pose.Translation[2], one)),
+            };
+
+            for (UINT uLane = 0u; uLane < uNumLanes; ++uLane)
+            {
+                pOutMatrices[uFirstNode + uLane] = XMMATRIX(aRows[0].r[uLane], aRows[1].r[uLane], aRows[2].r[uLane], aRows[3].r[uLane]);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::MeasureThroughput
+
+      Summary:  Samples frames spread over a clip into local matrices
+                one track at a time, spherically interpolating rotations
+                as the Assimp keys used to be, and four nodes at a time,
+                and logs the time of both and the largest difference
+                between their matrices
+
+      Args:     const AnimationClip& clip
+                  Clip to sample
+                UINT uNumFrames
+                  Number of frames to sample
+
+      Modifies: [m_auKeyCursors].
+
+      Returns:  AnimationSamplingStatistics
+                  Time per frame of both and their largest difference
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationSamplingStatistics AnimationSampler::MeasureThroughput(_In_ const AnimationClip& clip, _In_ UINT uNumFrames)
+    {
+        const UINT uNumNodes = clip.GetNumNodes();
+
+        AnimationSamplingStatistics statistics =
+        {
+            .uNumNodes = uNumNodes,
+            .uNumKeys = clip.GetNumKeys(),
+            .uNumFrames = uNumFrames,
+            .scalarMicroseconds = 0.0,
+            .soaMicroseconds = 0.0,
+            .maxError = 0.0f,
+        };
+
+        if (uNumNodes == 0u || uNumFrames == 0u)
+        {
+            return statistics;
+        }
+
+        std::vector<XMFLOAT4X4> aScalarMatrices(static_cast<size_t>(uNumNodes) * uNumFrames);
+        std::vector<XMFLOAT4X4> aSoaMatrices(static_cast<size_t>(uNumNodes) * uNumFrames);
+        std::vector<SoaTransform> aPose(GetNumSoaTransforms(uNumNodes));
+        std::vector<XMMATRIX> aMatrices(uNumNodes);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        m_auKeyCursors.assign(static_cast<size_t>(uNumNodes) * AnimationClip::NUM_TRACK_TYPES, 0u);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            const FLOAT time = clip.GetDuration() * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames);
+            for (UINT uNode = 0u; uNode < uNumNodes; ++uNode)
+            {
+                XMStoreFloat4x4(&aScalarMatrices[static_cast<size_t>(uFrame) * uNumNodes + uNode], sampleNode(clip, uNode, time));
+            }
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE scalarSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        m_auKeyCursors.assign(static_cast<size_t>(uNumNodes) * AnimationClip::NUM_TRACK_TYPES, 0u);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            const FLOAT time = clip.GetDuration() * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames);
+            Sample(clip, time, aPose.data());
+            ComposeMatrices(aPose.data(), uNumNodes, aMatrices.data());
+            for (UINT uNode = 0u; uNode < uNumNodes; ++uNode)
+            {
+                XMStoreFloat4x4(&aSoaMatrices[static_cast<size_t>(uFrame) * uNumNodes + uNode], aMatrices[uNode]);
+            }
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE soaSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        for (size_t i = 0u; i < aScalarMatrices.size(); ++i)
+        {
+            for (UINT uRow = 0u; uRow < 4u; ++uRow)
+            {
+                for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+                {
+                    statistics.maxError = std::max<FLOAT>(statistics.maxError, std::abs(aScalarMatrices[i].m[uRow][uColumn] - aSoaMatrices[i].m[uRow][uColumn]));
+                }
+            }
+        }
+
+        statistics.scalarMicroseconds = scalarSeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+        statistics.soaMicroseconds = soaSeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "AnimationSampler: %u node(s), %u key(s), %u frame(s), one track at a time %.2f us, four nodes at a time %.2f us per frame, max error %g\n",
+            statistics.uNumNodes,
+            statistics.uNumKeys,
+            statistics.uNumFrames,
+            statistics.scalarMicroseconds,
+            statistics.soaMicroseconds,
+            statistics.maxError
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::sample
+
+      Summary:  Samples every track of a clip of either kind at a time.
+                Lanes past the last node repeat it, so the last
+                SoaTransform is always fully written
+
+      Args:     const Clip& clip
+                  Clip to sample
+                FLOAT time
+                  Time in ticks
+                SoaTransform* pOutPose
+                  Local transforms of the nodes of the clip
+
+      Modifies: [m_auKeyCursors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class Clip>
+    void AnimationSampler::sample(_In_ const Clip& clip, _In_ FLOAT time, _Out_ SoaTransform* pOutPose)
+    {
+        const UINT uNumNodes = clip.GetNumNodes();
+        if (m_auKeyCursors.size() != static_cast<size_t>(uNumNodes) * AnimationClip::NUM_TRACK_TYPES)
+        {
+            m_auKeyCursors.assign(static_cast<size_t>(uNumNodes) * AnimationClip::NUM_TRACK_TYPES, 0u);
+        }
+
+        UINT auStartKeys[SOA_WIDTH];
+        UINT auEndKeys[SOA_WIDTH];
+        XMMATRIX start;
+        XMMATRIX end;
+        XMVECTOR factors;
+
+        for (UINT uFirstNode = 0u; uFirstNode < uNumNodes; uFirstNode += SOA_WIDTH)
+        {
+            SoaTransform& pose = pOutPose[uFirstNode / SOA_WIDTH];
+
+            loadKeys(clip, eAnimationTrackType::TRANSLATION, uFirstNode, time, auStartKeys, auEndKeys, start, end, factors);
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                pose.Translation[i] = XMVectorMultiplyAdd(factors, XMVectorSubtract(end.r[i], start.r[i]), start.r[i]);
+            }
+
+            loadKeys(clip, eAnimationTrackType::SCALE, uFirstNode, time, auStartKeys, auEndKeys, start, end, factors);
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                pose.Scale[i] = XMVectorMultiplyAdd(factors, XMVectorSubtract(end.r[i], start.r[i]), start.r[i]);
+            }
+
+            // Rotation, along the shorter arc: the end key is negated
+            // in the lanes whose keys are more than half a turn apart
+            loadKeys(clip, eAnimationTrackType::ROTATION, uFirstNode, time, auStartKeys, auEndKeys, start, end, factors);
+
+            XMVECTOR dot = XMVectorMultiply(start.r[0], end.r[0]);
+            dot = XMVectorMultiplyAdd(start.r[1], end.r[1], dot);
+            dot = XMVectorMultiplyAdd(start.r[2], end.r[2], dot);
+            dot = XMVectorMultiplyAdd(start.r[3], end.r[3], dot);
+            const XMVECTOR sign = XMVectorAndInt(dot, g_XMNegativeZero);
+
+            XMVECTOR lengthSquared = XMVectorZero();
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                const XMVECTOR shortEnd = XMVectorXorInt(end.r[i], sign);
+                pose.Rotation[i] = XMVectorMultiplyAdd(factors, XMVectorSubtract(shortEnd, start.r[i]), start.r[i]);
+                lengthSquared = XMVectorMultiplyAdd(pose.Rotation[i], pose.Rotation[i], lengthSquared);
+            }
+            const XMVECTOR inverseLength = XMVectorReciprocalSqrt(lengthSquared);
+            for (UINT i = 0u; i < 4u; ++i)
+            {
+                pose.Rotation[i] = XMVectorMultiply(pose.Rotation[i], inverseLength);
+            }
+
+            if (m_bSlerpFallback)
+            {
+                const XMVECTOR farApart = XMVectorLess(XMVectorAbs(dot), XMVectorReplicate(SLERP_THRESHOLD));
+                if (!XMVector4EqualInt(farApart, XMVectorFalseInt()))
+                {
+                    for (UINT uLane = 0u; uLane < SOA_WIDTH; ++uLane)
+                    {
+                        if (XMVectorGetIntByIndex(farApart, uLane) == 0u)
+                        {
+                            continue;
+                        }
+
+                        const UINT uNode = std::min<UINT>(uFirstNode + uLane, uNumNodes - 1u);
+                        const XMVECTOR rotation = XMQuaternionSlerp(
+                            clip.LoadKey(eAnimationTrackType::ROTATION, uNode, auStartKeys[uLane]),
+                            clip.LoadKey(eAnimationTrackType::ROTATION, uNode, auEndKeys[uLane]),
+                            XMVectorGetByIndex(factors, uLane)
+                        );
+                        for (UINT i = 0u; i < 4u; ++i)
+                        {
+                            pose.Rotation[i] = XMVectorSetByIndex(pose.Rotation[i], XMVectorGetByIndex(rotation, i), uLane);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::loadKeys
+
+      Summary:  Finds the keys around a time of the tracks of a kind of
+                four consecutive nodes, loads them and transposes them
+                so each row holds one component of the four. Lanes past
+                the last node repeat it. A resampled compressed clip
+                decompresses the four at once
+
+      Args:     const Clip& clip
+                  Clip to sample
+                eAnimationTrackType type
+                  Kind of the tracks
+                UINT uFirstNode
+                  Node of the first lane
+                FLOAT time
+                  Time in ticks
+                UINT* puOutStartKeys
+                  Key right before the time of every lane
+                UINT* puOutEndKeys
+                  Key right after the time of every lane
+                XMMATRIX& outStart
+                  Components of the keys right before the time
+                XMMATRIX& outEnd
+                  Components of the keys right after the time
+                XMVECTOR& outFactors
+                  Interpolation factor of every lane
+
+      Modifies: [m_auKeyCursors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class Clip>
+    void AnimationSampler::loadKeys(
+        _In_ const Clip& clip,
+        _In_ eAnimationTrackType type,
+        _In_ UINT uFirstNode,
+        _In_ FLOAT time,
+        _Out_writes_(SOA_WIDTH) UINT* puOutStartKeys,
+        _Out_writes_(SOA_WIDTH) UINT* puOutEndKeys,
+        _Out_ XMMATRIX& outStart,
+        _Out_ XMMATRIX& outEnd,
+        _Out_ XMVECTOR& outFactors
+    )
+    {
+        // Resampled lanes share their keys, decompressed together
+        if constexpr (std::is_same_v<Clip, CompressedAnimationClip>)
+        {
+            static_assert(CompressedAnimationClip::NUM_LANES == SOA_WIDTH);
+
+            if (clip.IsResampled())
+            {
+                clip.LoadSoaKeys(type, uFirstNode, time, puOutStartKeys, puOutEndKeys, outStart, outEnd, outFactors);
+                return;
+            }
+        }
+
+        const UINT uNumNodes = clip.GetNumNodes();
+        UINT* auKeyCursors = m_auKeyCursors.data() + static_cast<size_t>(type) * uNumNodes;
+
+        UINT auNodes[SOA_WIDTH];
+        XMFLOAT4A factors;
+        FLOAT* afFactors = &factors.x;
+        for (UINT uLane = 0u; uLane < SOA_WIDTH; ++uLane)
+        {
+            auNodes[uLane] = std::min<UINT>(uFirstNode + uLane, uNumNodes - 1u);
+            clip.FindKeys(type, auNodes[uLane], time, auKeyCursors[auNodes[uLane]], puOutStartKeys[uLane], puOutEndKeys[uLane], afFactors[uLane]);
+        }
+
+        // A track of a single key, or a time right on a key, loads the
+        // key once, which matters when loading decompresses it
+        for (UINT uLane = 0u; uLane < SOA_WIDTH; ++uLane)
+        {
+            outStart.r[uLane] = clip.LoadKey(type, auNodes[uLane], puOutStartKeys[uLane]);
+            outEnd.r[uLane] = puOutEndKeys[uLane] == puOutStartKeys[uLane] ? outStart.r[uLane] : clip.LoadKey(type, auNodes[uLane], puOutEndKeys[uLane]);
+        }
+        outStart = XMMatrixTranspose(outStart);
+        outEnd = XMMatrixTranspose(outEnd);
+        outFactors = XMLoadFloat4A(&factors);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AnimationSampler::sampleNode
+
+      Summary:  Samples the tracks of one node into its local matrix,
+                one track at a time
+
+      Args:     const AnimationClip& clip
+                  Clip to sample
+                UINT uNode
+                  Node to sample
+                FLOAT time
+                  Time in ticks
+
+      Modifies: [m_auKeyCursors].
+
+      Returns:  XMMATRIX
+                  Scaling, then rotation, then translation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX AnimationSampler::sampleNode(_In_ const AnimationClip& clip, _In_ UINT uNode, _In_ FLOAT time)
+    {
+        XMVECTOR aValues[AnimationClip::NUM_TRACK_TYPES];
+
+        for (UINT uType = 0u; uType < AnimationClip::NUM_TRACK_TYPES; ++uType)
+        {
+            const eAnimationTrackType type = static_cast<eAnimationTrackType>(uType);
+
+            UINT uStartKey;
+            UINT uEndKey;
+            FLOAT factor;
+            clip.FindKeys(type, uNode, time, m_auKeyCursors[static_cast<size_t>(uType) * clip.GetNumNodes() + uNode], uStartKey, uEndKey, factor);
+
+            const XMVECTOR start = clip.LoadKey(type, uNode, uStartKey);
+            const XMVECTOR end = clip.LoadKey(type, uNode, uEndKey);
+            aValues[uType] = type == eAnimationTrackType::ROTATION ? XMQuaternionSlerp(start, end, factor) : XMVectorLerp(start, end, factor);
+        }
+
+        return XMMatrixScalingFromVector(aValues[static_cast<UINT>(eAnimationTrackType::SCALE)])
+            * XMMatrixRotationQuaternion(aValues[static_cast<UINT>(eAnimationTrackType::ROTATION)])
+            * XMMatrixTranslationFromVector(aValues[static_cast<UINT>(eAnimationTrackType::TRANSLATION)]);
+    }
+}
@@ -0,0 +1,135 @@
+/*+===================================================================
+  File:      ANIMATIONSAMPLER.H
+
+  Summary:   AnimationSampler header file contains declarations of the
+             AnimationSampler class that interpolates the tracks of an
+             animation clip four nodes at a time for the lab samples
+             of Game Graphics Programming course.
+
+  Classes: AnimationSampler
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/AnimationClip.h"
+#include "Model/CompressedAnimationClip.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SoaTransform
+
+      Summary:  Local transforms of four consecutive skeleton nodes, one
+                component of all four per vector: translation x, y, z,
+                rotation quaternion x, y, z, w and scale x, y, z
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SoaTransform
+    {
+        XMVECTOR Translation[3];
+        XMVECTOR Rotation[4];
+        XMVECTOR Scale[3];
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationSamplingStatistics
+
+      Summary:  Time of sampling a clip into local matrices one track at
+                a time and four nodes at a time, and the largest
+                difference between the two
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationSamplingStatistics
+    {
+        UINT uNumNodes;
+        UINT uNumKeys;
+        UINT uNumFrames;
+        DOUBLE scalarMicroseconds;
+        DOUBLE soaMicroseconds;
+        FLOAT maxError;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AnimationSampler
+
+      Summary:  Samples every track of an animation clip at a time into
+                a pose of SoaTransforms. The keys around the time are
+                found one track at a time through a cursor per track;
+                the keys of four nodes are then loaded, transposed so
+                each vector holds one component of the four, and
+                interpolated together: translation and scale linearly,
+                rotation with a normalized linear interpolation along
+                the shorter arc. Normalized linear interpolation drifts
+                from a constant angular speed when the two rotations
+                are far apart, so with the slerp fallback on, a lane
+                whose rotations are further apart than
+                SLERP_THRESHOLD is spherically interpolated instead.
+                Local matrices are composed from a pose four at a time.
+                Nothing touches Direct3D, so sampling also runs
+                headless. Compressed clips are sampled the same way,
+                their keys decompressed as they are loaded. A sampler
+                keeps the cursors of one clip playing at a time
+
+      Methods:  Sample
+                  Samples a clip into a pose
+                SetSlerpFallback
+                  Turns the slerp fallback on or off
+                GetNumSoaTransforms
+                  Returns the SoaTransforms a pose of nodes needs
+                ComposeMatrices
+                  Composes the local matrices of a pose
+                MeasureThroughput
+                  Times sampling one track at a time against four
+                  nodes at a time
+                AnimationSampler
+                  Constructor.
+                ~AnimationSampler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AnimationSampler final
+    {
+    public:
+        static constexpr const UINT SOA_WIDTH = 4u;
+        // Cosine of the half angle between two rotation keys below
+        // which the slerp fallback interpolates spherically
+        static constexpr const FLOAT SLERP_THRESHOLD = 0.95f;
+
+        AnimationSampler();
+        AnimationSampler(const AnimationSampler& other) = delete;
+        AnimationSampler(AnimationSampler&& other) = delete;
+        AnimationSampler& operator=(const AnimationSampler& other) = delete;
+        AnimationSampler& operator=(AnimationSampler&& other) = delete;
+        ~AnimationSampler() = default;
+
+        void Sample(_In_ const AnimationClip& clip, _In_ FLOAT time, _Out_writes_(GetNumSoaTransforms(clip.GetNumNodes())) SoaTransform* pOutPose);
+        void Sample(_In_ const CompressedAnimationClip& clip, _In_ FLOAT time, _Out_writes_(GetNumSoaTransforms(clip.GetNumNodes())) SoaTransform* pOutPose);
+        void SetSlerpFallback(_In_ BOOL bSlerpFallback);
+
+        static UINT GetNumSoaTransforms(_In_ UINT uNumNodes);
+        static void ComposeMatrices(_In_ const SoaTransform* pPose, _In_ UINT uNumNodes, _Out_writes_(uNumNodes) XMMATRIX* pOutMatrices);
+
+        AnimationSamplingStatistics MeasureThroughput(_In_ const AnimationClip& clip, _In_ UINT uNumFrames);
+
+    private:
+        template <class Clip>
+        void sample(_In_ const Clip& clip, _In_ FLOAT time, _Out_ SoaTransform* pOutPose);
+        template <class Clip>
+        void loadKeys(
+            _In_ const Clip& clip,
+            _In_ eAnimationTrackType type,
+            _In_ UINT uFirstNode,
+            _In_ FLOAT time,
+            _Out_writes_(SOA_WIDTH) UINT* puOutStartKeys,
+            _Out_writes_(SOA_WIDTH) UINT* puOutEndKeys,
+            _Out_ XMMATRIX& outStart,
+            _Out_ XMMATRIX& outEnd,
+            _Out_ XMVECTOR& outFactors
+        );
+        XMMATRIX sampleNode(_In_ const AnimationClip& clip, _In_ UINT uNode, _In_ FLOAT time);
+
+    private:
+        BOOL m_bSlerpFallback;
+        std::vector<UINT> m_auKeyCursors;
+    };
+}
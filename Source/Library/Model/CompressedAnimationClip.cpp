@@ -0,0 +1,919 @@
+#include "Model/CompressedAnimationClip.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: InterpolateKeys
+
+      Summary:  Interpolates two key values of a kind the way the
+                sampler does: rotations spherically, everything else
+                linearly
+
+      Args:     eAnimationTrackType type
+                  Kind of the keys
+                FXMVECTOR start
+                  Value of the earlier key
+                FXMVECTOR end
+                  Value of the later key
+                FLOAT factor
+                  How far between the keys, from 0 to 1
+
+      Returns:  XMVECTOR
+                  Interpolated value
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMVECTOR InterpolateKeys(_In_ eAnimationTrackType type, _In_ FXMVECTOR start, _In_ FXMVECTOR end, _In_ FLOAT factor)
+    {
+        return type == eAnimationTrackType::ROTATION ? XMQuaternionSlerp(start, end, factor) : XMVectorLerp(start, end, factor);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetKeyError
+
+      Summary:  Returns how far apart two key values of a kind are: the
+                angle between two rotations, or the distance between
+                two translations or scales
+
+      Args:     eAnimationTrackType type
+                  Kind of the keys
+                FXMVECTOR value
+                  One value
+                FXMVECTOR reference
+                  Other value
+
+      Returns:  FLOAT
+                  Radians for rotations, units otherwise
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    FLOAT GetKeyError(_In_ eAnimationTrackType type, _In_ FXMVECTOR value, _In_ FXMVECTOR reference)
+    {
+        if (type == eAnimationTrackType::ROTATION)
+        {
+            const FLOAT dot = std::min<FLOAT>(std::abs(XMVectorGetX(XMVector4Dot(value, reference))), 1.0f);
+            return 2.0f * std::acos(dot);
+        }
+
+        return XMVectorGetX(XMVector3Length(XMVectorSubtract(value, reference)));
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ReduceKeys
+
+      Summary:  Picks the keys of a track to keep. The first and last
+                keys are kept; a run of keys between two kept keys is
+                dropped as long as interpolating those two reproduces
+                every key of the run within the tolerance
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                const FLOAT* aTimes
+                  Key times of the track
+                const XMFLOAT4* aValues
+                  Key values of the track
+                UINT uNumKeys
+                  Number of keys, at least two
+                FLOAT tolerance
+                  Largest error of a dropped key
+
+      Returns:  std::vector<UINT>
+                  Indices of the kept keys in order
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<UINT> ReduceKeys(
+        _In_ eAnimationTrackType type,
+        _In_reads_(uNumKeys) const FLOAT* aTimes,
+        _In_reads_(uNumKeys) const XMFLOAT4* aValues,
+        _In_ UINT uNumKeys,
+        _In_ FLOAT tolerance
+    )
+    {
+        std::vector<UINT> auKeptKeys = { 0u };
+
+        UINT uAnchor = 0u;
+        for (UINT uEnd = 2u; uEnd < uNumKeys; ++uEnd)
+        {
+            const XMVECTOR start = XMLoadFloat4(&aValues[uAnchor]);
+            const XMVECTOR end = XMLoadFloat4(&aValues[uEnd]);
+            const FLOAT span = aTimes[uEnd] - aTimes[uAnchor];
+
+            for (UINT uKey = uAnchor + 1u; uKey < uEnd; ++uKey)
+            {
+                const FLOAT factor = span > 0.0f ? (aTimes[uKey] - aTimes[uAnchor]) / span : 0.0f;
+                if (GetKeyError(type, InterpolateKeys(type, start, end, factor), XMLoadFloat4(&aValues[uKey])) > tolerance)
+                {
+                    uAnchor = uEnd - 1u;
+                    auKeptKeys.push_back(uAnchor);
+                    break;
+                }
+            }
+        }
+        auKeptKeys.push_back(uNumKeys - 1u);
+
+        return auKeptKeys;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::CompressedAnimationClip
+
+      Summary:  Constructor
+
+      Modifies: [m_duration, m_ticksPerSecond, m_uNumNodes,
+                 m_uNumFrames, m_frameInterval, m_aaTracks, m_aaRanges,
+                 m_aaKeyTimes, m_aaKeys, m_aaSoaTracks, m_aaSoaRanges,
+                 m_aaSoaKeys].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CompressedAnimationClip::CompressedAnimationClip()
+        : m_duration(0.0f)
+        , m_ticksPerSecond(25.0f)
+        , m_uNumNodes(0u)
+        , m_uNumFrames(0u)
+        , m_frameInterval(0.0f)
+        , m_aaTracks()
+        , m_aaRanges()
+        , m_aaKeyTimes()
+        , m_aaKeys()
+        , m_aaSoaTracks()
+        , m_aaSoaRanges()
+        , m_aaSoaKeys()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::Create
+
+      Summary:  Compresses every track of an animation clip
+
+      Args:     const AnimationClip& clip
+                  Clip to compress
+                const AnimationCompressionDesc& desc
+                  Tolerances and sample rate
+
+      Modifies: [m_duration, m_ticksPerSecond, m_uNumNodes,
+                 m_uNumFrames, m_frameInterval, m_aaTracks, m_aaRanges,
+                 m_aaKeyTimes, m_aaKeys, m_aaSoaTracks, m_aaSoaRanges,
+                 m_aaSoaKeys].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT CompressedAnimationClip::Create(_In_ const AnimationClip& clip, _In_ const AnimationCompressionDesc& desc)
+    {
+        if (desc.translationTolerance < 0.0f || desc.rotationTolerance < 0.0f || desc.scaleTolerance < 0.0f || desc.sampleRate < 0.0f)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_duration = clip.GetDuration();
+        m_ticksPerSecond = clip.GetTicksPerSecond();
+        m_uNumNodes = clip.GetNumNodes();
+        m_uNumFrames = 0u;
+        m_frameInterval = 0.0f;
+
+        if (desc.sampleRate > 0.0f && m_duration > 0.0f)
+        {
+            const FLOAT numIntervals = std::ceil(m_duration / m_ticksPerSecond * desc.sampleRate);
+            m_uNumFrames = std::max<UINT>(static_cast<UINT>(numIntervals), 1u) + 1u;
+            m_frameInterval = m_duration / static_cast<FLOAT>(m_uNumFrames - 1u);
+        }
+
+        for (UINT uType = 0u; uType < AnimationClip::NUM_TRACK_TYPES; ++uType)
+        {
+            m_aaTracks[uType].clear();
+            m_aaRanges[uType].clear();
+            m_aaKeyTimes[uType].clear();
+            m_aaKeys[uType].clear();
+            m_aaSoaTracks[uType].clear();
+            m_aaSoaRanges[uType].clear();
+            m_aaSoaKeys[uType].clear();
+        }
+
+        const FLOAT afTolerances[AnimationClip::NUM_TRACK_TYPES] =
+        {
+            desc.translationTolerance,
+            desc.rotationTolerance,
+            desc.scaleTolerance,
+        };
+
+        std::vector<FLOAT> aTimes;
+        std::vector<XMFLOAT4> aValues;
+        std::vector<XMFLOAT4> aaLaneValues[NUM_LANES];
+        for (UINT uType = 0u; uType < AnimationClip::NUM_TRACK_TYPES; ++uType)
+        {
+            const eAnimationTrackType type = static_cast<eAnimationTrackType>(uType);
+
+            for (UINT uNode = 0u; uNode < m_uNumNodes; ++uNode)
+            {
+                const AnimationTrack& track = clip.GetTracks(type)[uNode];
+                const FLOAT* aTrackTimes = clip.GetKeyTimes(type) + track.uFirstKey;
+                const XMFLOAT4* aTrackValues = clip.GetKeyValues(type) + track.uFirstKey;
+
+                aTimes.clear();
+                aValues.clear();
+
+                BOOL bConstant = TRUE;
+                for (UINT uKey = 1u; uKey < track.uNumKeys && bConstant; ++uKey)
+                {
+                    bConstant = GetKeyError(type, XMLoadFloat4(&aTrackValues[uKey]), XMLoadFloat4(&aTrackValues[0])) <= afTolerances[uType];
+                }
+
+                if (bConstant)
+                {
+                    aTimes.push_back(0.0f);
+                    aValues.push_back(aTrackValues[0]);
+                }
+                else if (m_uNumFrames > 0u)
+                {
+                    UINT uKeyCursor = 0u;
+                    for (UINT uFrame = 0u; uFrame < m_uNumFrames; ++uFrame)
+                    {
+                        UINT uStartKey;
+                        UINT uEndKey;
+                        FLOAT factor;
+                        clip.FindKeys(type, uNode, static_cast<FLOAT>(uFrame) * m_frameInterval, uKeyCursor, uStartKey, uEndKey, factor);
+
+                        XMFLOAT4 value;
+                        XMStoreFloat4(&value, InterpolateKeys(type, clip.LoadKey(type, uNode, uStartKey), clip.LoadKey(type, uNode, uEndKey), factor));
+                        aValues.push_back(value);
+                    }
+                }
+                else
+                {
+                    for (UINT uKey : ReduceKeys(type, aTrackTimes, aTrackValues, track.uNumKeys, afTolerances[uType]))
+                    {
+                        aTimes.push_back(aTrackTimes[uKey]);
+                        aValues.push_back(aTrackValues[uKey]);
+                    }
+                }
+
+                if (m_uNumFrames == 0u)
+                {
+                    appendTrack(type, aTimes, aValues);
+                    continue;
+                }
+
+                // Lanes past the last node repeat it
+                const UINT uLane = uNode % NUM_LANES;
+                aaLaneValues[uLane] = aValues;
+                if (uLane == NUM_LANES - 1u || uNode == m_uNumNodes - 1u)
+                {
+                    for (UINT i = uLane + 1u; i < NUM_LANES; ++i)
+                    {
+                        aaLaneValues[i] = aValues;
+                    }
+                    appendSoaTrack(type, aaLaneValues);
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::GetDuration
+
+      Summary:  Returns the length of the clip
+
+      Returns:  FLOAT
+                  Length of the clip in ticks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT CompressedAnimationClip::GetDuration() const
+    {
+        return m_duration;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::GetTicksPerSecond
+
+      Summary:  Returns the ticks of the clip per second
+
+      Returns:  FLOAT
+                  Ticks per second
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT CompressedAnimationClip::GetTicksPerSecond() const
+    {
+        return m_ticksPerSecond;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::GetNumNodes
+
+      Summary:  Returns the number of nodes of the skeleton
+
+      Returns:  UINT
+                  Number of nodes, and of tracks of every kind
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT CompressedAnimationClip::GetNumNodes() const
+    {
+        return m_uNumNodes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::GetNumKeys
+
+      Summary:  Returns the number of keys of every track
+
+      Returns:  UINT
+                  Number of keys of all kinds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT CompressedAnimationClip::GetNumKeys() const
+    {
+        size_t uNumKeys = 0u;
+        for (UINT uType = 0u; uType < AnimationClip::NUM_TRACK_TYPES; ++uType)
+        {
+            uNumKeys += m_aaKeys[uType].size();
+
+            // Lanes past the last node hold no key of their own
+            for (size_t uGroup = 0u; uGroup < m_aaSoaTracks[uType].size(); ++uGroup)
+            {
+                const size_t uNumLanes = std::min<size_t>(NUM_LANES, m_uNumNodes - uGroup * NUM_LANES);
+                uNumKeys += m_aaSoaTracks[uType][uGroup].uNumKeys * uNumLanes;
+            }
+        }
+
+        return static_cast<UINT>(uNumKeys);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::GetSizeInBytes
+
+      Summary:  Returns the memory of the tracks and keys
+
+      Returns:  size_t
+                  Bytes of the tracks, ranges, key times and keys of
+                  both layouts
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t CompressedAnimationClip::GetSizeInBytes() const
+    {
+        size_t uSizeInBytes = 0u;
+        for (UINT uType = 0u; uType < AnimationClip::NUM_TRACK_TYPES; ++uType)
+        {
+            uSizeInBytes += m_aaTracks[uType].size() * sizeof(AnimationTrack)
+                + m_aaRanges[uType].size() * sizeof(QuantizationRange)
+                + m_aaKeyTimes[uType].size() * sizeof(WORD)
+                + m_aaKeys[uType].size() * sizeof(PackedKey)
+                + m_aaSoaTracks[uType].size() * sizeof(AnimationTrack)
+                + m_aaSoaRanges[uType].size() * sizeof(SoaQuantizationRange)
+                + m_aaSoaKeys[uType].size() * sizeof(SoaPackedKey);
+        }
+
+        return uSizeInBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::FindKeys
+
+      Summary:  Finds the keys of a track right before and after a
+                time, and how far between them the time is. Resampled
+                tracks index their keys by the time directly, shared
+                with the other nodes of their lanes; others search
+                their key times from the cursor. A track of a single
+                key returns it twice
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                UINT uNode
+                  Node of the track
+                FLOAT time
+                  Time in ticks
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+                UINT& uOutStartKey
+                  Key right before the time
+                UINT& uOutEndKey
+                  Key right after the time
+                FLOAT& outFactor
+                  Interpolation factor, clamped to [0, 1]
+
+      Modifies: [uKeyCursor].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::FindKeys(
+        _In_ eAnimationTrackType type,
+        _In_ UINT uNode,
+        _In_ FLOAT time,
+        _Inout_ UINT& uKeyCursor,
+        _Out_ UINT& uOutStartKey,
+        _Out_ UINT& uOutEndKey,
+        _Out_ FLOAT& outFactor
+    ) const
+    {
+        const AnimationTrack& track = m_uNumFrames > 0u
+            ? m_aaSoaTracks[static_cast<UINT>(type)][uNode / NUM_LANES]
+            : m_aaTracks[static_cast<UINT>(type)][uNode];
+
+        if (track.uNumKeys == 1u)
+        {
+            uOutStartKey = track.uFirstKey;
+            uOutEndKey = track.uFirstKey;
+            outFactor = 0.0f;
+            return;
+        }
+
+        if (m_uNumFrames > 0u)
+        {
+            const FLOAT frame = std::clamp(time / m_frameInterval, 0.0f, static_cast<FLOAT>(m_uNumFrames - 1u));
+            const UINT uKey = std::min<UINT>(static_cast<UINT>(frame), m_uNumFrames - 2u);
+
+            uOutStartKey = track.uFirstKey + uKey;
+            uOutEndKey = uOutStartKey + 1u;
+            outFactor = std::min<FLOAT>(frame - static_cast<FLOAT>(uKey), 1.0f);
+            return;
+        }
+
+        const WORD* aTrackTimes = m_aaKeyTimes[static_cast<UINT>(type)].data() + track.uFirstKey;
+        const FLOAT ticksPerStep = m_duration / MAX_KEY_TIME;
+        const UINT uKey = FindKey(
+            time,
+            track.uNumKeys,
+            [aTrackTimes, ticksPerStep](UINT uIndex)
+            {
+                return static_cast<FLOAT>(aTrackTimes[uIndex]) * ticksPerStep;
+            },
+            uKeyCursor
+        );
+
+        // Keys closer than a step of the quantized times share a time
+        const FLOAT startTime = static_cast<FLOAT>(aTrackTimes[uKey]) * ticksPerStep;
+        const FLOAT span = static_cast<FLOAT>(aTrackTimes[uKey + 1u] - aTrackTimes[uKey]) * ticksPerStep;
+
+        uOutStartKey = track.uFirstKey + uKey;
+        uOutEndKey = uOutStartKey + 1u;
+        outFactor = span > 0.0f ? std::clamp((time - startTime) / span, 0.0f, 1.0f) : 1.0f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::LoadKey
+
+      Summary:  Decompresses the value of a key. The largest component
+                of a rotation is rebuilt from the other three, as the
+                quaternion has unit length. The key of a resampled
+                track is decompressed with the other nodes of its lanes
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                UINT uNode
+                  Node of the track
+                UINT uKey
+                  Key returned by FindKeys
+
+      Returns:  XMVECTOR
+                  Translation or scale with w of zero, or rotation
+                  quaternion
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR CompressedAnimationClip::LoadKey(_In_ eAnimationTrackType type, _In_ UINT uNode, _In_ UINT uKey) const
+    {
+        if (m_uNumFrames > 0u)
+        {
+            XMMATRIX soaKey;
+            loadSoaKey(type, uNode / NUM_LANES, uKey, soaKey);
+            return XMMatrixTranspose(soaKey).r[uNode % NUM_LANES];
+        }
+
+        const PackedKey& key = m_aaKeys[static_cast<UINT>(type)][uKey];
+
+        if (type != eAnimationTrackType::ROTATION)
+        {
+            const QuantizationRange& range = m_aaRanges[static_cast<UINT>(type)][uNode];
+            return XMVectorMultiplyAdd(
+                XMVectorSet(
+                    static_cast<FLOAT>(key.aComponents[0]),
+                    static_cast<FLOAT>(key.aComponents[1]),
+                    static_cast<FLOAT>(key.aComponents[2]),
+                    0.0f
+                ),
+                XMLoadFloat3(&range.Step),
+                XMLoadFloat3(&range.Minimum)
+            );
+        }
+
+        // Smallest components lie within [-1 / sqrt(2), 1 / sqrt(2)]
+        constexpr const FLOAT SCALE = 2.0f / MAX_SMALLEST_COMPONENT * 0.707106781f;
+        constexpr const FLOAT OFFSET = -0.707106781f;
+
+        // Where each component is read from among the largest and the
+        // three smallest, by the index of the largest. A lookup, as the
+        // index of the largest changes from key to key unpredictably
+        static constexpr const UINT SOURCES[4][4] =
+        {
+            { 0u, 1u, 2u, 3u },
+            { 1u, 0u, 2u, 3u },
+            { 1u, 2u, 0u, 3u },
+            { 1u, 2u, 3u, 0u },
+        };
+
+        FLOAT afComponents[4];
+        afComponents[1] = static_cast<FLOAT>(key.aComponents[0] & 0x7FFFu) * SCALE + OFFSET;
+        afComponents[2] = static_cast<FLOAT>(key.aComponents[1] & 0x7FFFu) * SCALE + OFFSET;
+        afComponents[3] = static_cast<FLOAT>(key.aComponents[2] & 0x7FFFu) * SCALE + OFFSET;
+        afComponents[0] = std::sqrt(std::max<FLOAT>(
+            1.0f - afComponents[1] * afComponents[1] - afComponents[2] * afComponents[2] - afComponents[3] * afComponents[3],
+            0.0f
+        ));
+
+        const UINT* auSources = SOURCES[(key.aComponents[0] >> 15u) | ((key.aComponents[1] >> 15u) << 1u)];
+        return XMVectorSet(afComponents[auSources[0]], afComponents[auSources[1]], afComponents[auSources[2]], afComponents[auSources[3]]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::appendTrack
+
+      Summary:  Quantizes the kept keys of the track of the next node
+                of a kind and appends them
+
+      Args:     eAnimationTrackType type
+                  Kind of the track
+                const std::vector<FLOAT>& aTimes
+                  Kept key times, empty if resampled
+                const std::vector<XMFLOAT4>& aValues
+                  Kept key values
+
+      Modifies: [m_aaTracks, m_aaRanges, m_aaKeyTimes, m_aaKeys].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::appendTrack(
+        _In_ eAnimationTrackType type,
+        _In_ const std::vector<FLOAT>& aTimes,
+        _In_ const std::vector<XMFLOAT4>& aValues
+    )
+    {
+        const UINT uType = static_cast<UINT>(type);
+
+        m_aaTracks[uType].push_back(
+            AnimationTrack
+            {
+                .uFirstKey = static_cast<UINT>(m_aaKeys[uType].size()),
+                .uNumKeys = static_cast<UINT>(aValues.size()),
+            }
+        );
+
+        // Resampled keys are found by their index and keep no time
+        if (m_uNumFrames == 0u)
+        {
+            for (FLOAT time : aTimes)
+            {
+                const FLOAT step = m_duration > 0.0f ? std::round(time / m_duration * MAX_KEY_TIME) : 0.0f;
+                m_aaKeyTimes[uType].push_back(static_cast<WORD>(std::clamp(step, 0.0f, MAX_KEY_TIME)));
+            }
+        }
+
+        if (type == eAnimationTrackType::ROTATION)
+        {
+            for (const XMFLOAT4& value : aValues)
+            {
+                PackedKey key;
+                packRotation(value, key.aComponents);
+                m_aaKeys[uType].push_back(key);
+            }
+
+            return;
+        }
+
+        XMVECTOR minimum = XMLoadFloat4(&aValues[0]);
+        XMVECTOR maximum = minimum;
+        for (const XMFLOAT4& value : aValues)
+        {
+            minimum = XMVectorMin(minimum, XMLoadFloat4(&value));
+            maximum = XMVectorMax(maximum, XMLoadFloat4(&value));
+        }
+        const XMVECTOR step = XMVectorScale(XMVectorSubtract(maximum, minimum), 1.0f / MAX_COMPONENT);
+
+        QuantizationRange range;
+        XMStoreFloat3(&range.Minimum, minimum);
+        XMStoreFloat3(&range.Step, step);
+        m_aaRanges[uType].push_back(range);
+
+        for (const XMFLOAT4& value : aValues)
+        {
+            XMFLOAT3 quantized;
+            XMStoreFloat3(&quantized, XMVectorRound(XMVectorDivide(XMVectorSubtract(XMLoadFloat4(&value), minimum), step)));
+
+            const FLOAT afQuantized[3] = { quantized.x, quantized.y, quantized.z };
+            const FLOAT afStep[3] = { range.Step.x, range.Step.y, range.Step.z };
+
+            PackedKey key = {};
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                key.aComponents[i] = afStep[i] > 0.0f ? static_cast<WORD>(std::clamp(afQuantized[i], 0.0f, MAX_COMPONENT)) : 0u;
+            }
+
+            m_aaKeys[uType].push_back(key);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::IsResampled
+
+      Summary:  Returns whether the tracks were resampled at a uniform
+                rate, so LoadSoaKeys can be used
+
+      Returns:  BOOL
+                  TRUE if resampled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL CompressedAnimationClip::IsResampled() const
+    {
+        return m_uNumFrames > 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::LoadSoaKeys
+
+      Summary:  Finds the frames of a resampled clip right before and
+                after a time and decompresses the keys of the tracks of
+                a kind of NUM_LANES consecutive nodes at both, one
+                component of every node per row. The nodes share their
+                keys and interpolation factor
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+                UINT uFirstNode
+                  Node of the first lane, a multiple of NUM_LANES
+                FLOAT time
+                  Time in ticks
+                UINT* puOutStartKeys
+                  Key right before the time of every lane
+                UINT* puOutEndKeys
+                  Key right after the time of every lane
+                XMMATRIX& outStart
+                  Components of the keys right before the time
+                XMMATRIX& outEnd
+                  Components of the keys right after the time
+                XMVECTOR& outFactors
+                  Interpolation factor of every lane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::LoadSoaKeys(
+        _In_ eAnimationTrackType type,
+        _In_ UINT uFirstNode,
+        _In_ FLOAT time,
+        _Out_writes_(NUM_LANES) UINT* puOutStartKeys,
+        _Out_writes_(NUM_LANES) UINT* puOutEndKeys,
+        _Out_ XMMATRIX& outStart,
+        _Out_ XMMATRIX& outEnd,
+        _Out_ XMVECTOR& outFactors
+    ) const
+    {
+        assert(m_uNumFrames > 0u && uFirstNode % NUM_LANES == 0u);
+
+        const UINT uGroup = uFirstNode / NUM_LANES;
+        const AnimationTrack& track = m_aaSoaTracks[static_cast<UINT>(type)][uGroup];
+
+        UINT uStartKey = track.uFirstKey;
+        UINT uEndKey = track.uFirstKey;
+        FLOAT factor = 0.0f;
+        if (track.uNumKeys > 1u)
+        {
+            const FLOAT frame = std::clamp(time / m_frameInterval, 0.0f, static_cast<FLOAT>(m_uNumFrames - 1u));
+            const UINT uFrame = std::min<UINT>(static_cast<UINT>(frame), m_uNumFrames - 2u);
+
+            uStartKey += uFrame;
+            uEndKey = uStartKey + 1u;
+            factor = std::min<FLOAT>(frame - static_cast<FLOAT>(uFrame), 1.0f);
+        }
+
+        for (UINT uLane = 0u; uLane < NUM_LANES; ++uLane)
+        {
+            puOutStartKeys[uLane] = uStartKey;
+            puOutEndKeys[uLane] = uEndKey;
+        }
+
+        loadSoaKey(type, uGroup, uStartKey, outStart);
+        if (uEndKey == uStartKey)
+        {
+            outEnd = outStart;
+        }
+        else
+        {
+            loadSoaKey(type, uGroup, uEndKey, outEnd);
+        }
+        outFactors = XMVectorReplicate(factor);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::packRotation
+
+      Summary:  Quantizes the three smallest components of a rotation
+                and the index of its largest
+
+      Args:     const XMFLOAT4& rotation
+                  Rotation quaternion
+                WORD* pOutComponents
+                  Three smallest components in 15 bits each, the index
+                  of the largest in the top bits of the first two
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::packRotation(_In_ const XMFLOAT4& rotation, _Out_writes_(3) WORD* pOutComponents)
+    {
+        const FLOAT afRotation[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+        UINT uLargest = 0u;
+        for (UINT i = 1u; i < 4u; ++i)
+        {
+            if (std::abs(afRotation[i]) > std::abs(afRotation[uLargest]))
+            {
+                uLargest = i;
+            }
+        }
+
+        // q and -q are the same rotation, so the largest is made
+        // positive and only its index is kept
+        const FLOAT sign = afRotation[uLargest] < 0.0f ? -1.0f : 1.0f;
+        const FLOAT length = std::sqrt(afRotation[0] * afRotation[0] + afRotation[1] * afRotation[1]
+            + afRotation[2] * afRotation[2] + afRotation[3] * afRotation[3]);
+
+        for (UINT i = 0u, uSmallest = 0u; i < 4u; ++i)
+        {
+            if (i == uLargest)
+            {
+                continue;
+            }
+
+            const FLOAT component = sign * afRotation[i] / length;
+            const FLOAT quantized = std::round((component * 1.414213562f * 0.5f + 0.5f) * MAX_SMALLEST_COMPONENT);
+            pOutComponents[uSmallest++] = static_cast<WORD>(std::clamp(quantized, 0.0f, MAX_SMALLEST_COMPONENT));
+        }
+        pOutComponents[0] |= static_cast<WORD>((uLargest & 1u) << 15u);
+        pOutComponents[1] |= static_cast<WORD>((uLargest >> 1u) << 15u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::appendSoaTrack
+
+      Summary:  Quantizes the resampled tracks of a kind of the next
+                NUM_LANES nodes and appends them as one. A single key
+                is kept if no lane moves
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+                const std::vector<XMFLOAT4>* paValues
+                  Values of every lane, a single one or one per frame
+
+      Modifies: [m_aaSoaTracks, m_aaSoaRanges, m_aaSoaKeys].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::appendSoaTrack(_In_ eAnimationTrackType type, _In_reads_(NUM_LANES) const std::vector<XMFLOAT4>* paValues)
+    {
+        const UINT uType = static_cast<UINT>(type);
+
+        UINT uNumKeys = 1u;
+        for (UINT uLane = 0u; uLane < NUM_LANES; ++uLane)
+        {
+            uNumKeys = std::max<UINT>(uNumKeys, static_cast<UINT>(paValues[uLane].size()));
+        }
+
+        m_aaSoaTracks[uType].push_back(
+            AnimationTrack
+            {
+                .uFirstKey = static_cast<UINT>(m_aaSoaKeys[uType].size()),
+                .uNumKeys = uNumKeys,
+            }
+        );
+
+        // A lane that does not move repeats its single value
+        auto getValue = [paValues](UINT uLane, UINT uKey) -> const XMFLOAT4&
+        {
+            return paValues[uLane].size() > 1u ? paValues[uLane][uKey] : paValues[uLane][0];
+        };
+
+        WORD aaComponents[3][NUM_LANES];
+        if (type == eAnimationTrackType::ROTATION)
+        {
+            for (UINT uKey = 0u; uKey < uNumKeys; ++uKey)
+            {
+                for (UINT uLane = 0u; uLane < NUM_LANES; ++uLane)
+                {
+                    WORD aComponents[3];
+                    packRotation(getValue(uLane, uKey), aComponents);
+                    for (UINT i = 0u; i < 3u; ++i)
+                    {
+                        aaComponents[i][uLane] = aComponents[i];
+                    }
+                }
+
+                SoaPackedKey key;
+                for (UINT i = 0u; i < 3u; ++i)
+                {
+                    key.aComponents[i] = PackedVector::XMUSHORT4(aaComponents[i][0], aaComponents[i][1], aaComponents[i][2], aaComponents[i][3]);
+                }
+                m_aaSoaKeys[uType].push_back(key);
+            }
+
+            return;
+        }
+
+        FLOAT aafMinimum[3][NUM_LANES];
+        FLOAT aafStep[3][NUM_LANES];
+        for (UINT uLane = 0u; uLane < NUM_LANES; ++uLane)
+        {
+            XMVECTOR minimum = XMLoadFloat4(&paValues[uLane][0]);
+            XMVECTOR maximum = minimum;
+            for (const XMFLOAT4& value : paValues[uLane])
+            {
+                minimum = XMVectorMin(minimum, XMLoadFloat4(&value));
+                maximum = XMVectorMax(maximum, XMLoadFloat4(&value));
+            }
+            const XMVECTOR step = XMVectorScale(XMVectorSubtract(maximum, minimum), 1.0f / MAX_COMPONENT);
+
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                aafMinimum[i][uLane] = XMVectorGetByIndex(minimum, i);
+                aafStep[i][uLane] = XMVectorGetByIndex(step, i);
+            }
+        }
+
+        SoaQuantizationRange range;
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            range.aMinimum[i] = XMFLOAT4A(aafMinimum[i]);
+            range.aStep[i] = XMFLOAT4A(aafStep[i]);
+        }
+        m_aaSoaRanges[uType].push_back(range);
+
+        for (UINT uKey = 0u; uKey < uNumKeys; ++uKey)
+        {
+            for (UINT uLane = 0u; uLane < NUM_LANES; ++uLane)
+            {
+                const XMFLOAT4& value = getValue(uLane, uKey);
+                const FLOAT afValue[3] = { value.x, value.y, value.z };
+                for (UINT i = 0u; i < 3u; ++i)
+                {
+                    const FLOAT quantized = aafStep[i][uLane] > 0.0f ? std::round((afValue[i] - aafMinimum[i][uLane]) / aafStep[i][uLane]) : 0.0f;
+                    aaComponents[i][uLane] = static_cast<WORD>(std::clamp(quantized, 0.0f, MAX_COMPONENT));
+                }
+            }
+
+            SoaPackedKey key;
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                key.aComponents[i] = PackedVector::XMUSHORT4(aaComponents[i][0], aaComponents[i][1], aaComponents[i][2], aaComponents[i][3]);
+            }
+            m_aaSoaKeys[uType].push_back(key);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CompressedAnimationClip::loadSoaKey
+
+      Summary:  Decompresses a key of the resampled tracks of a kind of
+                NUM_LANES nodes, one component of every node per row.
+                A rotation is rebuilt in every lane at once: the
+                largest component from the other three, then each
+                component picked by the index of the largest of its
+                lane
+
+      Args:     eAnimationTrackType type
+                  Kind of the tracks
+                UINT uGroup
+                  Index of the first node over NUM_LANES
+                UINT uKey
+                  Key of the tracks
+                XMMATRIX& outKey
+                  Components of the key, the last row zero for a
+                  translation or scale
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CompressedAnimationClip::loadSoaKey(_In_ eAnimationTrackType type, _In_ UINT uGroup, _In_ UINT uKey, _Out_ XMMATRIX& outKey) const
+    {
+        const SoaPackedKey& key = m_aaSoaKeys[static_cast<UINT>(type)][uKey];
+
+        if (type != eAnimationTrackType::ROTATION)
+        {
+            const SoaQuantizationRange& range = m_aaSoaRanges[static_cast<UINT>(type)][uGroup];
+            for (UINT i = 0u; i < 3u; ++i)
+            {
+                outKey.r[i] = XMVectorMultiplyAdd(PackedVector::XMLoadUShort4(&key.aComponents[i]), XMLoadFloat4A(&range.aStep[i]), XMLoadFloat4A(&range.aMinimum[i]));
+            }
+            outKey.r[3] = XMVectorZero();
+            return;
+        }
+
+        // Smallest components lie within [-1 / sqrt(2), 1 / sqrt(2)]
+        const XMVECTOR scale = XMVectorReplicate(2.0f / MAX_SMALLEST_COMPONENT * 0.707106781f);
+        const XMVECTOR offset = XMVectorReplicate(-0.707106781f);
+        const XMVECTOR topBit = XMVectorReplicate(32768.0f);
+
+        // The top bits of the first two rows hold the index of the
+        // largest component
+        XMVECTOR aSmallest[3];
+        XMVECTOR aIndexBits[2];
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            XMVECTOR components = PackedVector::XMLoadUShort4(&key.aComponents[i]);
+            if (i < 2u)
+            {
+                aIndexBits[i] = XMVectorGreaterOrEqual(components, topBit);
+                components = XMVectorSubtract(components, XMVectorAndInt(aIndexBits[i], topBit));
+            }
+            aSmallest[i] = XMVectorMultiplyAdd(components, scale, offset);
+        }
+
+        XMVECTOR lengthSquared = XMVectorMultiply(aSmallest[0], aSmallest[0]);
+        lengthSquared = XMVectorMultiplyAdd(aSmallest[1], aSmallest[1], lengthSquared);
+        lengthSquared = XMVectorMultiplyAdd(aSmallest[2], aSmallest[2], lengthSquared);
+        const XMVECTOR largest = XMVectorSqrt(XMVectorMax(XMVectorSubtract(g_XMOne, lengthSquared), XMVectorZero()));
+
+        // Components before the largest come from the smallest of the
+        // same position, those after it from the one before
+        const XMVECTOR isLargest0 = XMVectorNorInt(aIndexBits[0], aIndexBits[1]);
+        const XMVECTOR isLargest1 = XMVectorAndCInt(aIndexBits[0], aIndexBits[1]);
+        const XMVECTOR isLargest2 = XMVectorAndCInt(aIndexBits[1], aIndexBits[0]);
+        const XMVECTOR isLargest3 = XMVectorAndInt(aIndexBits[0], aIndexBits[1]);
+        outKey.r[0] = XMVectorSelect(aSmallest[0], largest, isLargest0);
+        outKey.r[1] = XMVectorSelect(XMVectorSelect(aSmallest[0], aSmallest[1], aIndexBits[1]), largest, isLargest1);
+        outKey.r[2] = XMVectorSelect(XMVectorSelect(aSmallest[1], aSmallest[2], isLargest3), largest, isLargest2);
+        outKey.r[3] = XMVectorSelect(aSmallest[2], largest, isLargest3);
+    }
+}
@@ -0,0 +1,202 @@
+/*+===================================================================
+  File:      COMPRESSEDANIMATIONCLIP.H
+
+  Summary:   CompressedAnimationClip header file contains declarations
+             of the CompressedAnimationClip class that keeps the keys
+             of an animation clip reduced and quantized for the lab
+             samples of Game Graphics Programming course.
+
+  Classes: CompressedAnimationClip
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <DirectXPackedVector.h>
+
+#include "Model/AnimationClip.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationCompressionDesc
+
+      Summary:  How far a compressed track may stray from the keys of
+                its source track: in model units for translation,
+                radians for rotation and a factor for scale. A sample
+                rate above zero, in samples per second, resamples every
+                moving track at that uniform rate instead of removing
+                keys, so a key is found by its index
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationCompressionDesc
+    {
+        FLOAT translationTolerance;
+        FLOAT rotationTolerance;
+        FLOAT scaleTolerance;
+        FLOAT sampleRate;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CompressedAnimationClip
+
+      Summary:  Animation clip compressed at import time. A track
+                whose keys all lie within the tolerance of its first
+                key keeps only that key. With a sample rate, the other
+                tracks are resampled at that rate, and the tracks of
+                NUM_LANES consecutive nodes are stored together, one
+                row per component holding all the nodes, so a frame is
+                found by its index and decompressed straight into the
+                lanes of the sampler. Without one, a key is removed
+                when interpolating the keys kept around it reproduces
+                it within the tolerance, and key times are stored as
+                16-bit fractions of the duration. A rotation keeps the
+                three smallest components of its quaternion, made
+                positive on the largest, in 15 bits each and the index
+                of the largest in the remaining two bits of the 48. A
+                translation or a scale keeps 16 bits per component
+                over the range of its track. Sampling decompresses only
+                the keys around the time
+
+      Methods:  Create
+                  Compresses an animation clip
+                GetDuration
+                  Returns the length of the clip in ticks
+                GetTicksPerSecond
+                  Returns the ticks of the clip per second
+                GetNumNodes
+                  Returns the number of nodes of the skeleton
+                GetNumKeys
+                  Returns the number of keys of every track
+                GetSizeInBytes
+                  Returns the memory of the tracks and keys
+                FindKeys
+                  Finds the keys of a track around a time
+                LoadKey
+                  Returns the decompressed value of a key
+                IsResampled
+                  Returns whether the tracks were resampled
+                LoadSoaKeys
+                  Decompresses the keys of NUM_LANES nodes around a
+                  time of a resampled clip
+                CompressedAnimationClip
+                  Constructor.
+                ~CompressedAnimationClip
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CompressedAnimationClip final
+    {
+    public:
+        // Nodes whose resampled tracks are stored together, as many as
+        // the lanes of the sampler
+        static constexpr const UINT NUM_LANES = 4u;
+
+        static constexpr const AnimationCompressionDesc DEFAULT_COMPRESSION_DESC =
+        {
+            .translationTolerance = 1.0e-3f,
+            .rotationTolerance = 1.0e-3f,
+            .scaleTolerance = 1.0e-3f,
+            .sampleRate = 30.0f,
+        };
+
+        CompressedAnimationClip();
+        CompressedAnimationClip(const CompressedAnimationClip& other) = delete;
+        CompressedAnimationClip(CompressedAnimationClip&& other) = delete;
+        CompressedAnimationClip& operator=(const CompressedAnimationClip& other) = delete;
+        CompressedAnimationClip& operator=(CompressedAnimationClip&& other) = delete;
+        ~CompressedAnimationClip() = default;
+
+        HRESULT Create(_In_ const AnimationClip& clip, _In_ const AnimationCompressionDesc& desc);
+
+        FLOAT GetDuration() const;
+        FLOAT GetTicksPerSecond() const;
+        UINT GetNumNodes() const;
+        UINT GetNumKeys() const;
+        size_t GetSizeInBytes() const;
+
+        void FindKeys(
+            _In_ eAnimationTrackType type,
+            _In_ UINT uNode,
+            _In_ FLOAT time,
+            _Inout_ UINT& uKeyCursor,
+            _Out_ UINT& uOutStartKey,
+            _Out_ UINT& uOutEndKey,
+            _Out_ FLOAT& outFactor
+        ) const;
+        XMVECTOR LoadKey(_In_ eAnimationTrackType type, _In_ UINT uNode, _In_ UINT uKey) const;
+
+        BOOL IsResampled() const;
+        void LoadSoaKeys(
+            _In_ eAnimationTrackType type,
+            _In_ UINT uFirstNode,
+            _In_ FLOAT time,
+            _Out_writes_(NUM_LANES) UINT* puOutStartKeys,
+            _Out_writes_(NUM_LANES) UINT* puOutEndKeys,
+            _Out_ XMMATRIX& outStart,
+            _Out_ XMMATRIX& outEnd,
+            _Out_ XMVECTOR& outFactors
+        ) const;
+
+    private:
+        static constexpr const FLOAT MAX_KEY_TIME = 65535.0f;
+        static constexpr const FLOAT MAX_COMPONENT = 65535.0f;
+        // Even, so that zero has a code of its own
+        static constexpr const FLOAT MAX_SMALLEST_COMPONENT = 32766.0f;
+
+        struct PackedKey
+        {
+            WORD aComponents[3];
+        };
+
+        // Value of a translation or scale component is minimum plus
+        // step times its quantized value
+        struct QuantizationRange
+        {
+            XMFLOAT3 Minimum;
+            XMFLOAT3 Step;
+        };
+
+        // Keys of NUM_LANES consecutive nodes at one frame, one row of
+        // quantized values per component
+        struct SoaPackedKey
+        {
+            PackedVector::XMUSHORT4 aComponents[3];
+        };
+
+        // Quantization ranges of NUM_LANES consecutive nodes, one row
+        // per component
+        struct SoaQuantizationRange
+        {
+            XMFLOAT4A aMinimum[3];
+            XMFLOAT4A aStep[3];
+        };
+
+        void appendTrack(
+            _In_ eAnimationTrackType type,
+            _In_ const std::vector<FLOAT>& aTimes,
+            _In_ const std::vector<XMFLOAT4>& aValues
+        );
+        static void packRotation(_In_ const XMFLOAT4& rotation, _Out_writes_(3) WORD* pOutComponents);
+        void appendSoaTrack(_In_ eAnimationTrackType type, _In_reads_(NUM_LANES) const std::vector<XMFLOAT4>* paValues);
+        void loadSoaKey(_In_ eAnimationTrackType type, _In_ UINT uGroup, _In_ UINT uKey, _Out_ XMMATRIX& outKey) const;
+
+    private:
+        FLOAT m_duration;
+        FLOAT m_ticksPerSecond;
+        UINT m_uNumNodes;
+        // Uniform frames every track that moves has, zero if the key
+        // times are kept
+        UINT m_uNumFrames;
+        FLOAT m_frameInterval;
+        std::vector<AnimationTrack> m_aaTracks[AnimationClip::NUM_TRACK_TYPES];
+        std::vector<QuantizationRange> m_aaRanges[AnimationClip::NUM_TRACK_TYPES];
+        std::vector<WORD> m_aaKeyTimes[AnimationClip::NUM_TRACK_TYPES];
+        std::vector<PackedKey> m_aaKeys[AnimationClip::NUM_TRACK_TYPES];
+        // Resampled tracks of every NUM_LANES nodes, either a single
+        // key or a key per frame
+        std::vector<AnimationTrack> m_aaSoaTracks[AnimationClip::NUM_TRACK_TYPES];
+        std::vector<SoaQuantizationRange> m_aaSoaRanges[AnimationClip::NUM_TRACK_TYPES];
+        std::vector<SoaPackedKey> m_aaSoaKeys[AnimationClip::NUM_TRACK_TYPES];
+    };
+}
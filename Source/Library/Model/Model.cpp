@@ -1,5 +1,9 @@
 #include "Model/Model.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "assimp/Importer.hpp"	// C++ importer interface
 #include "assimp/scene.h"		    // output data structure
 #include "assimp/postprocess.h"	// post processing flags
@@ -61,6 +65,23 @@ namespace library
         return XMLoadFloat4(&float4);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CreateAnimationSampler
+
+      Summary:  Creates a sampler for the clips of a model. Imported
+                keys may be far apart, and were interpolated spherically
+                before they were sampled four nodes at a time, so the
+                slerp fallback is on
+
+      Returns:  std::unique_ptr<AnimationSampler>
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::unique_ptr<AnimationSampler> CreateAnimationSampler()
+    {
+        auto pSampler = std::make_unique<AnimationSampler>();
+        pSampler->SetSlerpFallback(TRUE);
+        return pSampler;
+    }
+
     std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -74,8 +95,15 @@ namespace library
       Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
                  m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
                  m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
-                 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+                 m_aBoneInfo, m_aTransforms, m_aBoneBoundingBoxes,
+                 m_boneNameToIndexMap,
+                 m_aSkeletonNodes, m_nodeNameToIndexMap,
+                 m_aLocalTransforms, m_aGlobalTransforms,
+                 m_apAnimationClips, m_apCompressedAnimationClips,
+                 m_clipNameToIndexMap, m_aAnimationLayers, m_aBindPose,
+                 m_aPose, m_aLayerPose, m_aFadePose, m_pScene,
+                 m_timeSinceLoaded,
+                 m_globalInverseTransform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Model::Model(_In_ const std::filesystem::path& filePath)
         : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
@@ -88,7 +116,20 @@ namespace library
         , m_aBoneData()
         , m_aBoneInfo()
         , m_aTransforms()
+        , m_aBoneBoundingBoxes()
         , m_boneNameToIndexMap()
+        , m_aSkeletonNodes()
+        , m_nodeNameToIndexMap()
+        , m_aLocalTransforms()
+        , m_aGlobalTransforms()
+        , m_apAnimationClips()
+        , m_apCompressedAnimationClips()
+        , m_clipNameToIndexMap()
+        , m_aAnimationLayers()
+        , m_aBindPose()
+        , m_aPose()
+        , m_aLayerPose()
+        , m_aFadePose()
         , m_pScene()
         , m_timeSinceLoaded(0)
         , m_globalInverseTransform()
@@ -105,39 +146,18 @@ namespace library
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
-                 m_skinningConstantBuffer].
+      Modifies: [m_animationBuffer, m_skinningConstantBuffer].
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Model::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     { //
-        HRESULT hr = S_OK;
+        HRESULT hr = Load();
+        if (FAILED(hr)) return hr;
 
         // Create the buffers for the vertices attributes
-
-        m_pScene = sm_pImporter->ReadFile(
-            m_filePath.string().c_str(),
-            ASSIMP_LOAD_FLAGS
-            );
-
-        if (m_pScene)
-        {
-            m_globalInverseTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
-            m_globalInverseTransform = XMMatrixInverse(nullptr, m_globalInverseTransform);
-            hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
-        }
-        else
-        {
-            hr = E_FAIL;
-            OutputDebugString(L"Error parsing ");
-            OutputDebugString(m_filePath.c_str());
-            OutputDebugString(L": ");
-            OutputDebugStringA(sm_pImporter->GetErrorString());
-            OutputDebugString(L"\n");
-        }
-
+        hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
         if (FAILED(hr)) return hr;
 
         D3D11_BUFFER_DESC bd =
@@ -175,27 +195,34 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Update
 
-      Summary:  Update bone transformations
+      Summary:  Advances every animation layer and its fade, and
+                updates bone transformations
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
 
-      Modifies: [m_aTransforms].
+      Modifies: [m_timeSinceLoaded, m_aAnimationLayers, m_aTransforms].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::Update(_In_ FLOAT deltaTime)
     {
         m_timeSinceLoaded += deltaTime;
-        if (m_pScene->HasAnimations()) {
-            XMMATRIX identity = XMMatrixIdentity();
-            FLOAT ticksPerSecond =
-                static_cast<FLOAT>(m_pScene->mAnimations[0]->mTicksPerSecond != 0.0f
-                    ? m_pScene->mAnimations[0]->mTicksPerSecond : 25.0f);
-            FLOAT timeInTicks = m_timeSinceLoaded * ticksPerSecond;
-            FLOAT animationTimeTicks = fmod(timeInTicks,
-                static_cast<FLOAT>(m_pScene->mAnimations[0]->mDuration));
+        if (!m_apCompressedAnimationClips.empty()) {
+            for (AnimationLayer& layer : m_aAnimationLayers)
+            {
+                layer.time = advanceTime(layer.uClip, layer.time, deltaTime);
+                if (layer.iFadingClip >= 0)
+                {
+                    layer.fadingTime = advanceTime(static_cast<UINT>(layer.iFadingClip), layer.fadingTime, deltaTime);
+                    layer.fadeElapsedSeconds += deltaTime;
+                    if (layer.fadeElapsedSeconds >= layer.fadeSeconds)
+                    {
+                        layer.iFadingClip = -1;
+                    }
+                }
+            }
 
             if (m_pScene->mRootNode) {
-                readNodeHierarchy(animationTimeTicks, m_pScene->mRootNode, identity);
+                evaluateLayers();
                 m_aTransforms.resize(m_aBoneInfo.size());
                 for (UINT i = 0u; i < m_aTransforms.size(); i++) {
                     m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
@@ -205,110 +232,1087 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetAnimationBuffer
-
-      Summary:  Returns the animation buffer
+      Method:   Model::Load
+
+      Summary:  Reads the model file with the default compression of
+                the animation, releasing its source
+
+      Modifies: [m_pScene, m_globalInverseTransform, m_aMeshes,
+                 m_aVertices, m_aIndices, m_aBoneData, m_aBoneInfo,
+                 m_aBoneBoundingBoxes, m_boneNameToIndexMap,
+                 m_aSkeletonNodes,
+                 m_nodeNameToIndexMap, m_aLocalTransforms,
+                 m_aGlobalTransforms, m_apAnimationClips,
+                 m_apCompressedAnimationClips, m_clipNameToIndexMap,
+                 m_aAnimationLayers, m_aBindPose, m_aPose, m_aLayerPose,
+                 m_aFadePose].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Load()
+    {
+        return Load(CompressedAnimationClip::DEFAULT_COMPRESSION_DESC, FALSE);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::Load
+
+      Summary:  Reads the model file into the vertices, indices, bones
+                and flattened skeleton of the model without creating
+                any Direct3D resource, so the animation can also be
+                evaluated headless. Does nothing once loaded
+
+      Args:     const AnimationCompressionDesc& desc
+                  Tolerances and sample rate of the compressed clips
+                BOOL bKeepSourceAnimation
+                  Whether the source clips and the keys of the Assimp
+                  animations are kept to measure against, instead of
+                  released once compressed
+
+      Modifies: [m_pScene, m_globalInverseTransform, m_aMeshes,
+                 m_aVertices, m_aIndices, m_aBoneData, m_aBoneInfo,
+                 m_aBoneBoundingBoxes, m_boneNameToIndexMap,
+                 m_aSkeletonNodes,
+                 m_nodeNameToIndexMap, m_aLocalTransforms,
+                 m_aGlobalTransforms, m_apAnimationClips,
+                 m_apCompressedAnimationClips, m_clipNameToIndexMap,
+                 m_aAnimationLayers, m_aBindPose, m_aPose, m_aLayerPose,
+                 m_aFadePose].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Load(_In_ const AnimationCompressionDesc& desc, _In_ BOOL bKeepSourceAnimation)
+    {
+        if (m_pScene)
+        {
+            return S_OK;
+        }
+
+        m_pScene = sm_pImporter->ReadFile(
+            m_filePath.string().c_str(),
+            ASSIMP_LOAD_FLAGS
+            );
+
+        if (!m_pScene)
+        {
+            OutputDebugString(L"Error parsing ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L": ");
+            OutputDebugStringA(sm_pImporter->GetErrorString());
+            OutputDebugString(L"\n");
+            return E_FAIL;
+        }
+
+        m_globalInverseTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
+        m_globalInverseTransform = XMMatrixInverse(nullptr, m_globalInverseTransform);
+
+        m_aMeshes.resize(m_pScene->mNumMeshes);
+
+        UINT numVertices = 0u;
+        UINT numIndices = 0u;
+        countVerticesAndIndices(numVertices, numIndices, m_pScene);
+        reserveSpace(numVertices, numIndices);
+        initAllMeshes(m_pScene);
+        initBoneBoundingBoxes();
+
+        HRESULT hr = initSkeleton(m_pScene, desc);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (!bKeepSourceAnimation)
+        {
+            releaseSourceAnimation();
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetAnimationBuffer
+
+      Summary:  Returns the animation buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetAnimationBuffer()
+    {
+        return m_animationBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetSkinningConstantBuffer
+
+      Summary:  Returns the skinning constant buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetSkinningConstantBuffer()
+    {
+        return m_skinningConstantBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumVertices
+
+      Summary:  Returns the number of vertices
+
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_aVertices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumIndices
+
+      Summary:  Returns the number of indices
+
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::GetBoneTransforms
+
+       Summary:  Returns the vector containing bone transforms
+
+       Returns:  std::vector<XMMATRIX>&
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<XMMATRIX>& Model::GetBoneTransforms()
+    {
+        return m_aTransforms;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetSkinnedBoundingBox
+
+      Summary:  Returns the bounds of the vertices as the skinning
+                shader places them with the current bone transforms.
+                A skinned vertex is a weighted average of its position
+                moved by each of its bones, so it stays inside the
+                union of the bind pose bounds of every bone moved by
+                that bone. Falls back to the bind pose bounds until
+                the bones are first posed, or if no bone weighs any
+                vertex
+
+      Returns:  BoundingBox
+                  World space bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox Model::GetSkinnedBoundingBox() const
+    {
+        if (m_aBoneBoundingBoxes.empty() || m_aTransforms.size() != m_aBoneBoundingBoxes.size())
+        {
+            return GetBoundingBox();
+        }
+
+        XMVECTOR minCorner = XMVectorReplicate(std::numeric_limits<FLOAT>::infinity());
+        XMVECTOR maxCorner = XMVectorReplicate(-std::numeric_limits<FLOAT>::infinity());
+        BOOL bHasSkinnedVertices = FALSE;
+        for (size_t i = 0u; i < m_aBoneBoundingBoxes.size(); ++i)
+        {
+            // Bones weighing no vertex are left with negative extents
+            if (m_aBoneBoundingBoxes[i].Extents.x < 0.0f)
+            {
+                continue;
+            }
+
+            BoundingBox boneBoundingBox;
+            m_aBoneBoundingBoxes[i].Transform(boneBoundingBox, m_aTransforms[i] * m_world);
+
+            const XMVECTOR center = XMLoadFloat3(&boneBoundingBox.Center);
+            const XMVECTOR extents = XMLoadFloat3(&boneBoundingBox.Extents);
+            minCorner = XMVectorMin(minCorner, XMVectorSubtract(center, extents));
+            maxCorner = XMVectorMax(maxCorner, XMVectorAdd(center, extents));
+            bHasSkinnedVertices = TRUE;
+        }
+
+        if (!bHasSkinnedVertices)
+        {
+            return GetBoundingBox();
+        }
+
+        BoundingBox boundingBox;
+        BoundingBox::CreateFromPoints(boundingBox, minCorner, maxCorner);
+        return boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetBoneNameToIndexMap
+
+        Summary:  Returns the bone name to index map
+
+        Returns:  std::unordered_map<std::string, UINT>&
+
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
+    {
+        return m_boneNameToIndexMap;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumAnimationClips
+
+      Summary:  Returns the number of registered clips
+
+      Returns:  UINT
+                  Number of animations of the model file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumAnimationClips() const
+    {
+        return static_cast<UINT>(m_apCompressedAnimationClips.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetAnimationClipIndex
+
+      Summary:  Returns the index of a clip by the name of its
+                animation
+
+      Args:     PCSTR pszClipName
+                  Name of the animation
+
+      Returns:  INT
+                  Index of the clip, -1 if no clip has the name
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    INT Model::GetAnimationClipIndex(_In_ PCSTR pszClipName) const
+    {
+        auto clip = m_clipNameToIndexMap.find(pszClipName);
+        return clip == m_clipNameToIndexMap.end() ? -1 : static_cast<INT>(clip->second);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetAnimationClip
+
+      Summary:  Returns the source clip of a registered clip, kept
+                only when loaded to measure against
+
+      Args:     UINT uClip
+                  Index of the clip, below GetNumAnimationClips
+
+      Returns:  const AnimationClip*
+                  Clip over the flattened skeleton, nullptr if
+                  released
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const AnimationClip* Model::GetAnimationClip(_In_ UINT uClip) const
+    {
+        return uClip < m_apAnimationClips.size() ? m_apAnimationClips[uClip].get() : nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetCompressedAnimationClip
+
+      Summary:  Returns the compressed clip of a registered clip
+
+      Args:     UINT uClip
+                  Index of the clip, below GetNumAnimationClips
+
+      Returns:  const CompressedAnimationClip&
+                  Compressed copy of the clip
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CompressedAnimationClip& Model::GetCompressedAnimationClip(_In_ UINT uClip) const
+    {
+        return *m_apCompressedAnimationClips[uClip];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::CompressAnimation
+
+      Summary:  Compresses every registered clip again with other
+                tolerances or sample rate. Needs the source clips,
+                so the model must have been loaded keeping them
+
+      Args:     const AnimationCompressionDesc& desc
+                  Tolerances and sample rate
+
+      Modifies: [m_apCompressedAnimationClips].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::CompressAnimation(_In_ const AnimationCompressionDesc& desc)
+    {
+        if (m_apAnimationClips.size() != m_apCompressedAnimationClips.size())
+        {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_STATE);
+        }
+
+        for (size_t i = 0u; i < m_apAnimationClips.size(); ++i)
+        {
+            HRESULT hr = m_apCompressedAnimationClips[i]->Create(*m_apAnimationClips[i], desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::PlayAnimation
+
+      Summary:  Cross-fades a layer to a clip, played from its start.
+                The clip the layer played fades out over the given
+                time while it keeps playing; a fade already under way
+                is cut short, and the fading clip takes the sampler of
+                the layer along with it. An additive layer switches at
+                once, as its clips add differences from different
+                references
+
+      Args:     UINT uLayer
+                  Index of the layer, 0 for the first
+                UINT uClip
+                  Index of the clip to play
+                FLOAT fadeSeconds
+                  Length of the cross-fade, 0 to switch at once
+
+      Modifies: [m_aAnimationLayers].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::PlayAnimation(_In_ UINT uLayer, _In_ UINT uClip, _In_ FLOAT fadeSeconds)
+    {
+        if (uLayer >= m_aAnimationLayers.size() || uClip >= m_apCompressedAnimationClips.size() || fadeSeconds < 0.0f)
+        {
+            return E_INVALIDARG;
+        }
+
+        AnimationLayer& layer = m_aAnimationLayers[uLayer];
+        if (layer.BlendMode == eAnimationBlendMode::OVERRIDE && fadeSeconds > 0.0f)
+        {
+            layer.iFadingClip = static_cast<INT>(layer.uClip);
+            layer.fadingTime = layer.time;
+            layer.fadeElapsedSeconds = 0.0f;
+            layer.fadeSeconds = fadeSeconds;
+            std::swap(layer.pSampler, layer.pFadingSampler);
+        }
+        else
+        {
+            layer.iFadingClip = -1;
+        }
+
+        layer.uClip = uClip;
+        layer.time = 0.0f;
+
+        if (layer.BlendMode == eAnimationBlendMode::ADDITIVE)
+        {
+            // A sampler of its own leaves the cursors of the layers
+            // alone
+            CreateAnimationSampler()->Sample(*m_apCompressedAnimationClips[uClip], 0.0f, layer.aReferencePose.data());
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::AddAnimationLayer
+
+      Summary:  Adds a layer over the others, playing a clip from its
+                start with every node weighted fully
+
+      Args:     UINT uClip
+                  Index of the clip to play
+                eAnimationBlendMode blendMode
+                  Whether the layer replaces or adds to the layers
+                  below
+                FLOAT weight
+                  Weight of the layer, from 0 to 1
+                UINT& uOutLayer
+                  Index of the new layer
+
+      Modifies: [m_aAnimationLayers].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::AddAnimationLayer(_In_ UINT uClip, _In_ eAnimationBlendMode blendMode, _In_ FLOAT weight, _Out_ UINT& uOutLayer)
+    {
+        uOutLayer = static_cast<UINT>(m_aAnimationLayers.size());
+
+        if (uClip >= m_apCompressedAnimationClips.size() || weight < 0.0f || weight > 1.0f)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_aAnimationLayers.push_back(
+            AnimationLayer
+            {
+                .BlendMode = blendMode,
+                .weight = weight,
+                .uClip = uClip,
+                .time = 0.0f,
+                .iFadingClip = -1,
+                .fadingTime = 0.0f,
+                .fadeElapsedSeconds = 0.0f,
+                .fadeSeconds = 0.0f,
+                .aMask = std::vector<XMVECTOR>(),
+                .aReferencePose = std::vector<SoaTransform>(),
+                .pSampler = CreateAnimationSampler(),
+                .pFadingSampler = CreateAnimationSampler(),
+            }
+        );
+
+        if (blendMode == eAnimationBlendMode::ADDITIVE)
+        {
+            AnimationLayer& layer = m_aAnimationLayers.back();
+            layer.aReferencePose.resize(m_aPose.size());
+            CreateAnimationSampler()->Sample(*m_apCompressedAnimationClips[uClip], 0.0f, layer.aReferencePose.data());
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetAnimationLayerWeight
+
+      Summary:  Sets the weight of a layer
+
+      Args:     UINT uLayer
+                  Index of the layer
+                FLOAT weight
+                  Weight of the layer, from 0 to 1
+
+      Modifies: [m_aAnimationLayers].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::SetAnimationLayerWeight(_In_ UINT uLayer, _In_ FLOAT weight)
+    {
+        if (uLayer >= m_aAnimationLayers.size() || weight < 0.0f || weight > 1.0f)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_aAnimationLayers[uLayer].weight = weight;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetAnimationLayerMask
+
+      Summary:  Sets the weight of a node and all its descendants on a
+                layer, so a layer can play on the upper body only or
+                leave a limb out. Nodes not set keep their weight,
+                fully at first
+
+      Args:     UINT uLayer
+                  Index of the layer
+                PCSTR pszNodeName
+                  Name of the node, usually a bone
+                FLOAT weight
+                  Weight of the nodes, from 0 to 1
+
+      Modifies: [m_aAnimationLayers].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::SetAnimationLayerMask(_In_ UINT uLayer, _In_ PCSTR pszNodeName, _In_ FLOAT weight)
+    {
+        auto node = m_nodeNameToIndexMap.find(pszNodeName);
+        if (uLayer >= m_aAnimationLayers.size() || node == m_nodeNameToIndexMap.end() || weight < 0.0f || weight > 1.0f)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<XMVECTOR>& aMask = m_aAnimationLayers[uLayer].aMask;
+        if (aMask.empty())
+        {
+            aMask.assign(m_aPose.size(), XMVectorSplatOne());
+        }
+
+        // Descendants follow a node in the flattened skeleton until
+        // the first node whose parent comes before it
+        const UINT uFirstNode = node->second;
+        for (UINT i = uFirstNode; i < m_aSkeletonNodes.size(); ++i)
+        {
+            if (i > uFirstNode && m_aSkeletonNodes[i].iParent < static_cast<INT>(uFirstNode))
+            {
+                break;
+            }
+
+            aMask[i / AnimationSampler::SOA_WIDTH] = XMVectorSetByIndex(aMask[i / AnimationSampler::SOA_WIDTH], weight, i % AnimationSampler::SOA_WIDTH);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::MeasureSkeletonEvaluation
+
+      Summary:  Evaluates the bone transforms of frames spread over the
+                first animation by walking the node tree and with the
+                flattened skeleton, and logs the time of both and the
+                largest difference between their transforms. Needs the
+                source animation kept at load
+
+      Args:     UINT uNumFrames
+                  Number of frames to evaluate
+
+      Modifies: [m_aBoneInfo, m_aPose, m_aLocalTransforms,
+                 m_aGlobalTransforms].
+
+      Returns:  SkeletonEvaluationStatistics
+                  Time per frame of both and their largest difference
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkeletonEvaluationStatistics Model::MeasureSkeletonEvaluation(_In_ UINT uNumFrames)
+    {
+        SkeletonEvaluationStatistics statistics =
+        {
+            .uNumNodes = static_cast<UINT>(m_aSkeletonNodes.size()),
+            .uNumChannels = 0u,
+            .uNumFrames = uNumFrames,
+            .hierarchyMicroseconds = 0.0,
+            .flattenedMicroseconds = 0.0,
+            .maxError = 0.0f,
+        };
+
+        if (!m_pScene || m_apAnimationClips.empty() || !m_pScene->mRootNode || uNumFrames == 0u)
+        {
+            return statistics;
+        }
+
+        const aiAnimation* pAnimation = m_pScene->mAnimations[0];
+        statistics.uNumChannels = pAnimation->mNumChannels;
+
+        const size_t uNumBones = m_aBoneInfo.size();
+        const FLOAT duration = static_cast<FLOAT>(pAnimation->mDuration);
+        std::vector<XMFLOAT4X4> aHierarchyTransforms(uNumBones * uNumFrames);
+        std::vector<XMFLOAT4X4> aFlattenedTransforms(uNumBones * uNumFrames);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            readNodeHierarchy(duration * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames), m_pScene->mRootNode, XMMatrixIdentity());
+            for (size_t uBone = 0u; uBone < uNumBones; ++uBone)
+            {
+                XMStoreFloat4x4(&aHierarchyTransforms[uFrame * uNumBones + uBone], m_aBoneInfo[uBone].FinalTransformation);
+            }
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE hierarchySeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        std::unique_ptr<AnimationSampler> pSampler = CreateAnimationSampler();
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            evaluateSkeleton(*pSampler, duration * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames));
+            for (size_t uBone = 0u; uBone < uNumBones; ++uBone)
+            {
+                XMStoreFloat4x4(&aFlattenedTransforms[uFrame * uNumBones + uBone], m_aBoneInfo[uBone].FinalTransformation);
+            }
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE flattenedSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        for (size_t i = 0u; i < aHierarchyTransforms.size(); ++i)
+        {
+            for (UINT uRow = 0u; uRow < 4u; ++uRow)
+            {
+                for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+                {
+                    statistics.maxError = std::max<FLOAT>(statistics.maxError, std::abs(aHierarchyTransforms[i].m[uRow][uColumn] - aFlattenedTransforms[i].m[uRow][uColumn]));
+                }
+            }
+        }
+
+        statistics.hierarchyMicroseconds = hierarchySeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+        statistics.flattenedMicroseconds = flattenedSeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Model: %u node(s), %u channel(s), %u frame(s), node tree %.2f us, flattened %.2f us per frame, max error %g\n",
+            statistics.uNumNodes,
+            statistics.uNumChannels,
+            statistics.uNumFrames,
+            statistics.hierarchyMicroseconds,
+            statistics.flattenedMicroseconds,
+            statistics.maxError
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::MeasureAnimationCompression
+
+      Summary:  Samples frames spread over the first animation from the
+                clip and from the compressed clip, and logs the keys and
+                memory of both, the time of sampling both, and the
+                largest difference between their bone transforms for
+                every bone. Needs the source clips kept at load
+
+      Args:     UINT uNumFrames
+                  Number of frames to sample
+
+      Modifies: [m_aBoneInfo, m_aPose, m_aLocalTransforms,
+                 m_aGlobalTransforms].
+
+      Returns:  AnimationCompressionStatistics
+                  Size and time per frame of both and their largest
+                  difference
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationCompressionStatistics Model::MeasureAnimationCompression(_In_ UINT uNumFrames)
+    {
+        AnimationCompressionStatistics statistics =
+        {
+            .uNumKeys = 0u,
+            .uNumCompressedKeys = 0u,
+            .uSizeInBytes = 0u,
+            .uCompressedSizeInBytes = 0u,
+            .uNumFrames = uNumFrames,
+            .rawMicroseconds = 0.0,
+            .compressedMicroseconds = 0.0,
+            .maxError = 0.0f,
+        };
+
+        if (m_apAnimationClips.empty() || uNumFrames == 0u)
+        {
+            return statistics;
+        }
+
+        const AnimationClip& clip = *m_apAnimationClips[0];
+        const CompressedAnimationClip& compressedClip = *m_apCompressedAnimationClips[0];
+        statistics.uNumKeys = clip.GetNumKeys();
+        statistics.uNumCompressedKeys = compressedClip.GetNumKeys();
+        statistics.uSizeInBytes = clip.GetSizeInBytes();
+        statistics.uCompressedSizeInBytes = compressedClip.GetSizeInBytes();
+
+        const FLOAT duration = clip.GetDuration();
+
+        // Samplers of their own keep the cursors of the playing clip
+        AnimationSampler rawSampler;
+        AnimationSampler compressedSampler;
+        rawSampler.SetSlerpFallback(TRUE);
+        compressedSampler.SetSlerpFallback(TRUE);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            rawSampler.Sample(clip, duration * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames), m_aPose.data());
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE rawSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            compressedSampler.Sample(compressedClip, duration * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames), m_aPose.data());
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE compressedSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        const size_t uNumBones = m_aBoneInfo.size();
+        std::vector<XMFLOAT4X4> aRawTransforms(uNumBones);
+        std::vector<FLOAT> aBoneErrors(uNumBones, 0.0f);
+        for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+        {
+            const FLOAT time = duration * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames);
+
+            rawSampler.Sample(clip, time, m_aPose.data());
+            applyPose();
+            for (size_t uBone = 0u; uBone < uNumBones; ++uBone)
+            {
+                XMStoreFloat4x4(&aRawTransforms[uBone], m_aBoneInfo[uBone].FinalTransformation);
+            }
+
+            compressedSampler.Sample(compressedClip, time, m_aPose.data());
+            applyPose();
+            for (size_t uBone = 0u; uBone < uNumBones; ++uBone)
+            {
+                XMFLOAT4X4 compressedTransform;
+                XMStoreFloat4x4(&compressedTransform, m_aBoneInfo[uBone].FinalTransformation);
+
+                for (UINT uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    for (UINT uColumn = 0u; uColumn < 4u; ++uColumn)
+                    {
+                        aBoneErrors[uBone] = std::max<FLOAT>(aBoneErrors[uBone], std::abs(aRawTransforms[uBone].m[uRow][uColumn] - compressedTransform.m[uRow][uColumn]));
+                    }
+                }
+            }
+        }
+
+        statistics.rawMicroseconds = rawSeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+        statistics.compressedMicroseconds = compressedSeconds * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+
+        CHAR szDebugMessage[256];
+        for (const auto& [boneName, uBone] : m_boneNameToIndexMap)
+        {
+            statistics.maxError = std::max<FLOAT>(statistics.maxError, aBoneErrors[uBone]);
+
+            sprintf_s(szDebugMessage, "Model: bone %s max error %g\n", boneName.c_str(), aBoneErrors[uBone]);
+            OutputDebugStringA(szDebugMessage);
+        }
+
+        sprintf_s(
+            szDebugMessage,
+            "Model: %u key(s) in %zu byte(s) compressed to %u key(s) in %zu byte(s) (%.1f%%), %u frame(s), raw %.2f us, compressed %.2f us per frame, max error %g\n",
+            statistics.uNumKeys,
+            statistics.uSizeInBytes,
+            statistics.uNumCompressedKeys,
+            statistics.uCompressedSizeInBytes,
+            statistics.uSizeInBytes > 0u ? 100.0 * static_cast<DOUBLE>(statistics.uCompressedSizeInBytes) / static_cast<DOUBLE>(statistics.uSizeInBytes) : 0.0,
+            statistics.uNumFrames,
+            statistics.rawMicroseconds,
+            statistics.compressedMicroseconds,
+            statistics.maxError
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::MeasureAnimationBlending
+
+      Summary:  Updates frames playing the first clip alone, cross-fading
+                from it to the second, and cross-fading with an additive
+                layer of the first clip masked to the last child of the
+                root node on top, and logs the time of each. The layers
+                are restored afterwards
+
+      Args:     UINT uNumFrames
+                  Number of frames to update
+
+      Modifies: [m_timeSinceLoaded, m_aPose, m_aLayerPose,
+                 m_aFadePose, m_aLocalTransforms, m_aGlobalTransforms,
+                 m_aBoneInfo, m_aTransforms].
+
+      Returns:  AnimationBlendingStatistics
+                  Time per frame of each
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationBlendingStatistics Model::MeasureAnimationBlending(_In_ UINT uNumFrames)
+    {
+        AnimationBlendingStatistics statistics =
+        {
+            .uNumClips = GetNumAnimationClips(),
+            .uNumFrames = uNumFrames,
+            .singleMicroseconds = 0.0,
+            .crossFadeMicroseconds = 0.0,
+            .layeredMicroseconds = 0.0,
+        };
+
+        if (!m_pScene || m_apCompressedAnimationClips.empty() || !m_pScene->mRootNode || uNumFrames == 0u)
+        {
+            return statistics;
+        }
+
+        static constexpr const FLOAT FRAME_SECONDS = 1.0f / 60.0f;
+        // Long enough that the fade lasts all the frames
+        const FLOAT fadeSeconds = FRAME_SECONDS * static_cast<FLOAT>(uNumFrames + 1u);
+        const UINT uOtherClip = std::min<UINT>(1u, statistics.uNumClips - 1u);
+
+        std::string rootNodeName;
+        std::string maskedNodeName;
+        INT iMaskedNode = 0;
+        for (size_t i = 0u; i < m_aSkeletonNodes.size(); ++i)
+        {
+            if (m_aSkeletonNodes[i].iParent == 0)
+            {
+                iMaskedNode = static_cast<INT>(i);
+            }
+        }
+        for (const auto& [nodeName, uNode] : m_nodeNameToIndexMap)
+        {
+            if (uNode == 0u)
+            {
+                rootNodeName = nodeName;
+            }
+            if (uNode == static_cast<UINT>(iMaskedNode))
+            {
+                maskedNodeName = nodeName;
+            }
+        }
+
+        const FLOAT savedTimeSinceLoaded = m_timeSinceLoaded;
+        std::vector<AnimationLayer> aSavedLayers = std::move(m_aAnimationLayers);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        DOUBLE aSeconds[3];
+        for (UINT uSetup = 0u; uSetup < 3u; ++uSetup)
+        {
+            UINT uLayer = 0u;
+            m_aAnimationLayers.clear();
+            AddAnimationLayer(0u, eAnimationBlendMode::OVERRIDE, 1.0f, uLayer);
+
+            if (uSetup > 0u)
+            {
+                PlayAnimation(0u, uOtherClip, fadeSeconds);
+            }
+            if (uSetup > 1u)
+            {
+                AddAnimationLayer(0u, eAnimationBlendMode::ADDITIVE, 0.5f, uLayer);
+
+                // A new mask weighs every node fully, so the whole
+                // skeleton is left out before the subtree is let in
+                SetAnimationLayerMask(uLayer, rootNodeName.c_str(), 0.0f);
+                SetAnimationLayerMask(uLayer, maskedNodeName.c_str(), 1.0f);
+            }
+
+            QueryPerformanceCounter(&startingTime);
+            for (UINT uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+            {
+                Update(FRAME_SECONDS);
+            }
+            QueryPerformanceCounter(&endingTime);
+            aSeconds[uSetup] = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+        }
+
+        m_aAnimationLayers = std::move(aSavedLayers);
+        m_timeSinceLoaded = savedTimeSinceLoaded;
+
+        statistics.singleMicroseconds = aSeconds[0] * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+        statistics.crossFadeMicroseconds = aSeconds[1] * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+        statistics.layeredMicroseconds = aSeconds[2] * 1.0e6 / static_cast<DOUBLE>(uNumFrames);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Model: %u clip(s), %u frame(s), single clip %.2f us, cross-fade %.2f us, cross-fade and masked additive layer %.2f us per frame\n",
+            statistics.uNumClips,
+            statistics.uNumFrames,
+            statistics.singleMicroseconds,
+            statistics.crossFadeMicroseconds,
+            statistics.layeredMicroseconds
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::countVerticesAndIndices
 
-      Returns:  ComPtr<ID3D11Buffer>&
+      Summary:  Fill the BasicMeshEntry information
 
+      Args:     UINT& uOutNumVertices
+                  Total number of vertices
+                UINT& uOutNumIndices
+                  Total number of indices
+                const aiScene* pScene
+                  Pointer to an assimp scene object that contains the 
+                  mesh information
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11Buffer>& Model::GetAnimationBuffer()
+    void Model::countVerticesAndIndices(
+        _Inout_ UINT& uOutNumVertices,
+        _Inout_ UINT& uOutNumIndices,
+        _In_ const aiScene* pScene
+        ) 
     {
-        return m_animationBuffer;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i) {
+            m_aMeshes[i].uMaterialIndex = pScene->mMeshes[i]->mMaterialIndex;
+            m_aMeshes[i].uNumIndices = pScene->mMeshes[i]->mNumFaces * 3u;
+            m_aMeshes[i].uBaseVertex = uOutNumVertices;
+            m_aMeshes[i].uBaseIndex = uOutNumIndices;
+
+            uOutNumVertices += pScene->mMeshes[i]->mNumVertices;
+            uOutNumIndices += m_aMeshes[i].uNumIndices;
+        }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetSkinningConstantBuffer
+      Method:   Model::evaluateSkeleton
 
-      Summary:  Returns the skinning constant buffer
+      Summary:  Calculates the bone transformations of a frame from the
+                first clip alone
 
-      Returns:  ComPtr<ID3D11Buffer>&
+      Args:     AnimationSampler& sampler
+                  Sampler of the first clip
+                FLOAT animationTimeTicks
+                  Animation time
 
+      Modifies: [sampler, m_aPose, m_aLocalTransforms,
+                 m_aGlobalTransforms, m_aBoneInfo].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11Buffer>& Model::GetSkinningConstantBuffer()
+    void Model::evaluateSkeleton(_Inout_ AnimationSampler& sampler, _In_ FLOAT animationTimeTicks)
     {
-        return m_skinningConstantBuffer;
+        sampler.Sample(*m_apAnimationClips[0], animationTimeTicks, m_aPose.data());
+        applyPose();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetNumVertices
-
-      Summary:  Returns the number of vertices
-
-      Returns:  UINT
-                  Number of vertices
+      Method:   Model::evaluateLayers
+
+      Summary:  Calculates the bone transformations of a frame from
+                every layer, bottom first, in local space. An override
+                layer blends its pose over the layers below by its
+                weight and mask; an additive layer adds the difference
+                of its pose from its reference pose. A first override
+                layer at full weight with no mask or fade is sampled
+                straight into the pose; otherwise the layers are blended
+                over the bind pose
+
+      Modifies: [m_aAnimationLayers, m_aPose, m_aLayerPose,
+                 m_aFadePose, m_aLocalTransforms, m_aGlobalTransforms,
+                 m_aBoneInfo].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::GetNumVertices() const
+    void Model::evaluateLayers()
     {
-        return static_cast<UINT>(m_aVertices.size());
-    }
+        const UINT uNumSoaTransforms = static_cast<UINT>(m_aPose.size());
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetNumIndices
+        size_t uFirstLayer = 0u;
+        if (!m_aAnimationLayers.empty())
+        {
+            AnimationLayer& layer = m_aAnimationLayers[0];
+            if (layer.BlendMode == eAnimationBlendMode::OVERRIDE && layer.weight >= 1.0f && layer.aMask.empty()
+                && layer.iFadingClip < 0)
+            {
+                layer.pSampler->Sample(*m_apCompressedAnimationClips[layer.uClip], layer.time, m_aPose.data());
+                uFirstLayer = 1u;
+            }
+        }
 
-      Summary:  Returns the number of indices
+        if (uFirstLayer == 0u)
+        {
+            std::copy(m_aBindPose.begin(), m_aBindPose.end(), m_aPose.begin());
+        }
 
-      Returns:  UINT
-                  Number of indices
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::GetNumIndices() const
-    {
-        return static_cast<UINT>(m_aIndices.size());
+        for (size_t i = uFirstLayer; i < m_aAnimationLayers.size(); ++i)
+        {
+            AnimationLayer& layer = m_aAnimationLayers[i];
+            if (layer.weight <= 0.0f)
+            {
+                continue;
+            }
+
+            sampleLayer(layer, m_aLayerPose.data());
+
+            const XMVECTOR* pMask = layer.aMask.empty() ? nullptr : layer.aMask.data();
+            if (layer.BlendMode == eAnimationBlendMode::ADDITIVE)
+            {
+                AddPoses(m_aLayerPose.data(), layer.aReferencePose.data(), layer.weight, pMask, uNumSoaTransforms, m_aPose.data());
+            }
+            else
+            {
+                BlendPoses(m_aLayerPose.data(), layer.weight, pMask, uNumSoaTransforms, m_aPose.data());
+            }
+        }
+
+        applyPose();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::GetBoneTransforms
+      Method:   Model::sampleLayer
 
-       Summary:  Returns the vector containing bone transforms
+      Summary:  Samples the clip of a layer, blended over the clip
+                fading out of it by what is left of the fade
 
-       Returns:  std::vector<XMMATRIX>&
+      Args:     AnimationLayer& layer
+                  Layer to sample
+                SoaTransform* pOutPose
+                  Pose of the layer
 
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::vector<XMMATRIX>& Model::GetBoneTransforms()
+      Modifies: [layer.pSampler, layer.pFadingSampler, m_aFadePose].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::sampleLayer(_Inout_ AnimationLayer& layer, _Out_ SoaTransform* pOutPose)
     {
-        return m_aTransforms;
+        layer.pSampler->Sample(*m_apCompressedAnimationClips[layer.uClip], layer.time, pOutPose);
+
+        if (layer.iFadingClip >= 0)
+        {
+            // The fading pose goes over the new one, so the weight is
+            // what is left of the fade
+            const UINT uFadingClip = static_cast<UINT>(layer.iFadingClip);
+            layer.pFadingSampler->Sample(*m_apCompressedAnimationClips[uFadingClip], layer.fadingTime, m_aFadePose.data());
+            BlendPoses(
+                m_aFadePose.data(),
+                1.0f - layer.fadeElapsedSeconds / layer.fadeSeconds,
+                nullptr,
+                static_cast<UINT>(m_aFadePose.size()),
+                pOutPose
+            );
+        }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-        Method:   Model::GetBoneNameToIndexMap
+      Method:   Model::advanceTime
 
-        Summary:  Returns the bone name to index map
+      Summary:  Advances a time of a clip by a frame, wrapped around
+                the duration of the clip
 
-        Returns:  std::unordered_map<std::string, UINT>&
+      Args:     UINT uClip
+                  Index of the clip
+                FLOAT time
+                  Time in ticks of the clip
+                FLOAT deltaTime
+                  Time difference of a frame in seconds
 
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
+      Returns:  FLOAT
+                  Time in ticks a frame later
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT Model::advanceTime(_In_ UINT uClip, _In_ FLOAT time, _In_ FLOAT deltaTime) const
     {
-        return m_boneNameToIndexMap;
+        const CompressedAnimationClip& clip = *m_apCompressedAnimationClips[uClip];
+        const FLOAT duration = clip.GetDuration();
+        if (duration <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        return fmod(time + deltaTime * clip.GetTicksPerSecond(), duration);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::countVerticesAndIndices
+      Method:   Model::applyPose
 
-      Summary:  Fill the BasicMeshEntry information
+      Summary:  Calculates the bone transformations of the sampled
+                pose. The local transforms of every node are composed
+                four nodes at a time, then one pass over the flattened
+                skeleton accumulates them. Parents come first, so the
+                global transform of a parent is ready before its
+                children read it
 
-      Args:     UINT& uOutNumVertices
-                  Total number of vertices
-                UINT& uOutNumIndices
-                  Total number of indices
-                const aiScene* pScene
-                  Pointer to an assimp scene object that contains the 
-                  mesh information
+      Modifies: [m_aLocalTransforms, m_aGlobalTransforms, m_aBoneInfo].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::countVerticesAndIndices(
-        _Inout_ UINT& uOutNumVertices,
-        _Inout_ UINT& uOutNumIndices,
-        _In_ const aiScene* pScene
-        ) 
+    void Model::applyPose()
     {
-        for (UINT i = 0u; i < m_aMeshes.size(); ++i) {
-            m_aMeshes[i].uMaterialIndex = pScene->mMeshes[i]->mMaterialIndex;
-            m_aMeshes[i].uNumIndices = pScene->mMeshes[i]->mNumFaces * 3u;
-            m_aMeshes[i].uBaseVertex = uOutNumVertices;
-            m_aMeshes[i].uBaseIndex = uOutNumIndices;
+        AnimationSampler::ComposeMatrices(m_aPose.data(), static_cast<UINT>(m_aLocalTransforms.size()), m_aLocalTransforms.data());
 
-            uOutNumVertices += pScene->mMeshes[i]->mNumVertices;
-            uOutNumIndices += m_aMeshes[i].uNumIndices;
+        for (size_t i = 0u; i < m_aSkeletonNodes.size(); ++i)
+        {
+            const SkeletonNode& node = m_aSkeletonNodes[i];
+
+            XMMATRIX nodeTransform = node.bAnimated ? m_aLocalTransforms[i] : node.Transformation;
+            m_aGlobalTransforms[i] = node.iParent < 0 ? nodeTransform : nodeTransform * m_aGlobalTransforms[node.iParent];
+
+            if (node.iBone >= 0)
+            {
+                m_aBoneInfo[node.iBone].FinalTransformation = m_aBoneInfo[node.iBone].OffsetMatrix * m_aGlobalTransforms[i]
+                    * m_globalInverseTransform;
+            }
         }
     }
 
@@ -348,25 +1352,27 @@ namespace library
                     Animation time
                   const aiNodeAnim* pNodeAnim
                      Pointer to an assimp node anim object
+                  UINT& uKeyCursor
+                    Key the track was last sampled at
+
+        Modifies: [uKeyCursor].
 
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         assert(pNodeAnim->mNumPositionKeys > 0);
 
-        for (UINT i = 0; i < pNodeAnim->mNumPositionKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mPositionKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+        return FindKey(
+            animationTimeTicks,
+            pNodeAnim->mNumPositionKeys,
+            [pNodeAnim](UINT uIndex)
             {
-                return i;
-            }
-        }
-
-        return 0u;
+                return static_cast<FLOAT>(pNodeAnim->mPositionKeys[uIndex].mTime);
+            },
+            uKeyCursor
+        );
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -378,25 +1384,27 @@ namespace library
                     Animation time
                   const aiNodeAnim* pNodeAnim
                      Pointer to an assimp node anim object
+                  UINT& uKeyCursor
+                    Key the track was last sampled at
+
+        Modifies: [uKeyCursor].
 
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         assert(pNodeAnim->mNumRotationKeys > 0);
 
-        for (UINT i = 0u; i < pNodeAnim->mNumRotationKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mRotationKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+        return FindKey(
+            animationTimeTicks,
+            pNodeAnim->mNumRotationKeys,
+            [pNodeAnim](UINT uIndex)
             {
-                return i;
-            }
-        }
-
-        return 0u;
+                return static_cast<FLOAT>(pNodeAnim->mRotationKeys[uIndex].mTime);
+            },
+            uKeyCursor
+        );
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -408,25 +1416,27 @@ namespace library
                     Animation time
                   const aiNodeAnim* pNodeAnim
                      Pointer to an assimp node anim object
+                  UINT& uKeyCursor
+                    Key the track was last sampled at
+
+        Modifies: [uKeyCursor].
 
         Returns:  UINT
                     Index of the key
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    UINT Model::findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         assert(pNodeAnim->mNumScalingKeys > 0);
 
-        for (UINT i = 0u; i < pNodeAnim->mNumScalingKeys - 1; ++i)
-        {
-            FLOAT t = static_cast<FLOAT>(pNodeAnim->mScalingKeys[i + 1].mTime);
-
-            if (animationTimeTicks < t)
+        return FindKey(
+            animationTimeTicks,
+            pNodeAnim->mNumScalingKeys,
+            [pNodeAnim](UINT uIndex)
             {
-                return i;
-            }
-        }
-
-        return 0u;
+                return static_cast<FLOAT>(pNodeAnim->mScalingKeys[uIndex].mTime);
+            },
+            uKeyCursor
+        );
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -505,10 +1515,51 @@ namespace library
     }
 
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initBoneBoundingBoxes
+
+      Summary:  Bounds the bind pose positions of the vertices each
+                bone weighs, for GetSkinnedBoundingBox. A bone weighing
+                no vertex gets negative extents
+
+      Modifies: [m_aBoneBoundingBoxes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initBoneBoundingBoxes()
+    {
+        std::vector<XMVECTOR> aMinCorners(m_aBoneInfo.size(), XMVectorReplicate(std::numeric_limits<FLOAT>::infinity()));
+        std::vector<XMVECTOR> aMaxCorners(m_aBoneInfo.size(), XMVectorReplicate(-std::numeric_limits<FLOAT>::infinity()));
+        for (size_t i = 0u; i < m_aVertices.size(); ++i)
+        {
+            const XMVECTOR position = XMLoadFloat3(&m_aVertices[i].Position);
+            const VertexBoneData& boneData = m_aBoneData[i];
+            for (UINT j = 0u; j < boneData.uNumBones; ++j)
+            {
+                if (boneData.aWeights[j] > 0.0f)
+                {
+                    aMinCorners[boneData.aBoneIds[j]] = XMVectorMin(aMinCorners[boneData.aBoneIds[j]], position);
+                    aMaxCorners[boneData.aBoneIds[j]] = XMVectorMax(aMaxCorners[boneData.aBoneIds[j]], position);
+                }
+            }
+        }
+
+        m_aBoneBoundingBoxes.resize(m_aBoneInfo.size());
+        for (size_t i = 0u; i < m_aBoneBoundingBoxes.size(); ++i)
+        {
+            if (XMVector3Greater(aMinCorners[i], aMaxCorners[i]))
+            {
+                m_aBoneBoundingBoxes[i] = BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(-1.0f, -1.0f, -1.0f));
+                continue;
+            }
+
+            BoundingBox::CreateFromPoints(m_aBoneBoundingBoxes[i], aMinCorners[i], aMaxCorners[i]);
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initFromScene
 
-      Summary:  Initialize all meshes in a given assimp scene
+      Summary:  Initialize the materials and buffers of the meshes
+                loaded from a given assimp scene
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
@@ -529,13 +1580,6 @@ namespace library
         _In_ const std::filesystem::path& filePath
     ) {
         HRESULT hr;
-        m_aMeshes.resize(pScene->mNumMeshes);
-
-        UINT numVertices = 0u;
-        UINT numIndices = 0u;
-        countVerticesAndIndices(numVertices, numIndices, pScene);
-        reserveSpace(numVertices, numIndices);
-        initAllMeshes(pScene);
         hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
         if (FAILED(hr)) return hr;
 
@@ -698,6 +1742,167 @@ namespace library
         initMeshBones(uMeshIndex, pMesh);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initSkeleton
+
+      Summary:  Flattens the node tree of a given assimp scene into an
+                array of nodes in depth first order, so every parent
+                comes before its children, and resolves the bone of
+                every node and whether any animation moves it once by
+                its name. Every animation is then copied into a clip
+                over the nodes, compressed and registered by its name,
+                and a base layer plays the first one
+
+      Args:     const aiScene* pScene
+                  Assimp scene
+                const AnimationCompressionDesc& desc
+                  Tolerances and sample rate of the compressed clips
+
+      Modifies: [m_aSkeletonNodes, m_nodeNameToIndexMap,
+                 m_aLocalTransforms, m_aGlobalTransforms,
+                 m_apAnimationClips, m_apCompressedAnimationClips,
+                 m_clipNameToIndexMap, m_aAnimationLayers, m_aBindPose,
+                 m_aPose, m_aLayerPose, m_aFadePose].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initSkeleton(_In_ const aiScene* pScene, _In_ const AnimationCompressionDesc& desc)
+    {
+        m_aSkeletonNodes.clear();
+        m_nodeNameToIndexMap.clear();
+        m_apAnimationClips.clear();
+        m_apCompressedAnimationClips.clear();
+        m_clipNameToIndexMap.clear();
+        m_aAnimationLayers.clear();
+
+        std::vector<std::pair<const aiNode*, INT>> aStack;
+        if (pScene->mRootNode)
+        {
+            aStack.push_back({ pScene->mRootNode, -1 });
+        }
+
+        while (!aStack.empty())
+        {
+            const auto [pNode, iParent] = aStack.back();
+            aStack.pop_back();
+
+            BOOL bAnimated = FALSE;
+            for (UINT i = 0u; !bAnimated && i < pScene->mNumAnimations; ++i)
+            {
+                const aiAnimation* pAnimation = pScene->mAnimations[i];
+                for (UINT j = 0u; j < pAnimation->mNumChannels; ++j)
+                {
+                    if (pAnimation->mChannels[j]->mNodeName == pNode->mName)
+                    {
+                        bAnimated = TRUE;
+                        break;
+                    }
+                }
+            }
+
+            auto bone = m_boneNameToIndexMap.find(pNode->mName.C_Str());
+
+            const INT iNode = static_cast<INT>(m_aSkeletonNodes.size());
+            m_nodeNameToIndexMap.emplace(pNode->mName.C_Str(), static_cast<UINT>(iNode));
+            m_aSkeletonNodes.push_back(
+                SkeletonNode
+                {
+                    .Transformation = ConvertMatrix(pNode->mTransformation),
+                    .iParent = iParent,
+                    .iBone = bone == m_boneNameToIndexMap.end() ? -1 : static_cast<INT>(bone->second),
+                    .bAnimated = bAnimated,
+                }
+            );
+
+            // Children are pushed in reverse so they are visited in
+            // the order of the file
+            for (UINT i = pNode->mNumChildren; i > 0u; --i)
+            {
+                aStack.push_back({ pNode->mChildren[i - 1u], iNode });
+            }
+        }
+
+        const UINT uNumNodes = static_cast<UINT>(m_aSkeletonNodes.size());
+        m_aLocalTransforms.resize(uNumNodes);
+        m_aGlobalTransforms.resize(uNumNodes);
+        const UINT uNumSoaTransforms = AnimationSampler::GetNumSoaTransforms(uNumNodes);
+        m_aBindPose.resize(uNumSoaTransforms);
+        m_aPose.resize(uNumSoaTransforms);
+        m_aLayerPose.resize(uNumSoaTransforms);
+        m_aFadePose.resize(uNumSoaTransforms);
+
+        if (uNumNodes == 0u)
+        {
+            return S_OK;
+        }
+
+        std::vector<XMMATRIX> aBindTransforms(uNumNodes);
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            aBindTransforms[i] = m_aSkeletonNodes[i].Transformation;
+        }
+        LoadPose(aBindTransforms.data(), uNumNodes, m_aBindPose.data());
+
+        for (UINT i = 0u; i < pScene->mNumAnimations; ++i)
+        {
+            auto pClip = std::make_unique<AnimationClip>();
+            HRESULT hr = pClip->Create(pScene->mAnimations[i], m_nodeNameToIndexMap, aBindTransforms.data(), uNumNodes);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            auto pCompressedClip = std::make_unique<CompressedAnimationClip>();
+            hr = pCompressedClip->Create(*pClip, desc);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            // The first of animations sharing a name keeps it
+            m_clipNameToIndexMap.emplace(pScene->mAnimations[i]->mName.C_Str(), i);
+            m_apAnimationClips.push_back(std::move(pClip));
+            m_apCompressedAnimationClips.push_back(std::move(pCompressedClip));
+        }
+
+        if (!m_apCompressedAnimationClips.empty())
+        {
+            UINT uBaseLayer = 0u;
+            return AddAnimationLayer(0u, eAnimationBlendMode::OVERRIDE, 1.0f, uBaseLayer);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::releaseSourceAnimation
+
+      Summary:  Releases the source clips and the channels of the
+                Assimp animations once every clip is compressed, as
+                playback only reads the compressed clips. The names and
+                durations of the animations are kept
+
+      Modifies: [m_apAnimationClips, m_pScene].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::releaseSourceAnimation()
+    {
+        m_apAnimationClips.clear();
+        m_apAnimationClips.shrink_to_fit();
+
+        for (UINT i = 0u; i < m_pScene->mNumAnimations; ++i)
+        {
+            aiAnimation* pAnimation = m_pScene->mAnimations[i];
+            for (UINT j = 0u; j < pAnimation->mNumChannels; ++j)
+            {
+                delete pAnimation->mChannels[j];
+            }
+            delete[] pAnimation->mChannels;
+            pAnimation->mChannels = nullptr;
+            pAnimation->mNumChannels = 0u;
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::interpolatePosition
 
@@ -709,8 +1914,12 @@ namespace library
                   Animation time
                 const aiNodeAnim* pNodeAnim
                   Pointer to an assimp node anim object
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+
+      Modifies: [uKeyCursor].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         if (pNodeAnim->mNumPositionKeys == 1)
         {
@@ -718,7 +1927,7 @@ namespace library
             return;
         }
 
-        UINT uPositionIndex = findPosition(animationTimeTicks, pNodeAnim);
+        UINT uPositionIndex = findPosition(animationTimeTicks, pNodeAnim, uKeyCursor);
         UINT uNextPositionIndex = uPositionIndex + 1u;
         assert(uNextPositionIndex < pNodeAnim->mNumPositionKeys);
 
@@ -744,8 +1953,12 @@ namespace library
                   Animation time
                 const aiNodeAnim* pNodeAnim
                   Pointer to an assimp node anim object
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+
+      Modifies: [uKeyCursor].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         if (pNodeAnim->mNumRotationKeys == 1)
         {
@@ -753,7 +1966,7 @@ namespace library
             return;
         }
 
-        UINT uRotationIndex = findRotation(animationTimeTicks, pNodeAnim);
+        UINT uRotationIndex = findRotation(animationTimeTicks, pNodeAnim, uKeyCursor);
         UINT uNextRotationIndex = uRotationIndex + 1u;
 
         assert(uNextRotationIndex < pNodeAnim->mNumRotationKeys);
@@ -781,8 +1994,12 @@ namespace library
                   Animation time
                 const aiNodeAnim* pNodeAnim
                   Pointer to an assimp node anim object
+                UINT& uKeyCursor
+                  Key the track was last sampled at
+
+      Modifies: [uKeyCursor].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim)
+    void Model::interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor)
     {
         if (pNodeAnim->mNumScalingKeys == 1)
         {
@@ -790,7 +2007,7 @@ namespace library
             return;
         }
 
-        UINT uScaleIndex = findScaling(animationTimeTicks, pNodeAnim);
+        UINT uScaleIndex = findScaling(animationTimeTicks, pNodeAnim, uKeyCursor);
         UINT uNextScaleIndex = uScaleIndex + 1u;
         assert(uNextScaleIndex < pNodeAnim->mNumScalingKeys);
 
@@ -805,6 +2022,39 @@ namespace library
         outScale = ConvertVector3dToFloat3(start + factor * delta);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::interpolateTransform
+
+      Summary:  Interpolate the keyframes of a channel into the local
+                transform of its node
+
+      Args:     FLOAT animationTimeTicks
+                  Animation time
+                const aiNodeAnim* pNodeAnim
+                  Pointer to an assimp node anim object
+                ChannelCursor& cursor
+                  Keys the tracks of the channel were last sampled at
+
+      Modifies: [cursor].
+
+      Returns:  XMMATRIX
+                  Scaling, then rotation, then translation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Model::interpolateTransform(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ ChannelCursor& cursor)
+    {
+        XMFLOAT3 outScale = XMFLOAT3(), outTranslate = XMFLOAT3();
+        XMVECTOR outQuaternion = XMVECTOR();
+        interpolateScaling(outScale, animationTimeTicks, pNodeAnim, cursor.uScalingKey);
+        interpolateRotation(outQuaternion, animationTimeTicks, pNodeAnim, cursor.uRotationKey);
+        interpolatePosition(outTranslate, animationTimeTicks, pNodeAnim, cursor.uPositionKey);
+
+        XMMATRIX scalingMatrix = XMMatrixScalingFromVector(XMLoadFloat3(&outScale));
+        XMMATRIX rotationMatrix = XMMatrixRotationQuaternion(outQuaternion);
+        XMMATRIX translationMatrix = XMMatrixTranslationFromVector(XMLoadFloat3(&outTranslate));
+
+        return scalingMatrix * rotationMatrix * translationMatrix;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadDiffuseTexture
 
@@ -1033,6 +2283,9 @@ namespace library
       Method:   Model::readNodeHierarchy
 
       Summary:  Calculate bone transformation of the given assimp node
+                by walking the node tree, looking every node up by its
+                name. Kept as the reference evaluateSkeleton is
+                measured against
 
       Args:     FLOAT animationTimeTicks
                   Animation time
@@ -1046,17 +2299,8 @@ namespace library
         XMMATRIX nodeTransform = ConvertMatrix(pNode->mTransformation);
         const aiNodeAnim* pNodeAnim = findNodeAnimOrNull(m_pScene->mAnimations[0], pNode->mName.C_Str());
         if (pNodeAnim) {
-            XMFLOAT3 outScale = XMFLOAT3(), outTranslate = XMFLOAT3();
-            XMVECTOR outQuaternion = XMVECTOR();
-            interpolateScaling(outScale, animationTimeTicks, pNodeAnim);
-            interpolateRotation(outQuaternion, animationTimeTicks, pNodeAnim);
-            interpolatePosition(outTranslate, animationTimeTicks, pNodeAnim);
-
-            XMMATRIX scalingMatrix = XMMatrixScalingFromVector(XMLoadFloat3(&outScale));
-            XMMATRIX rotationMatrix = XMMatrixRotationQuaternion(outQuaternion);
-            XMMATRIX translationMatrix = XMMatrixTranslationFromVector(XMLoadFloat3(&outTranslate));
-
-            nodeTransform = scalingMatrix * rotationMatrix * translationMatrix;
+            ChannelCursor cursor = {};
+            nodeTransform = interpolateTransform(animationTimeTicks, pNodeAnim, cursor);
         }
 
         XMMATRIX globalTransformation = nodeTransform * parentTransform;
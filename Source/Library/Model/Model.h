@@ -12,6 +12,10 @@
 #pragma once
 
 #include "Common.h"
+#include "Model/AnimationBlending.h"
+#include "Model/AnimationClip.h"
+#include "Model/AnimationSampler.h"
+#include "Model/CompressedAnimationClip.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
@@ -33,13 +37,85 @@ namespace Assimp
 
 namespace library
 {
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkeletonEvaluationStatistics
+
+      Summary:  Time of evaluating the bone transforms of a model by
+                walking its node tree and with its flattened skeleton,
+                and the largest difference between the two
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkeletonEvaluationStatistics
+    {
+        UINT uNumNodes;
+        UINT uNumChannels;
+        UINT uNumFrames;
+        DOUBLE hierarchyMicroseconds;
+        DOUBLE flattenedMicroseconds;
+        FLOAT maxError;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationCompressionStatistics
+
+      Summary:  Keys and memory of the animation clip of a model before
+                and after compression, time of sampling both, and the
+                largest difference between the bone transforms of both
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationCompressionStatistics
+    {
+        UINT uNumKeys;
+        UINT uNumCompressedKeys;
+        size_t uSizeInBytes;
+        size_t uCompressedSizeInBytes;
+        UINT uNumFrames;
+        DOUBLE rawMicroseconds;
+        DOUBLE compressedMicroseconds;
+        FLOAT maxError;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AnimationBlendingStatistics
+
+      Summary:  Time of evaluating the bone transforms of a model
+                playing one clip, cross-fading between two clips, and
+                cross-fading with a masked additive layer on top
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AnimationBlendingStatistics
+    {
+        UINT uNumClips;
+        UINT uNumFrames;
+        DOUBLE singleMicroseconds;
+        DOUBLE crossFadeMicroseconds;
+        DOUBLE layeredMicroseconds;
+    };
+
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Model
 
-      Summary:  Model class is a renderable from model files
+      Summary:  Model class is a renderable from model files. The node
+                tree of the file is flattened at load time into an
+                array of nodes ordered parents first, each with the
+                index of its bone and parent. Every animation of the
+                file is copied into an AnimationClip over those nodes,
+                registered by its name and compressed, resampled at a
+                uniform rate by default, and frames are sampled from
+                the compressed clips four nodes at a time. The source
+                clips and the keys of the Assimp animations are then
+                released, unless kept to measure against.
+                Clips play on layers, the first over the bind pose and
+                every other over the layers below it, either replacing
+                or adding to their pose by a weight and a mask of nodes.
+                A layer cross-fades from the clip it played before.
+                Layers and fades are blended in local space, so the
+                bone transforms of a frame are one sampling pass per
+                clip playing, one blend pass per clip past the first,
+                and one pass over the array
 
       Methods:  Initialize
                   Pure virtual function that initializes the object
+                Load
+                  Reads the model file without Direct3D, optionally
+                  keeping the source animation
                 Update
                   Pure virtual function that updates the object each
                   frame
@@ -57,6 +133,36 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetSkinnedBoundingBox
+                  Returns the world space bounds of the posed
+                  vertices
+                GetNumAnimationClips
+                  Returns the number of registered clips
+                GetAnimationClipIndex
+                  Returns the index of a clip by its name
+                GetAnimationClip
+                  Returns the source clip of a registered clip, if
+                  kept
+                GetCompressedAnimationClip
+                  Returns the compressed clip of a registered clip
+                CompressAnimation
+                  Compresses every kept source clip again
+                PlayAnimation
+                  Cross-fades a layer to a clip
+                AddAnimationLayer
+                  Adds a layer over the others
+                SetAnimationLayerWeight
+                  Sets the weight of a layer
+                SetAnimationLayerMask
+                  Sets the weight of a node and its descendants on a
+                  layer
+                MeasureSkeletonEvaluation
+                  Times the node tree walk against the flattened
+                  skeleton
+                MeasureAnimationCompression
+                  Compares the compressed clip against the clip
+                MeasureAnimationBlending
+                  Times one clip against blended clips and layers
                 Model
                   Constructor.
                 ~Model
@@ -75,6 +181,8 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         virtual void Update(_In_ FLOAT deltaTime) override;
+        HRESULT Load();
+        HRESULT Load(_In_ const AnimationCompressionDesc& desc, _In_ BOOL bKeepSourceAnimation);
 
         ComPtr<ID3D11Buffer>& GetAnimationBuffer();
         ComPtr<ID3D11Buffer>& GetSkinningConstantBuffer();
@@ -83,7 +191,22 @@ namespace library
         virtual UINT GetNumIndices() const override;
 
         std::vector<XMMATRIX>& GetBoneTransforms();
+        BoundingBox GetSkinnedBoundingBox() const;
         const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        UINT GetNumAnimationClips() const;
+        INT GetAnimationClipIndex(_In_ PCSTR pszClipName) const;
+        const AnimationClip* GetAnimationClip(_In_ UINT uClip) const;
+        const CompressedAnimationClip& GetCompressedAnimationClip(_In_ UINT uClip) const;
+        HRESULT CompressAnimation(_In_ const AnimationCompressionDesc& desc);
+
+        HRESULT PlayAnimation(_In_ UINT uLayer, _In_ UINT uClip, _In_ FLOAT fadeSeconds);
+        HRESULT AddAnimationLayer(_In_ UINT uClip, _In_ eAnimationBlendMode blendMode, _In_ FLOAT weight, _Out_ UINT& uOutLayer);
+        HRESULT SetAnimationLayerWeight(_In_ UINT uLayer, _In_ FLOAT weight);
+        HRESULT SetAnimationLayerMask(_In_ UINT uLayer, _In_ PCSTR pszNodeName, _In_ FLOAT weight);
+
+        SkeletonEvaluationStatistics MeasureSkeletonEvaluation(_In_ UINT uNumFrames);
+        AnimationCompressionStatistics MeasureAnimationCompression(_In_ UINT uNumFrames);
+        AnimationBlendingStatistics MeasureAnimationBlending(_In_ UINT uNumFrames);
 
     protected:
         struct VertexBoneData
@@ -129,11 +252,53 @@ namespace library
             XMMATRIX FinalTransformation;
         };
 
+        // Node of the flattened skeleton. Parents come before their
+        // children, a missing bone or parent is -1, and a node no
+        // animation has a channel for keeps its transformation
+        struct SkeletonNode
+        {
+            XMMATRIX Transformation;
+            INT iParent;
+            INT iBone;
+            BOOL bAnimated;
+        };
+
+        // Clip a layer plays and its time in ticks, the clip it fades
+        // out from, if any, and how it blends over the layers below.
+        // An empty mask weighs every node fully; an additive layer
+        // adds the difference from the first frame of its clip. Each
+        // of the two clips has a sampler of its own, so layers playing
+        // the same clip keep their own key cursors
+        struct AnimationLayer
+        {
+            eAnimationBlendMode BlendMode;
+            FLOAT weight;
+            UINT uClip;
+            FLOAT time;
+            INT iFadingClip;
+            FLOAT fadingTime;
+            FLOAT fadeElapsedSeconds;
+            FLOAT fadeSeconds;
+            std::vector<XMVECTOR> aMask;
+            std::vector<SoaTransform> aReferencePose;
+            std::unique_ptr<AnimationSampler> pSampler;
+            std::unique_ptr<AnimationSampler> pFadingSampler;
+        };
+
+        // Keys the position, rotation and scaling tracks of a channel
+        // were last sampled at when walking the node tree
+        struct ChannelCursor
+        {
+            UINT uPositionKey;
+            UINT uRotationKey;
+            UINT uScalingKey;
+        };
+
         void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
         const aiNodeAnim* findNodeAnimOrNull(_In_ const aiAnimation* pAnimation, _In_ PCSTR pszNodeName);
-        UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
+        UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
+        UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
         UINT getBoneId(_In_ const aiBone* pBone);
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
@@ -153,9 +318,18 @@ namespace library
         void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
         void initMeshSingleBone(_In_ UINT uBoneIndex, _In_ const aiBone* pBone);
         void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
-        void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        void initBoneBoundingBoxes();
+        HRESULT initSkeleton(_In_ const aiScene* pScene, _In_ const AnimationCompressionDesc& desc);
+        void releaseSourceAnimation();
+        void evaluateSkeleton(_Inout_ AnimationSampler& sampler, _In_ FLOAT animationTimeTicks);
+        void evaluateLayers();
+        void sampleLayer(_Inout_ AnimationLayer& layer, _Out_ SoaTransform* pOutPose);
+        void applyPose();
+        FLOAT advanceTime(_In_ UINT uClip, _In_ FLOAT time, _In_ FLOAT deltaTime) const;
+        void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
+        void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
+        void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ UINT& uKeyCursor);
+        XMMATRIX interpolateTransform(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim, _Inout_ ChannelCursor& cursor);
         HRESULT loadDiffuseTexture(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext,
@@ -202,7 +376,20 @@ namespace library
         std::vector<VertexBoneData> m_aBoneData;
         std::vector<BoneInfo> m_aBoneInfo;
         std::vector<XMMATRIX> m_aTransforms;
+        std::vector<BoundingBox> m_aBoneBoundingBoxes;
         std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
+        std::vector<SkeletonNode> m_aSkeletonNodes;
+        std::unordered_map<std::string, UINT> m_nodeNameToIndexMap;
+        std::vector<XMMATRIX> m_aLocalTransforms;
+        std::vector<XMMATRIX> m_aGlobalTransforms;
+        std::vector<std::unique_ptr<AnimationClip>> m_apAnimationClips;
+        std::vector<std::unique_ptr<CompressedAnimationClip>> m_apCompressedAnimationClips;
+        std::unordered_map<std::string, UINT> m_clipNameToIndexMap;
+        std::vector<AnimationLayer> m_aAnimationLayers;
+        std::vector<SoaTransform> m_aBindPose;
+        std::vector<SoaTransform> m_aPose;
+        std::vector<SoaTransform> m_aLayerPose;
+        std::vector<SoaTransform> m_aFadePose;
 
         const aiScene* m_pScene;
 
@@ -20,6 +20,16 @@ namespace library
         XMMATRIX Transformation;
     };
 
+    struct PackedVoxelInstance
+    {
+        UINT Packed;
+    };
+
+    struct PackedVoxelLight
+    {
+        XMUINT2 Packed;
+    };
+
     struct AnimationData
     {
         XMUINT4 aBoneIndices;
@@ -49,6 +59,11 @@ namespace library
         XMMATRIX BoneTransforms[MAX_NUM_BONES];
     };
 
+    struct CBVoxelChunk
+    {
+        XMFLOAT4 ChunkOrigin;
+    };
+
     struct CBLights
     {
         XMFLOAT4 LightPositions[NUM_LIGHTS];
@@ -13,8 +13,9 @@ namespace library
     InstancedRenderable::InstancedRenderable(_In_ const XMFLOAT4& outputColor)
         : Renderable(outputColor)
         , m_instanceBuffer(nullptr)
-        , m_aInstanceData()
-        , m_padding()
+        , m_pInstanceArena(std::make_shared<std::vector<InstanceData>>())
+        , m_uFirstInstance(0u)
+        , m_uNumInstances(0u)
     {
     }
 
@@ -28,13 +29,15 @@ namespace library
                 const XMFLOAT4& outputColor
                   Default color of the renderable
 
-      Modifies: [m_instanceBuffer, m_aInstanceData].
+      Modifies: [m_instanceBuffer, m_pInstanceArena, m_uFirstInstance,
+                 m_uNumInstances].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     InstancedRenderable::InstancedRenderable(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor) 
         : Renderable(outputColor)
         , m_instanceBuffer(nullptr)
-        , m_aInstanceData(move(aInstanceData))
-        , m_padding()
+        , m_pInstanceArena(std::make_shared<std::vector<InstanceData>>(std::move(aInstanceData)))
+        , m_uFirstInstance(0u)
+        , m_uNumInstances(static_cast<UINT>(m_pInstanceArena->size()))
     {
     }
 
@@ -46,10 +49,35 @@ namespace library
       Args:     std::vector<InstanceData>&& aInstanceData
                   Instance data
 
-      Modifies: [m_aInstanceData].
+      Modifies: [m_pInstanceArena, m_uFirstInstance, m_uNumInstances].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void InstancedRenderable::SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData) {
-        m_aInstanceData = aInstanceData;
+        m_pInstanceArena = std::make_shared<std::vector<InstanceData>>(std::move(aInstanceData));
+        m_uFirstInstance = 0u;
+        m_uNumInstances = static_cast<UINT>(m_pInstanceArena->size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::SetInstanceData
+
+      Summary:  Sets the instance data to a range of an arena shared
+                with other instanced renderables
+
+      Args:     const std::shared_ptr<std::vector<InstanceData>>& pInstanceArena
+                  Shared instance arena
+                UINT uFirstInstance
+                  Index of the first instance in the arena
+                UINT uNumInstances
+                  Number of instances
+
+      Modifies: [m_pInstanceArena, m_uFirstInstance, m_uNumInstances].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void InstancedRenderable::SetInstanceData(_In_ const std::shared_ptr<std::vector<InstanceData>>& pInstanceArena, _In_ UINT uFirstInstance, _In_ UINT uNumInstances) {
+        assert(static_cast<size_t>(uFirstInstance) + uNumInstances <= pInstanceArena->size());
+
+        m_pInstanceArena = pInstanceArena;
+        m_uFirstInstance = uFirstInstance;
+        m_uNumInstances = uNumInstances;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -73,13 +101,14 @@ namespace library
                   Number of instances
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     UINT InstancedRenderable::GetNumInstances() const {
-        return static_cast<UINT>(m_aInstanceData.size());
+        return m_uNumInstances;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::initializeInstance
 
-      Summary:  Creates an instance buffer
+      Summary:  Creates an instance buffer, unless there are no
+                instances
 
       Args:     ID3D11Device* pDevice
                   Pointer to a Direct3D 11 device
@@ -90,6 +119,12 @@ namespace library
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT InstancedRenderable::initializeInstance(_In_ ID3D11Device* pDevice) {
+        // Voxels of a chunked map keep their instances in the chunks
+        if (GetNumInstances() == 0u)
+        {
+            return S_OK;
+        }
+
         D3D11_BUFFER_DESC bd =
         {
             .ByteWidth = sizeof(InstanceData) * GetNumInstances(),
@@ -99,7 +134,7 @@ namespace library
         };
         D3D11_SUBRESOURCE_DATA initData =
         {
-            .pSysMem = m_aInstanceData.data()
+            .pSysMem = m_pInstanceArena->data() + m_uFirstInstance
         };
 
         HRESULT hr = pDevice->CreateBuffer(&bd, &initData, m_instanceBuffer.GetAddressOf());
@@ -24,7 +24,8 @@ namespace library
       Summary:  Base class for renderable 3d cube object
 
       Methods:  SetInstanceData
-                  Sets the instance data
+                  Sets the instance data, either owned or as a range
+                  of an arena shared with other renderables
                 GetInstanceBuffer
                   Returns a instance buffer
                 GetNumInstances
@@ -51,6 +52,7 @@ namespace library
         virtual void Update(_In_ FLOAT deltaTime) override = 0;
 
         void SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData);
+        void SetInstanceData(_In_ const std::shared_ptr<std::vector<InstanceData>>& pInstanceArena, _In_ UINT uFirstInstance, _In_ UINT uNumInstances);
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
@@ -66,9 +68,8 @@ namespace library
 
     protected:
         ComPtr<ID3D11Buffer> m_instanceBuffer;
-        std::vector<InstanceData> m_aInstanceData;
-
-    private:
-        BYTE m_padding[8];
+        std::shared_ptr<std::vector<InstanceData>> m_pInstanceArena;
+        UINT m_uFirstInstance;
+        UINT m_uNumInstances;
     };
 }
\ No newline at end of file
@@ -17,7 +17,7 @@ namespace library
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_textureRV, m_samplerLinear, m_vertexShader,
                  m_pixelShader, m_textureFilePath, m_outputColor,
-                 m_world].
+                 m_world, m_boundingBox].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Renderable::Renderable definition (remove the comment)
@@ -35,6 +35,7 @@ namespace library
         , m_padding()
         , m_outputColor(outputColor)
         , m_world(XMMatrixIdentity())
+        , m_boundingBox()
         , m_bHasNormalMap()
     {
     }
@@ -42,14 +43,16 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::initialize
 
-      Summary:  Initializes the buffers, texture, and the world matrix
+      Summary:  Initializes the buffers, texture, and the world matrix,
+                and computes the bounds of the vertices
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer, m_constantBuffer].
+      Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer, m_constantBuffer,
+                 m_boundingBox].
 
       Returns:  HRESULT
                   Status code
@@ -80,6 +83,11 @@ namespace library
 
         if (FAILED(hr)) return hr;
 
+        if (GetNumVertices() > 0u)
+        {
+            BoundingBox::CreateFromPoints(m_boundingBox, GetNumVertices(), &getVertices()->Position, sizeof(SimpleVertex));
+        }
+
         UINT stride = sizeof(SimpleVertex);
         UINT offset = 0;
 
@@ -456,6 +464,21 @@ namespace library
         return m_world;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBoundingBox
+
+      Summary:  Returns the bounds of the vertices as they were
+                uploaded, moved by the world matrix
+
+      Returns:  BoundingBox
+                  World space bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox Renderable::GetBoundingBox() const {
+        BoundingBox boundingBox;
+        m_boundingBox.Transform(boundingBox, m_world);
+        return boundingBox;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetOutputColor
 
@@ -39,6 +39,8 @@ namespace library
                   Returns the constant buffer
                 GetWorldMatrix
                   Returns the world matrix
+                GetBoundingBox
+                  Returns the world space bounds of the vertices
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
@@ -98,6 +100,7 @@ namespace library
         ComPtr<ID3D11Buffer>& GetNormalBuffer();
 
         const XMMATRIX& GetWorldMatrix() const;
+        BoundingBox GetBoundingBox() const;
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const std::shared_ptr<Material>& GetMaterial(UINT uIndex) const;
@@ -144,6 +147,7 @@ namespace library
         XMFLOAT4 m_outputColor;
         BYTE m_padding[8];
         XMMATRIX m_world;
+        BoundingBox m_boundingBox;
         BOOL m_bHasNormalMap;
     };
 }
\ No newline at end of file
@@ -11,8 +11,8 @@ namespace library
                  m_immediateContext, m_immediateContext1, m_swapChain,
                  m_swapChain1, m_renderTargetView, m_depthStencil,
                  m_depthStencilView, m_cbChangeOnResize, m_camera,
-                 m_projection, m_renderables, m_vertexShaders,
-                 m_pixelShaders].
+                 m_projection, m_uClientWidth, m_uClientHeight,
+                 m_renderables, m_vertexShaders, m_pixelShaders].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderer::Renderer()
         : m_driverType(D3D_DRIVER_TYPE_NULL)
@@ -27,10 +27,13 @@ namespace library
         , m_depthStencil()
         , m_depthStencilView()
         , m_cbChangeOnResize()
+        , m_fullSkyLightBuffer()
         , m_pszMainSceneName(nullptr)
         , m_padding{ '\0' }
         , m_camera(XMVectorSet(0.0f, 3.0f, -6.0f, 0.0f))
         , m_projection()
+        , m_uClientWidth(0u)
+        , m_uClientHeight(0u)
         , m_scenes()
         , m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
     {
@@ -47,7 +50,8 @@ namespace library
       Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
                  m_d3dDevice1, m_immediateContext1, m_swapChain1,
                  m_swapChain, m_renderTargetView, m_cbChangeOnResize,
-                 m_projection, m_camera, m_vertexShaders,
+                 m_fullSkyLightBuffer, m_projection, m_uClientWidth,
+                 m_uClientHeight, m_camera, m_vertexShaders,
                  m_pixelShaders, m_renderables].
 
       Returns:  HRESULT
@@ -61,6 +65,8 @@ namespace library
         GetClientRect(hWnd, &rc);
         UINT uWidth = static_cast<UINT>(rc.right - rc.left);
         UINT uHeight = static_cast<UINT>(rc.bottom - rc.top);
+        m_uClientWidth = uWidth;
+        m_uClientHeight = uHeight;
 
         UINT uCreateDeviceFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 #if defined(DEBUG) || defined(_DEBUG)
@@ -258,7 +264,7 @@ namespace library
         }
 
         // Initialize the projection matrix
-        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), 0.01f, 1000.0f);
+        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), NEAR_PLANE, FAR_PLANE);
 
         CBChangeOnResize cbChangesOnResize =
         {
@@ -283,6 +289,29 @@ namespace library
         m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
         m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
 
+        // Voxel chunks without baked light read this one entry, every
+        // face in full sky
+        const BYTE fullSky = VoxelLightField::FULL_SKY;
+        const UINT uFullSkyWord = fullSky | (fullSky << 8u) | (fullSky << 16u) | (fullSky << 24u);
+        const PackedVoxelLight fullSkyLight =
+        {
+            .Packed = XMUINT2(uFullSkyWord, uFullSkyWord)
+        };
+        bd.ByteWidth = sizeof(PackedVoxelLight);
+        bd.Usage = D3D11_USAGE_IMMUTABLE;
+        bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        bd.CPUAccessFlags = 0u;
+        D3D11_SUBRESOURCE_DATA initData =
+        {
+            .pSysMem = &fullSkyLight
+        };
+
+        hr = m_d3dDevice->CreateBuffer(&bd, &initData, m_fullSkyLightBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
         m_camera.Initialize(m_d3dDevice.Get());
 
         if (!m_scenes.contains(m_pszMainSceneName))
@@ -406,12 +435,52 @@ namespace library
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
+
+      Modifies: [m_camera].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Update(_In_ FLOAT deltaTime)
     {
         m_scenes[m_pszMainSceneName]->Update(deltaTime);
 
+        XMFLOAT3 previousEye;
+        XMStoreFloat3(&previousEye, m_camera.GetEye());
+
         m_camera.Update(deltaTime);
+
+        // The camera slides along the terrain instead of flying into it.
+        // The resting center is applied even when nothing stopped the
+        // move, because a camera that started inside the terrain was
+        // pushed out of it, and it is the whole move without a collider
+        XMFLOAT3 eye;
+        XMStoreFloat3(&eye, m_camera.GetEye());
+        VoxelSweepResult cameraSweep;
+        m_scenes[m_pszMainSceneName]->CollideVoxels(
+            BoundingBox(previousEye, XMFLOAT3(0.5f, 0.5f, 0.5f)),
+            XMFLOAT3(eye.x - previousEye.x, eye.y - previousEye.y, eye.z - previousEye.z),
+            cameraSweep
+        );
+        m_camera.SetEye(XMLoadFloat3(&cameraSweep.center));
+
+        // Streamed terrain follows the camera after it moved
+        if (FAILED(m_scenes[m_pszMainSceneName]->UpdateTerrainStreaming(m_camera.GetEye(), m_d3dDevice.Get())))
+        {
+            OutputDebugString(L"Renderer: failed to upload streamed voxel chunks\n");
+        }
+
+        // Rebuilt voxel chunks are uploaded a frame or two after an edit
+        if (FAILED(m_scenes[m_pszMainSceneName]->UpdateVoxelEdits(m_d3dDevice.Get(), m_immediateContext.Get())))
+        {
+            OutputDebugString(L"Renderer: failed to upload edited voxel chunks\n");
+        }
+
+        // Chunks whose light or instances changed are baked again
+        if (FAILED(m_scenes[m_pszMainSceneName]->UpdateVoxelLight(m_d3dDevice.Get(), m_immediateContext.Get())))
+        {
+            OutputDebugString(L"Renderer: failed to upload baked voxel light\n");
+        }
+
+        // Distant voxel chunks switch to coarser levels of detail
+        m_scenes[m_pszMainSceneName]->UpdateVoxelLods(m_camera.GetEye());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -443,6 +512,12 @@ namespace library
 
         std::shared_ptr<library::Scene> mainScene = m_scenes[m_pszMainSceneName];
 
+        BoundingFrustum frustum;
+        BoundingFrustum::CreateFromMatrix(frustum, m_projection);
+        frustum.Transform(frustum, XMMatrixInverse(nullptr, m_camera.GetView()));
+        m_voxelCullingStatistics = mainScene->CullVoxelChunks(frustum, m_auVisibleVoxelChunks);
+        m_occlusionCullingStatistics = mainScene->CullOccludedVoxelChunks(m_camera.GetView(), m_projection, m_auVisibleVoxelChunks, m_voxelCullingStatistics);
+
         for (int i = 0; i < NUM_LIGHTS; i++) {
             if (!mainScene->GetPointLight(i)) continue;
             cbLights.LightPositions[i] = mainScene->GetPointLight(i)->GetPosition();
@@ -479,6 +554,10 @@ namespace library
             UINT offsets[2] = { 0u,0u };
 
             auto& renderable = i->second;
+            if (mainScene->IsOccluded(renderable->GetBoundingBox()))
+            {
+                continue;
+            }
 
             m_immediateContext->IASetVertexBuffers(
                 0,
@@ -591,7 +670,9 @@ namespace library
             }
         }
 
-        for (auto& voxel : mainScene->GetVoxels()) {
+        for (UINT uVoxelIndex = 0u; uVoxelIndex < mainScene->GetVoxels().size(); ++uVoxelIndex) {
+            std::shared_ptr<Voxel>& voxel = mainScene->GetVoxels()[uVoxelIndex];
+
             UINT strides[3] = { sizeof(SimpleVertex), sizeof(NormalData), sizeof(InstanceData)};
             UINT offsets[3] = { 0u, 0u, 0u };
 
@@ -692,6 +773,64 @@ namespace library
             else {
                 m_immediateContext->DrawIndexedInstanced(voxel->GetNumIndices(), voxel->GetNumInstances(), 0, 0, 0);
             }
+
+            drawVisibleVoxelChunks(*mainScene, uVoxelIndex, voxel->GetNumIndices());
+        }
+
+        for (auto& voxelChunkMesh : mainScene->GetVoxelChunkMeshes()) {
+            UINT uStride = sizeof(SimpleVertex);
+            UINT uOffset = 0u;
+
+            m_immediateContext->IASetVertexBuffers(
+                0,
+                1,
+                voxelChunkMesh->GetVertexBuffer().GetAddressOf(),
+                &uStride,
+                &uOffset
+            );
+
+            m_immediateContext->IASetIndexBuffer(
+                voxelChunkMesh->GetIndexBuffer().Get(),
+                DXGI_FORMAT_R16_UINT,
+                0
+            );
+
+            m_immediateContext->IASetInputLayout(
+                voxelChunkMesh->GetVertexLayout().Get()
+            );
+
+            m_immediateContext->VSSetShader(voxelChunkMesh->GetVertexShader().Get(), nullptr, 0);
+            m_immediateContext->PSSetShader(voxelChunkMesh->GetPixelShader().Get(), nullptr, 0);
+            m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+            m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+            m_immediateContext->VSSetConstantBuffers(2, 1, voxelChunkMesh->GetConstantBuffer().GetAddressOf());
+            m_immediateContext->PSSetConstantBuffers(2, 1, voxelChunkMesh->GetConstantBuffer().GetAddressOf());
+            m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+            m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+
+            // One mesh per block type, each drawn with the color of its type
+            for (UINT j = 0u; j < voxelChunkMesh->GetNumMeshes(); j++) {
+                CBChangesEveryFrame cbRenderable = {
+                    .World = XMMatrixTranspose(voxelChunkMesh->GetWorldMatrix()),
+                    .OutputColor = voxelChunkMesh->GetMeshColor(j),
+                    .HasNormalMap = FALSE
+                };
+
+                m_immediateContext->UpdateSubresource(
+                    voxelChunkMesh->GetConstantBuffer().Get(),
+                    0,
+                    nullptr,
+                    &cbRenderable,
+                    0,
+                    0
+                );
+
+                m_immediateContext->DrawIndexed(
+                    voxelChunkMesh->GetMesh(j).uNumIndices,
+                    voxelChunkMesh->GetMesh(j).uBaseIndex,
+                    voxelChunkMesh->GetMesh(j).uBaseVertex
+                );
+            }
         }
 
         for (auto& model : mainScene->GetModels()) {
@@ -700,6 +839,13 @@ namespace library
 
             auto& renderable = model.second;
 
+            // Skinned vertices leave the bind pose bounds, so the
+            // bounds of the current pose are tested
+            if (mainScene->IsOccluded(renderable->GetSkinnedBoundingBox()))
+            {
+                continue;
+            }
+
             ID3D11Buffer* aBuffers[2]
             {
                 renderable->GetVertexBuffer().Get(),
@@ -930,4 +1076,182 @@ namespace library
     D3D_DRIVER_TYPE Renderer::GetDriverType() const {
         return m_driverType;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetVoxelCullingStatistics
+
+      Summary:  Returns the voxel chunks and instances that passed the
+                frustum test in the last frame
+
+      Returns:  const VoxelCullingStatistics&
+                  Culling statistics of the last frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelCullingStatistics& Renderer::GetVoxelCullingStatistics() const
+    {
+        return m_voxelCullingStatistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetOcclusionCullingStatistics
+
+      Summary:  Returns the occluders drawn into the software depth
+                buffer in the last frame and the chunks they hid
+
+      Returns:  const OcclusionCullingStatistics&
+                  Occlusion culling statistics of the last frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const OcclusionCullingStatistics& Renderer::GetOcclusionCullingStatistics() const
+    {
+        return m_occlusionCullingStatistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::PickVoxel
+
+      Summary:  Casts the ray of the camera through a point of the
+                screen, such as the mouse cursor, against the voxels of
+                the main scene as far as the far plane
+
+      Args:     FLOAT screenX
+                  Horizontal position in pixels from the left
+                FLOAT screenY
+                  Vertical position in pixels from the top
+                UINT uWidth
+                  Width of the client area
+                UINT uHeight
+                  Height of the client area
+                VoxelRayHit& outHit
+                  Voxel under the point, bHit is FALSE if there is none
+
+      Returns:  BOOL
+                  TRUE if a voxel is under the point
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderer::PickVoxel(_In_ FLOAT screenX, _In_ FLOAT screenY, _In_ UINT uWidth, _In_ UINT uHeight, _Out_ VoxelRayHit& outHit)
+    {
+        XMFLOAT3 origin;
+        XMFLOAT3 direction;
+        m_camera.GetPickingRay(screenX, screenY, uWidth, uHeight, m_projection, origin, direction);
+
+        return m_scenes[m_pszMainSceneName]->RaycastVoxels(origin, direction, FAR_PLANE, outHit);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::HandleMouseClick
+
+      Summary:  Picks the voxel under the cursor of a click. A left
+                click removes it, a right click places a block of the
+                same type against the face the ray entered it through.
+                The edit shows once UpdateVoxelEdits rebuilds its chunk
+
+      Args:     const MouseClickInput& mouseClick
+                  Pressed mouse buttons and cursor position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::HandleMouseClick(_In_ const MouseClickInput& mouseClick)
+    {
+        if (!mouseClick.bLeft && !mouseClick.bRight)
+        {
+            return;
+        }
+
+        VoxelRayHit hit;
+        if (!PickVoxel(static_cast<FLOAT>(mouseClick.X), static_cast<FLOAT>(mouseClick.Y), m_uClientWidth, m_uClientHeight, hit))
+        {
+            return;
+        }
+
+        HRESULT hr = S_OK;
+        if (mouseClick.bLeft)
+        {
+            hr = m_scenes[m_pszMainSceneName]->RemoveBlock(hit.voxel);
+        }
+        else if (hit.normal.x != 0 || hit.normal.y != 0 || hit.normal.z != 0)
+        {
+            // A neighbor below zero wraps around and is rejected as
+            // outside the terrain
+            hr = m_scenes[m_pszMainSceneName]->PlaceBlock(
+                XMUINT3(
+                    hit.voxel.x + static_cast<UINT>(hit.normal.x),
+                    hit.voxel.y + static_cast<UINT>(hit.normal.y),
+                    hit.voxel.z + static_cast<UINT>(hit.normal.z)
+                ),
+                hit.blockType
+            );
+        }
+
+        if (FAILED(hr))
+        {
+            OutputDebugString(L"Renderer: failed to edit the picked voxel\n");
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::drawVisibleVoxelChunks
+
+      Summary:  Draws the instances of a voxel in every chunk that
+                passed the frustum test. Switches to the vertex shader
+                of the voxel chunks, which decodes the packed instances
+                relative to the origin of each chunk, and to their
+                pixel shader if the scene has one. The light baked for
+                the instances streams alongside them; chunks without
+                it read a single full sky entry. Expects the rest of
+                the pipeline state of the voxel to be set
+
+      Args:     Scene& scene
+                  Scene that owns the voxel chunks
+                UINT uVoxelIndex
+                  Index of the voxel in the scene
+                UINT uNumIndices
+                  Number of indices to draw per instance
+
+      Modifies: [m_immediateContext].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::drawVisibleVoxelChunks(_In_ Scene& scene, _In_ UINT uVoxelIndex, _In_ UINT uNumIndices)
+    {
+        std::shared_ptr<VertexShader>& vertexShader = scene.GetVertexShaderOfVoxelChunks();
+        if (!vertexShader)
+        {
+            return;
+        }
+
+        std::shared_ptr<PixelShader>& pixelShader = scene.GetPixelShaderOfVoxelChunks();
+        std::vector<std::shared_ptr<VoxelChunk>>& voxelChunks = scene.GetVoxelChunks();
+        const UINT uStride = sizeof(PackedVoxelInstance);
+        const UINT uLightStride = sizeof(PackedVoxelLight);
+        const UINT uFullSkyStride = 0u;
+        const UINT uOffset = 0u;
+        BOOL bShaderSet = FALSE;
+
+        for (UINT uChunk : m_auVisibleVoxelChunks)
+        {
+            VoxelChunk& voxelChunk = *voxelChunks[uChunk];
+            VoxelInstanceRange instanceRange = voxelChunk.GetInstanceRange(uVoxelIndex);
+            if (instanceRange.uNumInstances == 0u)
+            {
+                continue;
+            }
+
+            if (!bShaderSet)
+            {
+                m_immediateContext->IASetInputLayout(vertexShader->GetVertexLayout().Get());
+                m_immediateContext->VSSetShader(vertexShader->GetVertexShader().Get(), nullptr, 0);
+                if (pixelShader)
+                {
+                    m_immediateContext->PSSetShader(pixelShader->GetPixelShader().Get(), nullptr, 0);
+                }
+                bShaderSet = TRUE;
+            }
+
+            m_immediateContext->IASetVertexBuffers(2, 1, voxelChunk.GetInstanceBuffer().GetAddressOf(), &uStride, &uOffset);
+            if (voxelChunk.GetLightBuffer())
+            {
+                m_immediateContext->IASetVertexBuffers(3, 1, voxelChunk.GetLightBuffer().GetAddressOf(), &uLightStride, &uOffset);
+            }
+            else
+            {
+                m_immediateContext->IASetVertexBuffers(3, 1, m_fullSkyLightBuffer.GetAddressOf(), &uFullSkyStride, &uOffset);
+            }
+            m_immediateContext->VSSetConstantBuffers(4, 1, voxelChunk.GetConstantBuffer().GetAddressOf());
+            m_immediateContext->DrawIndexedInstanced(uNumIndices, instanceRange.uNumInstances, 0u, 0, instanceRange.uFirstInstance);
+        }
+    }
 }
\ No newline at end of file
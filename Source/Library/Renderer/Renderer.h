@@ -42,6 +42,15 @@ namespace library
                   Renders the frame
                 GetDriverType
                   Returns the Direct3D driver type
+                GetVoxelCullingStatistics
+                  Returns the voxel chunks culled in the last frame
+                GetOcclusionCullingStatistics
+                  Returns the occluders drawn and the chunks they hid
+                  in the last frame
+                PickVoxel
+                  Returns the voxel under a point of the screen
+                HandleMouseClick
+                  Removes or places a block at the clicked voxel
                 Renderer
                   Constructor.
                 ~Renderer
@@ -50,6 +59,9 @@ namespace library
     class Renderer final
     {
     public:
+        static constexpr const FLOAT NEAR_PLANE = 0.01f;
+        static constexpr const FLOAT FAR_PLANE = 1000.0f;
+
         Renderer();
         Renderer(const Renderer& other) = delete;
         Renderer(Renderer&& other) = delete;
@@ -68,6 +80,13 @@ namespace library
         void Render();
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        const VoxelCullingStatistics& GetVoxelCullingStatistics() const;
+        const OcclusionCullingStatistics& GetOcclusionCullingStatistics() const;
+        BOOL PickVoxel(_In_ FLOAT screenX, _In_ FLOAT screenY, _In_ UINT uWidth, _In_ UINT uHeight, _Out_ VoxelRayHit& outHit);
+        void HandleMouseClick(_In_ const MouseClickInput& mouseClick);
+
+    private:
+        void drawVisibleVoxelChunks(_In_ Scene& scene, _In_ UINT uVoxelIndex, _In_ UINT uNumIndices);
 
     private:
         D3D_DRIVER_TYPE m_driverType;
@@ -83,12 +102,19 @@ namespace library
         ComPtr<ID3D11DepthStencilView> m_depthStencilView;
         ComPtr<ID3D11Buffer> m_cbChangeOnResize;
         ComPtr<ID3D11Buffer> m_cbLights;
+        ComPtr<ID3D11Buffer> m_fullSkyLightBuffer;
         PCWSTR m_pszMainSceneName;
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
+        UINT m_uClientWidth;
+        UINT m_uClientHeight;
 
         std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
         std::shared_ptr<Texture> m_invalidTexture;
+
+        VoxelCullingStatistics m_voxelCullingStatistics;
+        OcclusionCullingStatistics m_occlusionCullingStatistics;
+        std::vector<UINT> m_auVisibleVoxelChunks;
     };
 }
\ No newline at end of file
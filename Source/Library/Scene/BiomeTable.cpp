@@ -0,0 +1,421 @@
+#include "Scene/BiomeTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <immintrin.h>
+#include <limits>
+
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::BiomeTable
+
+      Summary:  Constructor. The table classifies every column as
+                GRASSLAND until it is created
+
+      Modifies: [m_uNumHeightBreakpoints, m_uNumMoistureBreakpoints,
+                 m_aHeightBreakpoints, m_aMoistureBreakpoints,
+                 m_aBlockTypes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BiomeTable::BiomeTable()
+        : m_uNumHeightBreakpoints(0u)
+        , m_uNumMoistureBreakpoints(0u)
+        , m_aHeightBreakpoints()
+        , m_aMoistureBreakpoints()
+        , m_aBlockTypes()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::Create
+
+      Summary:  Fills the table. A column whose height reaches h
+                breakpoints and whose moisture reaches m breakpoints is
+                classified as the block type at row h and column m
+
+      Args:     const std::vector<FLOAT>& aHeightBreakpoints
+                  Increasing heights that start a new band
+                const std::vector<FLOAT>& aMoistureBreakpoints
+                  Increasing moistures that start a new band
+                const std::vector<BYTE>& aBlockTypes
+                  Palette indices of the block types, one row of
+                  moisture bands per height band
+
+      Modifies: [m_uNumHeightBreakpoints, m_uNumMoistureBreakpoints,
+                 m_aHeightBreakpoints, m_aMoistureBreakpoints,
+                 m_aBlockTypes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BiomeTable::Create(
+        _In_ const std::vector<FLOAT>& aHeightBreakpoints,
+        _In_ const std::vector<FLOAT>& aMoistureBreakpoints,
+        _In_ const std::vector<BYTE>& aBlockTypes
+    )
+    {
+        if (aHeightBreakpoints.size() > MAX_NUM_BREAKPOINTS || aMoistureBreakpoints.size() > MAX_NUM_BREAKPOINTS ||
+            !std::is_sorted(aHeightBreakpoints.begin(), aHeightBreakpoints.end()) ||
+            !std::is_sorted(aMoistureBreakpoints.begin(), aMoistureBreakpoints.end()))
+        {
+            return E_INVALIDARG;
+        }
+
+        size_t uNumHeightBands = aHeightBreakpoints.size() + 1u;
+        size_t uNumMoistureBands = aMoistureBreakpoints.size() + 1u;
+        if (aBlockTypes.size() != uNumHeightBands * uNumMoistureBands)
+        {
+            return E_INVALIDARG;
+        }
+
+        constexpr const BYTE NUM_BLOCK_TYPES = static_cast<BYTE>(eBlockType::COUNT) - static_cast<BYTE>(eBlockType::GRASSLAND);
+        if (std::any_of(aBlockTypes.begin(), aBlockTypes.end(), [](BYTE blockType) { return blockType >= NUM_BLOCK_TYPES; }))
+        {
+            return E_INVALIDARG;
+        }
+
+        // Unused breakpoints are never reached, so the batch path can
+        // compare against all of them
+        m_uNumHeightBreakpoints = static_cast<UINT>(aHeightBreakpoints.size());
+        m_uNumMoistureBreakpoints = static_cast<UINT>(aMoistureBreakpoints.size());
+        std::fill(std::begin(m_aHeightBreakpoints), std::end(m_aHeightBreakpoints), std::numeric_limits<FLOAT>::infinity());
+        std::fill(std::begin(m_aMoistureBreakpoints), std::end(m_aMoistureBreakpoints), std::numeric_limits<FLOAT>::infinity());
+        std::copy(aHeightBreakpoints.begin(), aHeightBreakpoints.end(), m_aHeightBreakpoints);
+        std::copy(aMoistureBreakpoints.begin(), aMoistureBreakpoints.end(), m_aMoistureBreakpoints);
+
+        std::fill(std::begin(m_aBlockTypes), std::end(m_aBlockTypes), static_cast<BYTE>(0u));
+        for (size_t uHeightBand = 0u; uHeightBand < uNumHeightBands; ++uHeightBand)
+        {
+            for (size_t uMoistureBand = 0u; uMoistureBand < uNumMoistureBands; ++uMoistureBand)
+            {
+                m_aBlockTypes[uHeightBand * TABLE_SIZE + uMoistureBand] = aBlockTypes[uHeightBand * uNumMoistureBands + uMoistureBand];
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::CreateFromThresholds
+
+      Summary:  Fills the table so that it classifies columns the same
+                way as the height bands and per band moisture
+                thresholds. The moisture breakpoints are the union of
+                the thresholds of all bands, and the bands that start
+                above a height start at the next representable value
+
+      Args:     const TerrainBiomeThresholds& thresholds
+                  Biome thresholds
+
+      Modifies: [m_uNumHeightBreakpoints, m_uNumMoistureBreakpoints,
+                 m_aHeightBreakpoints, m_aMoistureBreakpoints,
+                 m_aBlockTypes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BiomeTable::CreateFromThresholds(_In_ const TerrainBiomeThresholds& thresholds)
+    {
+        constexpr const FLOAT INF = std::numeric_limits<FLOAT>::infinity();
+
+        std::vector<FLOAT> aHeightBreakpoints =
+        {
+            thresholds.oceanHeight,
+            thresholds.beachHeight,
+            std::nextafter(thresholds.midlandHeight, INF),
+            std::nextafter(thresholds.highlandHeight, INF),
+            std::nextafter(thresholds.mountainHeight, INF),
+        };
+
+        std::vector<FLOAT> aMoistureBreakpoints;
+        aMoistureBreakpoints.insert(aMoistureBreakpoints.end(), std::begin(thresholds.aMountainMoistures), std::end(thresholds.aMountainMoistures));
+        aMoistureBreakpoints.insert(aMoistureBreakpoints.end(), std::begin(thresholds.aHighlandMoistures), std::end(thresholds.aHighlandMoistures));
+        aMoistureBreakpoints.insert(aMoistureBreakpoints.end(), std::begin(thresholds.aMidlandMoistures), std::end(thresholds.aMidlandMoistures));
+        aMoistureBreakpoints.insert(aMoistureBreakpoints.end(), std::begin(thresholds.aLowlandMoistures), std::end(thresholds.aLowlandMoistures));
+        std::sort(aMoistureBreakpoints.begin(), aMoistureBreakpoints.end());
+        aMoistureBreakpoints.erase(std::unique(aMoistureBreakpoints.begin(), aMoistureBreakpoints.end()), aMoistureBreakpoints.end());
+
+        // Every band is classified at its lower bound
+        std::vector<BYTE> aBlockTypes;
+        aBlockTypes.reserve((aHeightBreakpoints.size() + 1u) * (aMoistureBreakpoints.size() + 1u));
+        for (size_t uHeightBand = 0u; uHeightBand <= aHeightBreakpoints.size(); ++uHeightBand)
+        {
+            FLOAT height = uHeightBand == 0u ? -INF : aHeightBreakpoints[uHeightBand - 1u];
+            for (size_t uMoistureBand = 0u; uMoistureBand <= aMoistureBreakpoints.size(); ++uMoistureBand)
+            {
+                FLOAT moisture = uMoistureBand == 0u ? -INF : aMoistureBreakpoints[uMoistureBand - 1u];
+                eBlockType blockType = classifyByThresholds(thresholds, height, moisture);
+                aBlockTypes.push_back(static_cast<BYTE>(static_cast<CHAR>(blockType) - static_cast<CHAR>(eBlockType::GRASSLAND)));
+            }
+        }
+
+        return Create(aHeightBreakpoints, aMoistureBreakpoints, aBlockTypes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::LoadText
+
+      Summary:  Fills the table from a text file that holds the number
+                of height and moisture breakpoints, the breakpoints
+                themselves, and one row of block types (palette
+                indices) per height band
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the biome table file
+
+      Modifies: [m_uNumHeightBreakpoints, m_uNumMoistureBreakpoints,
+                 m_aHeightBreakpoints, m_aMoistureBreakpoints,
+                 m_aBlockTypes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT BiomeTable::LoadText(_In_ const std::filesystem::path& filePath)
+    {
+        std::ifstream inputFile(filePath);
+        if (!inputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        size_t uNumHeightBreakpoints = 0u;
+        size_t uNumMoistureBreakpoints = 0u;
+        inputFile >> uNumHeightBreakpoints >> uNumMoistureBreakpoints;
+        if (inputFile.fail() || uNumHeightBreakpoints > MAX_NUM_BREAKPOINTS || uNumMoistureBreakpoints > MAX_NUM_BREAKPOINTS)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<FLOAT> aHeightBreakpoints(uNumHeightBreakpoints);
+        std::vector<FLOAT> aMoistureBreakpoints(uNumMoistureBreakpoints);
+        std::vector<BYTE> aBlockTypes((uNumHeightBreakpoints + 1u) * (uNumMoistureBreakpoints + 1u));
+        for (FLOAT& breakpoint : aHeightBreakpoints)
+        {
+            inputFile >> breakpoint;
+        }
+        for (FLOAT& breakpoint : aMoistureBreakpoints)
+        {
+            inputFile >> breakpoint;
+        }
+        for (BYTE& blockType : aBlockTypes)
+        {
+            UINT uBlockType = 0u;
+            inputFile >> uBlockType;
+            blockType = static_cast<BYTE>(std::min<UINT>(uBlockType, 0xFFu));
+        }
+
+        if (inputFile.fail())
+        {
+            return E_INVALIDARG;
+        }
+
+        return Create(aHeightBreakpoints, aMoistureBreakpoints, aBlockTypes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::Classify
+
+      Summary:  Classifies a column
+
+      Args:     FLOAT height
+                  Normalized height of the column
+                FLOAT moisture
+                  Normalized moisture of the column
+
+      Returns:  BYTE
+                  Palette index of the block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE BiomeTable::Classify(_In_ FLOAT height, _In_ FLOAT moisture) const
+    {
+        UINT uHeightBand = 0u;
+        for (UINT i = 0u; i < m_uNumHeightBreakpoints; ++i)
+        {
+            uHeightBand += height >= m_aHeightBreakpoints[i] ? 1u : 0u;
+        }
+
+        UINT uMoistureBand = 0u;
+        for (UINT i = 0u; i < m_uNumMoistureBreakpoints; ++i)
+        {
+            uMoistureBand += moisture >= m_aMoistureBreakpoints[i] ? 1u : 0u;
+        }
+
+        return m_aBlockTypes[uHeightBand * TABLE_SIZE + uMoistureBand];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::ClassifyBatch
+
+      Summary:  Classifies columns four at a time. The bands are
+                counted by subtracting the all-ones comparison masks,
+                and only the table reads are done per lane
+
+      Args:     const FLOAT* pHeights
+                  Normalized heights of the columns
+                const FLOAT* pMoistures
+                  Normalized moistures of the columns
+                size_t uNumColumns
+                  Number of columns
+                BYTE* pOutBlockTypes
+                  Receives the palette index of every column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BiomeTable::ClassifyBatch(
+        _In_reads_(uNumColumns) const FLOAT* pHeights,
+        _In_reads_(uNumColumns) const FLOAT* pMoistures,
+        _In_ size_t uNumColumns,
+        _Out_writes_(uNumColumns) BYTE* pOutBlockTypes
+    ) const
+    {
+        static_assert(TABLE_SIZE == 16u, "Band indices are combined with a shift by 4");
+
+        size_t uNumVectorized = uNumColumns & ~static_cast<size_t>(3u);
+        for (size_t uColumn = 0u; uColumn < uNumVectorized; uColumn += 4u)
+        {
+            __m128 heights = _mm_loadu_ps(pHeights + uColumn);
+            __m128 moistures = _mm_loadu_ps(pMoistures + uColumn);
+
+            __m128i heightBands = _mm_setzero_si128();
+            for (UINT i = 0u; i < m_uNumHeightBreakpoints; ++i)
+            {
+                heightBands = _mm_sub_epi32(heightBands, _mm_castps_si128(_mm_cmpge_ps(heights, _mm_set1_ps(m_aHeightBreakpoints[i]))));
+            }
+
+            __m128i moistureBands = _mm_setzero_si128();
+            for (UINT i = 0u; i < m_uNumMoistureBreakpoints; ++i)
+            {
+                moistureBands = _mm_sub_epi32(moistureBands, _mm_castps_si128(_mm_cmpge_ps(moistures, _mm_set1_ps(m_aMoistureBreakpoints[i]))));
+            }
+
+            alignas(16) INT aiCells[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(aiCells), _mm_add_epi32(_mm_slli_epi32(heightBands, 4), moistureBands));
+            pOutBlockTypes[uColumn + 0u] = m_aBlockTypes[aiCells[0]];
+            pOutBlockTypes[uColumn + 1u] = m_aBlockTypes[aiCells[1]];
+            pOutBlockTypes[uColumn + 2u] = m_aBlockTypes[aiCells[2]];
+            pOutBlockTypes[uColumn + 3u] = m_aBlockTypes[aiCells[3]];
+        }
+
+        for (size_t uColumn = uNumVectorized; uColumn < uNumColumns; ++uColumn)
+        {
+            pOutBlockTypes[uColumn] = Classify(pHeights[uColumn], pMoistures[uColumn]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::Hash
+
+      Summary:  Folds everything that decides a classification into a
+                hash: the breakpoints in use and the cells of the table
+                they can reach. Two tables with the same hash classify
+                columns the same way
+
+      Args:     UINT64 ullHash
+                  Hash to continue from
+
+      Returns:  UINT64
+                  Hash of the table
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 BiomeTable::Hash(_In_ UINT64 ullHash) const
+    {
+        ullHash = HashBytes(&m_uNumHeightBreakpoints, sizeof(m_uNumHeightBreakpoints), ullHash);
+        ullHash = HashBytes(&m_uNumMoistureBreakpoints, sizeof(m_uNumMoistureBreakpoints), ullHash);
+        ullHash = HashBytes(m_aHeightBreakpoints, sizeof(FLOAT) * m_uNumHeightBreakpoints, ullHash);
+        ullHash = HashBytes(m_aMoistureBreakpoints, sizeof(FLOAT) * m_uNumMoistureBreakpoints, ullHash);
+        for (UINT uHeightBand = 0u; uHeightBand <= m_uNumHeightBreakpoints; ++uHeightBand)
+        {
+            ullHash = HashBytes(m_aBlockTypes + uHeightBand * TABLE_SIZE, m_uNumMoistureBreakpoints + 1u, ullHash);
+        }
+
+        return ullHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BiomeTable::classifyByThresholds
+
+      Summary:  Classifies a column by its height band and then by its
+                moisture within the band. Only used to fill the table
+
+      Args:     const TerrainBiomeThresholds& thresholds
+                  Biome thresholds
+                FLOAT height
+                  Normalized height of the column
+                FLOAT moisture
+                  Normalized moisture of the column
+
+      Returns:  eBlockType
+                  Block type of the biome
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockType BiomeTable::classifyByThresholds(_In_ const TerrainBiomeThresholds& thresholds, _In_ FLOAT height, _In_ FLOAT moisture)
+    {
+        if (height < thresholds.oceanHeight)
+        {
+            return eBlockType::OCEAN;
+        }
+        if (height < thresholds.beachHeight)
+        {
+            return eBlockType::SAND;
+        }
+
+        if (height > thresholds.mountainHeight)
+        {
+            if (moisture < thresholds.aMountainMoistures[0])
+            {
+                return eBlockType::SCORCHED;
+            }
+            if (moisture < thresholds.aMountainMoistures[1])
+            {
+                return eBlockType::BARE;
+            }
+            if (moisture < thresholds.aMountainMoistures[2])
+            {
+                return eBlockType::TUNDRA;
+            }
+            return eBlockType::SNOW;
+        }
+
+        if (height > thresholds.highlandHeight)
+        {
+            if (moisture < thresholds.aHighlandMoistures[0])
+            {
+                return eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < thresholds.aHighlandMoistures[1])
+            {
+                return eBlockType::SHRUBLAND;
+            }
+            return eBlockType::TAIGA;
+        }
+
+        if (height > thresholds.midlandHeight)
+        {
+            if (moisture < thresholds.aMidlandMoistures[0])
+            {
+                return eBlockType::TEMPERATE_DESERT;
+            }
+            if (moisture < thresholds.aMidlandMoistures[1])
+            {
+                return eBlockType::GRASSLAND;
+            }
+            if (moisture < thresholds.aMidlandMoistures[2])
+            {
+                return eBlockType::TEMPERATE_DECIDUOUS_FOREST;
+            }
+            return eBlockType::TEMPERATE_RAIN_FOREST;
+        }
+
+        if (moisture < thresholds.aLowlandMoistures[0])
+        {
+            return eBlockType::SUBTROPICAL_DESERT;
+        }
+        if (moisture < thresholds.aLowlandMoistures[1])
+        {
+            return eBlockType::GRASSLAND;
+        }
+        if (moisture < thresholds.aLowlandMoistures[2])
+        {
+            return eBlockType::TROPICAL_SEASONAL_FOREST;
+        }
+        return eBlockType::TROPICAL_RAIN_FOREST;
+    }
+}
@@ -0,0 +1,106 @@
+/*+===================================================================
+  File:      BIOMETABLE.H
+
+  Summary:   BiomeTable header file contains declarations of the
+             BiomeTable class that classifies height and moisture
+             pairs into block types for the lab samples of Game
+             Graphics Programming course.
+
+  Classes: BiomeTable
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainBiomeThresholds
+
+      Summary:  Heights that split the map into ocean, beach and four
+                land bands, and the moistures that split every land
+                band into its biomes, in increasing order
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainBiomeThresholds
+    {
+        FLOAT oceanHeight;
+        FLOAT beachHeight;
+        FLOAT midlandHeight;
+        FLOAT highlandHeight;
+        FLOAT mountainHeight;
+        FLOAT aMountainMoistures[3];
+        FLOAT aHighlandMoistures[2];
+        FLOAT aMidlandMoistures[3];
+        FLOAT aLowlandMoistures[3];
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BiomeTable
+
+      Summary:  Two dimensional table of block types indexed by the
+                height band and the moisture band of a column. A band
+                is the number of breakpoints the value reaches, so a
+                column is classified by counting comparisons and one
+                table read, without branches. Block types are stored
+                as palette indices, eBlockType minus GRASSLAND
+
+      Methods:  Create
+                  Fills the table from breakpoints and block types
+                CreateFromThresholds
+                  Fills the table from biome thresholds
+                LoadText
+                  Fills the table from a text file
+                Classify
+                  Returns the block type of a column
+                ClassifyBatch
+                  Classifies columns four at a time with SSE
+                Hash
+                  Folds the breakpoints and block types into a hash
+                BiomeTable
+                  Constructor.
+                ~BiomeTable
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BiomeTable final
+    {
+    public:
+        static constexpr const UINT MAX_NUM_BREAKPOINTS = 15u;
+        static constexpr const UINT TABLE_SIZE = MAX_NUM_BREAKPOINTS + 1u;
+
+        BiomeTable();
+        BiomeTable(const BiomeTable& other) = delete;
+        BiomeTable(BiomeTable&& other) = delete;
+        BiomeTable& operator=(const BiomeTable& other) = delete;
+        BiomeTable& operator=(BiomeTable&& other) = delete;
+        ~BiomeTable() = default;
+
+        HRESULT Create(
+            _In_ const std::vector<FLOAT>& aHeightBreakpoints,
+            _In_ const std::vector<FLOAT>& aMoistureBreakpoints,
+            _In_ const std::vector<BYTE>& aBlockTypes
+        );
+        HRESULT CreateFromThresholds(_In_ const TerrainBiomeThresholds& thresholds);
+        HRESULT LoadText(_In_ const std::filesystem::path& filePath);
+
+        BYTE Classify(_In_ FLOAT height, _In_ FLOAT moisture) const;
+        void ClassifyBatch(
+            _In_reads_(uNumColumns) const FLOAT* pHeights,
+            _In_reads_(uNumColumns) const FLOAT* pMoistures,
+            _In_ size_t uNumColumns,
+            _Out_writes_(uNumColumns) BYTE* pOutBlockTypes
+        ) const;
+        UINT64 Hash(_In_ UINT64 ullHash) const;
+
+    private:
+        static eBlockType classifyByThresholds(_In_ const TerrainBiomeThresholds& thresholds, _In_ FLOAT height, _In_ FLOAT moisture);
+
+    private:
+        UINT m_uNumHeightBreakpoints;
+        UINT m_uNumMoistureBreakpoints;
+        FLOAT m_aHeightBreakpoints[MAX_NUM_BREAKPOINTS];
+        FLOAT m_aMoistureBreakpoints[MAX_NUM_BREAKPOINTS];
+        BYTE m_aBlockTypes[TABLE_SIZE * TABLE_SIZE];
+    };
+}
@@ -0,0 +1,952 @@
+#include "Scene/HeightMap.h"
+
+#include <algorithm>
+#include <charconv>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: QuantizeColumnHeight
+
+      Summary:  Converts a normalized column height into the number of
+                voxels stacked in the column
+
+      Args:     FLOAT height
+                  Normalized height of the column
+                UINT uMapHeight
+                  Height of the map in voxels
+
+      Returns:  WORD
+                  Number of voxels in the column
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    WORD QuantizeColumnHeight(_In_ FLOAT height, _In_ UINT uMapHeight)
+    {
+        FLOAT numVoxels = static_cast<FLOAT>(uMapHeight) * height;
+        if (!(numVoxels > 0.0f))
+        {
+            return 0u;
+        }
+        if (numVoxels >= 65535.0f)
+        {
+            return 0xFFFFu;
+        }
+
+        return static_cast<WORD>(numVoxels);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: HashBytes
+
+      Summary:  Folds bytes into a 64-bit FNV-1a hash. Not meant to
+                resist collisions on purpose, only to key files written
+                by this program
+
+      Args:     const void* pData
+                  Bytes to hash
+                size_t uSize
+                  Number of bytes
+                UINT64 ullHash
+                  Hash to continue from, the FNV offset basis by
+                  default
+
+      Returns:  UINT64
+                  Hash of the bytes
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    UINT64 HashBytes(_In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize, _In_ UINT64 ullHash)
+    {
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        for (size_t i = 0u; i < uSize; ++i)
+        {
+            ullHash ^= pBytes[i];
+            ullHash *= 0x100000001B3ull;
+        }
+
+        return ullHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::HeightMap
+
+      Summary:  Constructor
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aBlockTypes, m_aColumnHeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMap::HeightMap()
+        : m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_aPalette()
+        , m_aBlockTypes()
+        , m_aColumnHeights()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::LoadText
+
+      Summary:  Parses a text height map file. The file starts with the
+                width, height, depth and the number of colors, followed
+                by one RGB color per block type and a (block type,
+                height) pair per column. When the body has one line per
+                row of the map, the rows are parsed on the thread pool
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map file
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aBlockTypes, m_aColumnHeights].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::LoadText(_In_ const std::filesystem::path& filePath)
+    {
+        std::ifstream inputFile(filePath, std::ios::binary | std::ios::ate);
+        if (!inputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        std::string text(static_cast<size_t>(inputFile.tellg()), '\0');
+        inputFile.seekg(0);
+        inputFile.read(text.data(), static_cast<std::streamsize>(text.size()));
+        inputFile.close();
+
+        const CHAR* pCursor = text.data();
+        const CHAR* pEnd = text.data() + text.size();
+
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (pCursor < pEnd && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            if (parseValue(pCursor, pEnd, aDimension[uDimensionIdx]))
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        m_uWidth = aDimension[0];
+        m_uHeight = aDimension[1];
+        m_uDepth = aDimension[2];
+
+        m_aPalette.clear();
+        m_aPalette.reserve(aDimension[3]);
+        XMFLOAT3 color;
+        while (pCursor < pEnd && m_aPalette.size() < aDimension[3])
+        {
+            if (parseValue(pCursor, pEnd, color.x) && parseValue(pCursor, pEnd, color.y) && parseValue(pCursor, pEnd, color.z))
+            {
+                m_aPalette.push_back(color);
+            }
+        }
+
+        size_t uNumColumns = static_cast<size_t>(m_uWidth) * static_cast<size_t>(m_uDepth);
+        m_aBlockTypes.assign(uNumColumns, 0u);
+        m_aColumnHeights.assign(uNumColumns, 0u);
+        if (uNumColumns == 0u)
+        {
+            return S_OK;
+        }
+
+        // Files written by the generator put every row of the map on its
+        // own line, which lets the rows be parsed independently
+        std::vector<const CHAR*> apRowBegins;
+        apRowBegins.reserve(static_cast<size_t>(m_uDepth) + 1u);
+        for (const CHAR* pLine = pCursor; pLine < pEnd; )
+        {
+            const CHAR* pLineEnd = static_cast<const CHAR*>(memchr(pLine, '\n', static_cast<size_t>(pEnd - pLine)));
+            pLineEnd = pLineEnd ? pLineEnd + 1 : pEnd;
+
+            if (skipWhitespace(pLine, pLineEnd) < pLineEnd)
+            {
+                apRowBegins.push_back(pLine);
+            }
+            pLine = pLineEnd;
+        }
+
+        if (apRowBegins.size() == m_uDepth)
+        {
+            apRowBegins.push_back(pEnd);
+
+            ThreadPool& threadPool = ThreadPool::GetDefault();
+            const UINT uNumWorkers = threadPool.GetNumThreads() + 1u;
+            threadPool.ParallelFor(
+                0u,
+                m_uDepth,
+                std::max<size_t>(m_uDepth / (uNumWorkers * 4u), 1u),
+                [this, &apRowBegins](size_t uBeginRow, size_t uEndRow)
+                {
+                    for (size_t uRow = uBeginRow; uRow < uEndRow; ++uRow)
+                    {
+                        parseColumns(apRowBegins[uRow], apRowBegins[uRow + 1u], uRow * m_uWidth, m_uWidth, FALSE);
+                    }
+                }
+            );
+        }
+        else
+        {
+            parseColumns(pCursor, pEnd, 0u, uNumColumns, TRUE);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::SaveBinary
+
+      Summary:  Writes the height map in the binary format that
+                HeightMapFile maps into memory
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map file
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::SaveBinary(_In_ const std::filesystem::path& filePath) const
+    {
+        return HeightMapFile::Write(filePath, GetDesc());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::Downsample
+
+      Summary:  Merges every cube of uFactor^3 voxels of another height
+                map into one voxel. A merged voxel is solid when at
+                least half of its voxels are, which keeps the solid
+                voxels of a column contiguous from the floor, and a
+                merged column takes the block type most of its columns
+                have
+
+      Args:     const HeightMapDesc& source
+                  Height map to downsample
+                UINT uFactor
+                  Number of voxels merged along every axis
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aBlockTypes, m_aColumnHeights].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::Downsample(_In_ const HeightMapDesc& source, _In_ UINT uFactor)
+    {
+        if (uFactor == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_uWidth = (source.uWidth + uFactor - 1u) / uFactor;
+        m_uHeight = (source.uHeight + uFactor - 1u) / uFactor;
+        m_uDepth = (source.uDepth + uFactor - 1u) / uFactor;
+        m_aPalette.assign(source.pPalette, source.pPalette + source.uNumColors);
+
+        size_t uNumColumns = static_cast<size_t>(m_uWidth) * static_cast<size_t>(m_uDepth);
+        m_aBlockTypes.assign(uNumColumns, 0u);
+        m_aColumnHeights.assign(uNumColumns, 0u);
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        threadPool.ParallelFor(
+            0u,
+            m_uDepth,
+            std::max<size_t>(m_uDepth / ((threadPool.GetNumThreads() + 1u) * 4u), 1u),
+            [this, &source, uFactor](size_t uBeginRow, size_t uEndRow)
+            {
+                UINT auVotes[256];
+                for (size_t z = uBeginRow; z < uEndRow; ++z)
+                {
+                    for (UINT x = 0u; x < m_uWidth; ++x)
+                    {
+                        const UINT uBeginX = x * uFactor;
+                        const UINT uBeginZ = static_cast<UINT>(z) * uFactor;
+                        const UINT uEndX = std::min<UINT>(uBeginX + uFactor, source.uWidth);
+                        const UINT uEndZ = std::min<UINT>(uBeginZ + uFactor, source.uDepth);
+                        const UINT uNumMergedColumns = (uEndX - uBeginX) * (uEndZ - uBeginZ);
+
+                        std::fill(std::begin(auVotes), std::end(auVotes), 0u);
+                        WORD highestColumn = 0u;
+                        for (UINT uSourceZ = uBeginZ; uSourceZ < uEndZ; ++uSourceZ)
+                        {
+                            for (UINT uSourceX = uBeginX; uSourceX < uEndX; ++uSourceX)
+                            {
+                                size_t uSourceColumn = static_cast<size_t>(uSourceZ) * source.uWidth + uSourceX;
+                                ++auVotes[source.pBlockTypes[uSourceColumn]];
+                                highestColumn = std::max<WORD>(highestColumn, source.pColumnHeights[uSourceColumn]);
+                            }
+                        }
+
+                        // The number of solid voxels in a merged layer
+                        // never grows with the layer
+                        UINT uNumLayers = 0u;
+                        for (UINT uLayer = 0u; uLayer * uFactor < highestColumn; ++uLayer)
+                        {
+                            UINT uNumSolidVoxels = 0u;
+                            for (UINT uSourceZ = uBeginZ; uSourceZ < uEndZ; ++uSourceZ)
+                            {
+                                for (UINT uSourceX = uBeginX; uSourceX < uEndX; ++uSourceX)
+                                {
+                                    UINT uHeight = source.pColumnHeights[static_cast<size_t>(uSourceZ) * source.uWidth + uSourceX];
+                                    uNumSolidVoxels += std::min<UINT>(uHeight - std::min<UINT>(uHeight, uLayer * uFactor), uFactor);
+                                }
+                            }
+                            if (2u * uNumSolidVoxels < uNumMergedColumns * uFactor)
+                            {
+                                break;
+                            }
+                            uNumLayers = uLayer + 1u;
+                        }
+
+                        size_t uColumn = z * m_uWidth + x;
+                        m_aBlockTypes[uColumn] = static_cast<BYTE>(std::max_element(std::begin(auVotes), std::end(auVotes)) - auVotes);
+                        m_aColumnHeights[uColumn] = static_cast<WORD>(uNumLayers);
+                    }
+                }
+            }
+        );
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::GetDesc
+
+      Summary:  Returns a view over the columns of the height map
+
+      Returns:  HeightMapDesc
+                  View over the columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapDesc HeightMap::GetDesc() const
+    {
+        return HeightMapDesc
+        {
+            .uWidth = m_uWidth,
+            .uHeight = m_uHeight,
+            .uDepth = m_uDepth,
+            .uNumColors = static_cast<UINT>(m_aPalette.size()),
+            .pPalette = m_aPalette.data(),
+            .pBlockTypes = m_aBlockTypes.data(),
+            .pColumnHeights = m_aColumnHeights.data()
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::MeasureTextParsing
+
+      Summary:  Parses a text height map with the single threaded
+                ifstream loop and with LoadText, and logs the time of
+                both and the number of columns they disagree on. The
+                height map keeps the columns LoadText parsed
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map file
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aBlockTypes, m_aColumnHeights].
+
+      Returns:  HeightMapParsingStatistics
+                  Time of both and their mismatched columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapParsingStatistics HeightMap::MeasureTextParsing(_In_ const std::filesystem::path& filePath)
+    {
+        HeightMapParsingStatistics statistics =
+        {
+            .uWidth = 0u,
+            .uDepth = 0u,
+            .streamMilliseconds = 0.0,
+            .parallelMilliseconds = 0.0,
+            .ullNumMismatchedColumns = 0u,
+        };
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        if (FAILED(loadTextStream(filePath)))
+        {
+            return statistics;
+        }
+        QueryPerformanceCounter(&endingTime);
+        statistics.streamMilliseconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+
+        const std::vector<BYTE> aStreamBlockTypes = std::move(m_aBlockTypes);
+        const std::vector<WORD> aStreamColumnHeights = std::move(m_aColumnHeights);
+
+        QueryPerformanceCounter(&startingTime);
+        if (FAILED(LoadText(filePath)))
+        {
+            return statistics;
+        }
+        QueryPerformanceCounter(&endingTime);
+        statistics.parallelMilliseconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+
+        statistics.uWidth = m_uWidth;
+        statistics.uDepth = m_uDepth;
+        for (size_t i = 0u; i < m_aBlockTypes.size(); ++i)
+        {
+            if (i >= aStreamBlockTypes.size() || aStreamBlockTypes[i] != m_aBlockTypes[i] || aStreamColumnHeights[i] != m_aColumnHeights[i])
+            {
+                ++statistics.ullNumMismatchedColumns;
+            }
+        }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "HeightMap: %ux%u text map, ifstream loop %.2f ms, LoadText %.2f ms (%.1fx), %llu mismatched column(s)\n",
+            statistics.uWidth,
+            statistics.uDepth,
+            statistics.streamMilliseconds,
+            statistics.parallelMilliseconds,
+            statistics.parallelMilliseconds > 0.0 ? statistics.streamMilliseconds / statistics.parallelMilliseconds : 0.0,
+            statistics.ullNumMismatchedColumns
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::loadTextStream
+
+      Summary:  Parses a text height map file on one thread by
+                extracting every value from an ifstream, the way scenes
+                were loaded before LoadText. Kept as the reference
+                LoadText is measured against. The block type is read as
+                one byte, as parseColumns does, since extraction would
+                skip the space of TEMPERATE_RAIN_FOREST
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map file
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aBlockTypes, m_aColumnHeights].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMap::loadTextStream(_In_ const std::filesystem::path& filePath)
+    {
+        std::ifstream inputFile(filePath, std::ios::binary);
+        if (!inputFile.is_open())
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        std::string trash;
+        UINT aDimension[4] = { 0u, };
+        UINT uDimensionIdx = 0u;
+        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        {
+            inputFile >> aDimension[uDimensionIdx];
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                ++uDimensionIdx;
+            }
+        }
+
+        m_uWidth = aDimension[0];
+        m_uHeight = aDimension[1];
+        m_uDepth = aDimension[2];
+
+        m_aPalette.clear();
+        XMFLOAT3 color;
+        while (!inputFile.eof() && m_aPalette.size() < aDimension[3])
+        {
+            inputFile >> color.x >> color.y >> color.z;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else
+            {
+                m_aPalette.push_back(color);
+            }
+        }
+
+        size_t uNumColumns = static_cast<size_t>(m_uWidth) * static_cast<size_t>(m_uDepth);
+        m_aBlockTypes.assign(uNumColumns, 0u);
+        m_aColumnHeights.assign(uNumColumns, 0u);
+
+        size_t uColumn = 0u;
+        FLOAT height;
+        while (uNumColumns > 0u && !inputFile.eof())
+        {
+            INT iVoxelType = inputFile.get();
+            while (iVoxelType == '\n' || iVoxelType == '\r')
+            {
+                iVoxelType = inputFile.get();
+            }
+            if (iVoxelType == std::char_traits<CHAR>::eof())
+            {
+                break;
+            }
+
+            inputFile >> height;
+
+            if (inputFile.fail())
+            {
+                if (inputFile.eof())
+                {
+                    break;
+                }
+                inputFile.clear();
+                inputFile >> trash;
+            }
+            else if (static_cast<INT>(eBlockType::GRASSLAND) <= iVoxelType && iVoxelType < static_cast<INT>(eBlockType::COUNT))
+            {
+                m_aBlockTypes[uColumn] = static_cast<BYTE>(iVoxelType - static_cast<INT>(eBlockType::GRASSLAND));
+                m_aColumnHeights[uColumn] = QuantizeColumnHeight(height, m_uHeight);
+
+                ++uColumn;
+                if (uColumn >= uNumColumns)
+                {
+                    uColumn = 0u;
+                }
+            }
+
+            const INT iSeparator = inputFile.peek();
+            if (iSeparator == ' ' || iSeparator == '\t')
+            {
+                inputFile.get();
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::parseColumns
+
+      Summary:  Parses (block type, height) pairs into consecutive
+                columns. A pair is the block type as one byte followed
+                by the height, and pairs are separated by one space or
+                a line break. The block type byte is read as is, since
+                the block type of TEMPERATE_RAIN_FOREST is a space.
+                Pairs with an unknown block type are skipped
+
+      Args:     const CHAR* pBegin
+                  Start of the text to parse
+                const CHAR* pEnd
+                  End of the text to parse
+                size_t uFirstColumn
+                  Index of the column the first pair is stored to
+                size_t uNumColumns
+                  Number of columns the text covers
+                BOOL bWrap
+                  Whether pairs past the last column wrap around to
+                  the first one instead of being ignored
+
+      Modifies: [m_aBlockTypes, m_aColumnHeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMap::parseColumns(
+        _In_ const CHAR* pBegin,
+        _In_ const CHAR* pEnd,
+        _In_ size_t uFirstColumn,
+        _In_ size_t uNumColumns,
+        _In_ BOOL bWrap
+    )
+    {
+        const CHAR* pCursor = pBegin;
+        size_t uColumnOffset = 0u;
+        CHAR voxelType;
+        FLOAT height;
+
+        while (uColumnOffset < uNumColumns)
+        {
+            while (pCursor < pEnd && (*pCursor == '\n' || *pCursor == '\r'))
+            {
+                ++pCursor;
+            }
+            if (pCursor >= pEnd)
+            {
+                break;
+            }
+
+            voxelType = *pCursor++;
+            std::from_chars_result result = std::from_chars(pCursor, pEnd, height);
+            if (result.ec != std::errc())
+            {
+                while (pCursor < pEnd && !isspace(static_cast<unsigned char>(*pCursor)))
+                {
+                    ++pCursor;
+                }
+            }
+            else
+            {
+                pCursor = result.ptr;
+            }
+            if (pCursor < pEnd && (*pCursor == ' ' || *pCursor == '\t'))
+            {
+                ++pCursor;
+            }
+            if (result.ec != std::errc())
+            {
+                continue;
+            }
+
+            if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+            {
+                m_aBlockTypes[uFirstColumn + uColumnOffset] = static_cast<BYTE>(voxelType - static_cast<CHAR>(eBlockType::GRASSLAND));
+                m_aColumnHeights[uFirstColumn + uColumnOffset] = QuantizeColumnHeight(height, m_uHeight);
+
+                ++uColumnOffset;
+                if (bWrap && uColumnOffset >= uNumColumns)
+                {
+                    uColumnOffset = 0u;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::parseValue
+
+      Summary:  Parses the next whitespace separated number. A token
+                that is not a number is skipped
+
+      Args:     const CHAR*& pCursor
+                  Cursor into the text, advanced past the token
+                const CHAR* pEnd
+                  End of the text
+                T& outValue
+                  Parsed value
+
+      Returns:  BOOL
+                  TRUE if a number was parsed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    BOOL HeightMap::parseValue(_Inout_ const CHAR*& pCursor, _In_ const CHAR* pEnd, _Out_ T& outValue)
+    {
+        pCursor = skipWhitespace(pCursor, pEnd);
+
+        std::from_chars_result result = std::from_chars(pCursor, pEnd, outValue);
+        if (result.ec != std::errc())
+        {
+            while (pCursor < pEnd && !isspace(static_cast<unsigned char>(*pCursor)))
+            {
+                ++pCursor;
+            }
+            return FALSE;
+        }
+
+        pCursor = result.ptr;
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMap::skipWhitespace
+
+      Summary:  Returns the first non-whitespace character
+
+      Args:     const CHAR* pCursor
+                  Cursor into the text
+                const CHAR* pEnd
+                  End of the text
+
+      Returns:  const CHAR*
+                  First non-whitespace character or pEnd
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CHAR* HeightMap::skipWhitespace(_In_ const CHAR* pCursor, _In_ const CHAR* pEnd)
+    {
+        while (pCursor < pEnd && isspace(static_cast<unsigned char>(*pCursor)))
+        {
+            ++pCursor;
+        }
+
+        return pCursor;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::ConvertFromText
+
+      Summary:  Converts a text height map file into a binary one
+
+      Args:     const std::filesystem::path& textFilePath
+                  Path to the text height map file
+                const std::filesystem::path& binaryFilePath
+                  Path to the binary height map file to write
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMapFile::ConvertFromText(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath)
+    {
+        HeightMap heightMap;
+
+        HRESULT hr = heightMap.LoadText(textFilePath);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return heightMap.SaveBinary(binaryFilePath);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::Write
+
+      Summary:  Writes a height map in the binary format that Open maps
+                into memory
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map file
+                const HeightMapDesc& heightMap
+                  Columns to write
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMapFile::Write(_In_ const std::filesystem::path& filePath, _In_ const HeightMapDesc& heightMap)
+    {
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        size_t uNumColumns = static_cast<size_t>(heightMap.uWidth) * static_cast<size_t>(heightMap.uDepth);
+        UINT64 ullPaletteOffset = sizeof(HeightMapFileHeader);
+        UINT64 ullBlockTypesOffset = ullPaletteOffset + sizeof(XMFLOAT3) * heightMap.uNumColors;
+        // Column heights are WORD aligned
+        UINT64 ullColumnHeightsOffset = (ullBlockTypesOffset + uNumColumns + 1u) & ~static_cast<UINT64>(1u);
+
+        HeightMapFileHeader header =
+        {
+            .dwMagic = MAGIC,
+            .dwVersion = VERSION,
+            .uWidth = heightMap.uWidth,
+            .uHeight = heightMap.uHeight,
+            .uDepth = heightMap.uDepth,
+            .uNumColors = heightMap.uNumColors,
+            .ullPaletteOffset = ullPaletteOffset,
+            .ullBlockTypesOffset = ullBlockTypesOffset,
+            .ullColumnHeightsOffset = ullColumnHeightsOffset
+        };
+
+        const CHAR padding = '\0';
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        outputFile.write(reinterpret_cast<const CHAR*>(heightMap.pPalette), static_cast<std::streamsize>(sizeof(XMFLOAT3) * heightMap.uNumColors));
+        outputFile.write(reinterpret_cast<const CHAR*>(heightMap.pBlockTypes), static_cast<std::streamsize>(uNumColumns));
+        if ((uNumColumns & 1u) != 0u)
+        {
+            outputFile.write(&padding, 1);
+        }
+        outputFile.write(reinterpret_cast<const CHAR*>(heightMap.pColumnHeights), static_cast<std::streamsize>(sizeof(WORD) * uNumColumns));
+
+        if (outputFile.fail())
+        {
+            return E_FAIL;
+        }
+
+        outputFile.close();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::HeightMapFile
+
+      Summary:  Constructor
+
+      Modifies: [m_hFile, m_hFileMapping, m_pView, m_ullFileSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapFile::HeightMapFile()
+        : m_hFile(INVALID_HANDLE_VALUE)
+        , m_hFileMapping(nullptr)
+        , m_pView(nullptr)
+        , m_ullFileSize(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::~HeightMapFile
+
+      Summary:  Destructor
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapFile::~HeightMapFile()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::Open
+
+      Summary:  Maps a binary height map file into memory and validates
+                its header
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map file
+
+      Modifies: [m_hFile, m_hFileMapping, m_pView, m_ullFileSize].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HeightMapFile::Open(_In_ const std::filesystem::path& filePath)
+    {
+        Close();
+
+        m_hFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+        m_ullFileSize = static_cast<UINT64>(fileSize.QuadPart);
+
+        if (m_ullFileSize < sizeof(HeightMapFileHeader))
+        {
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        m_hFileMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hFileMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pView = static_cast<const BYTE*>(MapViewOfFile(m_hFileMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pView)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        const HeightMapFileHeader* pHeader = reinterpret_cast<const HeightMapFileHeader*>(m_pView);
+        if (pHeader->dwMagic != MAGIC)
+        {
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        if (pHeader->dwVersion != VERSION)
+        {
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_REVISION_MISMATCH);
+        }
+
+        // Offsets come from the file, so they are never added to a
+        // size where the sum could wrap around
+        UINT64 ullNumColumns = static_cast<UINT64>(pHeader->uWidth) * static_cast<UINT64>(pHeader->uDepth);
+        if (ullNumColumns > m_ullFileSize
+            || !isRangeInFile(pHeader->ullPaletteOffset, sizeof(XMFLOAT3) * static_cast<UINT64>(pHeader->uNumColors))
+            || !isRangeInFile(pHeader->ullBlockTypesOffset, ullNumColumns)
+            || !isRangeInFile(pHeader->ullColumnHeightsOffset, sizeof(WORD) * ullNumColumns)
+            || (pHeader->ullPaletteOffset % alignof(XMFLOAT3)) != 0u
+            || (pHeader->ullColumnHeightsOffset % alignof(WORD)) != 0u)
+        {
+            Close();
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::isRangeInFile
+
+      Summary:  Checks that a range of bytes lies within the mapped
+                file without overflowing
+
+      Args:     UINT64 ullOffset
+                  Offset of the range from the start of the file
+                UINT64 ullSize
+                  Size of the range in bytes
+
+      Returns:  BOOL
+                  TRUE if the whole range is in the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL HeightMapFile::isRangeInFile(_In_ UINT64 ullOffset, _In_ UINT64 ullSize) const
+    {
+        return ullOffset <= m_ullFileSize && ullSize <= m_ullFileSize - ullOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::Close
+
+      Summary:  Unmaps the file and releases its handles
+
+      Modifies: [m_hFile, m_hFileMapping, m_pView, m_ullFileSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeightMapFile::Close()
+    {
+        if (m_pView)
+        {
+            UnmapViewOfFile(m_pView);
+            m_pView = nullptr;
+        }
+        if (m_hFileMapping)
+        {
+            CloseHandle(m_hFileMapping);
+            m_hFileMapping = nullptr;
+        }
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+        m_ullFileSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeightMapFile::GetDesc
+
+      Summary:  Returns a view over the columns in the mapped file
+
+      Returns:  HeightMapDesc
+                  View over the columns, empty if no file is open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapDesc HeightMapFile::GetDesc() const
+    {
+        if (!m_pView)
+        {
+            return HeightMapDesc{};
+        }
+
+        const HeightMapFileHeader* pHeader = reinterpret_cast<const HeightMapFileHeader*>(m_pView);
+
+        return HeightMapDesc
+        {
+            .uWidth = pHeader->uWidth,
+            .uHeight = pHeader->uHeight,
+            .uDepth = pHeader->uDepth,
+            .uNumColors = pHeader->uNumColors,
+            .pPalette = reinterpret_cast<const XMFLOAT3*>(m_pView + pHeader->ullPaletteOffset),
+            .pBlockTypes = m_pView + pHeader->ullBlockTypesOffset,
+            .pColumnHeights = reinterpret_cast<const WORD*>(m_pView + pHeader->ullColumnHeightsOffset)
+        };
+    }
+}
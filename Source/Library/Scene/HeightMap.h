@@ -0,0 +1,192 @@
+/*+===================================================================
+  File:      HEIGHTMAP.H
+
+  Summary:   HeightMap header file contains declarations of the
+             height map containers that Scene loads voxel maps from,
+             used for the lab samples of Game Graphics Programming
+             course.
+
+  Classes: HeightMap, HeightMapFile
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <fstream>
+
+namespace library
+{
+    WORD QuantizeColumnHeight(_In_ FLOAT height, _In_ UINT uMapHeight);
+    UINT64 HashBytes(_In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize, _In_ UINT64 ullHash = 0xCBF29CE484222325ull);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapDesc
+
+      Summary:  Non-owning view over the columns of a height map.
+                Column (x, z) is stored at index z * uWidth + x, its
+                block type is an index into the palette and its height
+                is the number of voxels stacked from the floor
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapDesc
+    {
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        UINT uNumColors;
+        const XMFLOAT3* pPalette;
+        const BYTE* pBlockTypes;
+        const WORD* pColumnHeights;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapFileHeader
+
+      Summary:  Header of the binary height map file. The palette, the
+                block type array and the column height array follow at
+                the given byte offsets from the start of the file
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapFileHeader
+    {
+        DWORD dwMagic;
+        DWORD dwVersion;
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        UINT uNumColors;
+        UINT64 ullPaletteOffset;
+        UINT64 ullBlockTypesOffset;
+        UINT64 ullColumnHeightsOffset;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   HeightMapParsingStatistics
+
+      Summary:  Time of parsing a text height map with the single
+                threaded ifstream loop and with LoadText, and the
+                number of columns the two disagree on
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct HeightMapParsingStatistics
+    {
+        UINT uWidth;
+        UINT uDepth;
+        DOUBLE streamMilliseconds;
+        DOUBLE parallelMilliseconds;
+        UINT64 ullNumMismatchedColumns;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMap
+
+      Summary:  Height map held in memory, loaded from the text format
+                or downsampled from another height map
+
+      Methods:  LoadText
+                  Parses a text height map file
+                SaveBinary
+                  Writes the height map in the binary format
+                Downsample
+                  Merges blocks of columns of another height map
+                GetDesc
+                  Returns a view over the columns
+                MeasureTextParsing
+                  Times the ifstream loop against LoadText
+                HeightMap
+                  Constructor.
+                ~HeightMap
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMap
+    {
+    public:
+        HeightMap();
+        HeightMap(const HeightMap& other) = delete;
+        HeightMap(HeightMap&& other) = delete;
+        HeightMap& operator=(const HeightMap& other) = delete;
+        HeightMap& operator=(HeightMap&& other) = delete;
+        ~HeightMap() = default;
+
+        HRESULT LoadText(_In_ const std::filesystem::path& filePath);
+        HRESULT SaveBinary(_In_ const std::filesystem::path& filePath) const;
+        HRESULT Downsample(_In_ const HeightMapDesc& source, _In_ UINT uFactor);
+
+        HeightMapDesc GetDesc() const;
+
+        HeightMapParsingStatistics MeasureTextParsing(_In_ const std::filesystem::path& filePath);
+
+    private:
+        HRESULT loadTextStream(_In_ const std::filesystem::path& filePath);
+        void parseColumns(
+            _In_ const CHAR* pBegin,
+            _In_ const CHAR* pEnd,
+            _In_ size_t uFirstColumn,
+            _In_ size_t uNumColumns,
+            _In_ BOOL bWrap
+        );
+
+        template <typename T>
+        static BOOL parseValue(_Inout_ const CHAR*& pCursor, _In_ const CHAR* pEnd, _Out_ T& outValue);
+        static const CHAR* skipWhitespace(_In_ const CHAR* pCursor, _In_ const CHAR* pEnd);
+
+    private:
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uDepth;
+        std::vector<XMFLOAT3> m_aPalette;
+        std::vector<BYTE> m_aBlockTypes;
+        std::vector<WORD> m_aColumnHeights;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeightMapFile
+
+      Summary:  Binary height map file mapped into memory. The columns
+                are read in place from the mapped view
+
+      Methods:  ConvertFromText
+                  Converts a text height map file into a binary one
+                Write
+                  Writes a height map in the binary format
+                Open
+                  Maps a binary height map file into memory
+                Close
+                  Unmaps the file
+                GetDesc
+                  Returns a view over the columns
+                HeightMapFile
+                  Constructor.
+                ~HeightMapFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeightMapFile
+    {
+    public:
+        static constexpr const DWORD MAGIC = 0x50414D48u; // "HMAP"
+        static constexpr const DWORD VERSION = 1u;
+
+        static HRESULT ConvertFromText(_In_ const std::filesystem::path& textFilePath, _In_ const std::filesystem::path& binaryFilePath);
+        static HRESULT Write(_In_ const std::filesystem::path& filePath, _In_ const HeightMapDesc& heightMap);
+
+        HeightMapFile();
+        HeightMapFile(const HeightMapFile& other) = delete;
+        HeightMapFile(HeightMapFile&& other) = delete;
+        HeightMapFile& operator=(const HeightMapFile& other) = delete;
+        HeightMapFile& operator=(HeightMapFile&& other) = delete;
+        ~HeightMapFile();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        void Close();
+
+        HeightMapDesc GetDesc() const;
+
+    private:
+        BOOL isRangeInFile(_In_ UINT64 ullOffset, _In_ UINT64 ullSize) const;
+
+    private:
+        HANDLE m_hFile;
+        HANDLE m_hFileMapping;
+        const BYTE* m_pView;
+        UINT64 m_ullFileSize;
+    };
+}
@@ -0,0 +1,794 @@
+#include "Scene/OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+
+using namespace DirectX;
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+
+      Summary:  Constructor. Allocates the depth buffer and every level
+                of the pyramid down to a single texel, all cleared to
+                the far plane
+
+      Args:     const OcclusionCullingDesc& desc
+                  Size of the depth buffer and number of occluders
+                ParallelForFunction parallelFor
+                  Runs the setup, rasterization and tests on several
+                  threads, everything runs on the calling thread if it
+                  is empty
+
+      Modifies: [m_desc, m_parallelFor, m_viewProjection,
+                 m_shrinkPerDepth, m_aLevels, m_aTriangles,
+                 m_auNumTriangles, m_aauBandTriangles,
+                 m_aSortedOccluders, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller(const OcclusionCullingDesc& desc, ParallelForFunction parallelFor)
+        : m_desc(desc)
+        , m_parallelFor(std::move(parallelFor))
+        , m_viewProjection(XMMatrixIdentity())
+        , m_shrinkPerDepth(0.0f)
+        , m_aLevels()
+        , m_aTriangles()
+        , m_auNumTriangles()
+        , m_aauBandTriangles()
+        , m_aSortedOccluders()
+        , m_statistics()
+    {
+        // Rows are rasterized four pixels at a time
+        m_desc.uWidth = (std::max<std::uint32_t>(m_desc.uWidth, 4u) + 3u) & ~3u;
+        m_desc.uHeight = std::max<std::uint32_t>(m_desc.uHeight, 1u);
+        m_aauBandTriangles.resize((m_desc.uHeight + ROWS_PER_BAND - 1u) / ROWS_PER_BAND);
+
+        std::uint32_t uWidth = m_desc.uWidth;
+        std::uint32_t uHeight = m_desc.uHeight;
+        for (;;)
+        {
+            m_aLevels.push_back(HiZLevel{ .uWidth = uWidth, .uHeight = uHeight, .aDepths = std::vector<float>(static_cast<size_t>(uWidth) * uHeight, 1.0f) });
+            if (uWidth == 1u && uHeight == 1u)
+            {
+                break;
+            }
+            uWidth = (uWidth + 1u) / 2u;
+            uHeight = (uHeight + 1u) / 2u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RenderOccluders
+
+      Summary:  Clears the depth buffer and draws the occluders of a
+                view into it. Boxes without volume or outside the view
+                frustum are skipped, and only the nearest uMaxOccluders
+                of the rest are drawn, since near ones cover the most
+                pixels. Their triangles are set up in parallel and
+                binned by band, then every band of rows is rasterized
+                by one batch of the parallel for, and the pyramid is
+                built from the result
+
+      Args:     const BoundingBox* pOccluders
+                  World space boxes inside solid geometry
+                size_t uNumOccluders
+                  Number of occluders
+                const XMMATRIX& view
+                  View matrix of the camera
+                const XMMATRIX& projection
+                  Projection matrix of the camera
+
+      Modifies: [m_viewProjection, m_shrinkPerDepth, m_aLevels,
+                 m_aTriangles, m_auNumTriangles, m_aauBandTriangles,
+                 m_aSortedOccluders, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RenderOccluders(const BoundingBox* pOccluders, std::size_t uNumOccluders, const XMMATRIX& view, const XMMATRIX& projection)
+    {
+        const std::chrono::steady_clock::time_point startingTime = std::chrono::steady_clock::now();
+
+        m_viewProjection = XMMatrixMultiply(view, projection);
+
+        // A pixel at view depth w spans w / f world units, f being the
+        // focal length in pixels along the coarser of the two axes.
+        // Shrinking by half its diagonal keeps the whole pixel around
+        // a covered center inside the occluder
+        const float focalLength = std::min<float>(
+            std::abs(XMVectorGetX(projection.r[0])) * 0.5f * static_cast<float>(m_desc.uWidth),
+            std::abs(XMVectorGetY(projection.r[1])) * 0.5f * static_cast<float>(m_desc.uHeight)
+        );
+        m_shrinkPerDepth = focalLength > 0.0f ? 0.70710678f / focalLength : 0.0f;
+
+        BoundingFrustum frustum;
+        BoundingFrustum::CreateFromMatrix(frustum, projection);
+        frustum.Transform(frustum, XMMatrixInverse(nullptr, view));
+
+        // Occluders are ordered by the view depth of their nearest
+        // possible point
+        m_aSortedOccluders.clear();
+        for (std::size_t i = 0u; i < uNumOccluders; ++i)
+        {
+            const BoundingBox& occluder = pOccluders[i];
+            if (occluder.Extents.x <= 0.0f || occluder.Extents.y <= 0.0f || occluder.Extents.z <= 0.0f || !frustum.Intersects(occluder))
+            {
+                continue;
+            }
+
+            const float viewDepth = XMVectorGetZ(XMVector3Transform(XMLoadFloat3(&occluder.Center), view)) - XMVectorGetX(XMVector3Length(XMLoadFloat3(&occluder.Extents)));
+            m_aSortedOccluders.push_back(std::make_pair(viewDepth, static_cast<std::uint32_t>(i)));
+        }
+        if (m_aSortedOccluders.size() > m_desc.uMaxOccluders)
+        {
+            std::nth_element(m_aSortedOccluders.begin(), m_aSortedOccluders.begin() + m_desc.uMaxOccluders, m_aSortedOccluders.end());
+            m_aSortedOccluders.resize(m_desc.uMaxOccluders);
+        }
+
+        const std::size_t uNumDrawn = m_aSortedOccluders.size();
+        m_aTriangles.resize(uNumDrawn * MAX_TRIANGLES_PER_OCCLUDER);
+        m_auNumTriangles.resize(uNumDrawn);
+
+        parallelFor(0u, uNumDrawn, 1u, [this, pOccluders](std::size_t uBegin, std::size_t uEnd)
+        {
+            for (std::size_t i = uBegin; i < uEnd; ++i)
+            {
+                m_auNumTriangles[i] = setupOccluder(pOccluders[m_aSortedOccluders[i].second], &m_aTriangles[i * MAX_TRIANGLES_PER_OCCLUDER]);
+            }
+        });
+
+        binTriangles();
+
+        parallelFor(0u, m_aauBandTriangles.size(), 1u, [this](std::size_t uBegin, std::size_t uEnd)
+        {
+            for (std::size_t uBand = uBegin; uBand < uEnd; ++uBand)
+            {
+                rasterizeBand(static_cast<std::uint32_t>(uBand));
+            }
+        });
+
+        buildPyramid();
+
+        const std::chrono::steady_clock::time_point endingTime = std::chrono::steady_clock::now();
+
+        std::uint32_t uNumTriangles = 0u;
+        for (std::uint32_t uNumOccluderTriangles : m_auNumTriangles)
+        {
+            uNumTriangles += uNumOccluderTriangles;
+        }
+
+        m_statistics = OcclusionCullingStatistics
+        {
+            .uNumOccluders = static_cast<std::uint32_t>(uNumDrawn),
+            .uNumTriangles = uNumTriangles,
+            .uNumTestedBoxes = 0u,
+            .uNumOccludedBoxes = 0u,
+            .rasterizationMilliseconds = std::chrono::duration<double, std::milli>(endingTime - startingTime).count(),
+            .testMilliseconds = 0.0,
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsVisible
+
+      Summary:  Tests a world space box against the pyramid of the last
+                RenderOccluders. A box that crosses the near plane or
+                leaves the screen is never hidden, since the frustum
+                test decides about it. Otherwise the level is chosen
+                where the pixels the box touches span at most 2 x 2
+                texels, and the box is hidden if its nearest depth lies
+                behind the farthest depth of all of them
+
+      Args:     const BoundingBox& boundingBox
+                  World space bounds to test
+
+      Returns:  bool
+                  false if the occluders hide the whole box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::IsVisible(const BoundingBox& boundingBox) const
+    {
+        const XMVECTOR center = XMLoadFloat3(&boundingBox.Center);
+        const XMVECTOR extents = XMLoadFloat3(&boundingBox.Extents);
+
+        XMVECTOR minimum = XMVectorReplicate(std::numeric_limits<float>::infinity());
+        XMVECTOR maximum = XMVectorReplicate(-std::numeric_limits<float>::infinity());
+        for (std::uint32_t uCorner = 0u; uCorner < 8u; ++uCorner)
+        {
+            const XMVECTOR sign = XMVectorSet(
+                (uCorner & 1u) ? 1.0f : -1.0f,
+                (uCorner & 2u) ? 1.0f : -1.0f,
+                (uCorner & 4u) ? 1.0f : -1.0f,
+                0.0f
+            );
+            const XMVECTOR clip = XMVector4Transform(XMVectorSetW(XMVectorMultiplyAdd(extents, sign, center), 1.0f), m_viewProjection);
+            const float w = XMVectorGetW(clip);
+            if (!(w > 0.0f) || XMVectorGetZ(clip) < 0.0f)
+            {
+                return true;
+            }
+
+            const XMVECTOR ndc = XMVectorDivide(clip, XMVectorReplicate(w));
+            minimum = XMVectorMin(minimum, ndc);
+            maximum = XMVectorMax(maximum, ndc);
+        }
+
+        XMFLOAT3 ndcMinimum;
+        XMFLOAT3 ndcMaximum;
+        XMStoreFloat3(&ndcMinimum, minimum);
+        XMStoreFloat3(&ndcMaximum, maximum);
+
+        // Screen rows grow downwards
+        const float width = static_cast<float>(m_desc.uWidth);
+        const float height = static_cast<float>(m_desc.uHeight);
+        const float minX = (ndcMinimum.x * 0.5f + 0.5f) * width;
+        const float maxX = (ndcMaximum.x * 0.5f + 0.5f) * width;
+        const float minY = (0.5f - ndcMaximum.y * 0.5f) * height;
+        const float maxY = (0.5f - ndcMinimum.y * 0.5f) * height;
+        if (maxX <= 0.0f || minX >= width || maxY <= 0.0f || minY >= height || ndcMinimum.z > 1.0f)
+        {
+            return true;
+        }
+
+        const int iMaxX = static_cast<int>(m_desc.uWidth) - 1;
+        const int iMaxY = static_cast<int>(m_desc.uHeight) - 1;
+        const int x0 = std::clamp(static_cast<int>(std::floor(minX)), 0, iMaxX);
+        const int y0 = std::clamp(static_cast<int>(std::floor(minY)), 0, iMaxY);
+        const int x1 = std::clamp(static_cast<int>(std::ceil(maxX)) - 1, x0, iMaxX);
+        const int y1 = std::clamp(static_cast<int>(std::ceil(maxY)) - 1, y0, iMaxY);
+
+        std::uint32_t uLevel = 0u;
+        while ((x1 >> uLevel) - (x0 >> uLevel) > 1 || (y1 >> uLevel) - (y0 >> uLevel) > 1)
+        {
+            ++uLevel;
+        }
+
+        const HiZLevel& level = m_aLevels[uLevel];
+        float farthestDepth = 0.0f;
+        for (int y = y0 >> uLevel; y <= (y1 >> uLevel); ++y)
+        {
+            for (int x = x0 >> uLevel; x <= (x1 >> uLevel); ++x)
+            {
+                farthestDepth = std::max<float>(farthestDepth, level.aDepths[static_cast<std::size_t>(y) * level.uWidth + x]);
+            }
+        }
+
+        return !(farthestDepth < ndcMinimum.z);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::TestBoxes
+
+      Summary:  Tests many boxes against the pyramid through the
+                parallel for and adds them to the statistics of the
+                frame
+
+      Args:     const BoundingBox* pBoxes
+                  World space bounds to test
+                size_t uNumBoxes
+                  Number of boxes
+                std::uint8_t* pbOutVisible
+                  Receives zero for every hidden box and one for the
+                  others
+
+      Modifies: [m_statistics].
+
+      Returns:  std::uint32_t
+                  Number of hidden boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::TestBoxes(const BoundingBox* pBoxes, std::size_t uNumBoxes, std::uint8_t* pbOutVisible)
+    {
+        const std::chrono::steady_clock::time_point startingTime = std::chrono::steady_clock::now();
+
+        parallelFor(0u, uNumBoxes, 16u, [this, pBoxes, pbOutVisible](std::size_t uBegin, std::size_t uEnd)
+        {
+            for (std::size_t i = uBegin; i < uEnd; ++i)
+            {
+                pbOutVisible[i] = IsVisible(pBoxes[i]) ? 1u : 0u;
+            }
+        });
+
+        std::uint32_t uNumOccluded = 0u;
+        for (std::size_t i = 0u; i < uNumBoxes; ++i)
+        {
+            if (!pbOutVisible[i])
+            {
+                ++uNumOccluded;
+            }
+        }
+
+        const std::chrono::steady_clock::time_point endingTime = std::chrono::steady_clock::now();
+
+        m_statistics.uNumTestedBoxes += static_cast<std::uint32_t>(uNumBoxes);
+        m_statistics.uNumOccludedBoxes += uNumOccluded;
+        m_statistics.testMilliseconds += std::chrono::duration<double, std::milli>(endingTime - startingTime).count();
+
+        return uNumOccluded;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetWidth
+
+      Summary:  Returns the width of the depth buffer
+
+      Returns:  std::uint32_t
+                  Width in pixels, a multiple of four
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetWidth() const
+    {
+        return m_desc.uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetHeight
+
+      Summary:  Returns the height of the depth buffer
+
+      Returns:  std::uint32_t
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetHeight() const
+    {
+        return m_desc.uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumLevels
+
+      Summary:  Returns the number of levels of the pyramid
+
+      Returns:  std::uint32_t
+                  Number of levels, the depth buffer being the first
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetNumLevels() const
+    {
+        return static_cast<std::uint32_t>(m_aLevels.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetLevel
+
+      Summary:  Returns the farthest depths of a level of the pyramid,
+                row by row. Level zero is the depth buffer itself
+
+      Args:     std::uint32_t uLevel
+                  Index of the level
+                std::uint32_t& uOutWidth
+                  Width of the level
+                std::uint32_t& uOutHeight
+                  Height of the level
+
+      Returns:  const float*
+                  Depths of the level, nullptr if there is no such
+                  level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const float* OcclusionCuller::GetLevel(std::uint32_t uLevel, std::uint32_t& uOutWidth, std::uint32_t& uOutHeight) const
+    {
+        if (uLevel >= m_aLevels.size())
+        {
+            uOutWidth = 0u;
+            uOutHeight = 0u;
+            return nullptr;
+        }
+
+        uOutWidth = m_aLevels[uLevel].uWidth;
+        uOutHeight = m_aLevels[uLevel].uHeight;
+        return m_aLevels[uLevel].aDepths.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetStatistics
+
+      Summary:  Returns the counts and times since the last
+                RenderOccluders
+
+      Returns:  const OcclusionCullingStatistics&
+                  Statistics of the frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const OcclusionCullingStatistics& OcclusionCuller::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::parallelFor
+
+      Summary:  Calls a function on batches of a range of indices
+                through the parallel for given to the constructor, or
+                on the whole range on the calling thread without one
+
+      Args:     size_t uBegin
+                  First index
+                size_t uEnd
+                  Index past the last one
+                size_t uMinBatchSize
+                  Smallest number of indices worth a batch
+                const std::function<void(size_t, size_t)>& function
+                  Function called on every batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::parallelFor(std::size_t uBegin, std::size_t uEnd, std::size_t uMinBatchSize, const std::function<void(std::size_t, std::size_t)>& function) const
+    {
+        if (uBegin >= uEnd)
+        {
+            return;
+        }
+
+        if (!m_parallelFor)
+        {
+            function(uBegin, uEnd);
+            return;
+        }
+
+        m_parallelFor(uBegin, uEnd, uMinBatchSize, function);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::setupOccluder
+
+      Summary:  Turns the faces of an occluder into screen space
+                triangles. The occluder is first shrunk by the footprint
+                of a pixel at its farthest point, and dropped if nothing
+                is left of it. The bottom face is left out, as terrain
+                is never seen from below. Triangles are clipped against
+                the near plane in clip space, which splits one into two
+                at most, and back faces are dropped after projection
+
+      Args:     const BoundingBox& occluder
+                  World space box
+                ScreenTriangle* pOutTriangles
+                  Receives the triangles
+
+      Returns:  std::uint32_t
+                  Number of triangles written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::setupOccluder(const BoundingBox& occluder, ScreenTriangle* pOutTriangles) const
+    {
+        // Corner i lies on the maximum side of x, y and z for bits 0, 1
+        // and 2, and every face winds clockwise seen from outside
+        static constexpr const std::uint32_t NUM_FACES = 5u;
+        static constexpr const std::uint32_t s_aauFaces[NUM_FACES][4] =
+        {
+            { 2u, 6u, 7u, 3u },
+            { 0u, 4u, 6u, 2u },
+            { 1u, 3u, 7u, 5u },
+            { 0u, 2u, 3u, 1u },
+            { 4u, 5u, 7u, 6u },
+        };
+
+        const XMVECTOR center = XMLoadFloat3(&occluder.Center);
+
+        // The view depth w is linear over the box, so its farthest
+        // corner is where the center w grows by every extent along the
+        // sign of its w coefficient
+        const XMVECTOR wCoefficients = XMVectorSet(
+            XMVectorGetW(m_viewProjection.r[0]),
+            XMVectorGetW(m_viewProjection.r[1]),
+            XMVectorGetW(m_viewProjection.r[2]),
+            0.0f
+        );
+        const float farthestW = XMVectorGetW(XMVector4Transform(XMVectorSetW(center, 1.0f), m_viewProjection))
+            + XMVectorGetX(XMVector3Dot(XMVectorAbs(wCoefficients), XMLoadFloat3(&occluder.Extents)));
+        const XMVECTOR extents = XMVectorSubtract(XMLoadFloat3(&occluder.Extents), XMVectorReplicate(m_shrinkPerDepth * std::max<float>(farthestW, 0.0f)));
+        if (!XMVector3Greater(extents, XMVectorZero()))
+        {
+            return 0u;
+        }
+
+        XMFLOAT4 aCorners[8];
+        for (std::uint32_t uCorner = 0u; uCorner < 8u; ++uCorner)
+        {
+            const XMVECTOR sign = XMVectorSet(
+                (uCorner & 1u) ? 1.0f : -1.0f,
+                (uCorner & 2u) ? 1.0f : -1.0f,
+                (uCorner & 4u) ? 1.0f : -1.0f,
+                0.0f
+            );
+            XMStoreFloat4(&aCorners[uCorner], XMVector4Transform(XMVectorSetW(XMVectorMultiplyAdd(extents, sign, center), 1.0f), m_viewProjection));
+        }
+
+        const float width = static_cast<float>(m_desc.uWidth);
+        const float height = static_cast<float>(m_desc.uHeight);
+
+        std::uint32_t uNumTriangles = 0u;
+        for (std::uint32_t uFace = 0u; uFace < NUM_FACES; ++uFace)
+        {
+            for (std::uint32_t uHalf = 0u; uHalf < 2u; ++uHalf)
+            {
+                const XMFLOAT4 aTriangle[3] =
+                {
+                    aCorners[s_aauFaces[uFace][0]],
+                    aCorners[s_aauFaces[uFace][1u + uHalf]],
+                    aCorners[s_aauFaces[uFace][2u + uHalf]],
+                };
+
+                // Sutherland-Hodgman against z >= 0
+                XMFLOAT4 aPolygon[4];
+                std::uint32_t uNumVertices = 0u;
+                for (std::uint32_t i = 0u; i < 3u; ++i)
+                {
+                    const XMFLOAT4& current = aTriangle[i];
+                    const XMFLOAT4& next = aTriangle[(i + 1u) % 3u];
+                    if (current.z >= 0.0f)
+                    {
+                        aPolygon[uNumVertices++] = current;
+                    }
+                    if ((current.z >= 0.0f) != (next.z >= 0.0f))
+                    {
+                        const float t = current.z / (current.z - next.z);
+                        aPolygon[uNumVertices++] = XMFLOAT4(
+                            current.x + (next.x - current.x) * t,
+                            current.y + (next.y - current.y) * t,
+                            0.0f,
+                            current.w + (next.w - current.w) * t
+                        );
+                    }
+                }
+                if (uNumVertices < 3u)
+                {
+                    continue;
+                }
+
+                float afX[4];
+                float afY[4];
+                float afZ[4];
+                for (std::uint32_t i = 0u; i < uNumVertices; ++i)
+                {
+                    const float inverseW = 1.0f / aPolygon[i].w;
+                    afX[i] = (aPolygon[i].x * inverseW * 0.5f + 0.5f) * width;
+                    afY[i] = (0.5f - aPolygon[i].y * inverseW * 0.5f) * height;
+                    afZ[i] = aPolygon[i].z * inverseW;
+                }
+
+                // A clipped triangle stays convex and keeps its winding
+                const float area = (afX[1] - afX[0]) * (afY[2] - afY[0]) - (afX[2] - afX[0]) * (afY[1] - afY[0]);
+                if (!(area > 0.0f))
+                {
+                    continue;
+                }
+
+                for (std::uint32_t i = 1u; i + 1u < uNumVertices; ++i)
+                {
+                    ScreenTriangle& triangle = pOutTriangles[uNumTriangles++];
+                    triangle = ScreenTriangle
+                    {
+                        .afX = { afX[0], afX[i], afX[i + 1u] },
+                        .afY = { afY[0], afY[i], afY[i + 1u] },
+                        .afZ = { afZ[0], afZ[i], afZ[i + 1u] },
+                    };
+                }
+            }
+        }
+
+        return uNumTriangles;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::binTriangles
+
+      Summary:  Lists every triangle under the bands of rows whose
+                pixel centers it may cover, in the order of the
+                occluders. Triangles off the screen are left out
+
+      Modifies: [m_aauBandTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::binTriangles()
+    {
+        for (std::vector<std::uint32_t>& auTriangles : m_aauBandTriangles)
+        {
+            auTriangles.clear();
+        }
+
+        const float width = static_cast<float>(m_desc.uWidth);
+        const int iLastRow = static_cast<int>(m_desc.uHeight) - 1;
+        for (std::size_t uOccluder = 0u; uOccluder < m_auNumTriangles.size(); ++uOccluder)
+        {
+            for (std::uint32_t i = 0u; i < m_auNumTriangles[uOccluder]; ++i)
+            {
+                const std::uint32_t uTriangle = static_cast<std::uint32_t>(uOccluder * MAX_TRIANGLES_PER_OCCLUDER + i);
+                const ScreenTriangle& triangle = m_aTriangles[uTriangle];
+                const float minX = std::min<float>(triangle.afX[0], std::min<float>(triangle.afX[1], triangle.afX[2]));
+                const float maxX = std::max<float>(triangle.afX[0], std::max<float>(triangle.afX[1], triangle.afX[2]));
+                const float minY = std::min<float>(triangle.afY[0], std::min<float>(triangle.afY[1], triangle.afY[2]));
+                const float maxY = std::max<float>(triangle.afY[0], std::max<float>(triangle.afY[1], triangle.afY[2]));
+                if (maxX < 0.0f || minX > width || maxY < 0.0f || minY > static_cast<float>(m_desc.uHeight))
+                {
+                    continue;
+                }
+
+                const int iFirstRow = std::max<int>(0, static_cast<int>(std::ceil(minY - 0.5f)));
+                const int iLastTriangleRow = std::min<int>(iLastRow, static_cast<int>(std::floor(maxY - 0.5f)));
+                for (int iBand = iFirstRow / static_cast<int>(ROWS_PER_BAND); iBand <= iLastTriangleRow / static_cast<int>(ROWS_PER_BAND) && iFirstRow <= iLastTriangleRow; ++iBand)
+                {
+                    m_aauBandTriangles[iBand].push_back(uTriangle);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeBand
+
+      Summary:  Clears a band of rows of the depth buffer and draws the
+                triangles binned under it. Bands do not share pixels,
+                so they are drawn without locks
+
+      Args:     std::uint32_t uBand
+                  Index of the band
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeBand(std::uint32_t uBand)
+    {
+        const std::uint32_t uFirstRow = uBand * ROWS_PER_BAND;
+        const std::uint32_t uEndRow = std::min<std::uint32_t>(uFirstRow + ROWS_PER_BAND, m_desc.uHeight);
+
+        std::vector<float>& aDepths = m_aLevels[0].aDepths;
+        std::fill(
+            aDepths.begin() + static_cast<std::size_t>(uFirstRow) * m_desc.uWidth,
+            aDepths.begin() + static_cast<std::size_t>(uEndRow) * m_desc.uWidth,
+            1.0f
+        );
+
+        for (std::uint32_t uTriangle : m_aauBandTriangles[uBand])
+        {
+            rasterizeTriangle(m_aTriangles[uTriangle], uFirstRow, uEndRow);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeTriangle
+
+      Summary:  Draws the rows of a front facing screen triangle that
+                lie in a band, keeping the nearest depth of every pixel
+                whose center it covers. Four pixels of a row are tested
+                against the three edge functions and depth tested at
+                once with SSE
+
+      Args:     const ScreenTriangle& triangle
+                  Screen space triangle, clockwise on screen
+                std::uint32_t uFirstRow
+                  First row of the band
+                std::uint32_t uEndRow
+                  Row past the last one of the band
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeTriangle(const ScreenTriangle& triangle, std::uint32_t uFirstRow, std::uint32_t uEndRow)
+    {
+        const float* afX = triangle.afX;
+        const float* afY = triangle.afY;
+        const float* afZ = triangle.afZ;
+
+        // Pixel (x, y) is covered if its center (x + 0.5, y + 0.5) is
+        const float minY = std::min<float>(afY[0], std::min<float>(afY[1], afY[2]));
+        const float maxY = std::max<float>(afY[0], std::max<float>(afY[1], afY[2]));
+        const float minX = std::min<float>(afX[0], std::min<float>(afX[1], afX[2]));
+        const float maxX = std::max<float>(afX[0], std::max<float>(afX[1], afX[2]));
+        if (maxY < static_cast<float>(uFirstRow) || minY > static_cast<float>(uEndRow) || maxX < 0.0f || minX > static_cast<float>(m_desc.uWidth))
+        {
+            return;
+        }
+
+        const int iFirstRow = std::max<int>(static_cast<int>(uFirstRow), static_cast<int>(std::ceil(minY - 0.5f)));
+        const int iEndRow = std::min<int>(static_cast<int>(uEndRow), static_cast<int>(std::floor(maxY - 0.5f)) + 1);
+        const int iFirstColumn = std::max<int>(0, static_cast<int>(std::ceil(minX - 0.5f))) & ~3;
+        const int iEndColumn = std::min<int>(static_cast<int>(m_desc.uWidth), static_cast<int>(std::floor(maxX - 0.5f)) + 1);
+        if (iFirstRow >= iEndRow || iFirstColumn >= iEndColumn)
+        {
+            return;
+        }
+
+        // Edge i runs from vertex i to the next one, and is positive on
+        // the inside of a triangle that is clockwise on screen
+        float afEdgeA[3];
+        float afEdgeB[3];
+        float afEdgeC[3];
+        for (std::uint32_t i = 0u; i < 3u; ++i)
+        {
+            const std::uint32_t j = (i + 1u) % 3u;
+            afEdgeA[i] = afY[i] - afY[j];
+            afEdgeB[i] = afX[j] - afX[i];
+            afEdgeC[i] = -(afEdgeA[i] * afX[i] + afEdgeB[i] * afY[i]);
+        }
+
+        // Depth is linear in screen space
+        const float area = (afX[1] - afX[0]) * (afY[2] - afY[0]) - (afX[2] - afX[0]) * (afY[1] - afY[0]);
+        const float depthDx = ((afZ[1] - afZ[0]) * (afY[2] - afY[0]) - (afZ[2] - afZ[0]) * (afY[1] - afY[0])) / area;
+        const float depthDy = ((afZ[2] - afZ[0]) * (afX[1] - afX[0]) - (afZ[1] - afZ[0]) * (afX[2] - afX[0])) / area;
+        const float depthC = afZ[0] - depthDx * afX[0] - depthDy * afY[0];
+
+        const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 edgeA0 = _mm_set1_ps(afEdgeA[0]);
+        const __m128 edgeA1 = _mm_set1_ps(afEdgeA[1]);
+        const __m128 edgeA2 = _mm_set1_ps(afEdgeA[2]);
+        const __m128 edgeStep0 = _mm_set1_ps(afEdgeA[0] * 4.0f);
+        const __m128 edgeStep1 = _mm_set1_ps(afEdgeA[1] * 4.0f);
+        const __m128 edgeStep2 = _mm_set1_ps(afEdgeA[2] * 4.0f);
+        const __m128 depthStep = _mm_set1_ps(depthDx * 4.0f);
+
+        float* pDepths = m_aLevels[0].aDepths.data();
+        for (int y = iFirstRow; y < iEndRow; ++y)
+        {
+            const float centerY = static_cast<float>(y) + 0.5f;
+            const __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(iFirstColumn)), pixelOffsets);
+
+            __m128 edge0 = _mm_add_ps(_mm_mul_ps(edgeA0, pixelX), _mm_set1_ps(afEdgeB[0] * centerY + afEdgeC[0]));
+            __m128 edge1 = _mm_add_ps(_mm_mul_ps(edgeA1, pixelX), _mm_set1_ps(afEdgeB[1] * centerY + afEdgeC[1]));
+            __m128 edge2 = _mm_add_ps(_mm_mul_ps(edgeA2, pixelX), _mm_set1_ps(afEdgeB[2] * centerY + afEdgeC[2]));
+            __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthDx), pixelX), _mm_set1_ps(depthDy * centerY + depthC));
+
+            float* pRow = pDepths + static_cast<std::size_t>(y) * m_desc.uWidth;
+            for (int x = iFirstColumn; x < iEndColumn; x += 4)
+            {
+                const __m128 inside = _mm_and_ps(
+                    _mm_cmpge_ps(edge0, zero),
+                    _mm_and_ps(_mm_cmpge_ps(edge1, zero), _mm_cmpge_ps(edge2, zero))
+                );
+                if (_mm_movemask_ps(inside) != 0)
+                {
+                    const __m128 previous = _mm_loadu_ps(pRow + x);
+                    const __m128 nearest = _mm_min_ps(previous, depth);
+                    _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, previous)));
+                }
+
+                edge0 = _mm_add_ps(edge0, edgeStep0);
+                edge1 = _mm_add_ps(edge1, edgeStep1);
+                edge2 = _mm_add_ps(edge2, edgeStep2);
+                depth = _mm_add_ps(depth, depthStep);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::buildPyramid
+
+      Summary:  Fills every level of the pyramid with the farthest depth
+                of the 2 x 2 texels below it. A level of odd size takes
+                the last row or column alone. The second level, the
+                only large one, is built in bands through the parallel
+                for
+
+      Modifies: [m_aLevels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::buildPyramid()
+    {
+        auto reduceRows = [this](std::uint32_t uLevel, std::uint32_t uFirstRow, std::uint32_t uEndRow)
+        {
+            const HiZLevel& source = m_aLevels[uLevel - 1u];
+            HiZLevel& destination = m_aLevels[uLevel];
+            for (std::uint32_t y = uFirstRow; y < uEndRow; ++y)
+            {
+                const float* pRow0 = &source.aDepths[static_cast<std::size_t>(2u * y) * source.uWidth];
+                const float* pRow1 = 2u * y + 1u < source.uHeight ? pRow0 + source.uWidth : pRow0;
+                float* pDestination = &destination.aDepths[static_cast<std::size_t>(y) * destination.uWidth];
+                for (std::uint32_t x = 0u; x < destination.uWidth; ++x)
+                {
+                    const std::uint32_t x0 = 2u * x;
+                    const std::uint32_t x1 = std::min<std::uint32_t>(x0 + 1u, source.uWidth - 1u);
+                    pDestination[x] = std::max<float>(std::max<float>(pRow0[x0], pRow0[x1]), std::max<float>(pRow1[x0], pRow1[x1]));
+                }
+            }
+        };
+
+        if (m_aLevels.size() < 2u)
+        {
+            return;
+        }
+
+        const std::uint32_t uHeight = m_aLevels[1].uHeight;
+        const std::uint32_t uRowsPerBand = ROWS_PER_BAND / 2u;
+        parallelFor(0u, (uHeight + uRowsPerBand - 1u) / uRowsPerBand, 1u, [&reduceRows, uHeight, uRowsPerBand](std::size_t uBegin, std::size_t uEnd)
+        {
+            for (std::size_t uBand = uBegin; uBand < uEnd; ++uBand)
+            {
+                const std::uint32_t uFirstRow = static_cast<std::uint32_t>(uBand) * uRowsPerBand;
+                reduceRows(1u, uFirstRow, std::min<std::uint32_t>(uFirstRow + uRowsPerBand, uHeight));
+            }
+        });
+
+        for (std::uint32_t uLevel = 2u; uLevel < m_aLevels.size(); ++uLevel)
+        {
+            reduceRows(uLevel, 0u, m_aLevels[uLevel].uHeight);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declarations of the
+             OcclusionCuller class that rasterizes occluders into a
+             coarse depth buffer on the processor and tests bounding
+             boxes against it for the lab samples of Game Graphics
+             Programming course. It needs nothing but the standard
+             library and DirectXMath, and leaves out the SAL
+             annotations, so it builds and runs headless with any
+             compiler.
+
+  Classes: OcclusionCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <DirectXCollision.h>
+#include <DirectXMath.h>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   OcclusionCullingDesc
+
+      Summary:  Size of the depth buffer in pixels, the width is
+                rounded up to a multiple of four, and the number of
+                nearest occluders drawn into it every frame
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct OcclusionCullingDesc
+    {
+        std::uint32_t uWidth;
+        std::uint32_t uHeight;
+        std::uint32_t uMaxOccluders;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   OcclusionCullingStatistics
+
+      Summary:  Occluders and triangles drawn into the depth buffer,
+                boxes tested against it and how many of them were
+                hidden, and the time both steps took
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct OcclusionCullingStatistics
+    {
+        std::uint32_t uNumOccluders;
+        std::uint32_t uNumTriangles;
+        std::uint32_t uNumTestedBoxes;
+        std::uint32_t uNumOccludedBoxes;
+        double rasterizationMilliseconds;
+        double testMilliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+
+      Summary:  Software occlusion culling that needs no Direct3D
+                device. The nearest occluder boxes in the view frustum
+                are clipped against the near plane, binned by the bands
+                of rows they overlap and rasterized four pixels at a
+                time with SSE into a small buffer of the nearest depth,
+                one band per batch of the parallel for. A pyramid keeps
+                the farthest depth of every 2 x 2 texels of the level
+                below, so a bounding box is tested against at most
+                2 x 2 texels of the level its screen rectangle fits in,
+                and is hidden if its nearest point lies behind all of
+                them. Occluders must lie inside the solid geometry they
+                stand for. Coverage is sampled at pixel centers, so
+                every occluder is first shrunk by the footprint of a
+                pixel at its farthest point: a pixel whose center the
+                shrunk box covers is wholly covered by the box it
+                stands for, no nearer than its stored depth, and an
+                occluder thinner than that is not drawn
+
+      Methods:  RenderOccluders
+                  Rasterizes the nearest occluders and builds the
+                  pyramid
+                IsVisible
+                  Returns whether a box may be visible
+                TestBoxes
+                  Tests many boxes through the parallel for
+                GetWidth
+                  Returns the width of the depth buffer
+                GetHeight
+                  Returns the height of the depth buffer
+                GetNumLevels
+                  Returns the number of levels of the pyramid
+                GetLevel
+                  Returns the farthest depths of a level
+                GetStatistics
+                  Returns the counts and times of the frame
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller final
+    {
+    public:
+        // Calls the function on batches of at least uMinBatchSize
+        // indices that cover [uBegin, uEnd), possibly on several
+        // threads at once, and returns once every batch is done
+        using ParallelForFunction = std::function<void(std::size_t uBegin, std::size_t uEnd, std::size_t uMinBatchSize, const std::function<void(std::size_t, std::size_t)>& function)>;
+
+        static constexpr const OcclusionCullingDesc DEFAULT_DESC =
+        {
+            .uWidth = 256u,
+            .uHeight = 128u,
+            .uMaxOccluders = 1024u,
+        };
+
+        explicit OcclusionCuller(const OcclusionCullingDesc& desc, ParallelForFunction parallelFor = ParallelForFunction());
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller() = default;
+
+        void RenderOccluders(const DirectX::BoundingBox* pOccluders, std::size_t uNumOccluders, const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& projection);
+        bool IsVisible(const DirectX::BoundingBox& boundingBox) const;
+        std::uint32_t TestBoxes(const DirectX::BoundingBox* pBoxes, std::size_t uNumBoxes, std::uint8_t* pbOutVisible);
+
+        std::uint32_t GetWidth() const;
+        std::uint32_t GetHeight() const;
+        std::uint32_t GetNumLevels() const;
+        const float* GetLevel(std::uint32_t uLevel, std::uint32_t& uOutWidth, std::uint32_t& uOutHeight) const;
+        const OcclusionCullingStatistics& GetStatistics() const;
+
+    private:
+        static constexpr const std::uint32_t MAX_TRIANGLES_PER_OCCLUDER = 20u;
+        static constexpr const std::uint32_t ROWS_PER_BAND = 8u;
+
+        struct ScreenTriangle
+        {
+            float afX[3];
+            float afY[3];
+            float afZ[3];
+        };
+
+        struct HiZLevel
+        {
+            std::uint32_t uWidth;
+            std::uint32_t uHeight;
+            std::vector<float> aDepths;
+        };
+
+        void parallelFor(std::size_t uBegin, std::size_t uEnd, std::size_t uMinBatchSize, const std::function<void(std::size_t, std::size_t)>& function) const;
+        std::uint32_t setupOccluder(const DirectX::BoundingBox& occluder, ScreenTriangle* pOutTriangles) const;
+        void binTriangles();
+        void rasterizeBand(std::uint32_t uBand);
+        void rasterizeTriangle(const ScreenTriangle& triangle, std::uint32_t uFirstRow, std::uint32_t uEndRow);
+        void buildPyramid();
+
+    private:
+        OcclusionCullingDesc m_desc;
+        ParallelForFunction m_parallelFor;
+        DirectX::XMMATRIX m_viewProjection;
+        float m_shrinkPerDepth;
+        std::vector<HiZLevel> m_aLevels;
+        std::vector<ScreenTriangle> m_aTriangles;
+        std::vector<std::uint32_t> m_auNumTriangles;
+        std::vector<std::vector<std::uint32_t>> m_aauBandTriangles;
+        std::vector<std::pair<float, std::uint32_t>> m_aSortedOccluders;
+        OcclusionCullingStatistics m_statistics;
+    };
+}
@@ -1,6 +1,11 @@
 #include "Scene/Scene.h"
 
+#include <algorithm>
+#include <intrin.h>
+#include <immintrin.h>
+
 #include "Shader/SkyMapVertexShader.h"
+#include "Thread/ThreadPool.h"
 
 namespace library
 {
@@ -24,138 +29,314 @@ namespace library
         return fin / div;
     }
 
-    Scene::Scene(const std::filesystem::path& filePath)
-        : m_filePath(filePath)
-        , m_voxels()
-        , m_renderables()
-        , m_aPointLights{ nullptr, nullptr }
-        , m_vertexShaders()
-        , m_pixelShaders()
-        , m_skyBox()
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPerlin2dBatch
+
+      Summary:  Evaluates GetPerlin2d for a batch of non-negative
+                coordinates, eight samples at a time with AVX2 when the
+                processor supports it and four at a time with SSE
+                otherwise. The operations are the same as the scalar
+                path, so the results match it
+
+      Args:     const FLOAT* pX
+                  X coordinates of the samples
+                const FLOAT* pY
+                  Y coordinates of the samples
+                size_t uNumSamples
+                  Number of samples
+                FLOAT frequency
+                  Frequency of the first octave
+                UINT uDepth
+                  Number of octaves
+                FLOAT* pOutNoise
+                  Receives the noise of every sample
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::GetPerlin2dBatch(
+        _In_reads_(uNumSamples) const FLOAT* pX,
+        _In_reads_(uNumSamples) const FLOAT* pY,
+        _In_ size_t uNumSamples,
+        _In_ FLOAT frequency,
+        _In_ UINT uDepth,
+        _Out_writes_(uNumSamples) FLOAT* pOutNoise
+    )
     {
-        std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
+        static const BOOL s_bAvx2Supported = isAvx2Supported();
 
-        std::string trash;
-        UINT aDimension[4] = { 0u, };
-        UINT uDimensionIdx = 0u;
-        while (!inputFile.eof() && uDimensionIdx < ARRAYSIZE(aDimension))
+        size_t uNumEvaluated = 0u;
+        if (s_bAvx2Supported)
         {
-            inputFile >> aDimension[uDimensionIdx];
+            uNumEvaluated = getPerlin2dBatchAvx2(pX, pY, uNumSamples, frequency, uDepth, pOutNoise);
+        }
+        uNumEvaluated += getPerlin2dBatchSse(pX + uNumEvaluated, pY + uNumEvaluated, uNumSamples - uNumEvaluated, frequency, uDepth, pOutNoise + uNumEvaluated);
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
-            {
-                ++uDimensionIdx;
-            }
+        for (size_t i = uNumEvaluated; i < uNumSamples; ++i)
+        {
+            pOutNoise[i] = GetPerlin2d(pX[i], pY[i], frequency, uDepth);
         }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::MeasurePerlin2dThroughput
+
+      Summary:  Samples the noise of a grid of the given size with
+                GetPerlin2d and with GetPerlin2dBatch one row at a
+                time, and writes the samples per second of both paths
+                and their largest difference to the debugger output
+
+      Args:     UINT uWidth
+                  Number of samples along x
+                UINT uDepth
+                  Number of samples along z
 
-        UINT uColorIdx = 0u;
-        XMFLOAT4 color;
-        while (!inputFile.eof() && uColorIdx < aDimension[3])
+      Returns:  FLOAT
+                  Largest absolute difference between the two paths
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT Scene::MeasurePerlin2dThroughput(_In_ UINT uWidth, _In_ UINT uDepth)
+    {
+        constexpr const FLOAT FREQUENCY = 0.1f;
+        constexpr const UINT NUM_OCTAVES = 4u;
+
+        size_t uNumSamples = static_cast<size_t>(uWidth) * uDepth;
+        std::vector<FLOAT> aScalarNoise(uNumSamples);
+        std::vector<FLOAT> aBatchNoise(uNumSamples);
+        std::vector<FLOAT> aX(uWidth);
+        std::vector<FLOAT> aY(uWidth);
+        for (UINT x = 0u; x < uWidth; ++x)
         {
-            inputFile >> color.x >> color.y >> color.z;
+            aX[x] = static_cast<FLOAT>(x);
+        }
 
-            if (inputFile.fail())
-            {
-                if (inputFile.eof())
-                {
-                    break;
-                }
-                inputFile.clear();
-                inputFile >> trash;
-            }
-            else
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
             {
-                color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
-                ++uColorIdx;
+                aScalarNoise[static_cast<size_t>(z) * uWidth + x] = GetPerlin2d(static_cast<FLOAT>(x), static_cast<FLOAT>(z), FREQUENCY, NUM_OCTAVES);
             }
         }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE scalarSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
+        QueryPerformanceCounter(&startingTime);
+        for (UINT z = 0u; z < uDepth; ++z)
         {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
+            std::fill(aY.begin(), aY.end(), static_cast<FLOAT>(z));
+            GetPerlin2dBatch(aX.data(), aY.data(), uWidth, FREQUENCY, NUM_OCTAVES, aBatchNoise.data() + static_cast<size_t>(z) * uWidth);
         }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE batchSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
 
-        UINT uDepthIdx = 0u;
-        UINT uWidthIdx = 0u;
-        CHAR voxelType;
-        FLOAT height;
-        while (!inputFile.eof())
+        FLOAT maxDifference = 0.0f;
+        for (size_t i = 0u; i < uNumSamples; ++i)
         {
-            inputFile >> voxelType >> height;
+            maxDifference = std::max<FLOAT>(maxDifference, fabsf(aScalarNoise[i] - aBatchNoise[i]));
+        }
 
-            if (inputFile.fail())
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Scene: Perlin noise of %zu sample(s), scalar %.2f Msamples/s, batch (%s) %.2f Msamples/s, max difference %g\n",
+            uNumSamples,
+            scalarSeconds > 0.0 ? static_cast<DOUBLE>(uNumSamples) / scalarSeconds / 1.0e6 : 0.0,
+            isAvx2Supported() ? "AVX2" : "SSE",
+            batchSeconds > 0.0 ? static_cast<DOUBLE>(uNumSamples) / batchSeconds / 1.0e6 : 0.0,
+            static_cast<DOUBLE>(maxDifference)
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return maxDifference;
+    }
+
+    Scene::Scene(
+        const std::filesystem::path& filePath,
+        _In_ BOOL bCullHiddenVoxels,
+        _In_ eVoxelMeshingMode voxelMeshingMode
+    )
+        : Scene(filePath, bCullHiddenVoxels, voxelMeshingMode, nullptr)
+    {
+        if (m_filePath.extension() == L".vcol")
+        {
+            m_pVoxelColumnStore = std::make_unique<VoxelColumnStore>();
+            if (SUCCEEDED(m_pVoxelColumnStore->Load(m_filePath)))
             {
-                if (inputFile.eof())
+                createVoxels();
+            }
+        }
+        else if (m_filePath.extension() == L".hmap")
+        {
+            HeightMapFile heightMapFile;
+            if (SUCCEEDED(heightMapFile.Open(m_filePath)))
+            {
+                if (m_voxelMeshingMode == eVoxelMeshingMode::GREEDY_MESH)
                 {
-                    break;
+                    createVoxelChunkMeshes(heightMapFile.GetDesc());
+                }
+                else
+                {
+                    m_pVoxelColumnStore = std::make_unique<VoxelColumnStore>();
+                    if (SUCCEEDED(m_pVoxelColumnStore->Create(heightMapFile.GetDesc())))
+                    {
+                        createVoxels();
+                    }
                 }
-                inputFile.clear();
-                inputFile >> trash;
             }
-            else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
+        }
+        else
+        {
+            HeightMap heightMap;
+            if (SUCCEEDED(heightMap.LoadText(m_filePath)))
             {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
+                if (m_voxelMeshingMode == eVoxelMeshingMode::GREEDY_MESH)
                 {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
+                    createVoxelChunkMeshes(heightMap.GetDesc());
                 }
-                ++uWidthIdx;
-                if (uWidthIdx >= aDimension[0])
+                else
                 {
-                    uWidthIdx -= aDimension[0];
-                    ++uDepthIdx;
-
-                    if (uDepthIdx >= aDimension[2])
+                    m_pVoxelColumnStore = std::make_unique<VoxelColumnStore>();
+                    if (SUCCEEDED(m_pVoxelColumnStore->Create(heightMap.GetDesc())))
                     {
-                        uDepthIdx -= aDimension[2];
+                        createVoxels();
                     }
                 }
             }
         }
+    }
 
-        inputFile.close();
-
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
+
+      Summary:  Constructor of a scene built from a height map held in
+                memory, such as the output of a TerrainGenerator. The
+                columns are only read during construction
+
+      Args:     const HeightMapDesc& heightMap
+                  Columns of the height map
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  skipped
+                eVoxelMeshingMode voxelMeshingMode
+                  Whether the voxels are instanced cubes or meshes
+
+      Modifies: [m_bCullHiddenVoxels, m_voxelMeshingMode, m_voxels,
+                 m_pVoxelColumnStore, m_voxelChunks, m_voxelChunkMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(
+        _In_ const HeightMapDesc& heightMap,
+        _In_ BOOL bCullHiddenVoxels,
+        _In_ eVoxelMeshingMode voxelMeshingMode
+    )
+        : Scene(std::filesystem::path(), bCullHiddenVoxels, voxelMeshingMode, nullptr)
+    {
+        if (m_voxelMeshingMode == eVoxelMeshingMode::GREEDY_MESH)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
-            {
-                it = m_voxels.erase(it);
-            }
-            else
+            createVoxelChunkMeshes(heightMap);
+        }
+        else
+        {
+            m_pVoxelColumnStore = std::make_unique<VoxelColumnStore>();
+            if (SUCCEEDED(m_pVoxelColumnStore->Create(heightMap)))
             {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
+                createVoxels();
             }
-            ++uVoxelIdx;
         }
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
+
+      Summary:  Constructor of a scene that streams the chunks of a
+                binary height map around the camera instead of building
+                all of them. The file stays mapped while the scene
+                lives and one voxel is created per palette entry, so
+                block types double as voxel indices
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the binary height map
+                const TerrainStreamingDesc& streamingDesc
+                  Chunk size, residency radius and budgets
+
+      Modifies: [m_filePath, m_bCullHiddenVoxels, m_voxelMeshingMode,
+                 m_voxels, m_pHeightMapFile, m_pTerrainStreamer].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(const std::filesystem::path& filePath, _In_ const TerrainStreamingDesc& streamingDesc)
+        : Scene(filePath, TRUE, eVoxelMeshingMode::INSTANCED_CUBES, std::make_unique<HeightMapFile>())
+    {
+        if (FAILED(m_pHeightMapFile->Open(m_filePath)))
+        {
+            return;
+        }
+
+        const HeightMapDesc heightMap = m_pHeightMapFile->GetDesc();
+        for (UINT uColorIdx = 0u; uColorIdx < heightMap.uNumColors; ++uColorIdx)
+        {
+            const XMFLOAT3& color = heightMap.pPalette[uColorIdx];
+            m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(color.x, color.y, color.z, 1.0f)));
+        }
+
+        m_pTerrainStreamer = std::make_unique<TerrainStreamer>(heightMap, m_bCullHiddenVoxels, streamingDesc);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Scene
+
+      Summary:  Constructor the others delegate to, which initializes
+                every member of an empty scene
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the height map, empty if it is held in memory
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  skipped
+                eVoxelMeshingMode voxelMeshingMode
+                  Whether the voxels are instanced cubes or meshes
+                std::unique_ptr<HeightMapFile> pHeightMapFile
+                  Height map file kept mapped while the scene lives, or
+                  nullptr
+
+      Modifies: [every member].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Scene::Scene(
+        const std::filesystem::path& filePath,
+        _In_ BOOL bCullHiddenVoxels,
+        _In_ eVoxelMeshingMode voxelMeshingMode,
+        _In_ std::unique_ptr<HeightMapFile> pHeightMapFile
+    )
+        : m_filePath(filePath)
+        , m_bCullHiddenVoxels(bCullHiddenVoxels)
+        , m_voxelBuildStatistics{ .ullNumSolidVoxels = 0u, .ullNumInstances = 0u, .ullNumCulledVoxels = 0u }
+        , m_voxelMeshingMode(voxelMeshingMode)
+        , m_voxels()
+        , m_pVoxelColumnStore()
+        , m_voxelChunks()
+        , m_voxelChunkVertexShader()
+        , m_voxelChunkPixelShader()
+        , m_pHeightMapFile(std::move(pHeightMapFile))
+        , m_pTerrainStreamer()
+        , m_pVoxelLodSelector()
+        , m_pVoxelRaycaster()
+        , m_pVoxelCollider()
+        , m_pVoxelLightField()
+        , m_pVoxelEditor()
+        , m_pOcclusionCuller()
+        , m_aOccluders()
+        , m_uNumOccluderTilesX(0u)
+        , m_aOcclusionTestBoxes()
+        , m_abOcclusionTestResults()
+        , m_voxelChunkMeshes()
+        , m_renderables()
+        , m_models()
+        , m_aPointLights{ nullptr, nullptr }
+        , m_vertexShaders()
+        , m_pixelShaders()
+        , m_skyBox()
+    {
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::Initialize
 
@@ -182,6 +363,35 @@ namespace library
             }
         }
 
+        if (m_pVoxelLodSelector)
+        {
+            HRESULT hr = m_pVoxelLodSelector->Initialize(pDevice);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+        else
+        {
+            for (std::shared_ptr<VoxelChunk>& voxelChunk : m_voxelChunks)
+            {
+                HRESULT hr = voxelChunk->Initialize(pDevice);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        for (std::shared_ptr<VoxelChunkMesh>& voxelChunkMesh : m_voxelChunkMeshes)
+        {
+            HRESULT hr = voxelChunkMesh->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
         for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
         {
             HRESULT hr = it->second->Initialize(pDevice);
@@ -454,6 +664,61 @@ namespace library
         return m_voxels;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelChunks
+
+      Summary:  Returns the vector of voxel chunks
+
+      Returns:  std::vector<std::shared_ptr<VoxelChunk>>&
+                  Voxel chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<VoxelChunk>>& Scene::GetVoxelChunks()
+    {
+        return m_voxelChunks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVertexShaderOfVoxelChunks
+
+      Summary:  Returns the vertex shader that decodes the packed
+                instances of the voxel chunks
+
+      Returns:  std::shared_ptr<VertexShader>&
+                  Vertex shader. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<VertexShader>& Scene::GetVertexShaderOfVoxelChunks()
+    {
+        return m_voxelChunkVertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetPixelShaderOfVoxelChunks
+
+      Summary:  Returns the pixel shader that shades the voxel chunks
+                with their baked light
+
+      Returns:  std::shared_ptr<PixelShader>&
+                  Pixel shader. Could be a nullptr, then the voxels
+                  keep their own pixel shaders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<PixelShader>& Scene::GetPixelShaderOfVoxelChunks()
+    {
+        return m_voxelChunkPixelShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelChunkMeshes
+
+      Summary:  Returns the vector of voxel chunk meshes
+
+      Returns:  std::vector<std::shared_ptr<VoxelChunkMesh>>&
+                  Voxel chunk meshes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<VoxelChunkMesh>>& Scene::GetVoxelChunkMeshes()
+    {
+        return m_voxelChunkMeshes;
+    }
+
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetRenderables
@@ -564,174 +829,1507 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetVertexShaderOfRenderable
+      Method:   Scene::IsCullingHiddenVoxels
 
-      Summary:  Sets the vertex shader for a renderable
+      Summary:  Returns whether voxels without a face exposed to air
+                are left out of the voxel instances
 
-      Args:     PCWSTR pszRenderableName
-                  Key of the renderable
-                PCWSTR pszVertexShaderName
-                  Key of the vertex shader
+      Returns:  BOOL
+                  TRUE if hidden voxels are culled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::IsCullingHiddenVoxels() const
+    {
+        return m_bCullHiddenVoxels;
+    }
 
-      Modifies: [m_renderables].
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelBuildStatistics
 
-      Returns:  HRESULT
-                  Status code
+      Summary:  Returns how many voxels of the height map were emitted
+                as instances and how many were culled
+
+      Returns:  const VoxelBuildStatistics&
+                  Statistics of the voxel build
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
+    const VoxelBuildStatistics& Scene::GetVoxelBuildStatistics() const
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_vertexShaders.contains(pszVertexShaderName))
-        {
-            return E_FAIL;
-        }
+        return m_voxelBuildStatistics;
+    }
 
-        m_renderables[pszRenderableName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelMeshingMode
 
-        return S_OK;
+      Summary:  Returns whether the voxels are drawn as instanced cubes
+                or as greedy chunk meshes
+
+      Returns:  eVoxelMeshingMode
+                  Voxel meshing mode
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eVoxelMeshingMode Scene::GetVoxelMeshingMode() const
+    {
+        return m_voxelMeshingMode;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetPixelShaderOfRenderable
+      Method:   Scene::IsStreamingTerrain
 
-      Summary:  Sets the pixel shader for a renderable
+      Summary:  Returns whether the voxel chunks are streamed around
+                the camera
 
-      Args:     PCWSTR pszRenderableName
-                  Key of the renderable
-                PCWSTR pszPixelShaderName
-                  Key of the pixel shader
+      Returns:  BOOL
+                  TRUE if the scene streams its terrain
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::IsStreamingTerrain() const
+    {
+        return m_pTerrainStreamer != nullptr;
+    }
 
-      Modifies: [m_renderables].
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetTerrainStreamingStatistics
 
-      Returns:  HRESULT
-                  Status code
+      Summary:  Returns the residency of the streamed chunks in the
+                last frame
+
+      Returns:  TerrainStreamingStatistics
+                  Resident and pending chunks, memory and changes. All
+                  zero if the scene does not stream its terrain
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName)
+    TerrainStreamingStatistics Scene::GetTerrainStreamingStatistics() const
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_pixelShaders.contains(pszPixelShaderName))
+        if (!m_pTerrainStreamer)
         {
-            return E_FAIL;
+            return TerrainStreamingStatistics{ .uNumResidentChunks = 0u, .uNumPendingBuilds = 0u, .uNumUploadedChunks = 0u, .uNumEvictedChunks = 0u, .ullResidentBytes = 0u };
         }
 
-        m_renderables[pszRenderableName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
-
-        return S_OK;
+        return m_pTerrainStreamer->GetStatistics();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetVertexShaderOfModel
+      Method:   Scene::GetVoxelLodStatistics
 
-      Summary:  Sets the vertex shader for a model
-
-      Args:     PCWSTR pszModelName
-                  Key of the renderable
-                PCWSTR pszVertexShaderName
-                  Key of the vertex shader
-
-      Modifies: [m_models].
+      Summary:  Returns the levels of detail selected in the last frame
 
-      Returns:  HRESULT
-                  Status code
+      Returns:  VoxelLodStatistics
+                  Chunks per level, instances and transitions. All zero
+                  if the scene has no levels of detail
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName)
+    VoxelLodStatistics Scene::GetVoxelLodStatistics() const
     {
-        if (!m_models.contains(pszModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+        if (!m_pVoxelLodSelector)
         {
-            return E_FAIL;
+            return VoxelLodStatistics{ .auNumChunks = { 0u, }, .uNumTransitions = 0u, .ullNumInstances = 0u };
         }
 
-        m_models[pszModelName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
-
-        return S_OK;
+        return m_pVoxelLodSelector->GetStatistics();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetPixelShaderOfModel
+      Method:   Scene::GetVoxelEditStatistics
 
-      Summary:  Sets the pixel shader for a model
+      Summary:  Returns the voxel edits and chunk rebuilds of the last
+                frame
 
-      Args:     PCWSTR pszModelName
-                  Key of the renderable
-                PCWSTR pszPixelShaderName
-                  Key of the pixel shader
+      Returns:  VoxelEditStatistics
+                  Queued edits, pending rebuilds and uploads. All zero
+                  if the scene cannot be edited
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelEditStatistics Scene::GetVoxelEditStatistics() const
+    {
+        if (!m_pVoxelEditor)
+        {
+            return VoxelEditStatistics{ .uNumQueuedEdits = 0u, .uNumPendingBuilds = 0u, .uNumUploadedChunks = 0u, .ullNumUploadedInstances = 0u };
+        }
 
-      Modifies: [m_models].
+        return m_pVoxelEditor->GetStatistics();
+    }
 
-      Returns:  HRESULT
-                  Status code
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelLightStatistics
+
+      Summary:  Returns the emitters, the stored light and the cost of
+                the last change of the voxel light
+
+      Returns:  VoxelLightStatistics
+                  Emitters, sections and the last flood fills. All zero
+                  if the scene has no voxel light
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName)
+    VoxelLightStatistics Scene::GetVoxelLightStatistics() const
     {
-        if (!m_models.contains(pszModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+        if (!m_pVoxelLightField)
         {
-            return E_FAIL;
+            return VoxelLightStatistics{ .uNumEmitters = 0u, .uNumSections = 0u, .ullNumVisitedCells = 0u, .updateMilliseconds = 0.0 };
         }
 
-        m_models[pszModelName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
-
-        return S_OK;
+        return m_pVoxelLightField->GetStatistics();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetVertexShaderOfScene
+      Method:   Scene::UpdateTerrainStreaming
 
-      Summary:  Sets the vertex shader for the voxels in a scene
+      Summary:  Moves the streamed terrain along with the camera:
+                evicts and schedules chunks, uploads the finished ones
+                within the per-frame budget and refreshes the voxel
+                chunks to draw. Does nothing if the scene does not
+                stream its terrain
 
-      Args:     PCWSTR pszSceneName
-                  Key of the scene
-                PCWSTR pszVertexShaderName
-                  Key of the vertex shader
+      Args:     const XMVECTOR& eye
+                  World position of the camera
+                ID3D11Device* pDevice
+                  The Direct3D device to create the chunk buffers
 
-      Modifies: [m_scenes].
+      Modifies: [m_voxelChunks, m_pTerrainStreamer].
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName)
+    HRESULT Scene::UpdateTerrainStreaming(_In_ const XMVECTOR& eye, _In_ ID3D11Device* pDevice)
     {
-        if (!m_vertexShaders.contains(pszVertexShaderName))
+        if (!m_pTerrainStreamer)
         {
-            return E_FAIL;
+            return S_OK;
         }
 
-        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        XMFLOAT3 eyePosition;
+        XMStoreFloat3(&eyePosition, eye);
+        m_pTerrainStreamer->Update(eyePosition);
+
+        HRESULT hr = m_pTerrainStreamer->UploadFinishedChunks(pDevice);
+
+        const TerrainStreamingStatistics& statistics = m_pTerrainStreamer->GetStatistics();
+        if (statistics.uNumUploadedChunks > 0u || statistics.uNumEvictedChunks > 0u)
         {
-            voxel->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+            m_voxelChunks = m_pTerrainStreamer->GetResidentChunks();
         }
 
-        return S_OK;
+        return hr;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Scene::SetPixelShaderOfScene
+      Method:   Scene::UpdateVoxelLods
 
-      Summary:  Sets the pixel shader for the voxels in a scene
+      Summary:  Selects the level of detail of every voxel chunk from
+                its distance to the camera and refreshes the voxel
+                chunks to draw if any chunk switched level. Does
+                nothing if the scene has no levels of detail
 
-      Args:     PCWSTR pszRenderableName
-                  Key of the renderable
-                PCWSTR pszPixelShaderName
-                  Key of the pixel shader
+      Args:     const XMVECTOR& eye
+                  World position of the camera
 
-      Modifies: [m_renderables].
+      Modifies: [m_voxelChunks, m_pVoxelLodSelector].
 
-      Returns:  HRESULT
-                  Status code
+      Returns:  BOOL
+                  TRUE if the voxel chunks to draw changed
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Scene::SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName)
+    BOOL Scene::UpdateVoxelLods(_In_ const XMVECTOR& eye)
     {
-        if (!m_pixelShaders.contains(pszPixelShaderName))
+        if (!m_pVoxelLodSelector)
         {
-            return E_FAIL;
+            return FALSE;
         }
 
-        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        XMFLOAT3 eyePosition;
+        XMStoreFloat3(&eyePosition, eye);
+        if (!m_pVoxelLodSelector->Update(eyePosition))
         {
-            voxel->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+            return FALSE;
         }
 
-        return S_OK;
+        m_pVoxelLodSelector->GetSelectedChunks(m_voxelChunks);
+
+        return TRUE;
     }
 
-    FLOAT Scene::getNoise2(UINT x, UINT y)
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UpdateVoxelEdits
+
+      Summary:  Uploads the chunks rebuilt since the last frame, then
+                applies the queued edits and schedules the rebuilds of
+                the chunks they touched. Does nothing if the scene
+                cannot be edited
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the chunk buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to upload the instances
+
+      Modifies: [m_voxelChunks, m_pVoxelLodSelector, m_pVoxelEditor].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::UpdateVoxelEdits(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_pVoxelEditor)
+        {
+            return S_OK;
+        }
+
+        BOOL bChunksChanged = FALSE;
+        HRESULT hr = m_pVoxelEditor->UploadFinishedChunks(pDevice, pImmediateContext, *m_pVoxelLodSelector, bChunksChanged);
+        if (bChunksChanged)
+        {
+            m_pVoxelLodSelector->GetSelectedChunks(m_voxelChunks);
+        }
+
+        m_pVoxelEditor->Update();
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UpdateVoxelLight
+
+      Summary:  Bakes the light of the chunks whose light or instances
+                changed since the last frame into the full resolution
+                level of the chunk, across the worker threads, and
+                uploads what changed. Coarser levels and streamed
+                chunks carry no baked light and are drawn in full
+                sky. Call after UpdateVoxelEdits so rebuilt chunks are
+                baked the frame they show. Does nothing if the scene
+                has no voxel light
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the light buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to upload the light
+
+      Modifies: [m_pVoxelLightField, m_pVoxelLodSelector].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::UpdateVoxelLight(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_pVoxelLightField)
+        {
+            return S_OK;
+        }
+
+        std::vector<UINT> auDirtyChunks;
+        m_pVoxelLightField->CollectDirtyChunks(auDirtyChunks);
+        if (auDirtyChunks.empty())
+        {
+            return S_OK;
+        }
+
+        std::vector<std::shared_ptr<VoxelChunk>> apChunks(auDirtyChunks.size());
+        std::vector<std::vector<PackedVoxelLight>> aaLights(auDirtyChunks.size());
+        ThreadPool::GetDefault().ParallelFor(0u, auDirtyChunks.size(), 1u, [this, &auDirtyChunks, &apChunks, &aaLights](size_t uBegin, size_t uEnd)
+        {
+            for (size_t i = uBegin; i < uEnd; ++i)
+            {
+                apChunks[i] = m_pVoxelLodSelector->GetChunk(auDirtyChunks[i], 0u);
+                if (apChunks[i])
+                {
+                    aaLights[i].resize(apChunks[i]->GetNumInstances());
+                    m_pVoxelLightField->BakeInstances(apChunks[i]->GetInstances(), aaLights[i].size(), auDirtyChunks[i], aaLights[i].data());
+                }
+            }
+        });
+
+        for (size_t i = 0u; i < apChunks.size(); ++i)
+        {
+            if (!apChunks[i])
+            {
+                continue;
+            }
+
+            UINT uNumUploadedLights = 0u;
+            HRESULT hr = apChunks[i]->UpdateLights(pDevice, pImmediateContext, std::move(aaLights[i]), uNumUploadedLights);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::CullVoxelChunks
+
+      Summary:  Collects the voxel chunks whose bounds intersect a view
+                frustum. Needs no Direct3D device
+
+      Args:     const BoundingFrustum& frustum
+                  World space view frustum
+                std::vector<UINT>& auOutVisibleChunks
+                  Indices of the visible chunks
+
+      Returns:  VoxelCullingStatistics
+                  Visible chunks and instances out of all of them
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelCullingStatistics Scene::CullVoxelChunks(_In_ const BoundingFrustum& frustum, _Out_ std::vector<UINT>& auOutVisibleChunks) const
+    {
+        VoxelCullingStatistics statistics =
+        {
+            .uNumChunks = static_cast<UINT>(m_voxelChunks.size()),
+            .uNumVisibleChunks = 0u,
+            .ullNumInstances = 0u,
+            .ullNumVisibleInstances = 0u,
+        };
+
+        auOutVisibleChunks.clear();
+        for (UINT uChunk = 0u; uChunk < m_voxelChunks.size(); ++uChunk)
+        {
+            const VoxelChunk& voxelChunk = *m_voxelChunks[uChunk];
+            statistics.ullNumInstances += voxelChunk.GetNumInstances();
+
+            if (frustum.Intersects(voxelChunk.GetBoundingBox()))
+            {
+                auOutVisibleChunks.push_back(uChunk);
+                statistics.ullNumVisibleInstances += voxelChunk.GetNumInstances();
+            }
+        }
+        statistics.uNumVisibleChunks = static_cast<UINT>(auOutVisibleChunks.size());
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::MeasureVoxelChunkCulling
+
+      Summary:  Culls the voxel chunks against every view of a camera
+                path and writes the average visible fraction and the
+                culling time per view to the debugger output
+
+      Args:     const XMMATRIX& projection
+                  Projection matrix of the camera
+                const std::vector<XMMATRIX>& aViews
+                  View matrices along the camera path
+
+      Returns:  VoxelCullingStatistics
+                  Visible chunks and instances summed over the path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelCullingStatistics Scene::MeasureVoxelChunkCulling(_In_ const XMMATRIX& projection, _In_ const std::vector<XMMATRIX>& aViews) const
+    {
+        VoxelCullingStatistics totalStatistics =
+        {
+            .uNumChunks = 0u,
+            .uNumVisibleChunks = 0u,
+            .ullNumInstances = 0u,
+            .ullNumVisibleInstances = 0u,
+        };
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        BoundingFrustum viewFrustum;
+        BoundingFrustum::CreateFromMatrix(viewFrustum, projection);
+
+        std::vector<UINT> auVisibleChunks;
+        auVisibleChunks.reserve(m_voxelChunks.size());
+        for (const XMMATRIX& view : aViews)
+        {
+            BoundingFrustum worldFrustum;
+            viewFrustum.Transform(worldFrustum, XMMatrixInverse(nullptr, view));
+
+            VoxelCullingStatistics statistics = CullVoxelChunks(worldFrustum, auVisibleChunks);
+            totalStatistics.uNumChunks += statistics.uNumChunks;
+            totalStatistics.uNumVisibleChunks += statistics.uNumVisibleChunks;
+            totalStatistics.ullNumInstances += statistics.ullNumInstances;
+            totalStatistics.ullNumVisibleInstances += statistics.ullNumVisibleInstances;
+        }
+
+        QueryPerformanceCounter(&endingTime);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Scene: %zu view(s), %.1f%% of chunks and %.1f%% of voxel instances visible on average, %.3f ms per view\n",
+            aViews.size(),
+            totalStatistics.uNumChunks > 0u ? 100.0 * totalStatistics.uNumVisibleChunks / totalStatistics.uNumChunks : 0.0,
+            totalStatistics.ullNumInstances > 0u ? 100.0 * static_cast<DOUBLE>(totalStatistics.ullNumVisibleInstances) / static_cast<DOUBLE>(totalStatistics.ullNumInstances) : 0.0,
+            aViews.empty() ? 0.0 : static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart) / static_cast<DOUBLE>(aViews.size())
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return totalStatistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::CullOccludedVoxelChunks
+
+      Summary:  Draws the nearest occluders of the terrain into the
+                software depth buffer and removes the chunks they hide
+                from a list that passed the frustum test. Models and
+                other bounds can then be tested with IsOccluded. Needs
+                no Direct3D device, and does nothing if the scene keeps
+                no column store
+
+      Args:     const XMMATRIX& view
+                  View matrix of the camera
+                const XMMATRIX& projection
+                  Projection matrix of the camera
+                std::vector<UINT>& auVisibleChunks
+                  Indices of the chunks in the frustum, the hidden ones
+                  are removed
+                VoxelCullingStatistics& cullingStatistics
+                  Statistics of the frustum test, the hidden chunks and
+                  instances are taken off the visible ones
+
+      Modifies: [m_pOcclusionCuller, m_aOcclusionTestBoxes,
+                 m_abOcclusionTestResults].
+
+      Returns:  OcclusionCullingStatistics
+                  Occluders drawn and chunks hidden
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCullingStatistics Scene::CullOccludedVoxelChunks(
+        _In_ const XMMATRIX& view,
+        _In_ const XMMATRIX& projection,
+        _Inout_ std::vector<UINT>& auVisibleChunks,
+        _Inout_ VoxelCullingStatistics& cullingStatistics
+    )
+    {
+        if (!m_pOcclusionCuller)
+        {
+            return OcclusionCullingStatistics{};
+        }
+
+        m_pOcclusionCuller->RenderOccluders(m_aOccluders.data(), m_aOccluders.size(), view, projection);
+
+        m_aOcclusionTestBoxes.resize(auVisibleChunks.size());
+        m_abOcclusionTestResults.resize(auVisibleChunks.size());
+        for (size_t i = 0u; i < auVisibleChunks.size(); ++i)
+        {
+            m_aOcclusionTestBoxes[i] = m_voxelChunks[auVisibleChunks[i]]->GetBoundingBox();
+        }
+        m_pOcclusionCuller->TestBoxes(m_aOcclusionTestBoxes.data(), m_aOcclusionTestBoxes.size(), m_abOcclusionTestResults.data());
+
+        size_t uNumVisible = 0u;
+        for (size_t i = 0u; i < auVisibleChunks.size(); ++i)
+        {
+            if (m_abOcclusionTestResults[i])
+            {
+                auVisibleChunks[uNumVisible++] = auVisibleChunks[i];
+            }
+            else
+            {
+                cullingStatistics.ullNumVisibleInstances -= m_voxelChunks[auVisibleChunks[i]]->GetNumInstances();
+            }
+        }
+        auVisibleChunks.resize(uNumVisible);
+        cullingStatistics.uNumVisibleChunks = static_cast<UINT>(uNumVisible);
+
+        return m_pOcclusionCuller->GetStatistics();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::IsOccluded
+
+      Summary:  Tests world space bounds against the occluders drawn by
+                the last CullOccludedVoxelChunks
+
+      Args:     const BoundingBox& boundingBox
+                  World space bounds to test
+
+      Returns:  BOOL
+                  TRUE if the terrain hides the whole box. Always FALSE
+                  if the scene keeps no column store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::IsOccluded(_In_ const BoundingBox& boundingBox) const
+    {
+        if (!m_pOcclusionCuller)
+        {
+            return FALSE;
+        }
+
+        return !m_pOcclusionCuller->IsVisible(boundingBox);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::MeasureOcclusionCulling
+
+      Summary:  Frustum culls the voxel chunks against every view of a
+                camera path, then occlusion culls the visible ones, and
+                writes the fraction of them the terrain hides and the
+                rasterization and test times per view to the debugger
+                output
+
+      Args:     const XMMATRIX& projection
+                  Projection matrix of the camera
+                const std::vector<XMMATRIX>& aViews
+                  View matrices along the camera path
+
+      Modifies: [m_pOcclusionCuller, m_aOcclusionTestBoxes,
+                 m_abOcclusionTestResults].
+
+      Returns:  OcclusionCullingStatistics
+                  Occluders, tests and times summed over the path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCullingStatistics Scene::MeasureOcclusionCulling(_In_ const XMMATRIX& projection, _In_ const std::vector<XMMATRIX>& aViews)
+    {
+        OcclusionCullingStatistics totalStatistics = {};
+        UINT64 ullNumFrustumInstances = 0u;
+        UINT64 ullNumVisibleInstances = 0u;
+
+        BoundingFrustum viewFrustum;
+        BoundingFrustum::CreateFromMatrix(viewFrustum, projection);
+
+        std::vector<UINT> auVisibleChunks;
+        auVisibleChunks.reserve(m_voxelChunks.size());
+        for (const XMMATRIX& view : aViews)
+        {
+            BoundingFrustum worldFrustum;
+            viewFrustum.Transform(worldFrustum, XMMatrixInverse(nullptr, view));
+
+            VoxelCullingStatistics cullingStatistics = CullVoxelChunks(worldFrustum, auVisibleChunks);
+            ullNumFrustumInstances += cullingStatistics.ullNumVisibleInstances;
+
+            OcclusionCullingStatistics statistics = CullOccludedVoxelChunks(view, projection, auVisibleChunks, cullingStatistics);
+            ullNumVisibleInstances += cullingStatistics.ullNumVisibleInstances;
+
+            totalStatistics.uNumOccluders += statistics.uNumOccluders;
+            totalStatistics.uNumTriangles += statistics.uNumTriangles;
+            totalStatistics.uNumTestedBoxes += statistics.uNumTestedBoxes;
+            totalStatistics.uNumOccludedBoxes += statistics.uNumOccludedBoxes;
+            totalStatistics.rasterizationMilliseconds += statistics.rasterizationMilliseconds;
+            totalStatistics.testMilliseconds += statistics.testMilliseconds;
+        }
+
+        const DOUBLE numViews = static_cast<DOUBLE>(std::max<size_t>(aViews.size(), 1u));
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Scene: %zu view(s), %.0f occluder(s) and %.0f triangle(s) per view, %.1f%% of chunks and %.1f%% of voxel instances in the frustum occluded, %.3f ms rasterization and %.3f ms tests per view\n",
+            aViews.size(),
+            static_cast<DOUBLE>(totalStatistics.uNumOccluders) / numViews,
+            static_cast<DOUBLE>(totalStatistics.uNumTriangles) / numViews,
+            totalStatistics.uNumTestedBoxes > 0u ? 100.0 * totalStatistics.uNumOccludedBoxes / totalStatistics.uNumTestedBoxes : 0.0,
+            ullNumFrustumInstances > 0u ? 100.0 * static_cast<DOUBLE>(ullNumFrustumInstances - ullNumVisibleInstances) / static_cast<DOUBLE>(ullNumFrustumInstances) : 0.0,
+            totalStatistics.rasterizationMilliseconds / numViews,
+            totalStatistics.testMilliseconds / numViews
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return totalStatistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::RaycastVoxels
+
+      Summary:  Finds the first solid voxel of the terrain along a world
+                space ray, such as a picking ray of the camera
+
+      Args:     const XMFLOAT3& origin
+                  World space origin of the ray
+                const XMFLOAT3& direction
+                  World space direction of the ray
+                FLOAT maxDistance
+                  Length of the ray in world units
+                VoxelRayHit& outHit
+                  First solid voxel, bHit is FALSE if there is none
+
+      Returns:  BOOL
+                  TRUE if the ray hits a solid voxel. Always FALSE if
+                  the scene keeps no column store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::RaycastVoxels(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& outHit) const
+    {
+        if (!m_pVoxelRaycaster)
+        {
+            outHit = VoxelRayHit{ .bHit = FALSE, .voxel = XMUINT3(0u, 0u, 0u), .blockType = VoxelColumnStore::EMPTY_BLOCK, .distance = 0.0f, .normal = XMINT3(0, 0, 0) };
+            return FALSE;
+        }
+
+        return m_pVoxelRaycaster->Raycast(origin, direction, maxDistance, outHit);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::PlaceBlock
+
+      Summary:  Places a block in a voxel of the terrain, such as the
+                one next to a picked voxel along its normal. The voxel
+                shows once its chunk is rebuilt and uploaded by
+                UpdateVoxelEdits
+
+      Args:     const XMUINT3& voxel
+                  Voxel coordinates
+                BYTE blockType
+                  Index of the block type in the palette
+
+      Modifies: [m_pVoxelEditor].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the voxel is outside the
+                  terrain or the block type is not in the palette,
+                  ERROR_NOT_SUPPORTED if the scene cannot be edited
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::PlaceBlock(_In_ const XMUINT3& voxel, _In_ BYTE blockType)
+    {
+        if (!m_pVoxelEditor)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+        if (blockType == VoxelColumnStore::EMPTY_BLOCK)
+        {
+            return E_INVALIDARG;
+        }
+
+        return m_pVoxelEditor->SetBlock(voxel.x, voxel.y, voxel.z, blockType);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::RemoveBlock
+
+      Summary:  Removes the block of a voxel of the terrain, such as a
+                picked one. The change shows once its chunk is rebuilt
+                and uploaded by UpdateVoxelEdits
+
+      Args:     const XMUINT3& voxel
+                  Voxel coordinates
+
+      Modifies: [m_pVoxelEditor, m_aOccluders].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the voxel is outside the
+                  terrain, ERROR_NOT_SUPPORTED if the scene cannot be
+                  edited
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::RemoveBlock(_In_ const XMUINT3& voxel)
+    {
+        if (!m_pVoxelEditor)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        HRESULT hr = m_pVoxelEditor->SetBlock(voxel.x, voxel.y, voxel.z, VoxelColumnStore::EMPTY_BLOCK);
+        if (SUCCEEDED(hr))
+        {
+            lowerOccluder(voxel);
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetBlockEmission
+
+      Summary:  Sets the light level the voxels of a block type emit,
+                such as lava or glowing ore, and floods the light of
+                the terrain again
+
+      Args:     BYTE blockType
+                  Index of the block type in the palette
+                BYTE level
+                  Light level from 0 to VoxelLightField::MAX_LIGHT_LEVEL
+
+      Modifies: [m_pVoxelLightField].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the block type is not in
+                  the palette or the level is too high,
+                  ERROR_NOT_SUPPORTED if the scene has no voxel light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetBlockEmission(_In_ BYTE blockType, _In_ BYTE level)
+    {
+        if (!m_pVoxelLightField)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        HRESULT hr = m_pVoxelLightField->SetBlockEmission(blockType, level);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_pVoxelLightField->Create();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::AddVoxelLightEmitter
+
+      Summary:  Places a light in a voxel of the terrain, such as a
+                torch. The light shows once the chunks it reaches are
+                baked by UpdateVoxelLight
+
+      Args:     const XMUINT3& voxel
+                  Voxel coordinates
+                BYTE level
+                  Light level from 1 to VoxelLightField::MAX_LIGHT_LEVEL
+                UINT& uOutEmitter
+                  Handle of the light
+
+      Modifies: [m_pVoxelLightField].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the voxel is outside the
+                  terrain or the level is out of range,
+                  ERROR_NOT_SUPPORTED if the scene has no voxel light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::AddVoxelLightEmitter(_In_ const XMUINT3& voxel, _In_ BYTE level, _Out_ UINT& uOutEmitter)
+    {
+        if (!m_pVoxelLightField)
+        {
+            uOutEmitter = 0u;
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        return m_pVoxelLightField->AddEmitter(voxel, level, uOutEmitter);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::MoveVoxelLightEmitter
+
+      Summary:  Moves a light placed in the terrain, such as one the
+                player carries
+
+      Args:     UINT uEmitter
+                  Handle of the light
+                const XMUINT3& voxel
+                  New voxel coordinates
+
+      Modifies: [m_pVoxelLightField].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the light was removed or
+                  the voxel is outside the terrain, ERROR_NOT_SUPPORTED
+                  if the scene has no voxel light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::MoveVoxelLightEmitter(_In_ UINT uEmitter, _In_ const XMUINT3& voxel)
+    {
+        if (!m_pVoxelLightField)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        return m_pVoxelLightField->MoveEmitter(uEmitter, voxel);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::RemoveVoxelLightEmitter
+
+      Summary:  Removes a light placed in the terrain
+
+      Args:     UINT uEmitter
+                  Handle of the light
+
+      Modifies: [m_pVoxelLightField].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the light was already
+                  removed, ERROR_NOT_SUPPORTED if the scene has no
+                  voxel light
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::RemoveVoxelLightEmitter(_In_ UINT uEmitter)
+    {
+        if (!m_pVoxelLightField)
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        return m_pVoxelLightField->RemoveEmitter(uEmitter);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::RaycastVoxelsBatch
+
+      Summary:  Casts many world space rays against the terrain across
+                the worker threads
+
+      Args:     const VoxelRay* pRays
+                  Rays to cast
+                size_t uNumRays
+                  Number of rays
+                VoxelRayHit* pOutHits
+                  First solid voxel along every ray, all misses if the
+                  scene keeps no column store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::RaycastVoxelsBatch(_In_reads_(uNumRays) const VoxelRay* pRays, _In_ size_t uNumRays, _Out_writes_(uNumRays) VoxelRayHit* pOutHits) const
+    {
+        if (!m_pVoxelRaycaster)
+        {
+            std::fill(pOutHits, pOutHits + uNumRays, VoxelRayHit{ .bHit = FALSE, .voxel = XMUINT3(0u, 0u, 0u), .blockType = VoxelColumnStore::EMPTY_BLOCK, .distance = 0.0f, .normal = XMINT3(0, 0, 0) });
+            return;
+        }
+
+        m_pVoxelRaycaster->RaycastBatch(pRays, uNumRays, pOutHits);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::CollideVoxels
+
+      Summary:  Moves a world space box, such as the one around the
+                camera or an entity, as far as the terrain lets it
+
+      Args:     const BoundingBox& box
+                  World space box at the start of the move
+                const XMFLOAT3& displacement
+                  World space move of the box
+                VoxelSweepResult& outResult
+                  Where the box came to rest and what stopped it, the
+                  whole move if the scene keeps no column store
+
+      Returns:  BOOL
+                  TRUE if the terrain stopped the box on any axis. A
+                  box pushed out of the terrain may not have been
+                  stopped, so the center is to be taken either way
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Scene::CollideVoxels(_In_ const BoundingBox& box, _In_ const XMFLOAT3& displacement, _Out_ VoxelSweepResult& outResult) const
+    {
+        if (!m_pVoxelCollider)
+        {
+            outResult = VoxelSweepResult
+            {
+                .center = XMFLOAT3(box.Center.x + displacement.x, box.Center.y + displacement.y, box.Center.z + displacement.z),
+                .displacement = displacement,
+                .contactNormal = XMINT3(0, 0, 0),
+                .bOnGround = FALSE,
+                .bStuck = FALSE,
+            };
+            return FALSE;
+        }
+
+        m_pVoxelCollider->Sweep(box, displacement, outResult);
+
+        return outResult.contactNormal.x != 0 || outResult.contactNormal.y != 0 || outResult.contactNormal.z != 0;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::CollideVoxelsBatch
+
+      Summary:  Moves many world space boxes through the terrain across
+                the worker threads
+
+      Args:     const VoxelSweep* pSweeps
+                  Boxes and their displacements
+                size_t uNumSweeps
+                  Number of boxes
+                VoxelSweepResult* pOutResults
+                  Where every box came to rest, the whole move if the
+                  scene keeps no column store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::CollideVoxelsBatch(_In_reads_(uNumSweeps) const VoxelSweep* pSweeps, _In_ size_t uNumSweeps, _Out_writes_(uNumSweeps) VoxelSweepResult* pOutResults) const
+    {
+        if (!m_pVoxelCollider)
+        {
+            for (size_t uSweep = 0u; uSweep < uNumSweeps; ++uSweep)
+            {
+                CollideVoxels(pSweeps[uSweep].box, pSweeps[uSweep].displacement, pOutResults[uSweep]);
+            }
+            return;
+        }
+
+        m_pVoxelCollider->SweepBatch(pSweeps, uNumSweeps, pOutResults);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfRenderable
+
+      Summary:  Sets the vertex shader for a renderable
+
+      Args:     PCWSTR pszRenderableName
+                  Key of the renderable
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_renderables].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_renderables.contains(pszRenderableName) || !m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_renderables[pszRenderableName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfRenderable
+
+      Summary:  Sets the pixel shader for a renderable
+
+      Args:     PCWSTR pszRenderableName
+                  Key of the renderable
+                PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_renderables].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_renderables.contains(pszRenderableName) || !m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_renderables[pszRenderableName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfModel
+
+      Summary:  Sets the vertex shader for a model
+
+      Args:     PCWSTR pszModelName
+                  Key of the renderable
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_models].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_models.contains(pszModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_models[pszModelName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfModel
+
+      Summary:  Sets the pixel shader for a model
+
+      Args:     PCWSTR pszModelName
+                  Key of the renderable
+                PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_models].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_models.contains(pszModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_models[pszModelName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfScene
+
+      Summary:  Sets the vertex shader for the voxels in a scene
+
+      Args:     PCWSTR pszSceneName
+                  Key of the scene
+                PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_scenes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            voxel->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfScene
+
+      Summary:  Sets the pixel shader for the voxels in a scene
+
+      Args:     PCWSTR pszRenderableName
+                  Key of the renderable
+                PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_renderables].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        for (std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            voxel->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfVoxelChunks
+
+      Summary:  Sets the vertex shader that decodes the packed
+                instances of the voxel chunks. The voxels keep their
+                own pixel shaders
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_voxelChunkVertexShader].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfVoxelChunks(_In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_voxelChunkVertexShader = m_vertexShaders[pszVertexShaderName];
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfVoxelChunks
+
+      Summary:  Sets the pixel shader that shades the voxel chunks with
+                the light baked for their faces, in place of the pixel
+                shaders of the voxels
+
+      Args:     PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_voxelChunkPixelShader].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfVoxelChunks(_In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        m_voxelChunkPixelShader = m_pixelShaders[pszPixelShaderName];
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetVertexShaderOfVoxelChunkMesh
+
+      Summary:  Sets the vertex shader for the voxel chunk meshes
+
+      Args:     PCWSTR pszVertexShaderName
+                  Key of the vertex shader
+
+      Modifies: [m_voxelChunkMeshes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetVertexShaderOfVoxelChunkMesh(_In_ PCWSTR pszVertexShaderName)
+    {
+        if (!m_vertexShaders.contains(pszVertexShaderName))
+        {
+            return E_FAIL;
+        }
+
+        for (std::shared_ptr<VoxelChunkMesh>& voxelChunkMesh : m_voxelChunkMeshes)
+        {
+            voxelChunkMesh->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPixelShaderOfVoxelChunkMesh
+
+      Summary:  Sets the pixel shader for the voxel chunk meshes
+
+      Args:     PCWSTR pszPixelShaderName
+                  Key of the pixel shader
+
+      Modifies: [m_voxelChunkMeshes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::SetPixelShaderOfVoxelChunkMesh(_In_ PCWSTR pszPixelShaderName)
+    {
+        if (!m_pixelShaders.contains(pszPixelShaderName))
+        {
+            return E_FAIL;
+        }
+
+        for (std::shared_ptr<VoxelChunkMesh>& voxelChunkMesh : m_voxelChunkMeshes)
+        {
+            voxelChunkMesh->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createVoxels
+
+      Summary:  Builds the instances of the column store into a single
+                arena split into chunks, along with the instances of
+                its surface downsampled 2, 4 and 8 times into arenas
+                of their own, chunked so that every downsampled chunk
+                covers the columns of the same full resolution chunk.
+                Creates a voxel object for every block type, hands
+                every level of every chunk to the level of detail
+                selector and sets up the raycaster, the collider, the
+                light and the editor over the store. Chunks start at
+                full resolution
+
+      Modifies: [m_voxels, m_voxelChunks, m_pVoxelLodSelector,
+                 m_pVoxelRaycaster, m_pVoxelCollider, m_pVoxelLightField,
+                 m_pVoxelEditor, m_voxelBuildStatistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createVoxels()
+    {
+        constexpr const UINT NUM_LODS = VoxelLodSelector::NUM_LODS;
+
+        const VoxelColumnStore& columnStore = *m_pVoxelColumnStore;
+        const XMFLOAT3* pPalette = columnStore.GetPalette();
+
+        m_pVoxelRaycaster = std::make_unique<VoxelRaycaster>(columnStore);
+        m_pVoxelCollider = std::make_unique<VoxelCollider>(columnStore);
+
+        // Coarser levels only approximate the terrain, so they are
+        // downsampled from its surface
+        std::vector<BYTE> aSurfaceBlockTypes;
+        std::vector<WORD> aSurfaceColumnHeights;
+        columnStore.GetSurface(aSurfaceBlockTypes, aSurfaceColumnHeights);
+        const HeightMapDesc surface =
+        {
+            .uWidth = columnStore.GetWidth(),
+            .uHeight = columnStore.GetHeight(),
+            .uDepth = columnStore.GetDepth(),
+            .uNumColors = columnStore.GetNumColors(),
+            .pPalette = pPalette,
+            .pBlockTypes = aSurfaceBlockTypes.data(),
+            .pColumnHeights = aSurfaceColumnHeights.data(),
+        };
+
+        // A level is only built if its chunks line up with the full
+        // resolution ones
+        HeightMap aDownsampledHeightMaps[NUM_LODS - 1u];
+        std::unique_ptr<VoxelBuilder> apVoxelBuilders[NUM_LODS];
+        apVoxelBuilders[0] = std::make_unique<VoxelBuilder>(columnStore, m_bCullHiddenVoxels, VoxelBuilder::DEFAULT_CHUNK_SIZE);
+        for (UINT uLod = 1u; uLod < NUM_LODS; ++uLod)
+        {
+            const UINT uFactor = 1u << uLod;
+            if (VoxelBuilder::DEFAULT_CHUNK_SIZE % uFactor != 0u || FAILED(aDownsampledHeightMaps[uLod - 1u].Downsample(surface, uFactor)))
+            {
+                break;
+            }
+
+            apVoxelBuilders[uLod] = std::make_unique<VoxelBuilder>(
+                aDownsampledHeightMaps[uLod - 1u].GetDesc(),
+                m_bCullHiddenVoxels,
+                VoxelBuilder::DEFAULT_CHUNK_SIZE / uFactor
+            );
+        }
+
+        for (std::unique_ptr<VoxelBuilder>& pVoxelBuilder : apVoxelBuilders)
+        {
+            if (pVoxelBuilder)
+            {
+                pVoxelBuilder->Build();
+            }
+        }
+
+        const VoxelBuilder& voxelBuilder = *apVoxelBuilders[0];
+        m_voxelBuildStatistics = voxelBuilder.GetStatistics();
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "Scene: %llu of %llu voxels emitted, %llu hidden voxels culled, %llu KiB of packed instances (%llu KiB as matrices)\n",
+            m_voxelBuildStatistics.ullNumInstances,
+            m_voxelBuildStatistics.ullNumSolidVoxels,
+            m_voxelBuildStatistics.ullNumCulledVoxels,
+            m_voxelBuildStatistics.ullNumInstances * sizeof(PackedVoxelInstance) / 1024u,
+            m_voxelBuildStatistics.ullNumInstances * sizeof(InstanceData) / 1024u
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        sprintf_s(
+            szDebugMessage,
+            "Scene: column store of %u x %u columns in %zu KiB, %zu multi-run column(s)\n",
+            columnStore.GetWidth(),
+            columnStore.GetDepth(),
+            columnStore.GetMemoryUsage() / 1024u,
+            columnStore.GetNumMultiRunColumns()
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        for (UINT uLod = 1u; uLod < NUM_LODS && apVoxelBuilders[uLod]; ++uLod)
+        {
+            sprintf_s(
+                szDebugMessage,
+                "Scene: level of detail %u (%ux voxels), %llu voxels emitted\n",
+                uLod,
+                1u << uLod,
+                apVoxelBuilders[uLod]->GetStatistics().ullNumInstances
+            );
+            OutputDebugStringA(szDebugMessage);
+        }
+
+        const UINT uNumChunks = voxelBuilder.GetNumChunksX() * voxelBuilder.GetNumChunksZ();
+
+        // Edits can place any block type, so every palette entry gets a
+        // voxel object and block types double as voxel indices
+        for (UINT uBlockType = 0u; uBlockType < voxelBuilder.GetNumBlockTypes(); ++uBlockType)
+        {
+            const XMFLOAT3& color = pPalette[uBlockType];
+            m_voxels.push_back(std::make_shared<Voxel>(XMFLOAT4(color.x, color.y, color.z, 1.0f)));
+        }
+
+        m_pVoxelLodSelector = std::make_unique<VoxelLodSelector>(VoxelLodSelector::DEFAULT_LOD_DESC);
+        for (UINT uChunk = 0u; uChunk < uNumChunks; ++uChunk)
+        {
+            std::shared_ptr<VoxelChunk> apLods[NUM_LODS];
+            for (UINT uLod = 0u; uLod < NUM_LODS && apVoxelBuilders[uLod]; ++uLod)
+            {
+                const VoxelBuilder& lodBuilder = *apVoxelBuilders[uLod];
+
+                // Ranges of a chunk are contiguous and in palette order
+                const UINT uFirstInstance = lodBuilder.GetInstanceRange(uChunk, 0u).uFirstInstance;
+                UINT uNumInstances = 0u;
+
+                std::vector<VoxelInstanceRange> aInstanceRanges(m_voxels.size(), VoxelInstanceRange{ .uFirstInstance = 0u, .uNumInstances = 0u });
+                for (UINT uBlockType = 0u; uBlockType < lodBuilder.GetNumBlockTypes(); ++uBlockType)
+                {
+                    const VoxelInstanceRange& instanceRange = lodBuilder.GetInstanceRange(uChunk, uBlockType);
+                    if (instanceRange.uNumInstances > 0u)
+                    {
+                        aInstanceRanges[uBlockType] = VoxelInstanceRange
+                        {
+                            .uFirstInstance = instanceRange.uFirstInstance - uFirstInstance,
+                            .uNumInstances = instanceRange.uNumInstances
+                        };
+                        uNumInstances += instanceRange.uNumInstances;
+                    }
+                }
+
+                if (uNumInstances == 0u)
+                {
+                    continue;
+                }
+
+                // A voxel of the level spans uFactor full resolution
+                // voxels on every axis, so its center sits uFactor - 1
+                // units past the center of the first of them
+                const FLOAT factor = static_cast<FLOAT>(1u << uLod);
+                XMFLOAT3 origin = voxelBuilder.GetChunkOrigin(uChunk);
+                origin.x += factor - 1.0f;
+                origin.y += factor - 1.0f;
+                origin.z += factor - 1.0f;
+
+                const XMFLOAT3 lodOrigin = lodBuilder.GetChunkOrigin(uChunk);
+                const BoundingBox& lodBoundingBox = lodBuilder.GetChunkBoundingBox(uChunk);
+                BoundingBox boundingBox;
+                XMStoreFloat3(
+                    &boundingBox.Center,
+                    XMVectorMultiplyAdd(XMVectorSubtract(XMLoadFloat3(&lodBoundingBox.Center), XMLoadFloat3(&lodOrigin)), XMVectorReplicate(factor), XMLoadFloat3(&origin))
+                );
+                XMStoreFloat3(&boundingBox.Extents, XMVectorScale(XMLoadFloat3(&lodBoundingBox.Extents), factor));
+
+                apLods[uLod] = std::make_shared<VoxelChunk>(
+                    lodBuilder.GetInstanceArena(),
+                    uFirstInstance,
+                    uNumInstances,
+                    std::move(aInstanceRanges),
+                    boundingBox,
+                    origin,
+                    factor
+                );
+            }
+
+            // Empty chunks are kept in the selector too, so chunk
+            // indices stay the same when an edit fills one
+            m_pVoxelLodSelector->AddChunk(apLods, voxelBuilder.GetChunkBoundingBox(uChunk));
+            if (apLods[0])
+            {
+                m_voxelChunks.push_back(apLods[0]);
+            }
+        }
+
+        m_pVoxelLightField = std::make_unique<VoxelLightField>(columnStore, VoxelBuilder::DEFAULT_CHUNK_SIZE);
+        m_pVoxelLightField->Create();
+
+        m_pVoxelEditor = std::make_unique<VoxelEditor>(*m_pVoxelColumnStore, m_bCullHiddenVoxels, VoxelBuilder::DEFAULT_CHUNK_SIZE, m_pVoxelLightField.get());
+
+        createOccluders();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createOccluders
+
+      Summary:  Covers the terrain with occluder boxes for the software
+                occlusion culling, one per tile of OCCLUDER_TILE_SIZE
+                columns on a side. A box rises from the floor to the
+                lowest of the solid layers the columns of its tile hold
+                from the floor up, so it lies inside the terrain
+
+      Modifies: [m_pOcclusionCuller, m_aOccluders,
+                 m_uNumOccluderTilesX].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createOccluders()
+    {
+        const VoxelColumnStore& columnStore = *m_pVoxelColumnStore;
+        const UINT uWidth = columnStore.GetWidth();
+        const UINT uDepth = columnStore.GetDepth();
+        const FLOAT floor = -1.25f * static_cast<FLOAT>(columnStore.GetHeight()) - 1.0f;
+
+        m_uNumOccluderTilesX = (uWidth + OCCLUDER_TILE_SIZE - 1u) / OCCLUDER_TILE_SIZE;
+        const UINT uNumTilesZ = (uDepth + OCCLUDER_TILE_SIZE - 1u) / OCCLUDER_TILE_SIZE;
+        m_aOccluders.resize(static_cast<size_t>(m_uNumOccluderTilesX) * uNumTilesZ);
+
+        std::vector<VoxelRun> aRuns;
+        for (UINT uTileZ = 0u; uTileZ < uNumTilesZ; ++uTileZ)
+        {
+            for (UINT uTileX = 0u; uTileX < m_uNumOccluderTilesX; ++uTileX)
+            {
+                const UINT x0 = uTileX * OCCLUDER_TILE_SIZE;
+                const UINT z0 = uTileZ * OCCLUDER_TILE_SIZE;
+                const UINT x1 = std::min<UINT>(x0 + OCCLUDER_TILE_SIZE, uWidth);
+                const UINT z1 = std::min<UINT>(z0 + OCCLUDER_TILE_SIZE, uDepth);
+
+                UINT uSolidHeight = columnStore.GetHeight();
+                for (UINT z = z0; z < z1 && uSolidHeight > 0u; ++z)
+                {
+                    for (UINT x = x0; x < x1 && uSolidHeight > 0u; ++x)
+                    {
+                        if (columnStore.IsSingleRun(x, z))
+                        {
+                            uSolidHeight = std::min<UINT>(uSolidHeight, columnStore.GetColumnHeight(x, z));
+                            continue;
+                        }
+
+                        columnStore.GetRuns(x, z, aRuns);
+                        uSolidHeight = aRuns.empty() || aRuns[0].blockType == VoxelColumnStore::EMPTY_BLOCK ? 0u : std::min<UINT>(uSolidHeight, aRuns[0].uLength);
+                    }
+                }
+
+                // Voxel (x, y, z) spans [2x - W - 1, 2x - W + 1] along x,
+                // and likewise along y and z
+                const XMFLOAT3 minimum(
+                    2.0f * static_cast<FLOAT>(x0) - static_cast<FLOAT>(uWidth) - 1.0f,
+                    floor,
+                    2.0f * static_cast<FLOAT>(z0) - static_cast<FLOAT>(uDepth) - 1.0f
+                );
+                const XMFLOAT3 maximum(
+                    2.0f * static_cast<FLOAT>(x1) - static_cast<FLOAT>(uWidth) - 1.0f,
+                    floor + 2.0f * static_cast<FLOAT>(uSolidHeight),
+                    2.0f * static_cast<FLOAT>(z1) - static_cast<FLOAT>(uDepth) - 1.0f
+                );
+                BoundingBox::CreateFromPoints(m_aOccluders[static_cast<size_t>(uTileZ) * m_uNumOccluderTilesX + uTileX], XMLoadFloat3(&minimum), XMLoadFloat3(&maximum));
+            }
+        }
+
+        // The culler knows nothing of the thread pool, each batch is
+        // split again to keep all the workers busy
+        m_pOcclusionCuller = std::make_unique<OcclusionCuller>(
+            OcclusionCuller::DEFAULT_DESC,
+            [](size_t uBegin, size_t uEnd, size_t uMinBatchSize, const std::function<void(size_t, size_t)>& function)
+            {
+                ThreadPool& threadPool = ThreadPool::GetDefault();
+                const size_t uNumWorkers = static_cast<size_t>(threadPool.GetNumThreads()) + 1u;
+                threadPool.ParallelFor(uBegin, uEnd, std::max<size_t>((uEnd - uBegin) / (uNumWorkers * 4u), uMinBatchSize), function);
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::lowerOccluder
+
+      Summary:  Lowers the top of the occluder of a tile below a voxel
+                that was removed, so the occluder stays inside the
+                terrain. Placed voxels only add solid layers, so they
+                leave the occluders as they are
+
+      Args:     const XMUINT3& voxel
+                  Voxel coordinates of the removed voxel
+
+      Modifies: [m_aOccluders].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::lowerOccluder(_In_ const XMUINT3& voxel)
+    {
+        if (m_aOccluders.empty())
+        {
+            return;
+        }
+
+        BoundingBox& occluder = m_aOccluders[static_cast<size_t>(voxel.z / OCCLUDER_TILE_SIZE) * m_uNumOccluderTilesX + voxel.x / OCCLUDER_TILE_SIZE];
+        const FLOAT bottom = occluder.Center.y - occluder.Extents.y;
+        const FLOAT top = std::min<FLOAT>(occluder.Center.y + occluder.Extents.y, bottom + 2.0f * static_cast<FLOAT>(voxel.y));
+        occluder.Center.y = (bottom + top) * 0.5f;
+        occluder.Extents.y = (top - bottom) * 0.5f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createVoxelChunkMeshes
+
+      Summary:  Greedy-meshes every chunk of the height map and creates
+                a chunk mesh for each one that has any faces
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map
+
+      Modifies: [m_voxelChunkMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createVoxelChunkMeshes(_In_ const HeightMapDesc& heightMap)
+    {
+        VoxelMesher voxelMesher(heightMap, VoxelMesher::DEFAULT_CHUNK_SIZE);
+
+        std::vector<VoxelChunkMeshData> aMeshData;
+        voxelMesher.MeshAllChunks(aMeshData);
+
+        for (VoxelChunkMeshData& meshData : aMeshData)
+        {
+            if (meshData.aIndices.empty())
+            {
+                continue;
+            }
+
+            m_voxelChunkMeshes.push_back(std::make_shared<VoxelChunkMesh>(std::move(meshData), heightMap.pPalette));
+        }
+    }
+
+    FLOAT Scene::getNoise2(UINT x, UINT y)
     {
         UINT temp = ms_aHashes[y % 256u];
 
@@ -765,4 +2363,190 @@ namespace library
     {
         return lerp(x, y, s * s * (3.0f - 2.0f * s));
     }
+
+    BOOL Scene::isAvx2Supported()
+    {
+        INT aCpuInfo[4];
+        __cpuid(aCpuInfo, 0);
+        if (aCpuInfo[0] < 7)
+        {
+            return FALSE;
+        }
+
+        // AVX needs the OS to save the YMM registers
+        __cpuid(aCpuInfo, 1);
+        constexpr const INT OSXSAVE_AND_AVX = (1 << 27) | (1 << 28);
+        if ((aCpuInfo[2] & OSXSAVE_AND_AVX) != OSXSAVE_AND_AVX || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return FALSE;
+        }
+
+        __cpuidex(aCpuInfo, 7, 0);
+        return (aCpuInfo[1] & (1 << 5)) != 0;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getPerlin2dBatchSse
+
+      Summary:  Evaluates groups of four samples with SSE. SSE has no
+                gather, so the hashes of the four lanes are looked up
+                one by one and the rest runs four wide
+
+      Returns:  size_t
+                  Number of samples evaluated, a multiple of four
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Scene::getPerlin2dBatchSse(
+        _In_reads_(uNumSamples) const FLOAT* pX,
+        _In_reads_(uNumSamples) const FLOAT* pY,
+        _In_ size_t uNumSamples,
+        _In_ FLOAT frequency,
+        _In_ UINT uDepth,
+        _Out_writes_(uNumSamples) FLOAT* pOutNoise
+    )
+    {
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+
+        // Summed the way GetPerlin2d does, so the results stay the same
+        // for any number of octaves
+        FLOAT div = 0.0f;
+        FLOAT amp = 1.0f;
+        for (UINT i = 0u; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            amp /= 2.0f;
+        }
+        const __m128 divisor = _mm_set1_ps(div);
+
+        size_t uNumEvaluated = uNumSamples & ~static_cast<size_t>(3u);
+        for (size_t uSample = 0u; uSample < uNumEvaluated; uSample += 4u)
+        {
+            __m128 xa = _mm_mul_ps(_mm_loadu_ps(pX + uSample), _mm_set1_ps(frequency));
+            __m128 ya = _mm_mul_ps(_mm_loadu_ps(pY + uSample), _mm_set1_ps(frequency));
+            __m128 amp = _mm_set1_ps(1.0f);
+            __m128 fin = _mm_setzero_ps();
+
+            for (UINT i = 0u; i < uDepth; ++i)
+            {
+                __m128i xi = _mm_cvttps_epi32(xa);
+                __m128i yi = _mm_cvttps_epi32(ya);
+                __m128 xFrac = _mm_sub_ps(xa, _mm_cvtepi32_ps(xi));
+                __m128 yFrac = _mm_sub_ps(ya, _mm_cvtepi32_ps(yi));
+
+                alignas(16) UINT auX[4];
+                alignas(16) UINT auY[4];
+                alignas(16) INT aiCorners[4][4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(auX), xi);
+                _mm_store_si128(reinterpret_cast<__m128i*>(auY), yi);
+                for (UINT uLane = 0u; uLane < 4u; ++uLane)
+                {
+                    UINT uRow0 = ms_aHashes[auY[uLane] % 256u];
+                    UINT uRow1 = ms_aHashes[(auY[uLane] + 1u) % 256u];
+                    aiCorners[0][uLane] = static_cast<INT>(ms_aHashes[(uRow0 + auX[uLane]) % 256u]);
+                    aiCorners[1][uLane] = static_cast<INT>(ms_aHashes[(uRow0 + auX[uLane] + 1u) % 256u]);
+                    aiCorners[2][uLane] = static_cast<INT>(ms_aHashes[(uRow1 + auX[uLane]) % 256u]);
+                    aiCorners[3][uLane] = static_cast<INT>(ms_aHashes[(uRow1 + auX[uLane] + 1u) % 256u]);
+                }
+                __m128 s = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aiCorners[0])));
+                __m128 t = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aiCorners[1])));
+                __m128 u = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aiCorners[2])));
+                __m128 v = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(aiCorners[3])));
+
+                // smoothLerp, with the operations in the same order
+                __m128 xWeight = _mm_mul_ps(_mm_mul_ps(xFrac, xFrac), _mm_sub_ps(three, _mm_mul_ps(two, xFrac)));
+                __m128 yWeight = _mm_mul_ps(_mm_mul_ps(yFrac, yFrac), _mm_sub_ps(three, _mm_mul_ps(two, yFrac)));
+                __m128 low = _mm_add_ps(s, _mm_mul_ps(xWeight, _mm_sub_ps(t, s)));
+                __m128 high = _mm_add_ps(u, _mm_mul_ps(xWeight, _mm_sub_ps(v, u)));
+                __m128 noise = _mm_add_ps(low, _mm_mul_ps(yWeight, _mm_sub_ps(high, low)));
+
+                fin = _mm_add_ps(fin, _mm_mul_ps(noise, amp));
+                amp = _mm_mul_ps(amp, _mm_set1_ps(0.5f));
+                xa = _mm_mul_ps(xa, two);
+                ya = _mm_mul_ps(ya, two);
+            }
+
+            _mm_storeu_ps(pOutNoise + uSample, _mm_div_ps(fin, divisor));
+        }
+
+        return uNumEvaluated;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::getPerlin2dBatchAvx2
+
+      Summary:  Evaluates groups of eight samples with AVX2, gathering
+                the hashes of all lanes at once. Must only be called
+                when isAvx2Supported returns TRUE
+
+      Returns:  size_t
+                  Number of samples evaluated, a multiple of eight
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t Scene::getPerlin2dBatchAvx2(
+        _In_reads_(uNumSamples) const FLOAT* pX,
+        _In_reads_(uNumSamples) const FLOAT* pY,
+        _In_ size_t uNumSamples,
+        _In_ FLOAT frequency,
+        _In_ UINT uDepth,
+        _Out_writes_(uNumSamples) FLOAT* pOutNoise
+    )
+    {
+        const INT* aiHashes = reinterpret_cast<const INT*>(ms_aHashes);
+        const __m256i hashMask = _mm256_set1_epi32(255);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        const __m256 three = _mm256_set1_ps(3.0f);
+
+        // Summed the way GetPerlin2d does, so the results stay the same
+        // for any number of octaves
+        FLOAT div = 0.0f;
+        FLOAT amp = 1.0f;
+        for (UINT i = 0u; i < uDepth; ++i)
+        {
+            div += 256.0f * amp;
+            amp /= 2.0f;
+        }
+        const __m256 divisor = _mm256_set1_ps(div);
+
+        size_t uNumEvaluated = uNumSamples & ~static_cast<size_t>(7u);
+        for (size_t uSample = 0u; uSample < uNumEvaluated; uSample += 8u)
+        {
+            __m256 xa = _mm256_mul_ps(_mm256_loadu_ps(pX + uSample), _mm256_set1_ps(frequency));
+            __m256 ya = _mm256_mul_ps(_mm256_loadu_ps(pY + uSample), _mm256_set1_ps(frequency));
+            __m256 amp = _mm256_set1_ps(1.0f);
+            __m256 fin = _mm256_setzero_ps();
+
+            for (UINT i = 0u; i < uDepth; ++i)
+            {
+                __m256i xi = _mm256_cvttps_epi32(xa);
+                __m256i yi = _mm256_cvttps_epi32(ya);
+                __m256 xFrac = _mm256_sub_ps(xa, _mm256_cvtepi32_ps(xi));
+                __m256 yFrac = _mm256_sub_ps(ya, _mm256_cvtepi32_ps(yi));
+
+                __m256i row0 = _mm256_i32gather_epi32(aiHashes, _mm256_and_si256(yi, hashMask), 4);
+                __m256i row1 = _mm256_i32gather_epi32(aiHashes, _mm256_and_si256(_mm256_add_epi32(yi, one), hashMask), 4);
+                __m256i x0 = _mm256_add_epi32(row0, xi);
+                __m256i x1 = _mm256_add_epi32(row1, xi);
+                __m256 s = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(aiHashes, _mm256_and_si256(x0, hashMask), 4));
+                __m256 t = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(aiHashes, _mm256_and_si256(_mm256_add_epi32(x0, one), hashMask), 4));
+                __m256 u = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(aiHashes, _mm256_and_si256(x1, hashMask), 4));
+                __m256 v = _mm256_cvtepi32_ps(_mm256_i32gather_epi32(aiHashes, _mm256_and_si256(_mm256_add_epi32(x1, one), hashMask), 4));
+
+                // smoothLerp, with the operations in the same order
+                __m256 xWeight = _mm256_mul_ps(_mm256_mul_ps(xFrac, xFrac), _mm256_sub_ps(three, _mm256_mul_ps(two, xFrac)));
+                __m256 yWeight = _mm256_mul_ps(_mm256_mul_ps(yFrac, yFrac), _mm256_sub_ps(three, _mm256_mul_ps(two, yFrac)));
+                __m256 low = _mm256_add_ps(s, _mm256_mul_ps(xWeight, _mm256_sub_ps(t, s)));
+                __m256 high = _mm256_add_ps(u, _mm256_mul_ps(xWeight, _mm256_sub_ps(v, u)));
+                __m256 noise = _mm256_add_ps(low, _mm256_mul_ps(yWeight, _mm256_sub_ps(high, low)));
+
+                fin = _mm256_add_ps(fin, _mm256_mul_ps(noise, amp));
+                amp = _mm256_mul_ps(amp, _mm256_set1_ps(0.5f));
+                xa = _mm256_mul_ps(xa, two);
+                ya = _mm256_mul_ps(ya, two);
+            }
+
+            _mm256_storeu_ps(pOutNoise + uSample, _mm256_div_ps(fin, divisor));
+        }
+
+        return uNumEvaluated;
+    }
 }
\ No newline at end of file
@@ -19,7 +19,20 @@
 #include "Light/PointLight.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Scene/HeightMap.h"
+#include "Scene/OcclusionCuller.h"
+#include "Scene/TerrainStreamer.h"
 #include "Scene/Voxel.h"
+#include "Scene/VoxelBuilder.h"
+#include "Scene/VoxelChunk.h"
+#include "Scene/VoxelChunkMesh.h"
+#include "Scene/VoxelCollider.h"
+#include "Scene/VoxelColumnStore.h"
+#include "Scene/VoxelEditor.h"
+#include "Scene/VoxelLightField.h"
+#include "Scene/VoxelLodSelector.h"
+#include "Scene/VoxelMesher.h"
+#include "Scene/VoxelRaycaster.h"
 
 namespace library
 {
@@ -27,8 +40,27 @@ namespace library
     {
     public:
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
-
-        Scene(const std::filesystem::path& filePath);
+        static void GetPerlin2dBatch(
+            _In_reads_(uNumSamples) const FLOAT* pX,
+            _In_reads_(uNumSamples) const FLOAT* pY,
+            _In_ size_t uNumSamples,
+            _In_ FLOAT frequency,
+            _In_ UINT uDepth,
+            _Out_writes_(uNumSamples) FLOAT* pOutNoise
+        );
+        static FLOAT MeasurePerlin2dThroughput(_In_ UINT uWidth, _In_ UINT uDepth);
+
+        Scene(
+            const std::filesystem::path& filePath,
+            _In_ BOOL bCullHiddenVoxels = TRUE,
+            _In_ eVoxelMeshingMode voxelMeshingMode = eVoxelMeshingMode::INSTANCED_CUBES
+        );
+        Scene(
+            _In_ const HeightMapDesc& heightMap,
+            _In_ BOOL bCullHiddenVoxels = TRUE,
+            _In_ eVoxelMeshingMode voxelMeshingMode = eVoxelMeshingMode::INSTANCED_CUBES
+        );
+        Scene(const std::filesystem::path& filePath, _In_ const TerrainStreamingDesc& streamingDesc);
         Scene(const Scene& other) = delete;
         Scene(Scene&& other) = delete;
         Scene& operator=(const Scene& other) = delete;
@@ -46,8 +78,16 @@ namespace library
         HRESULT AddSkyBox(_In_ const std::shared_ptr<Skybox>& skybox);
 
         void Update(_In_ FLOAT deltaTime);
+        HRESULT UpdateTerrainStreaming(_In_ const XMVECTOR& eye, _In_ ID3D11Device* pDevice);
+        BOOL UpdateVoxelLods(_In_ const XMVECTOR& eye);
+        HRESULT UpdateVoxelEdits(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT UpdateVoxelLight(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+        std::vector<std::shared_ptr<VoxelChunk>>& GetVoxelChunks();
+        std::shared_ptr<VertexShader>& GetVertexShaderOfVoxelChunks();
+        std::shared_ptr<PixelShader>& GetPixelShaderOfVoxelChunks();
+        std::vector<std::shared_ptr<VoxelChunkMesh>>& GetVoxelChunkMeshes();
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
         std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
         std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
@@ -57,6 +97,31 @@ namespace library
 
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
+        BOOL IsCullingHiddenVoxels() const;
+        const VoxelBuildStatistics& GetVoxelBuildStatistics() const;
+        eVoxelMeshingMode GetVoxelMeshingMode() const;
+        BOOL IsStreamingTerrain() const;
+        TerrainStreamingStatistics GetTerrainStreamingStatistics() const;
+        VoxelLodStatistics GetVoxelLodStatistics() const;
+        VoxelEditStatistics GetVoxelEditStatistics() const;
+        VoxelLightStatistics GetVoxelLightStatistics() const;
+
+        VoxelCullingStatistics CullVoxelChunks(_In_ const BoundingFrustum& frustum, _Out_ std::vector<UINT>& auOutVisibleChunks) const;
+        VoxelCullingStatistics MeasureVoxelChunkCulling(_In_ const XMMATRIX& projection, _In_ const std::vector<XMMATRIX>& aViews) const;
+        OcclusionCullingStatistics CullOccludedVoxelChunks(_In_ const XMMATRIX& view, _In_ const XMMATRIX& projection, _Inout_ std::vector<UINT>& auVisibleChunks, _Inout_ VoxelCullingStatistics& cullingStatistics);
+        BOOL IsOccluded(_In_ const BoundingBox& boundingBox) const;
+        OcclusionCullingStatistics MeasureOcclusionCulling(_In_ const XMMATRIX& projection, _In_ const std::vector<XMMATRIX>& aViews);
+
+        BOOL RaycastVoxels(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& outHit) const;
+        HRESULT PlaceBlock(_In_ const XMUINT3& voxel, _In_ BYTE blockType);
+        HRESULT RemoveBlock(_In_ const XMUINT3& voxel);
+        HRESULT SetBlockEmission(_In_ BYTE blockType, _In_ BYTE level);
+        HRESULT AddVoxelLightEmitter(_In_ const XMUINT3& voxel, _In_ BYTE level, _Out_ UINT& uOutEmitter);
+        HRESULT MoveVoxelLightEmitter(_In_ UINT uEmitter, _In_ const XMUINT3& voxel);
+        HRESULT RemoveVoxelLightEmitter(_In_ UINT uEmitter);
+        void RaycastVoxelsBatch(_In_reads_(uNumRays) const VoxelRay* pRays, _In_ size_t uNumRays, _Out_writes_(uNumRays) VoxelRayHit* pOutHits) const;
+        BOOL CollideVoxels(_In_ const BoundingBox& box, _In_ const XMFLOAT3& displacement, _Out_ VoxelSweepResult& outResult) const;
+        void CollideVoxelsBatch(_In_reads_(uNumSweeps) const VoxelSweep* pSweeps, _In_ size_t uNumSweeps, _Out_writes_(uNumSweeps) VoxelSweepResult* pOutResults) const;
 
         HRESULT SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName);
@@ -64,14 +129,34 @@ namespace library
         HRESULT SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName);
         HRESULT SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName);
         HRESULT SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName);
+        HRESULT SetVertexShaderOfVoxelChunks(_In_ PCWSTR pszVertexShaderName);
+        HRESULT SetPixelShaderOfVoxelChunks(_In_ PCWSTR pszPixelShaderName);
+        HRESULT SetVertexShaderOfVoxelChunkMesh(_In_ PCWSTR pszVertexShaderName);
+        HRESULT SetPixelShaderOfVoxelChunkMesh(_In_ PCWSTR pszPixelShaderName);
 
     private:
+        Scene(
+            const std::filesystem::path& filePath,
+            _In_ BOOL bCullHiddenVoxels,
+            _In_ eVoxelMeshingMode voxelMeshingMode,
+            _In_ std::unique_ptr<HeightMapFile> pHeightMapFile
+        );
+
+        void createVoxels();
+        void createVoxelChunkMeshes(_In_ const HeightMapDesc& heightMap);
+        void createOccluders();
+        void lowerOccluder(_In_ const XMUINT3& voxel);
+
         static FLOAT getNoise2(UINT x, UINT y);
         static FLOAT getNoise2d(FLOAT x, FLOAT y);
         static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
         static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
+        static BOOL isAvx2Supported();
+        static size_t getPerlin2dBatchSse(_In_reads_(uNumSamples) const FLOAT* pX, _In_reads_(uNumSamples) const FLOAT* pY, _In_ size_t uNumSamples, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(uNumSamples) FLOAT* pOutNoise);
+        static size_t getPerlin2dBatchAvx2(_In_reads_(uNumSamples) const FLOAT* pX, _In_reads_(uNumSamples) const FLOAT* pY, _In_ size_t uNumSamples, _In_ FLOAT frequency, _In_ UINT uDepth, _Out_writes_(uNumSamples) FLOAT* pOutNoise);
 
     private:
+        static constexpr const UINT OCCLUDER_TILE_SIZE = 8u;
         static constexpr const UINT ms_aHashes[] =
         {
             208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
@@ -90,7 +175,27 @@ namespace library
 
     private:
         std::filesystem::path m_filePath;
+        BOOL m_bCullHiddenVoxels;
+        VoxelBuildStatistics m_voxelBuildStatistics;
+        eVoxelMeshingMode m_voxelMeshingMode;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
+        std::unique_ptr<VoxelColumnStore> m_pVoxelColumnStore;
+        std::vector<std::shared_ptr<VoxelChunk>> m_voxelChunks;
+        std::shared_ptr<VertexShader> m_voxelChunkVertexShader;
+        std::shared_ptr<PixelShader> m_voxelChunkPixelShader;
+        std::unique_ptr<HeightMapFile> m_pHeightMapFile;
+        std::unique_ptr<TerrainStreamer> m_pTerrainStreamer;
+        std::unique_ptr<VoxelLodSelector> m_pVoxelLodSelector;
+        std::unique_ptr<VoxelRaycaster> m_pVoxelRaycaster;
+        std::unique_ptr<VoxelCollider> m_pVoxelCollider;
+        std::unique_ptr<VoxelLightField> m_pVoxelLightField;
+        std::unique_ptr<VoxelEditor> m_pVoxelEditor;
+        std::unique_ptr<OcclusionCuller> m_pOcclusionCuller;
+        std::vector<BoundingBox> m_aOccluders;
+        UINT m_uNumOccluderTilesX;
+        std::vector<BoundingBox> m_aOcclusionTestBoxes;
+        std::vector<BYTE> m_abOcclusionTestResults;
+        std::vector<std::shared_ptr<VoxelChunkMesh>> m_voxelChunkMeshes;
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
         std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
         std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
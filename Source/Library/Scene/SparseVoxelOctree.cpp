@@ -0,0 +1,589 @@
+#include "Scene/SparseVoxelOctree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::SparseVoxelOctree
+
+      Summary:  Constructor of an empty octree
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_uNumLevels,
+                 m_auNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SparseVoxelOctree::SparseVoxelOctree()
+        : m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_uNumLevels(1u)
+        , m_auNodes(1u, makeLeaf(EMPTY_BLOCK))
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::Build
+
+      Summary:  Fills the octree from the columns of a height map. The
+                minimum and maximum column heights and the block type
+                of every aligned square of columns are reduced into a
+                pyramid first, so whether a node is uniform is a single
+                read and the octree is built top down without visiting
+                the voxels inside uniform nodes
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_uNumLevels,
+                 m_auNodes].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the palette collides
+                  with the reserved block types
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SparseVoxelOctree::Build(_In_ const HeightMapDesc& heightMap)
+    {
+        if (heightMap.uNumColors > MIXED_BLOCKS)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_uWidth = heightMap.uWidth;
+        m_uHeight = heightMap.uHeight;
+        m_uDepth = heightMap.uDepth;
+        m_uNumLevels = 1u;
+        m_auNodes.assign(1u, makeLeaf(EMPTY_BLOCK));
+
+        if (m_uWidth == 0u || m_uHeight == 0u || m_uDepth == 0u)
+        {
+            return S_OK;
+        }
+
+        const UINT uLargestSize = std::max<UINT>(std::max<UINT>(m_uWidth, m_uHeight), m_uDepth);
+        while ((1u << (m_uNumLevels - 1u)) < uLargestSize)
+        {
+            ++m_uNumLevels;
+        }
+        const UINT uSize = 1u << (m_uNumLevels - 1u);
+
+        // Columns past the edges of the map and columns without solid
+        // voxels match any block type
+        std::vector<std::vector<ColumnBounds>> aColumnPyramid(m_uNumLevels);
+        aColumnPyramid[0].assign(static_cast<size_t>(uSize) * uSize, ColumnBounds{ .minHeight = 0u, .maxHeight = 0u, .blockType = EMPTY_BLOCK });
+        for (UINT z = 0u; z < m_uDepth; ++z)
+        {
+            for (UINT x = 0u; x < m_uWidth; ++x)
+            {
+                size_t uColumn = static_cast<size_t>(z) * m_uWidth + x;
+                WORD columnHeight = static_cast<WORD>(std::min<UINT>(heightMap.pColumnHeights[uColumn], m_uHeight));
+                aColumnPyramid[0][static_cast<size_t>(z) * uSize + x] = ColumnBounds
+                {
+                    .minHeight = columnHeight,
+                    .maxHeight = columnHeight,
+                    .blockType = columnHeight > 0u ? heightMap.pBlockTypes[uColumn] : EMPTY_BLOCK,
+                };
+            }
+        }
+
+        for (UINT uLevel = 1u; uLevel < m_uNumLevels; ++uLevel)
+        {
+            const UINT uLevelSize = uSize >> uLevel;
+            const std::vector<ColumnBounds>& aFinerBounds = aColumnPyramid[uLevel - 1u];
+            aColumnPyramid[uLevel].resize(static_cast<size_t>(uLevelSize) * uLevelSize);
+            for (UINT z = 0u; z < uLevelSize; ++z)
+            {
+                for (UINT x = 0u; x < uLevelSize; ++x)
+                {
+                    ColumnBounds bounds = aFinerBounds[static_cast<size_t>(2u * z) * (2u * uLevelSize) + 2u * x];
+                    for (UINT uQuadrant = 1u; uQuadrant < 4u; ++uQuadrant)
+                    {
+                        const ColumnBounds& finerBounds = aFinerBounds[static_cast<size_t>(2u * z + (uQuadrant >> 1u)) * (2u * uLevelSize) + 2u * x + (uQuadrant & 1u)];
+                        bounds.minHeight = std::min<WORD>(bounds.minHeight, finerBounds.minHeight);
+                        bounds.maxHeight = std::max<WORD>(bounds.maxHeight, finerBounds.maxHeight);
+                        if (bounds.blockType == EMPTY_BLOCK)
+                        {
+                            bounds.blockType = finerBounds.blockType;
+                        }
+                        else if (finerBounds.blockType != EMPTY_BLOCK && finerBounds.blockType != bounds.blockType)
+                        {
+                            bounds.blockType = MIXED_BLOCKS;
+                        }
+                    }
+                    aColumnPyramid[uLevel][static_cast<size_t>(z) * uLevelSize + x] = bounds;
+                }
+            }
+        }
+
+        m_auNodes[0] = buildNode(aColumnPyramid, m_uNumLevels - 1u, 0u, 0u, 0u);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::GetBlockType
+
+      Summary:  Returns the block type of a voxel
+
+      Args:     UINT x
+                  Column of the voxel along the width
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column of the voxel along the depth
+
+      Returns:  BYTE
+                  Block type, EMPTY_BLOCK for air and voxels outside
+                  the volume
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE SparseVoxelOctree::GetBlockType(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        if (x >= m_uWidth || y >= m_uHeight || z >= m_uDepth)
+        {
+            return EMPTY_BLOCK;
+        }
+
+        XMUINT3 leafOrigin;
+        UINT uLeafSize;
+        return findLeaf(x, y, z, leafOrigin, uLeafSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::Raycast
+
+      Summary:  Finds the first solid voxel along a ray in voxel
+                coordinates, where voxel (x, y, z) spans [x, x + 1) on
+                every axis. The ray steps from leaf to leaf, so a large
+                empty leaf is crossed in one step
+
+      Args:     const XMFLOAT3& origin
+                  Origin of the ray
+                const XMFLOAT3& direction
+                  Direction of the ray
+                FLOAT maxDistance
+                  Length of the ray in units of the direction
+                SparseVoxelOctreeRayHit& outHit
+                  First solid voxel, left untouched if nothing is hit
+
+      Returns:  BOOL
+                  TRUE if the ray hits a solid voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL SparseVoxelOctree::Raycast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ SparseVoxelOctreeRayHit& outHit) const
+    {
+        const FLOAT afOrigin[3] = { origin.x, origin.y, origin.z };
+        const FLOAT afDirection[3] = { direction.x, direction.y, direction.z };
+        const UINT uSize = 1u << (m_uNumLevels - 1u);
+
+        // Clip the ray to the root cube
+        FLOAT tEnter = 0.0f;
+        FLOAT tExit = maxDistance;
+        INT iAxis = -1;
+        for (INT i = 0; i < 3; ++i)
+        {
+            if (afDirection[i] == 0.0f)
+            {
+                if (afOrigin[i] < 0.0f || afOrigin[i] >= static_cast<FLOAT>(uSize))
+                {
+                    return FALSE;
+                }
+                continue;
+            }
+
+            FLOAT tNear = (0.0f - afOrigin[i]) / afDirection[i];
+            FLOAT tFar = (static_cast<FLOAT>(uSize) - afOrigin[i]) / afDirection[i];
+            if (tNear > tFar)
+            {
+                std::swap(tNear, tFar);
+            }
+            if (tNear > tEnter)
+            {
+                tEnter = tNear;
+                iAxis = i;
+            }
+            tExit = std::min<FLOAT>(tExit, tFar);
+        }
+
+        if (tEnter > tExit)
+        {
+            return FALSE;
+        }
+
+        UINT auVoxel[3];
+        for (INT i = 0; i < 3; ++i)
+        {
+            FLOAT position = std::floor(afOrigin[i] + afDirection[i] * tEnter);
+            auVoxel[i] = static_cast<UINT>(std::clamp<FLOAT>(position, 0.0f, static_cast<FLOAT>(uSize - 1u)));
+        }
+        if (iAxis >= 0)
+        {
+            auVoxel[iAxis] = afDirection[iAxis] > 0.0f ? 0u : uSize - 1u;
+        }
+
+        FLOAT t = tEnter;
+        for (;;)
+        {
+            XMUINT3 leafOrigin;
+            UINT uLeafSize;
+            BYTE blockType = findLeaf(auVoxel[0], auVoxel[1], auVoxel[2], leafOrigin, uLeafSize);
+            if (blockType != EMPTY_BLOCK)
+            {
+                INT aiNormal[3] = { 0, 0, 0 };
+                if (iAxis >= 0)
+                {
+                    aiNormal[iAxis] = afDirection[iAxis] > 0.0f ? -1 : 1;
+                }
+
+                outHit = SparseVoxelOctreeRayHit
+                {
+                    .voxel = XMUINT3(auVoxel[0], auVoxel[1], auVoxel[2]),
+                    .blockType = blockType,
+                    .distance = t,
+                    .normal = XMINT3(aiNormal[0], aiNormal[1], aiNormal[2]),
+                };
+                return TRUE;
+            }
+
+            // Leave the empty leaf through its nearest face
+            const UINT auLeafOrigin[3] = { leafOrigin.x, leafOrigin.y, leafOrigin.z };
+            FLOAT tNext = std::numeric_limits<FLOAT>::infinity();
+            iAxis = -1;
+            for (INT i = 0; i < 3; ++i)
+            {
+                if (afDirection[i] == 0.0f)
+                {
+                    continue;
+                }
+
+                UINT uFace = afDirection[i] > 0.0f ? auLeafOrigin[i] + uLeafSize : auLeafOrigin[i];
+                FLOAT tFace = (static_cast<FLOAT>(uFace) - afOrigin[i]) / afDirection[i];
+                if (tFace < tNext)
+                {
+                    tNext = tFace;
+                    iAxis = i;
+                }
+            }
+
+            if (iAxis < 0 || tNext > tExit)
+            {
+                return FALSE;
+            }
+
+            if (afDirection[iAxis] > 0.0f)
+            {
+                if (auLeafOrigin[iAxis] + uLeafSize >= uSize)
+                {
+                    return FALSE;
+                }
+                auVoxel[iAxis] = auLeafOrigin[iAxis] + uLeafSize;
+            }
+            else
+            {
+                if (auLeafOrigin[iAxis] == 0u)
+                {
+                    return FALSE;
+                }
+                auVoxel[iAxis] = auLeafOrigin[iAxis] - 1u;
+            }
+
+            t = std::max<FLOAT>(t, tNext);
+            for (INT i = 0; i < 3; ++i)
+            {
+                if (i != iAxis)
+                {
+                    FLOAT position = std::floor(afOrigin[i] + afDirection[i] * t);
+                    auVoxel[i] = static_cast<UINT>(std::clamp<FLOAT>(position, static_cast<FLOAT>(auLeafOrigin[i]), static_cast<FLOAT>(auLeafOrigin[i] + uLeafSize - 1u)));
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::GetOccupiedLeaves
+
+      Summary:  Returns the leaves that hold solid voxels, skipping the
+                empty ones
+
+      Args:     std::vector<SparseVoxelOctreeLeaf>& aOutLeaves
+                  Occupied leaves in depth first order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SparseVoxelOctree::GetOccupiedLeaves(_Out_ std::vector<SparseVoxelOctreeLeaf>& aOutLeaves) const
+    {
+        aOutLeaves.clear();
+
+        struct PendingNode
+        {
+            UINT uNode;
+            UINT uSize;
+            XMUINT3 origin;
+        };
+
+        std::vector<PendingNode> aPendingNodes;
+        aPendingNodes.push_back(PendingNode{ .uNode = m_auNodes[0], .uSize = 1u << (m_uNumLevels - 1u), .origin = XMUINT3(0u, 0u, 0u) });
+        while (!aPendingNodes.empty())
+        {
+            PendingNode pendingNode = aPendingNodes.back();
+            aPendingNodes.pop_back();
+
+            if (isLeaf(pendingNode.uNode))
+            {
+                BYTE blockType = static_cast<BYTE>(pendingNode.uNode);
+                if (blockType != EMPTY_BLOCK)
+                {
+                    aOutLeaves.push_back(SparseVoxelOctreeLeaf{ .origin = pendingNode.origin, .uSize = pendingNode.uSize, .blockType = blockType });
+                }
+                continue;
+            }
+
+            const UINT uChildSize = pendingNode.uSize >> 1u;
+            for (UINT uChild = 8u; uChild-- > 0u;)
+            {
+                aPendingNodes.push_back(
+                    PendingNode
+                    {
+                        .uNode = m_auNodes[pendingNode.uNode + uChild],
+                        .uSize = uChildSize,
+                        .origin = XMUINT3(
+                            pendingNode.origin.x + ((uChild & 1u) ? uChildSize : 0u),
+                            pendingNode.origin.y + ((uChild & 2u) ? uChildSize : 0u),
+                            pendingNode.origin.z + ((uChild & 4u) ? uChildSize : 0u)
+                        ),
+                    }
+                );
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::GetNumNodes
+
+      Summary:  Returns the number of nodes
+
+      Returns:  size_t
+                  Number of inner nodes and leaves
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t SparseVoxelOctree::GetNumNodes() const
+    {
+        return m_auNodes.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::GetMemoryUsage
+
+      Summary:  Returns the bytes taken by the nodes
+
+      Returns:  size_t
+                  Size of the node array in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t SparseVoxelOctree::GetMemoryUsage() const
+    {
+        return m_auNodes.size() * sizeof(UINT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::MeasureAgainstFlat
+
+      Summary:  Fills a dense grid of block types from the height map
+                the octree was built from, looks the same random voxels
+                up in both and writes their memory, the memory of one
+                instance matrix per solid voxel and the time of a
+                lookup to the debugger output
+
+      Args:     const HeightMapDesc& heightMap
+                  Height map the octree was built from
+                UINT uNumLookups
+                  Number of random voxels looked up
+
+      Returns:  SparseVoxelOctreeStatistics
+                  Memory and lookup time of both representations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SparseVoxelOctreeStatistics SparseVoxelOctree::MeasureAgainstFlat(_In_ const HeightMapDesc& heightMap, _In_ UINT uNumLookups) const
+    {
+        std::vector<XMUINT3> aLookups;
+        aLookups.reserve(uNumLookups);
+
+        std::vector<BYTE> aDenseGrid(static_cast<size_t>(m_uWidth) * m_uHeight * m_uDepth, EMPTY_BLOCK);
+        UINT64 ullNumSolidVoxels = 0u;
+        for (UINT z = 0u; z < m_uDepth; ++z)
+        {
+            for (UINT x = 0u; x < m_uWidth; ++x)
+            {
+                size_t uColumn = static_cast<size_t>(z) * m_uWidth + x;
+                UINT uColumnHeight = std::min<UINT>(heightMap.pColumnHeights[uColumn], m_uHeight);
+                for (UINT y = 0u; y < uColumnHeight; ++y)
+                {
+                    aDenseGrid[(static_cast<size_t>(y) * m_uDepth + z) * m_uWidth + x] = heightMap.pBlockTypes[uColumn];
+                }
+                ullNumSolidVoxels += uColumnHeight;
+            }
+        }
+
+        if (!aDenseGrid.empty())
+        {
+            std::mt19937 generator(0u);
+            for (UINT uLookup = 0u; uLookup < uNumLookups; ++uLookup)
+            {
+                aLookups.push_back(XMUINT3(generator() % m_uWidth, generator() % m_uHeight, generator() % m_uDepth));
+            }
+        }
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        // Block types are summed so the lookups are not optimized away
+        // and the two representations can be compared
+        QueryPerformanceCounter(&startingTime);
+        UINT64 ullOctreeChecksum = 0u;
+        for (const XMUINT3& lookup : aLookups)
+        {
+            ullOctreeChecksum += GetBlockType(lookup.x, lookup.y, lookup.z);
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE octreeSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        QueryPerformanceCounter(&startingTime);
+        UINT64 ullDenseGridChecksum = 0u;
+        for (const XMUINT3& lookup : aLookups)
+        {
+            ullDenseGridChecksum += aDenseGrid[(static_cast<size_t>(lookup.y) * m_uDepth + lookup.z) * m_uWidth + lookup.x];
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE denseGridSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        std::vector<SparseVoxelOctreeLeaf> aOccupiedLeaves;
+        GetOccupiedLeaves(aOccupiedLeaves);
+
+        SparseVoxelOctreeStatistics statistics =
+        {
+            .ullNumNodes = m_auNodes.size(),
+            .ullNumOccupiedLeaves = aOccupiedLeaves.size(),
+            .ullOctreeBytes = GetMemoryUsage(),
+            .ullDenseGridBytes = aDenseGrid.size(),
+            .ullInstanceDataBytes = ullNumSolidVoxels * sizeof(InstanceData),
+            .octreeLookupNanoseconds = aLookups.empty() ? 0.0 : octreeSeconds * 1.0e9 / static_cast<DOUBLE>(aLookups.size()),
+            .denseGridLookupNanoseconds = aLookups.empty() ? 0.0 : denseGridSeconds * 1.0e9 / static_cast<DOUBLE>(aLookups.size()),
+        };
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "SparseVoxelOctree: %llu node(s), %llu KiB against %llu KiB dense and %llu KiB of instance matrices, lookup %.1f ns against %.1f ns dense%s\n",
+            statistics.ullNumNodes,
+            statistics.ullOctreeBytes / 1024u,
+            statistics.ullDenseGridBytes / 1024u,
+            statistics.ullInstanceDataBytes / 1024u,
+            statistics.octreeLookupNanoseconds,
+            statistics.denseGridLookupNanoseconds,
+            ullOctreeChecksum == ullDenseGridChecksum ? "" : ", lookups DIFFER"
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::buildNode
+
+      Summary:  Builds the node of a cube of voxels. The cube is a leaf
+                if it lies above every column under it, or below every
+                one of them while they share a block type. Otherwise
+                its eight children are reserved together and built
+                depth first
+
+      Args:     const std::vector<std::vector<ColumnBounds>>& aColumnPyramid
+                  Column bounds of every level
+                UINT uLevel
+                  Level of the cube, its edge being 2^uLevel voxels
+                UINT x
+                  Lowest voxel of the cube along the width
+                UINT y
+                  Lowest voxel of the cube along the height
+                UINT z
+                  Lowest voxel of the cube along the depth
+
+      Modifies: [m_auNodes].
+
+      Returns:  UINT
+                  Leaf or index of the first child
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SparseVoxelOctree::buildNode(_In_ const std::vector<std::vector<ColumnBounds>>& aColumnPyramid, _In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z)
+    {
+        const UINT uSize = 1u << uLevel;
+        const UINT uLevelSize = 1u << (m_uNumLevels - 1u - uLevel);
+        const ColumnBounds& bounds = aColumnPyramid[uLevel][static_cast<size_t>(z >> uLevel) * uLevelSize + (x >> uLevel)];
+        if (y >= bounds.maxHeight)
+        {
+            return makeLeaf(EMPTY_BLOCK);
+        }
+        if (y + uSize <= bounds.minHeight && bounds.blockType != MIXED_BLOCKS)
+        {
+            return makeLeaf(bounds.blockType);
+        }
+
+        const UINT uFirstChild = static_cast<UINT>(m_auNodes.size());
+        m_auNodes.resize(m_auNodes.size() + 8u);
+
+        const UINT uChildSize = uSize >> 1u;
+        for (UINT uChild = 0u; uChild < 8u; ++uChild)
+        {
+            UINT uNode = buildNode(
+                aColumnPyramid,
+                uLevel - 1u,
+                x + ((uChild & 1u) ? uChildSize : 0u),
+                y + ((uChild & 2u) ? uChildSize : 0u),
+                z + ((uChild & 4u) ? uChildSize : 0u)
+            );
+            m_auNodes[uFirstChild + uChild] = uNode;
+        }
+
+        return uFirstChild;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SparseVoxelOctree::findLeaf
+
+      Summary:  Descends from the root to the leaf holding a voxel
+
+      Args:     UINT x
+                  Column of the voxel along the width
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column of the voxel along the depth
+                XMUINT3& outOrigin
+                  Lowest voxel of the leaf
+                UINT& uOutSize
+                  Edge of the leaf in voxels
+
+      Returns:  BYTE
+                  Block type of the leaf
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE SparseVoxelOctree::findLeaf(_In_ UINT x, _In_ UINT y, _In_ UINT z, _Out_ XMUINT3& outOrigin, _Out_ UINT& uOutSize) const
+    {
+        UINT uNode = m_auNodes[0];
+        UINT uSize = 1u << (m_uNumLevels - 1u);
+        while (!isLeaf(uNode))
+        {
+            uSize >>= 1u;
+            uNode = m_auNodes[uNode + ((x & uSize) ? 1u : 0u) + ((y & uSize) ? 2u : 0u) + ((z & uSize) ? 4u : 0u)];
+        }
+
+        outOrigin = XMUINT3(x & ~(uSize - 1u), y & ~(uSize - 1u), z & ~(uSize - 1u));
+        uOutSize = uSize;
+
+        return static_cast<BYTE>(uNode);
+    }
+
+    BOOL SparseVoxelOctree::isLeaf(_In_ UINT uNode)
+    {
+        return (uNode & LEAF_BIT) != 0u;
+    }
+
+    UINT SparseVoxelOctree::makeLeaf(_In_ BYTE blockType)
+    {
+        return LEAF_BIT | blockType;
+    }
+}
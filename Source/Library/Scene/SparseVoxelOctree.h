@@ -0,0 +1,147 @@
+/*+===================================================================
+  File:      SPARSEVOXELOCTREE.H
+
+  Summary:   SparseVoxelOctree header file contains declarations of the
+             SparseVoxelOctree class that stores the block types of a
+             voxel volume in an octree for the lab samples of Game
+             Graphics Programming course.
+
+  Classes: SparseVoxelOctree
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SparseVoxelOctreeLeaf
+
+      Summary:  Cube of voxels of a single block type, given by its
+                lowest voxel and its edge length in voxels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SparseVoxelOctreeLeaf
+    {
+        XMUINT3 origin;
+        UINT uSize;
+        BYTE blockType;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SparseVoxelOctreeRayHit
+
+      Summary:  First solid voxel along a ray, its block type, the
+                distance to the face the ray entered it through and the
+                normal of that face
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SparseVoxelOctreeRayHit
+    {
+        XMUINT3 voxel;
+        BYTE blockType;
+        FLOAT distance;
+        XMINT3 normal;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SparseVoxelOctreeStatistics
+
+      Summary:  Memory of the octree against a dense grid of block
+                types and against one instance matrix per solid voxel,
+                and the time of a point lookup in the octree and in the
+                dense grid
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SparseVoxelOctreeStatistics
+    {
+        UINT64 ullNumNodes;
+        UINT64 ullNumOccupiedLeaves;
+        UINT64 ullOctreeBytes;
+        UINT64 ullDenseGridBytes;
+        UINT64 ullInstanceDataBytes;
+        DOUBLE octreeLookupNanoseconds;
+        DOUBLE denseGridLookupNanoseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SparseVoxelOctree
+
+      Summary:  Block types of a voxel volume in an octree over the
+                smallest power of two cube that holds it. A node that
+                is empty or of a single block type is a leaf, so air
+                above the terrain and uniform ground below it take a
+                handful of nodes and the node count follows the surface
+                rather than the volume. Nodes are 32 bits in one array:
+                a leaf holds its block type, an inner node the index of
+                its eight children, which are stored together
+
+      Methods:  Build
+                  Fills the octree from a height map
+                GetBlockType
+                  Returns the block type of a voxel
+                Raycast
+                  Returns the first solid voxel along a ray
+                GetOccupiedLeaves
+                  Returns the leaves that hold solid voxels
+                GetNumNodes
+                  Returns the number of nodes
+                GetMemoryUsage
+                  Returns the bytes taken by the nodes
+                MeasureAgainstFlat
+                  Compares memory and lookups with a dense grid
+                SparseVoxelOctree
+                  Constructor.
+                ~SparseVoxelOctree
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SparseVoxelOctree final
+    {
+    public:
+        static constexpr const BYTE EMPTY_BLOCK = 0xFFu;
+
+        SparseVoxelOctree();
+        SparseVoxelOctree(const SparseVoxelOctree& other) = delete;
+        SparseVoxelOctree(SparseVoxelOctree&& other) = delete;
+        SparseVoxelOctree& operator=(const SparseVoxelOctree& other) = delete;
+        SparseVoxelOctree& operator=(SparseVoxelOctree&& other) = delete;
+        ~SparseVoxelOctree() = default;
+
+        HRESULT Build(_In_ const HeightMapDesc& heightMap);
+
+        BYTE GetBlockType(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        BOOL Raycast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ SparseVoxelOctreeRayHit& outHit) const;
+        void GetOccupiedLeaves(_Out_ std::vector<SparseVoxelOctreeLeaf>& aOutLeaves) const;
+
+        size_t GetNumNodes() const;
+        size_t GetMemoryUsage() const;
+
+        SparseVoxelOctreeStatistics MeasureAgainstFlat(_In_ const HeightMapDesc& heightMap, _In_ UINT uNumLookups) const;
+
+    private:
+        struct ColumnBounds
+        {
+            WORD minHeight;
+            WORD maxHeight;
+            BYTE blockType;
+        };
+
+        UINT buildNode(_In_ const std::vector<std::vector<ColumnBounds>>& aColumnPyramid, _In_ UINT uLevel, _In_ UINT x, _In_ UINT y, _In_ UINT z);
+        BYTE findLeaf(_In_ UINT x, _In_ UINT y, _In_ UINT z, _Out_ XMUINT3& outOrigin, _Out_ UINT& uOutSize) const;
+
+        static BOOL isLeaf(_In_ UINT uNode);
+        static UINT makeLeaf(_In_ BYTE blockType);
+
+    private:
+        static constexpr const UINT LEAF_BIT = 0x80000000u;
+        static constexpr const BYTE MIXED_BLOCKS = 0xFEu;
+
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uDepth;
+        UINT m_uNumLevels;
+        std::vector<UINT> m_auNodes;
+    };
+}
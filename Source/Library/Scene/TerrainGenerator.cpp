@@ -0,0 +1,466 @@
+#include "Scene/TerrainGenerator.h"
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
+#include "Scene/Scene.h"
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::TerrainGenerator
+
+      Summary:  Constructor
+
+      Args:     const TerrainGenerationDesc& generationDesc
+                  Parameters of the generated terrain
+
+      Modifies: [m_generationDesc, m_heightOffset, m_moistureOffset,
+                 m_biomeTable, m_bBiomeTableLoaded, m_aBlockTypes,
+                 m_aHeights, m_aColumnHeights, m_cacheFile].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainGenerator::TerrainGenerator(_In_ const TerrainGenerationDesc& generationDesc)
+        : m_generationDesc(generationDesc)
+        , m_heightOffset(getSeedOffset(generationDesc.uSeed, generationDesc.frequency))
+        , m_moistureOffset(getSeedOffset(~generationDesc.uSeed, generationDesc.frequency))
+        , m_biomeTable()
+        , m_bBiomeTableLoaded(FALSE)
+        , m_aBlockTypes()
+        , m_aHeights()
+        , m_aColumnHeights()
+        , m_cacheFile()
+    {
+        static_assert(ARRAYSIZE(ms_aBiomeColors) == static_cast<size_t>(eBlockType::COUNT) - static_cast<size_t>(eBlockType::GRASSLAND));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::Generate
+
+      Summary:  Generates the columns of the map. The rows are split
+                into batches that the thread pool generates in parallel.
+                Unless a biome table was loaded, one is created from
+                the biome thresholds first. A cache file mapped by
+                GenerateCached is closed
+
+      Modifies: [m_biomeTable, m_aBlockTypes, m_aHeights,
+                 m_aColumnHeights, m_cacheFile].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainGenerator::Generate()
+    {
+        if (m_generationDesc.uNumOctaves == 0u || !(m_generationDesc.frequency > 0.0f))
+        {
+            return E_INVALIDARG;
+        }
+
+        m_cacheFile.Close();
+
+        if (!m_bBiomeTableLoaded)
+        {
+            HRESULT hr = m_biomeTable.CreateFromThresholds(m_generationDesc.biomeThresholds);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        LARGE_INTEGER startingTime, endingTime, frequency;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        size_t uNumColumns = static_cast<size_t>(m_generationDesc.uWidth) * static_cast<size_t>(m_generationDesc.uDepth);
+        m_aBlockTypes.assign(uNumColumns, 0u);
+        m_aHeights.assign(uNumColumns, 0.0f);
+        m_aColumnHeights.assign(uNumColumns, 0u);
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        UINT uNumThreads = threadPool.GetNumThreads() + 1u;
+        threadPool.ParallelFor(
+            0u,
+            m_generationDesc.uDepth,
+            std::max<size_t>(m_generationDesc.uDepth / (uNumThreads * 4u), 1u),
+            [this](size_t uBeginRow, size_t uEndRow)
+            {
+                generateRows(uBeginRow, uEndRow);
+            }
+        );
+
+        QueryPerformanceCounter(&endingTime);
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "TerrainGenerator: generated %ux%ux%u map in %.2f ms on %u thread(s)\n",
+            m_generationDesc.uWidth,
+            m_generationDesc.uHeight,
+            m_generationDesc.uDepth,
+            static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart),
+            uNumThreads
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GenerateCached
+
+      Summary:  Maps the cache file named after GetCacheKey into memory
+                when it exists and matches the size of the map, which
+                skips generation entirely. Otherwise generates the map
+                and writes the file for the next launch, through a
+                temporary file so an interrupted write never leaves a
+                truncated cache behind. A cache that cannot be written
+                is not an error. The normalized heights are not cached,
+                so ExportText needs Generate
+
+      Args:     const std::filesystem::path& cacheDirectory
+                  Directory of the cache files, created if missing
+
+      Modifies: [m_biomeTable, m_aBlockTypes, m_aHeights,
+                 m_aColumnHeights, m_cacheFile].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainGenerator::GenerateCached(_In_ const std::filesystem::path& cacheDirectory)
+    {
+        const std::filesystem::path cacheFilePath = GetCacheFilePath(cacheDirectory);
+
+        LARGE_INTEGER startingTime, endingTime, frequency;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        if (SUCCEEDED(m_cacheFile.Open(cacheFilePath)))
+        {
+            const HeightMapDesc heightMap = m_cacheFile.GetDesc();
+            if (heightMap.uWidth == m_generationDesc.uWidth
+                && heightMap.uHeight == m_generationDesc.uHeight
+                && heightMap.uDepth == m_generationDesc.uDepth
+                && heightMap.uNumColors == ARRAYSIZE(ms_aBiomeColors))
+            {
+                m_aBlockTypes.clear();
+                m_aHeights.clear();
+                m_aColumnHeights.clear();
+
+                QueryPerformanceCounter(&endingTime);
+
+                CHAR szDebugMessage[256];
+                sprintf_s(
+                    szDebugMessage,
+                    "TerrainGenerator: mapped cached %ux%ux%u map in %.2f ms\n",
+                    heightMap.uWidth,
+                    heightMap.uHeight,
+                    heightMap.uDepth,
+                    static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart)
+                );
+                OutputDebugStringA(szDebugMessage);
+
+                return S_OK;
+            }
+            m_cacheFile.Close();
+        }
+
+        HRESULT hr = Generate();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+
+        std::filesystem::path temporaryFilePath = cacheFilePath;
+        temporaryFilePath += L".tmp";
+        if (FAILED(HeightMapFile::Write(temporaryFilePath, GetDesc())))
+        {
+            std::filesystem::remove(temporaryFilePath, error);
+            OutputDebugStringA("TerrainGenerator: could not write the terrain cache\n");
+            return S_OK;
+        }
+
+        std::filesystem::rename(temporaryFilePath, cacheFilePath, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryFilePath, error);
+            OutputDebugStringA("TerrainGenerator: could not write the terrain cache\n");
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::ExportText
+
+      Summary:  Writes the generated map in the text format that
+                HeightMap::LoadText parses, with one line per row. Only
+                Generate keeps the normalized heights the format holds
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the text height map file
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainGenerator::ExportText(_In_ const std::filesystem::path& filePath) const
+    {
+        if (m_aHeights.size() != static_cast<size_t>(m_generationDesc.uWidth) * static_cast<size_t>(m_generationDesc.uDepth))
+        {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_STATE);
+        }
+
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        outputFile << m_generationDesc.uWidth << ' ' << m_generationDesc.uHeight << ' ' << m_generationDesc.uDepth << ' ' << ARRAYSIZE(ms_aBiomeColors) << '\n';
+        for (const XMFLOAT3& color : ms_aBiomeColors)
+        {
+            outputFile << color.x << ' ' << color.y << ' ' << color.z << '\n';
+        }
+
+        // Block type character, shortest round-trip height and separator
+        constexpr const size_t MAX_COLUMN_LENGTH = 1u + 16u + 1u;
+        std::string row(static_cast<size_t>(m_generationDesc.uWidth) * MAX_COLUMN_LENGTH + 1u, '\0');
+        for (UINT z = 0u; z < m_generationDesc.uDepth; ++z)
+        {
+            CHAR* pCursor = row.data();
+            CHAR* pEnd = row.data() + row.size();
+            for (UINT x = 0u; x < m_generationDesc.uWidth; ++x)
+            {
+                size_t uColumn = static_cast<size_t>(z) * m_generationDesc.uWidth + x;
+                *pCursor++ = static_cast<CHAR>(m_aBlockTypes[uColumn] + static_cast<BYTE>(eBlockType::GRASSLAND));
+                pCursor = std::to_chars(pCursor, pEnd, m_aHeights[uColumn]).ptr;
+                *pCursor++ = ' ';
+            }
+            *pCursor++ = '\n';
+            outputFile.write(row.data(), static_cast<std::streamsize>(pCursor - row.data()));
+        }
+
+        outputFile.close();
+        if (outputFile.fail())
+        {
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::LoadBiomeTable
+
+      Summary:  Loads the biome table used by the next Generate from a
+                file in place of the biome thresholds
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the biome table file
+
+      Modifies: [m_biomeTable, m_bBiomeTableLoaded].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainGenerator::LoadBiomeTable(_In_ const std::filesystem::path& filePath)
+    {
+        HRESULT hr = m_biomeTable.LoadText(filePath);
+        m_bBiomeTableLoaded = SUCCEEDED(hr);
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetDesc
+
+      Summary:  Returns a view over the generated columns, or over the
+                mapped cache file, valid until the next Generate or
+                GenerateCached
+
+      Returns:  HeightMapDesc
+                  Columns of the map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeightMapDesc TerrainGenerator::GetDesc() const
+    {
+        const HeightMapDesc cachedHeightMap = m_cacheFile.GetDesc();
+        if (cachedHeightMap.pBlockTypes)
+        {
+            return cachedHeightMap;
+        }
+
+        return HeightMapDesc
+        {
+            .uWidth = m_aBlockTypes.empty() ? 0u : m_generationDesc.uWidth,
+            .uHeight = m_generationDesc.uHeight,
+            .uDepth = m_aBlockTypes.empty() ? 0u : m_generationDesc.uDepth,
+            .uNumColors = ARRAYSIZE(ms_aBiomeColors),
+            .pPalette = ms_aBiomeColors,
+            .pBlockTypes = m_aBlockTypes.data(),
+            .pColumnHeights = m_aColumnHeights.data(),
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetGenerationDesc
+
+      Summary:  Returns the parameters of the generator
+
+      Returns:  const TerrainGenerationDesc&
+                  Parameters of the generator
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TerrainGenerationDesc& TerrainGenerator::GetGenerationDesc() const
+    {
+        return m_generationDesc;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetCacheKey
+
+      Summary:  Hashes everything the generated columns depend on: the
+                cache version that stands for the generation code, the
+                generation parameters, the biome table or the
+                thresholds it is created from, and the palette
+
+      Returns:  UINT64
+                  Key of the cache file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TerrainGenerator::GetCacheKey() const
+    {
+        UINT64 ullHash = HashBytes(&CACHE_VERSION, sizeof(CACHE_VERSION));
+        ullHash = HashBytes(&NOISE_DEPTH, sizeof(NOISE_DEPTH), ullHash);
+        ullHash = HashBytes(&m_generationDesc.uWidth, sizeof(m_generationDesc.uWidth), ullHash);
+        ullHash = HashBytes(&m_generationDesc.uHeight, sizeof(m_generationDesc.uHeight), ullHash);
+        ullHash = HashBytes(&m_generationDesc.uDepth, sizeof(m_generationDesc.uDepth), ullHash);
+        ullHash = HashBytes(&m_generationDesc.uSeed, sizeof(m_generationDesc.uSeed), ullHash);
+        ullHash = HashBytes(&m_generationDesc.uNumOctaves, sizeof(m_generationDesc.uNumOctaves), ullHash);
+        ullHash = HashBytes(&m_generationDesc.frequency, sizeof(m_generationDesc.frequency), ullHash);
+        ullHash = m_bBiomeTableLoaded
+            ? m_biomeTable.Hash(ullHash)
+            : HashBytes(&m_generationDesc.biomeThresholds, sizeof(m_generationDesc.biomeThresholds), ullHash);
+
+        return HashBytes(ms_aBiomeColors, sizeof(ms_aBiomeColors), ullHash);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::GetCacheFilePath
+
+      Summary:  Returns the path GenerateCached maps or writes the map
+                at, so a streaming scene can open the same file
+
+      Args:     const std::filesystem::path& cacheDirectory
+                  Directory of the cache files
+
+      Returns:  std::filesystem::path
+                  Path of the cache file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path TerrainGenerator::GetCacheFilePath(_In_ const std::filesystem::path& cacheDirectory) const
+    {
+        WCHAR szFileName[32];
+        swprintf_s(szFileName, L"Terrain_%016llX.hmap", GetCacheKey());
+
+        return cacheDirectory / szFileName;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::generateRows
+
+      Summary:  Generates a range of rows. Every octave samples a whole
+                row of height and moisture noise through the batch
+                Perlin noise API, and the row is classified in a batch
+                through the biome table
+
+      Args:     size_t uBeginRow
+                  First row to generate
+                size_t uEndRow
+                  One past the last row to generate
+
+      Modifies: [m_aBlockTypes, m_aHeights, m_aColumnHeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainGenerator::generateRows(_In_ size_t uBeginRow, _In_ size_t uEndRow)
+    {
+        UINT uWidth = m_generationDesc.uWidth;
+        std::vector<FLOAT> aSampleX(uWidth);
+        std::vector<FLOAT> aSampleZ(uWidth);
+        std::vector<FLOAT> aNoise(uWidth);
+        std::vector<FLOAT> aHeights(uWidth);
+        std::vector<FLOAT> aMoistures(uWidth);
+
+        for (size_t z = uBeginRow; z < uEndRow; ++z)
+        {
+            std::fill(aHeights.begin(), aHeights.end(), 0.0f);
+            std::fill(aMoistures.begin(), aMoistures.end(), 0.0f);
+
+            FLOAT frequencySum = 0.0f;
+            for (UINT i = 0u; i < m_generationDesc.uNumOctaves; ++i)
+            {
+                FLOAT frequency = static_cast<FLOAT>(1u << std::min<UINT>(i, 31u));
+                frequencySum += 1.0f / frequency;
+
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aSampleX[x] = frequency * (static_cast<FLOAT>(x) + m_heightOffset);
+                    aSampleZ[x] = frequency * (static_cast<FLOAT>(z) + m_heightOffset);
+                }
+                Scene::GetPerlin2dBatch(aSampleX.data(), aSampleZ.data(), uWidth, m_generationDesc.frequency, NOISE_DEPTH, aNoise.data());
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aHeights[x] += aNoise[x] / frequency;
+                }
+
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aSampleX[x] = frequency * (static_cast<FLOAT>(x) + m_moistureOffset);
+                    aSampleZ[x] = frequency * (static_cast<FLOAT>(z) + m_moistureOffset);
+                }
+                Scene::GetPerlin2dBatch(aSampleX.data(), aSampleZ.data(), uWidth, m_generationDesc.frequency, NOISE_DEPTH, aNoise.data());
+                for (UINT x = 0u; x < uWidth; ++x)
+                {
+                    aMoistures[x] += aNoise[x] / frequency;
+                }
+            }
+
+            size_t uFirstColumn = z * uWidth;
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                aHeights[x] = powf(aHeights[x] / frequencySum * 1.2f, 1.25f);
+                aMoistures[x] = powf(aMoistures[x] / frequencySum * 1.2f, 1.25f);
+
+                m_aHeights[uFirstColumn + x] = aHeights[x];
+                m_aColumnHeights[uFirstColumn + x] = QuantizeColumnHeight(aHeights[x], m_generationDesc.uHeight);
+            }
+            m_biomeTable.ClassifyBatch(aHeights.data(), aMoistures.data(), uWidth, m_aBlockTypes.data() + uFirstColumn);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainGenerator::getSeedOffset
+
+      Summary:  Hashes a seed into an offset of the noise coordinates.
+                The offset is a whole number of noise cells inside the
+                period of the hash table, so the noise stays in the
+                non-negative range the batch path expects
+
+      Args:     UINT uSeed
+                  Seed of the terrain
+                FLOAT frequency
+                  Frequency of the first octave
+
+      Returns:  FLOAT
+                  Offset of the map coordinates
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainGenerator::getSeedOffset(_In_ UINT uSeed, _In_ FLOAT frequency)
+    {
+        UINT uHash = uSeed;
+        uHash ^= uHash >> 16u;
+        uHash *= 0x7FEB352Du;
+        uHash ^= uHash >> 15u;
+        uHash *= 0x846CA68Bu;
+        uHash ^= uHash >> 16u;
+
+        return frequency > 0.0f ? static_cast<FLOAT>(uHash % 256u) / frequency : 0.0f;
+    }
+}
@@ -0,0 +1,151 @@
+/*+===================================================================
+  File:      TERRAINGENERATOR.H
+
+  Summary:   TerrainGenerator header file contains declarations of the
+             TerrainGenerator class that generates height maps from
+             Perlin noise for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: TerrainGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/BiomeTable.h"
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainGenerationDesc
+
+      Summary:  Size of the map in voxels, the seed that offsets the
+                height and moisture noise, the number of noise octaves
+                summed per column, the frequency of the first one and
+                the biome thresholds the biome table is created from
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainGenerationDesc
+    {
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        UINT uSeed;
+        UINT uNumOctaves;
+        FLOAT frequency;
+        TerrainBiomeThresholds biomeThresholds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainGenerator
+
+      Summary:  Generates the columns of a height map from height and
+                moisture noise, one row at a time on the thread pool,
+                and classifies the columns of every row into biomes in
+                a batch through a biome table. The result is held in
+                memory and can be built into voxels directly or
+                exported in the text format. Generated maps can be
+                cached on disk in the binary height map format, named
+                after a hash of everything the columns depend on, so a
+                later launch with the same parameters maps the file
+                into memory instead of generating it
+
+      Methods:  Generate
+                  Generates the height map
+                GenerateCached
+                  Loads the height map from the cache or generates
+                  and caches it
+                ExportText
+                  Writes the height map in the text format
+                LoadBiomeTable
+                  Replaces the biome thresholds with a table loaded
+                  from a file
+                GetDesc
+                  Returns a view over the columns
+                GetGenerationDesc
+                  Returns the parameters of the generator
+                GetCacheKey
+                  Returns the hash the cache file is named after
+                GetCacheFilePath
+                  Returns the path of the cache file
+                TerrainGenerator
+                  Constructor.
+                ~TerrainGenerator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainGenerator final
+    {
+    public:
+        static constexpr const UINT NOISE_DEPTH = 4u;
+        // Bump whenever the columns Generate produces change for the
+        // same parameters, so stale cache files are no longer found
+        static constexpr const UINT CACHE_VERSION = 1u;
+        static constexpr const TerrainBiomeThresholds DEFAULT_BIOME_THRESHOLDS =
+        {
+            .oceanHeight = 0.1f,
+            .beachHeight = 0.12f,
+            .midlandHeight = 0.3f,
+            .highlandHeight = 0.6f,
+            .mountainHeight = 0.8f,
+            .aMountainMoistures = { 0.1f, 0.2f, 0.5f },
+            .aHighlandMoistures = { 0.33f, 0.66f },
+            .aMidlandMoistures = { 0.16f, 0.5f, 0.83f },
+            .aLowlandMoistures = { 0.16f, 0.33f, 0.66f },
+        };
+
+        explicit TerrainGenerator(_In_ const TerrainGenerationDesc& generationDesc);
+        TerrainGenerator(const TerrainGenerator& other) = delete;
+        TerrainGenerator(TerrainGenerator&& other) = delete;
+        TerrainGenerator& operator=(const TerrainGenerator& other) = delete;
+        TerrainGenerator& operator=(TerrainGenerator&& other) = delete;
+        ~TerrainGenerator() = default;
+
+        HRESULT Generate();
+        HRESULT GenerateCached(_In_ const std::filesystem::path& cacheDirectory);
+        HRESULT ExportText(_In_ const std::filesystem::path& filePath) const;
+        HRESULT LoadBiomeTable(_In_ const std::filesystem::path& filePath);
+
+        HeightMapDesc GetDesc() const;
+        const TerrainGenerationDesc& GetGenerationDesc() const;
+        UINT64 GetCacheKey() const;
+        std::filesystem::path GetCacheFilePath(_In_ const std::filesystem::path& cacheDirectory) const;
+
+    private:
+        void generateRows(_In_ size_t uBeginRow, _In_ size_t uEndRow);
+
+        static FLOAT getSeedOffset(_In_ UINT uSeed, _In_ FLOAT frequency);
+
+    private:
+        static constexpr const XMFLOAT3 ms_aBiomeColors[] =
+        {
+            XMFLOAT3(0.0f,      0.666f, 0.0f),      // GRASSLAND
+            XMFLOAT3(1.0f,      1.0f,   1.0f),      // SNOW
+            XMFLOAT3(0.0f,      0.0f,   0.666f),    // OCEAN
+            XMFLOAT3(1.0f,      0.666f, 0.0f),      // SAND
+            XMFLOAT3(0.666f,    0.0f,   0.0f),      // SCORCHED
+            XMFLOAT3(0.956f,    0.643f, 0.376f),    // BARE
+            XMFLOAT3(0.941f,    0.0f,   1.0f),      // TUNDRA
+            XMFLOAT3(0.803f,    0.521f, 0.247f),    // TEMPERATE_DESERT
+            XMFLOAT3(0.42f,     0.556f, 0.137f),    // SHRUBLAND
+            XMFLOAT3(0.0f,      0.392f, 0.0f),      // TAIGA
+            XMFLOAT3(1.0f,      0.55f,  0.0f),      // TEMPERATE_DECIDUOUS_FOREST
+            XMFLOAT3(0.0f,      0.5f,   0.0f),      // TEMPERATE_RAIN_FOREST
+            XMFLOAT3(0.956f,    0.643f, 0.376f),    // SUBTROPICAL_DESERT
+            XMFLOAT3(0.133f,    0.545f, 0.133f),    // TROPICAL_SEASONAL_FOREST
+            XMFLOAT3(0.15f,     0.372f, 0.15f),     // TROPICAL_RAIN_FOREST
+        };
+
+    private:
+        TerrainGenerationDesc m_generationDesc;
+        FLOAT m_heightOffset;
+        FLOAT m_moistureOffset;
+        BiomeTable m_biomeTable;
+        BOOL m_bBiomeTableLoaded;
+        std::vector<BYTE> m_aBlockTypes;
+        std::vector<FLOAT> m_aHeights;
+        std::vector<WORD> m_aColumnHeights;
+        HeightMapFile m_cacheFile;
+    };
+}
@@ -0,0 +1,321 @@
+#include "Scene/TerrainStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::TerrainStreamer
+
+      Summary:  Constructor
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map. The columns
+                  must stay valid until the streamer is destroyed
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  left out
+                const TerrainStreamingDesc& streamingDesc
+                  Chunk size, residency radius and budgets
+
+      Modifies: [m_voxelBuilder, m_heightMap, m_streamingDesc,
+                 m_effectiveRadius, m_aChunkStates, m_residentChunks,
+                 m_auResidentChunkIndices, m_auBuildingChunks,
+                 m_statistics, m_buildQueue].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TerrainStreamer::TerrainStreamer(_In_ const HeightMapDesc& heightMap, _In_ BOOL bCullHiddenVoxels, _In_ const TerrainStreamingDesc& streamingDesc)
+        : m_voxelBuilder(heightMap, bCullHiddenVoxels, streamingDesc.uChunkSize)
+        , m_heightMap(heightMap)
+        , m_streamingDesc(streamingDesc)
+        , m_effectiveRadius(streamingDesc.residencyRadius)
+        , m_aChunkStates(static_cast<size_t>(m_voxelBuilder.GetNumChunksX()) * m_voxelBuilder.GetNumChunksZ(), eChunkState::NOT_RESIDENT)
+        , m_residentChunks()
+        , m_auResidentChunkIndices()
+        , m_auBuildingChunks()
+        , m_statistics{ .uNumResidentChunks = 0u, .uNumPendingBuilds = 0u, .uNumUploadedChunks = 0u, .uNumEvictedChunks = 0u, .ullResidentBytes = 0u }
+        , m_buildQueue(m_voxelBuilder)
+    {
+        m_streamingDesc.uMaxUploadsPerFrame = std::max<UINT>(m_streamingDesc.uMaxUploadsPerFrame, 1u);
+        m_streamingDesc.uMaxPendingBuilds = std::max<UINT>(m_streamingDesc.uMaxPendingBuilds, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::Update
+
+      Summary:  Evicts the resident chunks that left the residency
+                radius, then the farthest ones while over the memory
+                budget, shrinking the radius so they are not built
+                again right away. Schedules builds of the nearest
+                missing chunks on the thread pool while the budget and
+                the number of pending builds allow it
+
+      Args:     const XMFLOAT3& eye
+                  World position of the camera
+
+      Modifies: [m_effectiveRadius, m_aChunkStates, m_residentChunks,
+                 m_auResidentChunkIndices, m_auBuildingChunks,
+                 m_statistics, m_buildQueue].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::Update(_In_ const XMFLOAT3& eye)
+    {
+        const FLOAT chunkWidth = 2.0f * static_cast<FLOAT>(m_voxelBuilder.GetChunkSize());
+        m_statistics.uNumEvictedChunks = 0u;
+
+        // Chunks are kept until they are a chunk past the radius, so a
+        // camera moving along a chunk border does not rebuild them
+        const FLOAT evictionRadius = m_effectiveRadius + chunkWidth;
+        for (UINT uResidentIdx = static_cast<UINT>(m_residentChunks.size()); uResidentIdx-- > 0u;)
+        {
+            if (getDistanceSquared(m_auResidentChunkIndices[uResidentIdx], eye) > evictionRadius * evictionRadius)
+            {
+                evictChunk(uResidentIdx);
+            }
+        }
+
+        while (m_statistics.ullResidentBytes > m_streamingDesc.ullMemoryBudget && !m_residentChunks.empty())
+        {
+            UINT uFarthestIdx = 0u;
+            FLOAT farthestDistanceSquared = -1.0f;
+            for (UINT uResidentIdx = 0u; uResidentIdx < m_residentChunks.size(); ++uResidentIdx)
+            {
+                FLOAT distanceSquared = getDistanceSquared(m_auResidentChunkIndices[uResidentIdx], eye);
+                if (distanceSquared > farthestDistanceSquared)
+                {
+                    uFarthestIdx = uResidentIdx;
+                    farthestDistanceSquared = distanceSquared;
+                }
+            }
+
+            m_effectiveRadius = std::max<FLOAT>(std::min<FLOAT>(m_effectiveRadius, sqrtf(farthestDistanceSquared) - chunkWidth), 0.0f);
+            evictChunk(uFarthestIdx);
+        }
+
+        const UINT64 ullAverageChunkBytes = m_residentChunks.empty() ? 0u : m_statistics.ullResidentBytes / m_residentChunks.size();
+        if (m_statistics.ullResidentBytes + 2u * ullAverageChunkBytes < m_streamingDesc.ullMemoryBudget)
+        {
+            m_effectiveRadius = std::min<FLOAT>(m_effectiveRadius + chunkWidth, m_streamingDesc.residencyRadius);
+        }
+
+        // Only the chunks under the square around the eye can be in
+        // range. Chunk c spans [c * width - W - 1, (c + 1) * width - W - 1]
+        const INT iMinX = static_cast<INT>(floorf((eye.x - m_effectiveRadius + static_cast<FLOAT>(m_heightMap.uWidth) + 1.0f) / chunkWidth));
+        const INT iMaxX = static_cast<INT>(floorf((eye.x + m_effectiveRadius + static_cast<FLOAT>(m_heightMap.uWidth) + 1.0f) / chunkWidth));
+        const INT iMinZ = static_cast<INT>(floorf((eye.z - m_effectiveRadius + static_cast<FLOAT>(m_heightMap.uDepth) + 1.0f) / chunkWidth));
+        const INT iMaxZ = static_cast<INT>(floorf((eye.z + m_effectiveRadius + static_cast<FLOAT>(m_heightMap.uDepth) + 1.0f) / chunkWidth));
+        const UINT uNumChunksX = m_voxelBuilder.GetNumChunksX();
+        const UINT uNumChunksZ = m_voxelBuilder.GetNumChunksZ();
+
+        std::vector<std::pair<FLOAT, UINT>> aCandidates;
+        for (INT iChunkZ = std::max<INT>(iMinZ, 0); iChunkZ <= std::min<INT>(iMaxZ, static_cast<INT>(uNumChunksZ) - 1); ++iChunkZ)
+        {
+            for (INT iChunkX = std::max<INT>(iMinX, 0); iChunkX <= std::min<INT>(iMaxX, static_cast<INT>(uNumChunksX) - 1); ++iChunkX)
+            {
+                UINT uChunk = static_cast<UINT>(iChunkZ) * uNumChunksX + static_cast<UINT>(iChunkX);
+                FLOAT distanceSquared = getDistanceSquared(uChunk, eye);
+                if (distanceSquared > m_effectiveRadius * m_effectiveRadius)
+                {
+                    continue;
+                }
+
+                if (m_aChunkStates[uChunk] == eChunkState::CANCELLED)
+                {
+                    m_aChunkStates[uChunk] = eChunkState::BUILDING;
+                }
+                else if (m_aChunkStates[uChunk] == eChunkState::NOT_RESIDENT)
+                {
+                    aCandidates.emplace_back(distanceSquared, uChunk);
+                }
+            }
+        }
+
+        // Builds that left the range are dropped once they finish
+        for (UINT uChunk : m_auBuildingChunks)
+        {
+            if (m_aChunkStates[uChunk] == eChunkState::BUILDING && getDistanceSquared(uChunk, eye) > evictionRadius * evictionRadius)
+            {
+                m_aChunkStates[uChunk] = eChunkState::CANCELLED;
+            }
+        }
+
+        std::sort(aCandidates.begin(), aCandidates.end());
+
+        // Builds only finish meanwhile, so the count can only be high
+        UINT uNumPendingBuilds = m_buildQueue.GetNumPendingBuilds();
+        for (const std::pair<FLOAT, UINT>& candidate : aCandidates)
+        {
+            if (uNumPendingBuilds >= m_streamingDesc.uMaxPendingBuilds ||
+                m_statistics.ullResidentBytes + (uNumPendingBuilds + 1u) * ullAverageChunkBytes > m_streamingDesc.ullMemoryBudget)
+            {
+                break;
+            }
+
+            UINT uChunk = candidate.second;
+            m_aChunkStates[uChunk] = eChunkState::BUILDING;
+            m_auBuildingChunks.push_back(uChunk);
+            ++uNumPendingBuilds;
+            m_buildQueue.Enqueue(uChunk);
+        }
+        m_statistics.uNumPendingBuilds = uNumPendingBuilds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::UploadFinishedChunks
+
+      Summary:  Creates the GPU buffers of at most uMaxUploadsPerFrame
+                finished chunks and makes them resident. Chunks
+                cancelled while they were building are dropped. Called
+                on the thread that owns the device
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_aChunkStates, m_residentChunks,
+                 m_auResidentChunkIndices, m_auBuildingChunks,
+                 m_statistics, m_buildQueue].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TerrainStreamer::UploadFinishedChunks(_In_ ID3D11Device* pDevice)
+    {
+        m_statistics.uNumUploadedChunks = 0u;
+        while (m_statistics.uNumUploadedChunks < m_streamingDesc.uMaxUploadsPerFrame)
+        {
+            VoxelChunkData chunkData;
+            if (!m_buildQueue.PopFinishedChunk(chunkData))
+            {
+                break;
+            }
+            std::erase(m_auBuildingChunks, chunkData.uChunk);
+
+            if (m_aChunkStates[chunkData.uChunk] == eChunkState::CANCELLED)
+            {
+                m_aChunkStates[chunkData.uChunk] = eChunkState::NOT_RESIDENT;
+                continue;
+            }
+
+            // Empty chunks have nothing to draw but stay resident so
+            // they are not built again
+            m_aChunkStates[chunkData.uChunk] = eChunkState::RESIDENT;
+            const UINT uNumInstances = static_cast<UINT>(chunkData.pInstances->size());
+            if (uNumInstances == 0u)
+            {
+                continue;
+            }
+
+            // Block types double as voxel indices, the streaming scene
+            // creates one voxel per palette entry
+            std::shared_ptr<VoxelChunk> voxelChunk = std::make_shared<VoxelChunk>(
+                chunkData.pInstances,
+                0u,
+                uNumInstances,
+                std::move(chunkData.aInstanceRanges),
+                chunkData.boundingBox,
+                chunkData.origin,
+                1.0f
+            );
+
+            HRESULT hr = voxelChunk->Initialize(pDevice);
+            if (FAILED(hr))
+            {
+                m_aChunkStates[chunkData.uChunk] = eChunkState::NOT_RESIDENT;
+                return hr;
+            }
+
+            m_residentChunks.push_back(voxelChunk);
+            m_auResidentChunkIndices.push_back(chunkData.uChunk);
+            m_statistics.ullResidentBytes += static_cast<UINT64>(uNumInstances) * sizeof(PackedVoxelInstance);
+            ++m_statistics.uNumUploadedChunks;
+        }
+        m_statistics.uNumResidentChunks = static_cast<UINT>(m_residentChunks.size());
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetResidentChunks
+
+      Summary:  Returns the chunks uploaded to the GPU
+
+      Returns:  const std::vector<std::shared_ptr<VoxelChunk>>&
+                  Resident chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<std::shared_ptr<VoxelChunk>>& TerrainStreamer::GetResidentChunks() const
+    {
+        return m_residentChunks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::GetStatistics
+
+      Summary:  Returns the residency of the last frame
+
+      Returns:  const TerrainStreamingStatistics&
+                  Resident and pending chunks, memory and changes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TerrainStreamingStatistics& TerrainStreamer::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::getDistanceSquared
+
+      Summary:  Returns the squared horizontal distance from the eye to
+                the columns of a chunk
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+                const XMFLOAT3& eye
+                  World position of the camera
+
+      Returns:  FLOAT
+                  Squared distance, zero above the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT TerrainStreamer::getDistanceSquared(_In_ UINT uChunk, _In_ const XMFLOAT3& eye) const
+    {
+        const UINT uChunkSize = m_voxelBuilder.GetChunkSize();
+        const UINT uBeginX = (uChunk % m_voxelBuilder.GetNumChunksX()) * uChunkSize;
+        const UINT uBeginZ = (uChunk / m_voxelBuilder.GetNumChunksX()) * uChunkSize;
+        const UINT uEndX = std::min<UINT>(uBeginX + uChunkSize, m_heightMap.uWidth);
+        const UINT uEndZ = std::min<UINT>(uBeginZ + uChunkSize, m_heightMap.uDepth);
+
+        // Column x spans [2x - W - 1, 2x - W + 1] in world space
+        const FLOAT minX = 2.0f * static_cast<FLOAT>(uBeginX) - static_cast<FLOAT>(m_heightMap.uWidth) - 1.0f;
+        const FLOAT maxX = 2.0f * static_cast<FLOAT>(uEndX) - static_cast<FLOAT>(m_heightMap.uWidth) - 1.0f;
+        const FLOAT minZ = 2.0f * static_cast<FLOAT>(uBeginZ) - static_cast<FLOAT>(m_heightMap.uDepth) - 1.0f;
+        const FLOAT maxZ = 2.0f * static_cast<FLOAT>(uEndZ) - static_cast<FLOAT>(m_heightMap.uDepth) - 1.0f;
+
+        const FLOAT dx = std::max<FLOAT>(std::max<FLOAT>(minX - eye.x, eye.x - maxX), 0.0f);
+        const FLOAT dz = std::max<FLOAT>(std::max<FLOAT>(minZ - eye.z, eye.z - maxZ), 0.0f);
+
+        return dx * dx + dz * dz;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TerrainStreamer::evictChunk
+
+      Summary:  Releases a resident chunk. The last resident chunk takes
+                its slot
+
+      Args:     UINT uResidentIdx
+                  Index of the chunk among the resident chunks
+
+      Modifies: [m_aChunkStates, m_residentChunks,
+                 m_auResidentChunkIndices, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TerrainStreamer::evictChunk(_In_ UINT uResidentIdx)
+    {
+        m_aChunkStates[m_auResidentChunkIndices[uResidentIdx]] = eChunkState::NOT_RESIDENT;
+        m_statistics.ullResidentBytes -= static_cast<UINT64>(m_residentChunks[uResidentIdx]->GetNumInstances()) * sizeof(PackedVoxelInstance);
+
+        m_residentChunks[uResidentIdx] = std::move(m_residentChunks.back());
+        m_residentChunks.pop_back();
+        m_auResidentChunkIndices[uResidentIdx] = m_auResidentChunkIndices.back();
+        m_auResidentChunkIndices.pop_back();
+
+        m_statistics.uNumResidentChunks = static_cast<UINT>(m_residentChunks.size());
+        ++m_statistics.uNumEvictedChunks;
+    }
+}
@@ -0,0 +1,119 @@
+/*+===================================================================
+  File:      TERRAINSTREAMER.H
+
+  Summary:   TerrainStreamer header file contains declarations of the
+             TerrainStreamer class that keeps the voxel chunks around
+             the camera resident for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: TerrainStreamer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/HeightMap.h"
+#include "Scene/VoxelBuilder.h"
+#include "Scene/VoxelChunk.h"
+#include "Scene/VoxelChunkBuildQueue.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainStreamingDesc
+
+      Summary:  Chunk size, the world space radius around the eye that
+                is kept resident, the instance memory budget of the
+                resident chunks, and the number of finished chunks
+                uploaded to the GPU per frame
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainStreamingDesc
+    {
+        UINT uChunkSize;
+        FLOAT residencyRadius;
+        UINT64 ullMemoryBudget;
+        UINT uMaxUploadsPerFrame;
+        UINT uMaxPendingBuilds;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TerrainStreamingStatistics
+
+      Summary:  Resident and in-flight chunks, the instance memory of
+                the resident ones, and what the last frame changed
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TerrainStreamingStatistics
+    {
+        UINT uNumResidentChunks;
+        UINT uNumPendingBuilds;
+        UINT uNumUploadedChunks;
+        UINT uNumEvictedChunks;
+        UINT64 ullResidentBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TerrainStreamer
+
+      Summary:  Builds the chunks of a height map within a radius of
+                the eye on the thread pool and evicts the ones that fall
+                out of it or exceed the memory budget. The height map is
+                usually a mapped binary file, so only the columns of
+                built chunks are paged in. The main thread only uploads
+                finished chunks, a bounded number per frame
+
+      Methods:  Update
+                  Evicts and schedules chunks around the eye
+                UploadFinishedChunks
+                  Uploads finished chunks to the GPU
+                GetResidentChunks
+                  Returns the chunks that can be drawn
+                GetStatistics
+                  Returns the residency of the last frame
+                TerrainStreamer
+                  Constructor.
+                ~TerrainStreamer
+                  Destructor. Waits for the scheduled builds
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TerrainStreamer final
+    {
+    public:
+        TerrainStreamer(_In_ const HeightMapDesc& heightMap, _In_ BOOL bCullHiddenVoxels, _In_ const TerrainStreamingDesc& streamingDesc);
+        TerrainStreamer(const TerrainStreamer& other) = delete;
+        TerrainStreamer(TerrainStreamer&& other) = delete;
+        TerrainStreamer& operator=(const TerrainStreamer& other) = delete;
+        TerrainStreamer& operator=(TerrainStreamer&& other) = delete;
+        ~TerrainStreamer() = default;
+
+        void Update(_In_ const XMFLOAT3& eye);
+        HRESULT UploadFinishedChunks(_In_ ID3D11Device* pDevice);
+
+        const std::vector<std::shared_ptr<VoxelChunk>>& GetResidentChunks() const;
+        const TerrainStreamingStatistics& GetStatistics() const;
+
+    private:
+        enum class eChunkState : BYTE
+        {
+            NOT_RESIDENT = 0,
+            BUILDING,
+            CANCELLED,
+            RESIDENT,
+        };
+
+        FLOAT getDistanceSquared(_In_ UINT uChunk, _In_ const XMFLOAT3& eye) const;
+        void evictChunk(_In_ UINT uResidentIdx);
+
+    private:
+        VoxelBuilder m_voxelBuilder;
+        HeightMapDesc m_heightMap;
+        TerrainStreamingDesc m_streamingDesc;
+        FLOAT m_effectiveRadius;
+        std::vector<eChunkState> m_aChunkStates;
+        std::vector<std::shared_ptr<VoxelChunk>> m_residentChunks;
+        std::vector<UINT> m_auResidentChunkIndices;
+        std::vector<UINT> m_auBuildingChunks;
+        TerrainStreamingStatistics m_statistics;
+        VoxelChunkBuildQueue m_buildQueue;
+    };
+}
@@ -0,0 +1,637 @@
+#include "Scene/VoxelBuilder.h"
+
+#include <algorithm>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::VoxelBuilder
+
+      Summary:  Constructor
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map. The columns
+                  must stay valid until Build returns
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  left out
+                UINT uChunkSize
+                  Number of columns along a chunk side, at most
+                  VoxelInstancePacker::MAX_CHUNK_SIZE
+
+      Modifies: [m_heightMap, m_pColumnStore, m_bCullHiddenVoxels,
+                 m_uChunkSize, m_pInstanceArena, m_aInstanceRanges,
+                 m_aChunkBoundingBoxes, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelBuilder::VoxelBuilder(_In_ const HeightMapDesc& heightMap, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize)
+        : m_heightMap(heightMap)
+        , m_pColumnStore(nullptr)
+        , m_bCullHiddenVoxels(bCullHiddenVoxels)
+        , m_uChunkSize(std::clamp<UINT>(uChunkSize, 1u, VoxelInstancePacker::MAX_CHUNK_SIZE))
+        , m_pInstanceArena(std::make_shared<std::vector<PackedVoxelInstance>>())
+        , m_aInstanceRanges()
+        , m_aChunkBoundingBoxes()
+        , m_statistics{ .ullNumSolidVoxels = 0u, .ullNumInstances = 0u, .ullNumCulledVoxels = 0u }
+    {
+        const size_t uNumChunks = static_cast<size_t>(GetNumChunksX()) * GetNumChunksZ();
+        m_aInstanceRanges.resize(uNumChunks * m_heightMap.uNumColors, VoxelInstanceRange{ 0u, 0u });
+        m_aChunkBoundingBoxes.resize(uNumChunks);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::VoxelBuilder
+
+      Summary:  Constructor of a builder that derives the instances
+                from the runs of a column store
+
+      Args:     const VoxelColumnStore& columnStore
+                  Columns to build. The store must stay valid and
+                  unchanged while the builder builds
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  left out
+                UINT uChunkSize
+                  Number of columns along a chunk side, at most
+                  VoxelInstancePacker::MAX_CHUNK_SIZE
+
+      Modifies: [m_heightMap, m_pColumnStore, m_bCullHiddenVoxels,
+                 m_uChunkSize, m_pInstanceArena, m_aInstanceRanges,
+                 m_aChunkBoundingBoxes, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelBuilder::VoxelBuilder(_In_ const VoxelColumnStore& columnStore, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize)
+        : VoxelBuilder(
+            HeightMapDesc
+            {
+                .uWidth = columnStore.GetWidth(),
+                .uHeight = columnStore.GetHeight(),
+                .uDepth = columnStore.GetDepth(),
+                .uNumColors = columnStore.GetNumColors(),
+                .pPalette = columnStore.GetPalette(),
+                .pBlockTypes = nullptr,
+                .pColumnHeights = nullptr,
+            },
+            bCullHiddenVoxels,
+            uChunkSize
+        )
+    {
+        m_pColumnStore = &columnStore;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::Build
+
+      Summary:  Counts the instances of every block type per chunk,
+                sizes the arena once, and writes every chunk's
+                instances at its precomputed offset
+
+      Modifies: [m_pInstanceArena, m_aInstanceRanges,
+                 m_aChunkBoundingBoxes, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelBuilder::Build()
+    {
+        const UINT uNumBlockTypes = m_heightMap.uNumColors;
+        const size_t uNumChunks = m_aChunkBoundingBoxes.size();
+        if (uNumBlockTypes == 0u || uNumChunks == 0u)
+        {
+            return;
+        }
+
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+
+        // Pass 1: instance count of every (chunk, block type)
+        std::vector<UINT> auChunkCounts(uNumChunks * uNumBlockTypes, 0u);
+        std::vector<UINT64> aullChunkSolidVoxels(uNumChunks, 0u);
+        threadPool.ParallelFor(
+            0u,
+            uNumChunks,
+            1u,
+            [this, &auChunkCounts, &aullChunkSolidVoxels, uNumBlockTypes](size_t uBeginChunk, size_t uEndChunk)
+            {
+                for (size_t uChunk = uBeginChunk; uChunk < uEndChunk; ++uChunk)
+                {
+                    countChunk(static_cast<UINT>(uChunk), &auChunkCounts[uChunk * uNumBlockTypes], aullChunkSolidVoxels[uChunk]);
+                }
+            }
+        );
+
+        // Chunks are laid out one after another and the block types of a
+        // chunk in palette order, so the counts become write cursors
+        UINT uNumInstances = 0u;
+        for (size_t uRange = 0u; uRange < auChunkCounts.size(); ++uRange)
+        {
+            m_aInstanceRanges[uRange] = VoxelInstanceRange{ .uFirstInstance = uNumInstances, .uNumInstances = auChunkCounts[uRange] };
+            auChunkCounts[uRange] = uNumInstances;
+            uNumInstances += m_aInstanceRanges[uRange].uNumInstances;
+        }
+
+        m_statistics.ullNumSolidVoxels = 0u;
+        for (UINT64 ullChunkSolidVoxels : aullChunkSolidVoxels)
+        {
+            m_statistics.ullNumSolidVoxels += ullChunkSolidVoxels;
+        }
+        m_statistics.ullNumInstances = uNumInstances;
+        m_statistics.ullNumCulledVoxels = m_statistics.ullNumSolidVoxels - uNumInstances;
+
+        // Pass 2: the only allocation, then every chunk fills its own slots
+        m_pInstanceArena->resize(uNumInstances);
+        threadPool.ParallelFor(
+            0u,
+            uNumChunks,
+            1u,
+            [this, &auChunkCounts, uNumBlockTypes](size_t uBeginChunk, size_t uEndChunk)
+            {
+                for (size_t uChunk = uBeginChunk; uChunk < uEndChunk; ++uChunk)
+                {
+                    emitChunk(static_cast<UINT>(uChunk), &auChunkCounts[uChunk * uNumBlockTypes], m_pInstanceArena->data());
+                }
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::BuildChunk
+
+      Summary:  Counts and emits the instances of one chunk into a
+                buffer of their own, leaving the shared arena and the
+                statistics untouched. Different chunks can be built on
+                different threads at the same time
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+                VoxelChunkData& outChunk
+                  Instances, ranges, bounds and origin of the chunk
+
+      Modifies: [m_aChunkBoundingBoxes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelBuilder::BuildChunk(_In_ UINT uChunk, _Out_ VoxelChunkData& outChunk)
+    {
+        assert(uChunk < m_aChunkBoundingBoxes.size());
+
+        const UINT uNumBlockTypes = m_heightMap.uNumColors;
+        std::vector<UINT> auCursors(uNumBlockTypes, 0u);
+        UINT64 ullNumSolidVoxels = 0u;
+        countChunk(uChunk, auCursors.data(), ullNumSolidVoxels);
+
+        outChunk.uChunk = uChunk;
+        outChunk.aInstanceRanges.resize(uNumBlockTypes);
+
+        UINT uNumInstances = 0u;
+        for (UINT uBlockType = 0u; uBlockType < uNumBlockTypes; ++uBlockType)
+        {
+            outChunk.aInstanceRanges[uBlockType] = VoxelInstanceRange{ .uFirstInstance = uNumInstances, .uNumInstances = auCursors[uBlockType] };
+            auCursors[uBlockType] = uNumInstances;
+            uNumInstances += outChunk.aInstanceRanges[uBlockType].uNumInstances;
+        }
+
+        outChunk.pInstances = std::make_shared<std::vector<PackedVoxelInstance>>(uNumInstances);
+        emitChunk(uChunk, auCursors.data(), outChunk.pInstances->data());
+
+        outChunk.boundingBox = m_aChunkBoundingBoxes[uChunk];
+        outChunk.origin = GetChunkOrigin(uChunk);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetInstanceArena
+
+      Summary:  Returns the arena that holds the instances of every
+                chunk
+
+      Returns:  const std::shared_ptr<std::vector<PackedVoxelInstance>>&
+                  Instance arena
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<std::vector<PackedVoxelInstance>>& VoxelBuilder::GetInstanceArena() const
+    {
+        return m_pInstanceArena;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetInstanceRange
+
+      Summary:  Returns the range of a block type of a chunk in the
+                arena
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+                UINT uBlockType
+                  Index of the block type in the palette
+
+      Returns:  const VoxelInstanceRange&
+                  Range of the block type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelInstanceRange& VoxelBuilder::GetInstanceRange(_In_ UINT uChunk, _In_ UINT uBlockType) const
+    {
+        assert(uBlockType < m_heightMap.uNumColors);
+
+        return m_aInstanceRanges[static_cast<size_t>(uChunk) * m_heightMap.uNumColors + uBlockType];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetChunkBoundingBox
+
+      Summary:  Returns the world space bounds of the emitted voxels of
+                a chunk
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+
+      Returns:  const BoundingBox&
+                  Axis-aligned bounding box of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& VoxelBuilder::GetChunkBoundingBox(_In_ UINT uChunk) const
+    {
+        assert(uChunk < m_aChunkBoundingBoxes.size());
+
+        return m_aChunkBoundingBoxes[uChunk];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetChunkOrigin
+
+      Summary:  Returns the world position of the center of the voxel
+                at the lowest corner of a chunk, layer 0. Packed
+                instances of the chunk are offsets from it in 2-unit
+                steps
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+
+      Returns:  XMFLOAT3
+                  Origin of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT3 VoxelBuilder::GetChunkOrigin(_In_ UINT uChunk) const
+    {
+        const UINT uBeginX = (uChunk % GetNumChunksX()) * m_uChunkSize;
+        const UINT uBeginZ = (uChunk / GetNumChunksX()) * m_uChunkSize;
+
+        return XMFLOAT3(
+            2.0f * (static_cast<FLOAT>(uBeginX) - static_cast<FLOAT>(m_heightMap.uWidth) / 2.0f),
+            -2.0f * static_cast<FLOAT>(m_heightMap.uHeight) + (static_cast<FLOAT>(m_heightMap.uHeight) * 0.75f),
+            2.0f * (static_cast<FLOAT>(uBeginZ) - static_cast<FLOAT>(m_heightMap.uDepth) / 2.0f)
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetNumBlockTypes
+
+      Summary:  Returns the number of block types
+
+      Returns:  UINT
+                  Number of block types
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::GetNumBlockTypes() const
+    {
+        return m_heightMap.uNumColors;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetChunkSize
+
+      Summary:  Returns the number of columns along a chunk side
+
+      Returns:  UINT
+                  Chunk size
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::GetChunkSize() const
+    {
+        return m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetNumChunksX
+
+      Summary:  Returns the number of chunks along x
+
+      Returns:  UINT
+                  Number of chunks along x
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::GetNumChunksX() const
+    {
+        return (m_heightMap.uWidth + m_uChunkSize - 1u) / m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetNumChunksZ
+
+      Summary:  Returns the number of chunks along z
+
+      Returns:  UINT
+                  Number of chunks along z
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::GetNumChunksZ() const
+    {
+        return (m_heightMap.uDepth + m_uChunkSize - 1u) / m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::GetStatistics
+
+      Summary:  Returns the statistics of the last build
+
+      Returns:  const VoxelBuildStatistics&
+                  Solid, emitted and culled voxel counts
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelBuildStatistics& VoxelBuilder::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::getFirstEmittedLayer
+
+      Summary:  Returns the lowest layer of a column that gets emitted.
+                A voxel is exposed to air through its top face if it is
+                the top of its column, and through a side face if it
+                rises above the shortest of the four neighbouring
+                columns. Columns outside the map count as empty, and the
+                bottom faces of the lowest layer count as covered
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  UINT
+                  Lowest emitted layer, equal to the column height if
+                  the column is empty
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::getFirstEmittedLayer(_In_ UINT x, _In_ UINT z) const
+    {
+        WORD height = getColumnHeight(x, z);
+        if (!m_bCullHiddenVoxels || height == 0u)
+        {
+            return 0u;
+        }
+
+        WORD lowestNeighbour = std::min<WORD>(
+            std::min<WORD>(
+                x > 0u ? getColumnHeight(x - 1u, z) : 0u,
+                x + 1u < m_heightMap.uWidth ? getColumnHeight(x + 1u, z) : 0u
+            ),
+            std::min<WORD>(
+                z > 0u ? getColumnHeight(x, z - 1u) : 0u,
+                z + 1u < m_heightMap.uDepth ? getColumnHeight(x, z + 1u) : 0u
+            )
+        );
+
+        return std::min<UINT>(lowestNeighbour, height - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::getColumnHeight
+
+      Summary:  Returns the height of a column, zero if its block type
+                is not in the palette. Columns taller than the packed
+                encoding can address are cut off
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  WORD
+                  Number of voxels in the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WORD VoxelBuilder::getColumnHeight(_In_ UINT x, _In_ UINT z) const
+    {
+        if (m_pColumnStore)
+        {
+            return std::min<WORD>(m_pColumnStore->GetColumnHeight(x, z), static_cast<WORD>(VoxelInstancePacker::MAX_NUM_LAYERS));
+        }
+
+        size_t uColumnIdx = static_cast<size_t>(z) * m_heightMap.uWidth + x;
+        if (m_heightMap.pBlockTypes[uColumnIdx] >= m_heightMap.uNumColors)
+        {
+            return 0u;
+        }
+
+        return std::min<WORD>(m_heightMap.pColumnHeights[uColumnIdx], static_cast<WORD>(VoxelInstancePacker::MAX_NUM_LAYERS));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::getColumnBlockType
+
+      Summary:  Returns the block type of a column that is a single run
+                from the floor
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  UINT
+                  Index of the block type in the palette
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelBuilder::getColumnBlockType(_In_ UINT x, _In_ UINT z) const
+    {
+        if (m_pColumnStore)
+        {
+            return m_pColumnStore->GetBlockType(x, 0u, z);
+        }
+
+        return m_heightMap.pBlockTypes[static_cast<size_t>(z) * m_heightMap.uWidth + x];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::isSingleRunNeighbourhood
+
+      Summary:  Returns whether a column and its four neighbours are
+                each a single run from the floor, so the column can be
+                culled from the column heights alone
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  BOOL
+                  TRUE for every height map column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelBuilder::isSingleRunNeighbourhood(_In_ UINT x, _In_ UINT z) const
+    {
+        if (!m_pColumnStore)
+        {
+            return TRUE;
+        }
+
+        return m_pColumnStore->IsSingleRun(x, z)
+            && (x == 0u || m_pColumnStore->IsSingleRun(x - 1u, z))
+            && (x + 1u >= m_heightMap.uWidth || m_pColumnStore->IsSingleRun(x + 1u, z))
+            && (z == 0u || m_pColumnStore->IsSingleRun(x, z - 1u))
+            && (z + 1u >= m_heightMap.uDepth || m_pColumnStore->IsSingleRun(x, z + 1u));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::getEmittedVoxels
+
+      Summary:  Walks the runs of a column store column and returns its
+                solid voxels, only the ones with a face exposed to air
+                with hidden voxel culling
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+                std::vector<VoxelRun>& aRuns
+                  Scratch buffer for the runs of the column
+                std::vector<EmittedVoxel>& aOutVoxels
+                  Layer and block type of every emitted voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelBuilder::getEmittedVoxels(_In_ UINT x, _In_ UINT z, _Inout_ std::vector<VoxelRun>& aRuns, _Out_ std::vector<EmittedVoxel>& aOutVoxels) const
+    {
+        aOutVoxels.clear();
+        m_pColumnStore->GetRuns(x, z, aRuns);
+
+        UINT uRunBegin = 0u;
+        for (const VoxelRun& run : aRuns)
+        {
+            const UINT uRunEnd = std::min<UINT>(uRunBegin + run.uLength, VoxelInstancePacker::MAX_NUM_LAYERS);
+            if (run.blockType < m_heightMap.uNumColors)
+            {
+                for (UINT y = uRunBegin; y < uRunEnd; ++y)
+                {
+                    if (!m_bCullHiddenVoxels || m_pColumnStore->IsExposed(x, y, z))
+                    {
+                        aOutVoxels.push_back(EmittedVoxel{ .uLayer = y, .uBlockType = run.blockType });
+                    }
+                }
+            }
+            uRunBegin += run.uLength;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::countChunk
+
+      Summary:  Counts the instances of every block type in a chunk and
+                computes the bounds of its emitted voxels
+
+      Args:     UINT uChunk
+                  Index of the chunk
+                UINT* auOutCounts
+                  Instance count per block type
+                UINT64& ullOutNumSolidVoxels
+                  Number of solid voxels in the chunk, culled or not
+
+      Modifies: [m_aChunkBoundingBoxes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelBuilder::countChunk(_In_ UINT uChunk, _Out_writes_(m_heightMap.uNumColors) UINT* auOutCounts, _Out_ UINT64& ullOutNumSolidVoxels)
+    {
+        const UINT uBeginX = (uChunk % GetNumChunksX()) * m_uChunkSize;
+        const UINT uBeginZ = (uChunk / GetNumChunksX()) * m_uChunkSize;
+        const UINT uEndX = std::min<UINT>(uBeginX + m_uChunkSize, m_heightMap.uWidth);
+        const UINT uEndZ = std::min<UINT>(uBeginZ + m_uChunkSize, m_heightMap.uDepth);
+
+        UINT uLowestLayer = UINT_MAX;
+        UINT uHighestLayer = 0u;
+        ullOutNumSolidVoxels = 0u;
+        std::vector<VoxelRun> aRuns;
+        std::vector<EmittedVoxel> aEmittedVoxels;
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                WORD height = getColumnHeight(x, z);
+                if (height == 0u)
+                {
+                    continue;
+                }
+
+                if (!isSingleRunNeighbourhood(x, z))
+                {
+                    getEmittedVoxels(x, z, aRuns, aEmittedVoxels);
+                    for (const EmittedVoxel& emittedVoxel : aEmittedVoxels)
+                    {
+                        ++auOutCounts[emittedVoxel.uBlockType];
+                        uLowestLayer = std::min<UINT>(uLowestLayer, emittedVoxel.uLayer);
+                    }
+                    for (const VoxelRun& run : aRuns)
+                    {
+                        ullOutNumSolidVoxels += run.blockType < m_heightMap.uNumColors ? run.uLength : 0u;
+                    }
+                    uHighestLayer = std::max<UINT>(uHighestLayer, height);
+                    continue;
+                }
+
+                UINT uFirstLayer = getFirstEmittedLayer(x, z);
+                auOutCounts[getColumnBlockType(x, z)] += height - uFirstLayer;
+                ullOutNumSolidVoxels += height;
+                uLowestLayer = std::min<UINT>(uLowestLayer, uFirstLayer);
+                uHighestLayer = std::max<UINT>(uHighestLayer, height);
+            }
+        }
+
+        if (uLowestLayer > uHighestLayer)
+        {
+            m_aChunkBoundingBoxes[uChunk] = BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+            return;
+        }
+
+        // Voxel (x, y, z) is a 2-unit cube centered on its translation
+        XMFLOAT3 minCorner(
+            2.0f * static_cast<FLOAT>(uBeginX) - static_cast<FLOAT>(m_heightMap.uWidth) - 1.0f,
+            2.0f * (static_cast<FLOAT>(uLowestLayer) - static_cast<FLOAT>(m_heightMap.uHeight)) + (static_cast<FLOAT>(m_heightMap.uHeight) * 0.75f) - 1.0f,
+            2.0f * static_cast<FLOAT>(uBeginZ) - static_cast<FLOAT>(m_heightMap.uDepth) - 1.0f
+        );
+        XMFLOAT3 maxCorner(
+            2.0f * static_cast<FLOAT>(uEndX) - static_cast<FLOAT>(m_heightMap.uWidth) - 1.0f,
+            2.0f * (static_cast<FLOAT>(uHighestLayer) - static_cast<FLOAT>(m_heightMap.uHeight)) + (static_cast<FLOAT>(m_heightMap.uHeight) * 0.75f) - 1.0f,
+            2.0f * static_cast<FLOAT>(uEndZ) - static_cast<FLOAT>(m_heightMap.uDepth) - 1.0f
+        );
+        BoundingBox::CreateFromPoints(m_aChunkBoundingBoxes[uChunk], XMLoadFloat3(&minCorner), XMLoadFloat3(&maxCorner));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelBuilder::emitChunk
+
+      Summary:  Writes the instances of a chunk at the cursors of their
+                block types, row by row
+
+      Args:     UINT uChunk
+                  Index of the chunk
+                UINT* auInOutCursors
+                  Next index per block type, advanced past the written
+                  instances
+                PackedVoxelInstance* pInstances
+                  Buffer the cursors index into
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelBuilder::emitChunk(_In_ UINT uChunk, _Inout_updates_(m_heightMap.uNumColors) UINT* auInOutCursors, _Out_ PackedVoxelInstance* pInstances) const
+    {
+        const UINT uBeginX = (uChunk % GetNumChunksX()) * m_uChunkSize;
+        const UINT uBeginZ = (uChunk / GetNumChunksX()) * m_uChunkSize;
+        const UINT uEndX = std::min<UINT>(uBeginX + m_uChunkSize, m_heightMap.uWidth);
+        const UINT uEndZ = std::min<UINT>(uBeginZ + m_uChunkSize, m_heightMap.uDepth);
+
+        std::vector<VoxelRun> aRuns;
+        std::vector<EmittedVoxel> aEmittedVoxels;
+        for (UINT z = uBeginZ; z < uEndZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uEndX; ++x)
+            {
+                WORD height = getColumnHeight(x, z);
+                if (height == 0u)
+                {
+                    continue;
+                }
+
+                if (!isSingleRunNeighbourhood(x, z))
+                {
+                    getEmittedVoxels(x, z, aRuns, aEmittedVoxels);
+                    for (const EmittedVoxel& emittedVoxel : aEmittedVoxels)
+                    {
+                        pInstances[auInOutCursors[emittedVoxel.uBlockType]++] = VoxelInstancePacker::Pack(x - uBeginX, emittedVoxel.uLayer, z - uBeginZ, emittedVoxel.uBlockType);
+                    }
+                    continue;
+                }
+
+                const UINT uBlockType = getColumnBlockType(x, z);
+                UINT& uCursor = auInOutCursors[uBlockType];
+                for (UINT y = getFirstEmittedLayer(x, z); y < height; ++y)
+                {
+                    pInstances[uCursor++] = VoxelInstancePacker::Pack(x - uBeginX, y, z - uBeginZ, uBlockType);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*+===================================================================
+  File:      VOXELBUILDER.H
+
+  Summary:   VoxelBuilder header file contains declarations of the
+             VoxelBuilder class that turns height map columns into
+             voxel instance data for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: VoxelBuilder
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Scene/HeightMap.h"
+#include "Scene/VoxelColumnStore.h"
+#include "Scene/VoxelInstancePacker.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelInstanceRange
+
+      Summary:  Range of instances of one block type of one chunk
+                inside the shared instance arena
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelInstanceRange
+    {
+        UINT uFirstInstance;
+        UINT uNumInstances;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelBuildStatistics
+
+      Summary:  Number of solid voxels in the height map, the number of
+                instances emitted for them and the number of buried
+                voxels culled
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelBuildStatistics
+    {
+        UINT64 ullNumSolidVoxels;
+        UINT64 ullNumInstances;
+        UINT64 ullNumCulledVoxels;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelChunkData
+
+      Summary:  Packed instances of a single chunk built on its own,
+                with the range of every block type inside them, the
+                world space bounds and the origin of the chunk
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelChunkData
+    {
+        UINT uChunk;
+        std::shared_ptr<std::vector<PackedVoxelInstance>> pInstances;
+        std::vector<VoxelInstanceRange> aInstanceRanges;
+        BoundingBox boundingBox;
+        XMFLOAT3 origin;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelBuilder
+
+      Summary:  Builds the voxel instances of a height map or a column
+                store in two passes over square chunks of columns. The first pass
+                counts the instances of every block type per chunk, the
+                second one writes them in parallel into a single arena
+                allocated at its exact size, grouped by chunk and then
+                by block type. Instances are packed relative to the
+                origin of their chunk. With hidden voxel culling, only
+                the voxels with a face exposed to air are emitted.
+                Columns of a column store that are one run from the
+                floor, next to columns that are too, take the same path
+                as height map columns; the others are walked run by run
+
+      Methods:  Build
+                  Counts and emits the instances
+                BuildChunk
+                  Counts and emits the instances of one chunk into
+                  their own buffer
+                GetInstanceArena
+                  Returns the arena all voxel chunks share
+                GetInstanceRange
+                  Returns the range of a block type of a chunk in the
+                  arena
+                GetChunkBoundingBox
+                  Returns the world space bounds of a chunk
+                GetChunkOrigin
+                  Returns the world position of a chunk's grid origin
+                GetNumBlockTypes
+                  Returns the number of block types
+                GetChunkSize
+                  Returns the number of columns along a chunk side
+                GetNumChunksX
+                  Returns the number of chunks along x
+                GetNumChunksZ
+                  Returns the number of chunks along z
+                GetStatistics
+                  Returns the statistics of the last build
+                VoxelBuilder
+                  Constructor.
+                ~VoxelBuilder
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelBuilder final
+    {
+    public:
+        static constexpr const UINT DEFAULT_CHUNK_SIZE = 32u;
+
+        VoxelBuilder(_In_ const HeightMapDesc& heightMap, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize);
+        VoxelBuilder(_In_ const VoxelColumnStore& columnStore, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize);
+        VoxelBuilder(const VoxelBuilder& other) = delete;
+        VoxelBuilder(VoxelBuilder&& other) = delete;
+        VoxelBuilder& operator=(const VoxelBuilder& other) = delete;
+        VoxelBuilder& operator=(VoxelBuilder&& other) = delete;
+        ~VoxelBuilder() = default;
+
+        void Build();
+        void BuildChunk(_In_ UINT uChunk, _Out_ VoxelChunkData& outChunk);
+
+        const std::shared_ptr<std::vector<PackedVoxelInstance>>& GetInstanceArena() const;
+        const VoxelInstanceRange& GetInstanceRange(_In_ UINT uChunk, _In_ UINT uBlockType) const;
+        const BoundingBox& GetChunkBoundingBox(_In_ UINT uChunk) const;
+        XMFLOAT3 GetChunkOrigin(_In_ UINT uChunk) const;
+        UINT GetNumBlockTypes() const;
+        UINT GetChunkSize() const;
+        UINT GetNumChunksX() const;
+        UINT GetNumChunksZ() const;
+        const VoxelBuildStatistics& GetStatistics() const;
+
+    private:
+        struct EmittedVoxel
+        {
+            UINT uLayer;
+            UINT uBlockType;
+        };
+
+        UINT getFirstEmittedLayer(_In_ UINT x, _In_ UINT z) const;
+        WORD getColumnHeight(_In_ UINT x, _In_ UINT z) const;
+        UINT getColumnBlockType(_In_ UINT x, _In_ UINT z) const;
+        BOOL isSingleRunNeighbourhood(_In_ UINT x, _In_ UINT z) const;
+        void getEmittedVoxels(_In_ UINT x, _In_ UINT z, _Inout_ std::vector<VoxelRun>& aRuns, _Out_ std::vector<EmittedVoxel>& aOutVoxels) const;
+
+        void countChunk(_In_ UINT uChunk, _Out_writes_(m_heightMap.uNumColors) UINT* auOutCounts, _Out_ UINT64& ullOutNumSolidVoxels);
+        void emitChunk(_In_ UINT uChunk, _Inout_updates_(m_heightMap.uNumColors) UINT* auInOutCursors, _Out_ PackedVoxelInstance* pInstances) const;
+
+    private:
+        HeightMapDesc m_heightMap;
+        const VoxelColumnStore* m_pColumnStore;
+        BOOL m_bCullHiddenVoxels;
+        UINT m_uChunkSize;
+        std::shared_ptr<std::vector<PackedVoxelInstance>> m_pInstanceArena;
+        std::vector<VoxelInstanceRange> m_aInstanceRanges;
+        std::vector<BoundingBox> m_aChunkBoundingBoxes;
+        VoxelBuildStatistics m_statistics;
+    };
+}
@@ -0,0 +1,433 @@
+#include "Scene/VoxelChunk.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::VoxelChunk
+
+      Summary:  Constructor
+
+      Args:     const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstanceArena
+                  Shared instance arena
+                UINT uFirstInstance
+                  Index of the first instance of the chunk in the arena
+                UINT uNumInstances
+                  Number of instances of the chunk
+                std::vector<VoxelInstanceRange>&& aInstanceRanges
+                  Range of every voxel object, relative to the first
+                  instance of the chunk
+                const BoundingBox& boundingBox
+                  World space bounds of the chunk
+                const XMFLOAT3& origin
+                  World position the packed instances are relative to
+                FLOAT voxelScale
+                  Size of the voxels of the chunk in base voxels, more
+                  than 1 for downsampled levels of detail
+
+      Modifies: [m_instanceBuffer, m_lightBuffer, m_constantBuffer,
+                 m_pInstanceArena, m_uFirstInstance, m_uNumInstances,
+                 m_uCapacity, m_aLights, m_uLightCapacity,
+                 m_aInstanceRanges, m_boundingBox, m_origin,
+                 m_voxelScale].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunk::VoxelChunk(
+        _In_ const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstanceArena,
+        _In_ UINT uFirstInstance,
+        _In_ UINT uNumInstances,
+        _In_ std::vector<VoxelInstanceRange>&& aInstanceRanges,
+        _In_ const BoundingBox& boundingBox,
+        _In_ const XMFLOAT3& origin,
+        _In_ FLOAT voxelScale
+    )
+        : m_instanceBuffer(nullptr)
+        , m_lightBuffer(nullptr)
+        , m_constantBuffer(nullptr)
+        , m_pInstanceArena(pInstanceArena)
+        , m_uFirstInstance(uFirstInstance)
+        , m_uNumInstances(uNumInstances)
+        , m_uCapacity(uNumInstances)
+        , m_aLights()
+        , m_uLightCapacity(0u)
+        , m_aInstanceRanges(std::move(aInstanceRanges))
+        , m_boundingBox(boundingBox)
+        , m_origin(origin)
+        , m_voxelScale(voxelScale)
+    {
+        assert(static_cast<size_t>(uFirstInstance) + uNumInstances <= pInstanceArena->size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::Initialize
+
+      Summary:  Creates the instance buffer of the chunk and the
+                constant buffer holding its origin and voxel scale
+
+      Args:     ID3D11Device* pDevice
+                  Pointer to a Direct3D 11 device
+
+      Modifies: [m_instanceBuffer, m_constantBuffer, m_uCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunk::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        m_uCapacity = m_uNumInstances;
+
+        D3D11_BUFFER_DESC bd =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(PackedVoxelInstance)) * m_uCapacity,
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0
+        };
+        D3D11_SUBRESOURCE_DATA initData =
+        {
+            .pSysMem = m_pInstanceArena->data() + m_uFirstInstance
+        };
+
+        HRESULT hr = pDevice->CreateBuffer(&bd, &initData, m_instanceBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        CBVoxelChunk cbVoxelChunk =
+        {
+            .ChunkOrigin = XMFLOAT4(m_origin.x, m_origin.y, m_origin.z, m_voxelScale)
+        };
+        bd =
+        {
+            .ByteWidth = sizeof(CBVoxelChunk),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0
+        };
+        initData =
+        {
+            .pSysMem = &cbVoxelChunk
+        };
+
+        return pDevice->CreateBuffer(&bd, &initData, m_constantBuffer.GetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::UpdateInstances
+
+      Summary:  Replaces the instances of an initialized chunk with a
+                rebuilt set. The old and new instances are compared and
+                only the range between the first and the last that
+                differ is uploaded. If the new instances do not fit in
+                the buffer, it is created again with a quarter more
+                room, so a chunk that keeps growing is not reallocated
+                on every edit
+
+      Args:     ID3D11Device* pDevice
+                  Pointer to a Direct3D 11 device
+                ID3D11DeviceContext* pImmediateContext
+                  Context the upload is recorded on
+                const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstances
+                  Rebuilt instances of the chunk, relative to the same
+                  origin
+                std::vector<VoxelInstanceRange>&& aInstanceRanges
+                  Range of every voxel object inside the instances
+                const BoundingBox& boundingBox
+                  World space bounds of the rebuilt chunk
+                UINT& uOutNumUploadedInstances
+                  Number of instances written to the buffer
+
+      Modifies: [m_instanceBuffer, m_pInstanceArena, m_uFirstInstance,
+                 m_uNumInstances, m_uCapacity, m_aInstanceRanges,
+                 m_boundingBox].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunk::UpdateInstances(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstances,
+        _In_ std::vector<VoxelInstanceRange>&& aInstanceRanges,
+        _In_ const BoundingBox& boundingBox,
+        _Out_ UINT& uOutNumUploadedInstances
+    )
+    {
+        uOutNumUploadedInstances = 0u;
+
+        const PackedVoxelInstance* pOldInstances = m_pInstanceArena->data() + m_uFirstInstance;
+        const PackedVoxelInstance* pNewInstances = pInstances->data();
+        const UINT uNumNewInstances = static_cast<UINT>(pInstances->size());
+
+        UINT uBeginUpload = 0u;
+        UINT uEndUpload = uNumNewInstances;
+        if (uNumNewInstances > m_uCapacity)
+        {
+            const UINT uCapacity = uNumNewInstances + uNumNewInstances / 4u;
+            D3D11_BUFFER_DESC bd =
+            {
+                .ByteWidth = static_cast<UINT>(sizeof(PackedVoxelInstance)) * uCapacity,
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                .CPUAccessFlags = 0
+            };
+
+            ComPtr<ID3D11Buffer> instanceBuffer;
+            HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, instanceBuffer.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            m_instanceBuffer = instanceBuffer;
+            m_uCapacity = uCapacity;
+        }
+        else
+        {
+            // Instances are grouped by block type, so an edit changes
+            // a single stretch from the edited voxel to where the later
+            // groups stop shifting
+            const UINT uNumCommon = std::min<UINT>(m_uNumInstances, uNumNewInstances);
+            while (uBeginUpload < uNumCommon && pOldInstances[uBeginUpload].Packed == pNewInstances[uBeginUpload].Packed)
+            {
+                ++uBeginUpload;
+            }
+            if (uNumNewInstances <= m_uNumInstances)
+            {
+                while (uEndUpload > uBeginUpload && pOldInstances[uEndUpload - 1u].Packed == pNewInstances[uEndUpload - 1u].Packed)
+                {
+                    --uEndUpload;
+                }
+            }
+        }
+
+        if (uEndUpload > uBeginUpload)
+        {
+            const D3D11_BOX box =
+            {
+                .left = uBeginUpload * static_cast<UINT>(sizeof(PackedVoxelInstance)),
+                .top = 0u,
+                .front = 0u,
+                .right = uEndUpload * static_cast<UINT>(sizeof(PackedVoxelInstance)),
+                .bottom = 1u,
+                .back = 1u,
+            };
+            pImmediateContext->UpdateSubresource(m_instanceBuffer.Get(), 0u, &box, pNewInstances + uBeginUpload, 0u, 0u);
+            uOutNumUploadedInstances = uEndUpload - uBeginUpload;
+        }
+
+        m_pInstanceArena = pInstances;
+        m_uFirstInstance = 0u;
+        m_uNumInstances = uNumNewInstances;
+        m_aInstanceRanges = std::move(aInstanceRanges);
+        m_boundingBox = boundingBox;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::UpdateLights
+
+      Summary:  Replaces the light baked for the instances of the chunk,
+                one entry per instance in the same order. Only the range
+                between the first and the last entry that differ is
+                uploaded, and the buffer grows with a quarter more room
+                when the entries no longer fit
+
+      Args:     ID3D11Device* pDevice
+                  Pointer to a Direct3D 11 device
+                ID3D11DeviceContext* pImmediateContext
+                  Context the upload is recorded on
+                std::vector<PackedVoxelLight>&& aLights
+                  Light of every instance of the chunk
+                UINT& uOutNumUploadedLights
+                  Number of entries written to the buffer
+
+      Modifies: [m_lightBuffer, m_aLights, m_uLightCapacity].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunk::UpdateLights(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ std::vector<PackedVoxelLight>&& aLights,
+        _Out_ UINT& uOutNumUploadedLights
+    )
+    {
+        uOutNumUploadedLights = 0u;
+
+        const UINT uNumLights = static_cast<UINT>(aLights.size());
+        if (uNumLights == 0u)
+        {
+            m_aLights.clear();
+            return S_OK;
+        }
+
+        UINT uBeginUpload = 0u;
+        UINT uEndUpload = uNumLights;
+        if (uNumLights > m_uLightCapacity)
+        {
+            const UINT uCapacity = uNumLights + uNumLights / 4u;
+            D3D11_BUFFER_DESC bd =
+            {
+                .ByteWidth = static_cast<UINT>(sizeof(PackedVoxelLight)) * uCapacity,
+                .Usage = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+                .CPUAccessFlags = 0
+            };
+
+            ComPtr<ID3D11Buffer> lightBuffer;
+            HRESULT hr = pDevice->CreateBuffer(&bd, nullptr, lightBuffer.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            m_lightBuffer = lightBuffer;
+            m_uLightCapacity = uCapacity;
+        }
+        else
+        {
+            const UINT uNumCommon = std::min<UINT>(static_cast<UINT>(m_aLights.size()), uNumLights);
+            while (uBeginUpload < uNumCommon
+                && m_aLights[uBeginUpload].Packed.x == aLights[uBeginUpload].Packed.x && m_aLights[uBeginUpload].Packed.y == aLights[uBeginUpload].Packed.y)
+            {
+                ++uBeginUpload;
+            }
+            if (uNumLights <= m_aLights.size())
+            {
+                while (uEndUpload > uBeginUpload
+                    && m_aLights[uEndUpload - 1u].Packed.x == aLights[uEndUpload - 1u].Packed.x && m_aLights[uEndUpload - 1u].Packed.y == aLights[uEndUpload - 1u].Packed.y)
+                {
+                    --uEndUpload;
+                }
+            }
+        }
+
+        if (uEndUpload > uBeginUpload)
+        {
+            const D3D11_BOX box =
+            {
+                .left = uBeginUpload * static_cast<UINT>(sizeof(PackedVoxelLight)),
+                .top = 0u,
+                .front = 0u,
+                .right = uEndUpload * static_cast<UINT>(sizeof(PackedVoxelLight)),
+                .bottom = 1u,
+                .back = 1u,
+            };
+            pImmediateContext->UpdateSubresource(m_lightBuffer.Get(), 0u, &box, aLights.data() + uBeginUpload, 0u, 0u);
+            uOutNumUploadedLights = uEndUpload - uBeginUpload;
+        }
+
+        m_aLights = std::move(aLights);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetInstanceBuffer
+
+      Summary:  Returns the instance buffer
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Instance buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& VoxelChunk::GetInstanceBuffer()
+    {
+        return m_instanceBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetLightBuffer
+
+      Summary:  Returns the buffer of the light baked for the faces of
+                every instance. Null until the chunk is baked, such as
+                for the coarser levels of detail
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Light buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& VoxelChunk::GetLightBuffer()
+    {
+        return m_lightBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetConstantBuffer
+
+      Summary:  Returns the constant buffer holding the origin of the
+                chunk and the scale of its voxels
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& VoxelChunk::GetConstantBuffer()
+    {
+        return m_constantBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetBoundingBox
+
+      Summary:  Returns the world space bounds of the chunk
+
+      Returns:  const BoundingBox&
+                  Axis-aligned bounding box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingBox& VoxelChunk::GetBoundingBox() const
+    {
+        return m_boundingBox;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetInstanceRange
+
+      Summary:  Returns the range of a voxel object in the instance
+                buffer of the chunk. Voxel objects added to the scene
+                after the map was loaded have no instances in chunks
+
+      Args:     UINT uVoxelIndex
+                  Index of the voxel object in the scene
+
+      Returns:  VoxelInstanceRange
+                  Range of the voxel object
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelInstanceRange VoxelChunk::GetInstanceRange(_In_ UINT uVoxelIndex) const
+    {
+        if (uVoxelIndex >= m_aInstanceRanges.size())
+        {
+            return VoxelInstanceRange{ .uFirstInstance = 0u, .uNumInstances = 0u };
+        }
+
+        return m_aInstanceRanges[uVoxelIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetInstances
+
+      Summary:  Returns the instances of the chunk, in the order of the
+                instance buffer
+
+      Returns:  const PackedVoxelInstance*
+                  First instance of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const PackedVoxelInstance* VoxelChunk::GetInstances() const
+    {
+        return m_pInstanceArena->data() + m_uFirstInstance;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunk::GetNumInstances
+
+      Summary:  Returns the number of instances of the chunk
+
+      Returns:  UINT
+                  Number of instances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunk::GetNumInstances() const
+    {
+        return m_uNumInstances;
+    }
+}
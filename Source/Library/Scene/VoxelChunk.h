@@ -0,0 +1,134 @@
+/*+===================================================================
+  File:      VOXELCHUNK.H
+
+  Summary:   VoxelChunk header file contains declarations of VoxelChunk
+             class that holds the instances of one chunk of the voxel
+             map for the lab samples of Game Graphics Programming
+             course.
+
+  Classes: VoxelChunk
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Scene/VoxelBuilder.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelCullingStatistics
+
+      Summary:  Number of voxel chunks and instances, and how many of
+                them intersect the view frustum
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelCullingStatistics
+    {
+        UINT uNumChunks;
+        UINT uNumVisibleChunks;
+        UINT64 ullNumInstances;
+        UINT64 ullNumVisibleInstances;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelChunk
+
+      Summary:  Packed instances of one chunk of columns in their own
+                instance buffer, with the range of every voxel object
+                inside it, the world space bounds of the chunk and a
+                constant buffer holding its origin and the scale of its
+                voxels. After an edit the chunk uploads only the
+                instances that changed, and the buffer only grows, with
+                headroom, when they no longer fit. A chunk of the full
+                resolution may also hold the light baked for the faces
+                of every instance, in a second buffer updated the same
+                way
+
+      Methods:  Initialize
+                  Creates the instance and constant buffers
+                UpdateInstances
+                  Replaces the instances and uploads the changed range
+                UpdateLights
+                  Replaces the baked light and uploads the changed
+                  range
+                GetInstanceBuffer
+                  Returns the instance buffer
+                GetLightBuffer
+                  Returns the baked light buffer, null until baked
+                GetConstantBuffer
+                  Returns the constant buffer holding the origin and
+                  the voxel scale
+                GetBoundingBox
+                  Returns the world space bounds
+                GetInstanceRange
+                  Returns the range of a voxel object in the buffer
+                GetInstances
+                  Returns the instances
+                GetNumInstances
+                  Returns the number of instances
+                VoxelChunk
+                  Constructor.
+                ~VoxelChunk
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelChunk final
+    {
+    public:
+        VoxelChunk(
+            _In_ const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstanceArena,
+            _In_ UINT uFirstInstance,
+            _In_ UINT uNumInstances,
+            _In_ std::vector<VoxelInstanceRange>&& aInstanceRanges,
+            _In_ const BoundingBox& boundingBox,
+            _In_ const XMFLOAT3& origin,
+            _In_ FLOAT voxelScale
+        );
+        VoxelChunk(const VoxelChunk& other) = delete;
+        VoxelChunk(VoxelChunk&& other) = delete;
+        VoxelChunk& operator=(const VoxelChunk& other) = delete;
+        VoxelChunk& operator=(VoxelChunk&& other) = delete;
+        ~VoxelChunk() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        HRESULT UpdateInstances(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::shared_ptr<std::vector<PackedVoxelInstance>>& pInstances,
+            _In_ std::vector<VoxelInstanceRange>&& aInstanceRanges,
+            _In_ const BoundingBox& boundingBox,
+            _Out_ UINT& uOutNumUploadedInstances
+        );
+        HRESULT UpdateLights(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ std::vector<PackedVoxelLight>&& aLights,
+            _Out_ UINT& uOutNumUploadedLights
+        );
+
+        ComPtr<ID3D11Buffer>& GetInstanceBuffer();
+        ComPtr<ID3D11Buffer>& GetLightBuffer();
+        ComPtr<ID3D11Buffer>& GetConstantBuffer();
+        const BoundingBox& GetBoundingBox() const;
+        VoxelInstanceRange GetInstanceRange(_In_ UINT uVoxelIndex) const;
+        const PackedVoxelInstance* GetInstances() const;
+        UINT GetNumInstances() const;
+
+    private:
+        ComPtr<ID3D11Buffer> m_instanceBuffer;
+        ComPtr<ID3D11Buffer> m_lightBuffer;
+        ComPtr<ID3D11Buffer> m_constantBuffer;
+        std::shared_ptr<std::vector<PackedVoxelInstance>> m_pInstanceArena;
+        UINT m_uFirstInstance;
+        UINT m_uNumInstances;
+        UINT m_uCapacity;
+        std::vector<PackedVoxelLight> m_aLights;
+        UINT m_uLightCapacity;
+        std::vector<VoxelInstanceRange> m_aInstanceRanges;
+        BoundingBox m_boundingBox;
+        XMFLOAT3 m_origin;
+        FLOAT m_voxelScale;
+    };
+}
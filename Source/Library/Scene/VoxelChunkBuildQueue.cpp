@@ -0,0 +1,133 @@
+#include "Scene/VoxelChunkBuildQueue.h"
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::VoxelChunkBuildQueue
+
+      Summary:  Constructor
+
+      Args:     VoxelBuilder& voxelBuilder
+                  Builder of the chunks. The builder must outlive the
+                  queue
+
+      Modifies: [m_voxelBuilder, m_mutex, m_buildFinished,
+                 m_finishedChunks, m_uNumPendingBuilds, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunkBuildQueue::VoxelChunkBuildQueue(_In_ VoxelBuilder& voxelBuilder)
+        : m_voxelBuilder(voxelBuilder)
+        , m_mutex()
+        , m_buildFinished()
+        , m_finishedChunks()
+        , m_uNumPendingBuilds(0u)
+        , m_bStopping(FALSE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::~VoxelChunkBuildQueue
+
+      Summary:  Destructor. Lets the scheduled builds return early and
+                waits for them, since they refer to the queue
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunkBuildQueue::~VoxelChunkBuildQueue()
+    {
+        m_bStopping = TRUE;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_buildFinished.wait(lock, [this] { return m_uNumPendingBuilds == 0u; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::Enqueue
+
+      Summary:  Schedules the build of a chunk on the thread pool
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+
+      Modifies: [m_uNumPendingBuilds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunkBuildQueue::Enqueue(_In_ UINT uChunk)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_uNumPendingBuilds;
+        }
+        ThreadPool::GetDefault().Enqueue([this, uChunk]() { buildChunk(uChunk); });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::PopFinishedChunk
+
+      Summary:  Takes the oldest finished chunk, in the order the builds
+                finished
+
+      Args:     VoxelChunkData& outChunkData
+                  Receives the chunk
+
+      Modifies: [m_finishedChunks].
+
+      Returns:  BOOL
+                  FALSE if no chunk is finished
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelChunkBuildQueue::PopFinishedChunk(_Out_ VoxelChunkData& outChunkData)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_finishedChunks.empty())
+        {
+            return FALSE;
+        }
+
+        outChunkData = std::move(m_finishedChunks.front());
+        m_finishedChunks.pop_front();
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::GetNumPendingBuilds
+
+      Summary:  Returns the number of scheduled builds that did not
+                finish yet. It only decreases until Enqueue is called
+                again
+
+      Returns:  UINT
+                  Number of pending builds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunkBuildQueue::GetNumPendingBuilds() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_uNumPendingBuilds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkBuildQueue::buildChunk
+
+      Summary:  Builds a chunk on a worker thread and queues it for the
+                main thread. Skips the work when the queue is stopping
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * GetNumChunksX() + x
+
+      Modifies: [m_finishedChunks, m_uNumPendingBuilds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunkBuildQueue::buildChunk(_In_ UINT uChunk)
+    {
+        VoxelChunkData chunkData;
+        if (!m_bStopping)
+        {
+            m_voxelBuilder.BuildChunk(uChunk, chunkData);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bStopping)
+        {
+            m_finishedChunks.push_back(std::move(chunkData));
+        }
+        --m_uNumPendingBuilds;
+        m_buildFinished.notify_all();
+    }
+}
@@ -0,0 +1,73 @@
+/*+===================================================================
+  File:      VOXELCHUNKBUILDQUEUE.H
+
+  Summary:   VoxelChunkBuildQueue header file contains declarations of
+             the VoxelChunkBuildQueue class that builds voxel chunks
+             on the thread pool and hands them back to the main thread
+             for the lab samples of Game Graphics Programming course.
+
+  Classes: VoxelChunkBuildQueue
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "Scene/VoxelBuilder.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelChunkBuildQueue
+
+      Summary:  Builds chunks with a voxel builder on the thread pool
+                and keeps the finished ones until the thread that owns
+                the device takes them. The builder must outlive the
+                queue
+
+      Methods:  Enqueue
+                  Schedules the build of a chunk
+                PopFinishedChunk
+                  Takes the oldest finished chunk
+                GetNumPendingBuilds
+                  Returns the number of builds not finished yet
+                VoxelChunkBuildQueue
+                  Constructor.
+                ~VoxelChunkBuildQueue
+                  Destructor. Waits for the scheduled builds
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelChunkBuildQueue final
+    {
+    public:
+        VoxelChunkBuildQueue() = delete;
+        explicit VoxelChunkBuildQueue(_In_ VoxelBuilder& voxelBuilder);
+        VoxelChunkBuildQueue(const VoxelChunkBuildQueue& other) = delete;
+        VoxelChunkBuildQueue(VoxelChunkBuildQueue&& other) = delete;
+        VoxelChunkBuildQueue& operator=(const VoxelChunkBuildQueue& other) = delete;
+        VoxelChunkBuildQueue& operator=(VoxelChunkBuildQueue&& other) = delete;
+        ~VoxelChunkBuildQueue();
+
+        void Enqueue(_In_ UINT uChunk);
+        BOOL PopFinishedChunk(_Out_ VoxelChunkData& outChunkData);
+
+        UINT GetNumPendingBuilds() const;
+
+    private:
+        void buildChunk(_In_ UINT uChunk);
+
+    private:
+        VoxelBuilder& m_voxelBuilder;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_buildFinished;
+        std::deque<VoxelChunkData> m_finishedChunks;
+        UINT m_uNumPendingBuilds;
+        std::atomic<BOOL> m_bStopping;
+    };
+}
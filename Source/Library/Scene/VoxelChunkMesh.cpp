@@ -0,0 +1,144 @@
+#include "Scene/VoxelChunkMesh.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::VoxelChunkMesh
+
+      Summary:  Constructor. Places the mesh at the origin of its chunk
+
+      Args:     VoxelChunkMeshData&& meshData
+                  Merged quads of the chunk
+                const XMFLOAT3* pPalette
+                  Color of every block type
+
+      Modifies: [m_meshData, m_aMeshColors, m_world].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelChunkMesh::VoxelChunkMesh(_In_ VoxelChunkMeshData&& meshData, _In_ const XMFLOAT3* pPalette)
+        : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
+        , m_meshData(std::move(meshData))
+        , m_aMeshColors()
+    {
+        m_aMeshColors.reserve(m_meshData.aSections.size());
+        for (const VoxelChunkMeshSection& section : m_meshData.aSections)
+        {
+            const XMFLOAT3& color = pPalette[section.uBlockType];
+            m_aMeshColors.push_back(XMFLOAT4(color.x, color.y, color.z, 1.0f));
+        }
+
+        Translate(XMLoadFloat3(&m_meshData.origin));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::Initialize
+
+      Summary:  Creates the buffers of the chunk and one mesh entry per
+                block type
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+
+      Modifies: [m_aMeshes].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelChunkMesh::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        for (const VoxelChunkMeshSection& section : m_meshData.aSections)
+        {
+            BasicMeshEntry basicMeshEntry;
+            basicMeshEntry.uNumIndices = section.uNumIndices;
+            basicMeshEntry.uBaseIndex = section.uBaseIndex;
+
+            m_aMeshes.push_back(basicMeshEntry);
+        }
+
+        return initialize(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::Update
+
+      Summary:  Updates the chunk mesh every frame
+
+      Args:     FLOAT deltaTime
+                  Elapsed time
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelChunkMesh::Update(_In_ FLOAT deltaTime)
+    {
+        UNREFERENCED_PARAMETER(deltaTime);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::GetMeshColor
+
+      Summary:  Returns the color of the block type a mesh is made of
+
+      Args:     UINT uMeshIndex
+                  Index of the mesh
+
+      Returns:  const XMFLOAT4&
+                  Color of the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& VoxelChunkMesh::GetMeshColor(_In_ UINT uMeshIndex) const
+    {
+        assert(uMeshIndex < m_aMeshColors.size());
+
+        return m_aMeshColors[uMeshIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::GetNumVertices
+
+      Summary:  Returns the number of vertices in the chunk mesh
+
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunkMesh::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_meshData.aVertices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::GetNumIndices
+
+      Summary:  Returns the number of indices in the chunk mesh
+
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelChunkMesh::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_meshData.aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::getVertices
+
+      Summary:  Returns the pointer to the vertices data
+
+      Returns:  const library::SimpleVertex*
+                  Pointer to the vertices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* VoxelChunkMesh::getVertices() const
+    {
+        return m_meshData.aVertices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelChunkMesh::getIndices
+
+      Summary:  Returns the pointer to the indices data
+
+      Returns:  const WORD*
+                  Pointer to the indices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const WORD* VoxelChunkMesh::getIndices() const
+    {
+        return m_meshData.aIndices.data();
+    }
+}
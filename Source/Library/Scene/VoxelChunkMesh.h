@@ -0,0 +1,61 @@
+/*+===================================================================
+  File:      VOXELCHUNKMESH.H
+
+  Summary:   VoxelChunkMesh header file contains declarations of
+             VoxelChunkMesh class used for the lab samples of Game
+             Graphics Programming course.
+
+  Classes: VoxelChunkMesh
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Scene/VoxelMesher.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelChunkMesh
+
+      Summary:  Static greedy mesh of one voxel chunk. Every block type
+                of the chunk is a mesh drawn with its own color
+
+      Methods:  GetMeshColor
+                  Returns the color of a mesh
+                VoxelChunkMesh
+                  Constructor.
+                ~VoxelChunkMesh
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelChunkMesh : public Renderable
+    {
+    public:
+        VoxelChunkMesh(_In_ VoxelChunkMeshData&& meshData, _In_ const XMFLOAT3* pPalette);
+        VoxelChunkMesh(const VoxelChunkMesh& other) = delete;
+        VoxelChunkMesh(VoxelChunkMesh&& other) = delete;
+        VoxelChunkMesh& operator=(const VoxelChunkMesh& other) = delete;
+        VoxelChunkMesh& operator=(VoxelChunkMesh&& other) = delete;
+        ~VoxelChunkMesh() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        virtual void Update(_In_ FLOAT deltaTime) override;
+
+        const XMFLOAT4& GetMeshColor(_In_ UINT uMeshIndex) const;
+
+        UINT GetNumVertices() const override;
+        UINT GetNumIndices() const override;
+
+    protected:
+        const SimpleVertex* getVertices() const override;
+        const WORD* getIndices() const override;
+
+    private:
+        VoxelChunkMeshData m_meshData;
+        std::vector<XMFLOAT4> m_aMeshColors;
+    };
+}
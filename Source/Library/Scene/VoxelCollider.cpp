@@ -0,0 +1,482 @@
+#include "Scene/VoxelCollider.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::VoxelCollider
+
+      Summary:  Constructor. Voxel (x, y, z) is drawn as a cube of edge
+                two centered at (2x - W, 2y - 1.25H, 2z - D), so it
+                fills the grid cell [x, x + 1) of half of the world
+                position moved by the offset, as in VoxelRaycaster
+
+      Args:     const VoxelColumnStore& columnStore
+                  Voxels to collide with
+
+      Modifies: [m_columnStore, m_gridOffset, m_aiGridSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelCollider::VoxelCollider(_In_ const VoxelColumnStore& columnStore)
+        : m_columnStore(columnStore)
+        , m_gridOffset(
+            static_cast<FLOAT>(columnStore.GetWidth()) + 1.0f,
+            static_cast<FLOAT>(columnStore.GetHeight()) * 1.25f + 1.0f,
+            static_cast<FLOAT>(columnStore.GetDepth()) + 1.0f
+        )
+        , m_aiGridSize{ static_cast<INT>(columnStore.GetWidth()), static_cast<INT>(columnStore.GetHeight()), static_cast<INT>(columnStore.GetDepth()) }
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::Overlaps
+
+      Summary:  Returns whether a world space box overlaps a solid
+                voxel. Touching a face does not count
+
+      Args:     const BoundingBox& box
+                  World space box
+
+      Returns:  BOOL
+                  TRUE if a solid voxel lies inside the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelCollider::Overlaps(_In_ const BoundingBox& box) const
+    {
+        return overlaps(toGrid(box));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::Sweep
+
+      Summary:  Moves a world space box by a displacement as far as the
+                voxels let it. The vertical part of the move goes first
+                so a box falling onto a slope lands before it slides,
+                then the two horizontal parts; every part stops at the
+                first solid layer of cells in its way and the rest of
+                the move continues along the other axes. A box that
+                starts inside solid voxels is pushed out first, or
+                moves freely if it is deeper than MAX_PUSH_CELLS
+
+      Args:     const BoundingBox& box
+                  World space box at the start of the move
+                const XMFLOAT3& displacement
+                  World space move of the box
+                VoxelSweepResult& outResult
+                  Where the box came to rest and what stopped it
+
+      Modifies: [outResult].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelCollider::Sweep(_In_ const BoundingBox& box, _In_ const XMFLOAT3& displacement, _Out_ VoxelSweepResult& outResult) const
+    {
+        outResult = VoxelSweepResult
+        {
+            .center = box.Center,
+            .displacement = XMFLOAT3(0.0f, 0.0f, 0.0f),
+            .contactNormal = XMINT3(0, 0, 0),
+            .bOnGround = FALSE,
+            .bStuck = FALSE,
+        };
+
+        const FLOAT afDisplacement[3] = { displacement.x * 0.5f, displacement.y * 0.5f, displacement.z * 0.5f };
+        GridBox gridBox = toGrid(box);
+        INT aiNormal[3] = { 0, 0, 0 };
+
+        if (overlaps(gridBox) && !pushOut(gridBox))
+        {
+            // Too deep to push out, such as a camera flying inside the
+            // terrain, so let it move until it leaves
+            outResult.center = XMFLOAT3(box.Center.x + displacement.x, box.Center.y + displacement.y, box.Center.z + displacement.z);
+            outResult.displacement = displacement;
+            outResult.bStuck = TRUE;
+            return;
+        }
+
+        constexpr const UINT auAxes[3] = { 1u, 0u, 2u };
+        for (UINT uAxis : auAxes)
+        {
+            if (afDisplacement[uAxis] == 0.0f)
+            {
+                continue;
+            }
+
+            const FLOAT moved = sweepAxis(gridBox, uAxis, afDisplacement[uAxis]);
+            gridBox.afMin[uAxis] += moved;
+            gridBox.afMax[uAxis] += moved;
+            if (moved != afDisplacement[uAxis])
+            {
+                aiNormal[uAxis] = afDisplacement[uAxis] > 0.0f ? -1 : 1;
+            }
+        }
+
+        outResult.center = XMFLOAT3(
+            gridBox.afMin[0] + gridBox.afMax[0] - m_gridOffset.x,
+            gridBox.afMin[1] + gridBox.afMax[1] - m_gridOffset.y,
+            gridBox.afMin[2] + gridBox.afMax[2] - m_gridOffset.z
+        );
+        outResult.displacement = XMFLOAT3(outResult.center.x - box.Center.x, outResult.center.y - box.Center.y, outResult.center.z - box.Center.z);
+        outResult.contactNormal = XMINT3(aiNormal[0], aiNormal[1], aiNormal[2]);
+        outResult.bOnGround = aiNormal[1] > 0;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::SweepBatch
+
+      Summary:  Moves many world space boxes across the worker threads.
+                Boxes do not collide with each other
+
+      Args:     const VoxelSweep* pSweeps
+                  Boxes and their displacements
+                size_t uNumSweeps
+                  Number of boxes
+                VoxelSweepResult* pOutResults
+                  Where every box came to rest
+
+      Modifies: [pOutResults].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelCollider::SweepBatch(_In_reads_(uNumSweeps) const VoxelSweep* pSweeps, _In_ size_t uNumSweeps, _Out_writes_(uNumSweeps) VoxelSweepResult* pOutResults) const
+    {
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        size_t uBatchSize = std::max<size_t>(uNumSweeps / ((threadPool.GetNumThreads() + 1u) * 4u), 16u);
+
+        threadPool.ParallelFor(0u, uNumSweeps, uBatchSize, [this, pSweeps, pOutResults](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uSweep = uBegin; uSweep < uEnd; ++uSweep)
+            {
+                Sweep(pSweeps[uSweep].box, pSweeps[uSweep].displacement, pOutResults[uSweep]);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::MeasureThroughput
+
+      Summary:  Sweeps boxes the size of a person, scattered around a
+                point, in random directions one after another and as
+                one batch, and logs the time of both
+
+      Args:     const XMFLOAT3& origin
+                  World space point the boxes are scattered around
+                UINT uNumSweeps
+                  Number of boxes
+                FLOAT distance
+                  Length of every move in world units
+
+      Returns:  VoxelCollisionStatistics
+                  Time per box, time of the batch and number of boxes
+                  stopped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelCollisionStatistics VoxelCollider::MeasureThroughput(_In_ const XMFLOAT3& origin, _In_ UINT uNumSweeps, _In_ FLOAT distance) const
+    {
+        std::vector<VoxelSweep> aSweeps;
+        aSweeps.reserve(uNumSweeps);
+
+        std::mt19937 generator(0u);
+        std::uniform_real_distribution<FLOAT> scatter(-64.0f, 64.0f);
+        std::normal_distribution<FLOAT> distribution(0.0f, 1.0f);
+        for (UINT uSweep = 0u; uSweep < uNumSweeps; ++uSweep)
+        {
+            XMFLOAT3 direction(distribution(generator), distribution(generator), distribution(generator));
+            const FLOAT length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+            const FLOAT scale = length == 0.0f ? 0.0f : distance / length;
+            aSweeps.push_back(VoxelSweep
+            {
+                .box = BoundingBox(XMFLOAT3(origin.x + scatter(generator), origin.y + scatter(generator) * 0.25f, origin.z + scatter(generator)), XMFLOAT3(0.6f, 1.8f, 0.6f)),
+                .displacement = XMFLOAT3(direction.x * scale, direction.y * scale, direction.z * scale),
+            });
+        }
+
+        std::vector<VoxelSweepResult> aSingleResults(uNumSweeps);
+        std::vector<VoxelSweepResult> aBatchResults(uNumSweeps);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uSweep = 0u; uSweep < uNumSweeps; ++uSweep)
+        {
+            Sweep(aSweeps[uSweep].box, aSweeps[uSweep].displacement, aSingleResults[uSweep]);
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE singleSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        QueryPerformanceCounter(&startingTime);
+        SweepBatch(aSweeps.data(), aSweeps.size(), aBatchResults.data());
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE batchSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        UINT uNumBlocked = 0u;
+        UINT uNumMismatches = 0u;
+        for (UINT uSweep = 0u; uSweep < uNumSweeps; ++uSweep)
+        {
+            const VoxelSweepResult& singleResult = aSingleResults[uSweep];
+            const VoxelSweepResult& batchResult = aBatchResults[uSweep];
+            if (singleResult.contactNormal.x != 0 || singleResult.contactNormal.y != 0 || singleResult.contactNormal.z != 0)
+            {
+                ++uNumBlocked;
+            }
+            if (singleResult.center.x != batchResult.center.x || singleResult.center.y != batchResult.center.y || singleResult.center.z != batchResult.center.z)
+            {
+                ++uNumMismatches;
+            }
+        }
+
+        VoxelCollisionStatistics statistics =
+        {
+            .uNumSweeps = uNumSweeps,
+            .uNumBlocked = uNumBlocked,
+            .singleSweepMicroseconds = uNumSweeps == 0u ? 0.0 : singleSeconds * 1.0e6 / static_cast<DOUBLE>(uNumSweeps),
+            .batchMilliseconds = batchSeconds * 1.0e3,
+        };
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "VoxelCollider: %u sweep(s) of %.0f unit(s), %u stopped, %.2f us per sweep, batch %.3f ms%s\n",
+            statistics.uNumSweeps,
+            distance,
+            statistics.uNumBlocked,
+            statistics.singleSweepMicroseconds,
+            statistics.batchMilliseconds,
+            uNumMismatches == 0u ? "" : ", batch DIFFERS"
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::toGrid
+
+      Summary:  Returns the corners of a world space box in grid units,
+                where voxel (x, y, z) fills [x, x + 1) on every axis
+
+      Args:     const BoundingBox& box
+                  World space box
+
+      Returns:  GridBox
+                  Grid space box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelCollider::GridBox VoxelCollider::toGrid(_In_ const BoundingBox& box) const
+    {
+        return GridBox
+        {
+            .afMin =
+            {
+                (box.Center.x - box.Extents.x + m_gridOffset.x) * 0.5f,
+                (box.Center.y - box.Extents.y + m_gridOffset.y) * 0.5f,
+                (box.Center.z - box.Extents.z + m_gridOffset.z) * 0.5f,
+            },
+            .afMax =
+            {
+                (box.Center.x + box.Extents.x + m_gridOffset.x) * 0.5f,
+                (box.Center.y + box.Extents.y + m_gridOffset.y) * 0.5f,
+                (box.Center.z + box.Extents.z + m_gridOffset.z) * 0.5f,
+            },
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::overlaps
+
+      Summary:  Returns whether a grid space box overlaps a solid voxel.
+                Columns whose top is below the box are skipped whole
+
+      Args:     const GridBox& box
+                  Grid space box
+
+      Returns:  BOOL
+                  TRUE if a solid voxel lies inside the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelCollider::overlaps(_In_ const GridBox& box) const
+    {
+        INT aiFirst[3];
+        INT aiLast[3];
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            aiFirst[uAxis] = std::max<INT>(static_cast<INT>(std::floor(box.afMin[uAxis] + SKIN)), 0);
+            aiLast[uAxis] = std::min<INT>(static_cast<INT>(std::floor(box.afMax[uAxis] - SKIN)), m_aiGridSize[uAxis] - 1);
+            if (aiFirst[uAxis] > aiLast[uAxis])
+            {
+                return FALSE;
+            }
+        }
+
+        for (INT z = aiFirst[2]; z <= aiLast[2]; ++z)
+        {
+            for (INT x = aiFirst[0]; x <= aiLast[0]; ++x)
+            {
+                const INT iTop = std::min<INT>(aiLast[1], static_cast<INT>(m_columnStore.GetColumnHeight(static_cast<UINT>(x), static_cast<UINT>(z))) - 1);
+                for (INT y = aiFirst[1]; y <= iTop; ++y)
+                {
+                    if (m_columnStore.IsSolid(x, y, z))
+                    {
+                        return TRUE;
+                    }
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::isLayerSolid
+
+      Summary:  Returns whether a layer of cells on an axis holds a
+                solid voxel under the cross section of a box
+
+      Args:     const GridBox& box
+                  Grid space box whose cross section is tested
+                UINT uAxis
+                  Axis the layer is perpendicular to
+                INT iLayer
+                  Cell coordinate of the layer on the axis
+
+      Returns:  BOOL
+                  TRUE if a solid voxel lies in the layer under the box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelCollider::isLayerSolid(_In_ const GridBox& box, _In_ UINT uAxis, _In_ INT iLayer) const
+    {
+        const UINT uAxisU = (uAxis + 1u) % 3u;
+        const UINT uAxisV = (uAxis + 2u) % 3u;
+        const INT iFirstU = std::max<INT>(static_cast<INT>(std::floor(box.afMin[uAxisU] + SKIN)), 0);
+        const INT iLastU = std::min<INT>(static_cast<INT>(std::floor(box.afMax[uAxisU] - SKIN)), m_aiGridSize[uAxisU] - 1);
+        const INT iFirstV = std::max<INT>(static_cast<INT>(std::floor(box.afMin[uAxisV] + SKIN)), 0);
+        const INT iLastV = std::min<INT>(static_cast<INT>(std::floor(box.afMax[uAxisV] - SKIN)), m_aiGridSize[uAxisV] - 1);
+
+        INT aiCell[3];
+        aiCell[uAxis] = iLayer;
+        for (INT v = iFirstV; v <= iLastV; ++v)
+        {
+            aiCell[uAxisV] = v;
+            for (INT u = iFirstU; u <= iLastU; ++u)
+            {
+                aiCell[uAxisU] = u;
+                if (m_columnStore.IsSolid(aiCell[0], aiCell[1], aiCell[2]))
+                {
+                    return TRUE;
+                }
+            }
+        }
+
+        return FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::sweepAxis
+
+      Summary:  Returns how far a box that overlaps no solid voxel can
+                move along one axis. Every layer of cells the leading
+                face crosses is tested in order, and the move stops
+                against the first solid one. Layers outside the store
+                are air and are not visited
+
+      Args:     const GridBox& box
+                  Grid space box
+                UINT uAxis
+                  Axis of the move
+                FLOAT displacement
+                  Move along the axis in grid units
+
+      Returns:  FLOAT
+                  Move the box can make, between zero and displacement
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT VoxelCollider::sweepAxis(_In_ const GridBox& box, _In_ UINT uAxis, _In_ FLOAT displacement) const
+    {
+        if (displacement > 0.0f)
+        {
+            const INT iFirst = std::max<INT>(static_cast<INT>(std::floor(box.afMax[uAxis] - SKIN)) + 1, 0);
+            const INT iLast = std::min<INT>(static_cast<INT>(std::floor(box.afMax[uAxis] + displacement - SKIN)), m_aiGridSize[uAxis] - 1);
+            for (INT iLayer = iFirst; iLayer <= iLast; ++iLayer)
+            {
+                if (isLayerSolid(box, uAxis, iLayer))
+                {
+                    return std::max<FLOAT>(static_cast<FLOAT>(iLayer) - box.afMax[uAxis], 0.0f);
+                }
+            }
+        }
+        else
+        {
+            const INT iFirst = std::min<INT>(static_cast<INT>(std::floor(box.afMin[uAxis] + SKIN)) - 1, m_aiGridSize[uAxis] - 1);
+            const INT iLast = std::max<INT>(static_cast<INT>(std::floor(box.afMin[uAxis] + displacement + SKIN)), 0);
+            for (INT iLayer = iFirst; iLayer >= iLast; --iLayer)
+            {
+                if (isLayerSolid(box, uAxis, iLayer))
+                {
+                    return std::min<FLOAT>(static_cast<FLOAT>(iLayer + 1) - box.afMin[uAxis], 0.0f);
+                }
+            }
+        }
+
+        return displacement;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelCollider::pushOut
+
+      Summary:  Moves a box that overlaps solid voxels out of them. The
+                box is tried with one of its faces moved onto each of
+                the next MAX_PUSH_CELLS cell boundaries in each of the
+                six axis directions, and takes the shortest move that
+                clears it. Up comes first, so a tie lifts the box onto
+                the voxel it is in
+
+      Args:     GridBox& box
+                  Grid space box, moved if a push clears it
+
+      Modifies: [box].
+
+      Returns:  BOOL
+                  TRUE if the box no longer overlaps a solid voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelCollider::pushOut(_Inout_ GridBox& box) const
+    {
+        constexpr const UINT auAxes[3] = { 1u, 0u, 2u };
+
+        BOOL bFound = FALSE;
+        UINT uBestAxis = 0u;
+        FLOAT bestShift = 0.0f;
+        for (UINT uAxis : auAxes)
+        {
+            for (UINT uCell = 1u; uCell <= MAX_PUSH_CELLS; ++uCell)
+            {
+                const FLOAT afShifts[2] =
+                {
+                    std::floor(box.afMin[uAxis]) + static_cast<FLOAT>(uCell) - box.afMin[uAxis],
+                    std::ceil(box.afMax[uAxis]) - static_cast<FLOAT>(uCell) - box.afMax[uAxis],
+                };
+                for (FLOAT shift : afShifts)
+                {
+                    if (bFound && std::abs(shift) >= std::abs(bestShift))
+                    {
+                        continue;
+                    }
+
+                    GridBox shiftedBox = box;
+                    shiftedBox.afMin[uAxis] += shift;
+                    shiftedBox.afMax[uAxis] += shift;
+                    if (!overlaps(shiftedBox))
+                    {
+                        bFound = TRUE;
+                        uBestAxis = uAxis;
+                        bestShift = shift;
+                    }
+                }
+            }
+        }
+
+        if (bFound)
+        {
+            box.afMin[uBestAxis] += bestShift;
+            box.afMax[uBestAxis] += bestShift;
+        }
+
+        return bFound;
+    }
+}
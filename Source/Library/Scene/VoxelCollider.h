@@ -0,0 +1,136 @@
+/*+===================================================================
+  File:      VOXELCOLLIDER.H
+
+  Summary:   VoxelCollider header file contains declarations of the
+             VoxelCollider class that moves boxes through the voxels
+             of a terrain without letting them pass into solid voxels
+             for the lab samples of Game Graphics Programming course.
+
+  Classes: VoxelCollider
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/VoxelColumnStore.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelSweep
+
+      Summary:  World space box of a batch and the displacement it
+                tries to move by in the frame
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelSweep
+    {
+        BoundingBox box;
+        XMFLOAT3 displacement;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelSweepResult
+
+      Summary:  World space center a box came to rest at and how far it
+                actually moved. Every axis it was stopped on has the
+                normal of the face it hit, zero otherwise. bOnGround is
+                TRUE if it was stopped moving down, bStuck if it
+                started too deep inside solid voxels to be pushed out
+                and moved freely
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelSweepResult
+    {
+        XMFLOAT3 center;
+        XMFLOAT3 displacement;
+        XMINT3 contactNormal;
+        BOOL bOnGround;
+        BOOL bStuck;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelCollisionStatistics
+
+      Summary:  Time of sweeping a set of boxes one after another and as
+                one batch, and how many of them were stopped
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelCollisionStatistics
+    {
+        UINT uNumSweeps;
+        UINT uNumBlocked;
+        DOUBLE singleSweepMicroseconds;
+        DOUBLE batchMilliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelCollider
+
+      Summary:  Moves world space axis-aligned boxes through the grid
+                the voxels of a column store are drawn on. A move is
+                split into one sweep per axis, vertical first, and each
+                sweep visits every layer of cells between the start and
+                the end of the box on that axis, so a fast box cannot
+                tunnel through a thin wall and slides along what stops
+                it. A box that starts inside solid voxels, such as
+                after a block was placed on it, is first pushed out
+                along the shortest of the six axis directions. Voxels
+                outside the store are air. Nothing is allocated per
+                sweep, so batches of thousands of boxes run across the
+                worker threads. The store must outlive the collider and
+                is not edited while boxes are swept
+
+      Methods:  Overlaps
+                  Returns whether a box overlaps a solid voxel
+                Sweep
+                  Moves a box as far as the voxels let it
+                SweepBatch
+                  Moves many boxes across the worker threads
+                MeasureThroughput
+                  Times boxes swept around a point in random directions
+                VoxelCollider
+                  Constructor.
+                ~VoxelCollider
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelCollider final
+    {
+    public:
+        static constexpr const UINT MAX_PUSH_CELLS = 2u;
+
+        VoxelCollider() = delete;
+        VoxelCollider(_In_ const VoxelColumnStore& columnStore);
+        VoxelCollider(const VoxelCollider& other) = delete;
+        VoxelCollider(VoxelCollider&& other) = delete;
+        VoxelCollider& operator=(const VoxelCollider& other) = delete;
+        VoxelCollider& operator=(VoxelCollider&& other) = delete;
+        ~VoxelCollider() = default;
+
+        BOOL Overlaps(_In_ const BoundingBox& box) const;
+        void Sweep(_In_ const BoundingBox& box, _In_ const XMFLOAT3& displacement, _Out_ VoxelSweepResult& outResult) const;
+        void SweepBatch(_In_reads_(uNumSweeps) const VoxelSweep* pSweeps, _In_ size_t uNumSweeps, _Out_writes_(uNumSweeps) VoxelSweepResult* pOutResults) const;
+
+        VoxelCollisionStatistics MeasureThroughput(_In_ const XMFLOAT3& origin, _In_ UINT uNumSweeps, _In_ FLOAT distance) const;
+
+    private:
+        // Boxes touching a face of a solid voxel do not overlap it
+        static constexpr const FLOAT SKIN = 1.0e-4f;
+
+        struct GridBox
+        {
+            FLOAT afMin[3];
+            FLOAT afMax[3];
+        };
+
+        GridBox toGrid(_In_ const BoundingBox& box) const;
+        BOOL overlaps(_In_ const GridBox& box) const;
+        BOOL isLayerSolid(_In_ const GridBox& box, _In_ UINT uAxis, _In_ INT iLayer) const;
+        FLOAT sweepAxis(_In_ const GridBox& box, _In_ UINT uAxis, _In_ FLOAT displacement) const;
+        BOOL pushOut(_Inout_ GridBox& box) const;
+
+    private:
+        const VoxelColumnStore& m_columnStore;
+        XMFLOAT3 m_gridOffset;
+        INT m_aiGridSize[3];
+    };
+}
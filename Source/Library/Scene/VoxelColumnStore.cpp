@@ -0,0 +1,716 @@
+#include "Scene/VoxelColumnStore.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "Scene/VoxelInstancePacker.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::VoxelColumnStore
+
+      Summary:  Constructor of an empty store
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aColumns, m_multiRunColumns].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelColumnStore::VoxelColumnStore()
+        : m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_aPalette()
+        , m_aColumns()
+        , m_multiRunColumns()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::Create
+
+      Summary:  Fills the store from the columns of a height map, every
+                column becoming a single run. Columns whose block type
+                is not in the palette become empty
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aColumns, m_multiRunColumns].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the palette collides
+                  with the reserved block types
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelColumnStore::Create(_In_ const HeightMapDesc& heightMap)
+    {
+        if (heightMap.uNumColors > MULTI_RUN_COLUMN)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_uWidth = heightMap.uWidth;
+        m_uHeight = heightMap.uHeight;
+        m_uDepth = heightMap.uDepth;
+        m_aPalette.assign(heightMap.pPalette, heightMap.pPalette + heightMap.uNumColors);
+        m_multiRunColumns.clear();
+
+        const size_t uNumColumns = static_cast<size_t>(m_uWidth) * m_uDepth;
+        m_aColumns.resize(uNumColumns);
+        for (size_t uColumn = 0u; uColumn < uNumColumns; ++uColumn)
+        {
+            const BOOL bInPalette = heightMap.pBlockTypes[uColumn] < heightMap.uNumColors;
+            m_aColumns[uColumn] = VoxelRun
+            {
+                .blockType = bInPalette ? heightMap.pBlockTypes[uColumn] : EMPTY_BLOCK,
+                .reserved = 0u,
+                .uLength = bInPalette ? heightMap.pColumnHeights[uColumn] : static_cast<WORD>(0u),
+            };
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::Load
+
+      Summary:  Reads the store from a binary column store file. The
+                file is rejected unless the columns fit in it, no column
+                is taller than the map or the layers the instance
+                packer can address, every block type is in the palette
+                or empty, and the runs of every multi-run column stack
+                up exactly to its top
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_aPalette,
+                 m_aColumns, m_multiRunColumns].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelColumnStore::Load(_In_ const std::filesystem::path& filePath)
+    {
+        std::ifstream inputFile(filePath, std::ios::binary);
+        if (!inputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        VoxelColumnStoreFileHeader header;
+        inputFile.read(reinterpret_cast<CHAR*>(&header), sizeof(header));
+        if (inputFile.fail())
+        {
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+        if (header.dwMagic != MAGIC || header.uNumColors > MULTI_RUN_COLUMN)
+        {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+        if (header.dwVersion != VERSION)
+        {
+            return HRESULT_FROM_WIN32(ERROR_REVISION_MISMATCH);
+        }
+        if (header.uHeight > VoxelInstancePacker::MAX_NUM_LAYERS)
+        {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        // The palette and the columns must fit in the file before
+        // anything is allocated for them
+        std::error_code errorCode;
+        const UINT64 ullFileSize = static_cast<UINT64>(std::filesystem::file_size(filePath, errorCode));
+        const UINT64 ullNumColumns = static_cast<UINT64>(header.uWidth) * static_cast<UINT64>(header.uDepth);
+        const UINT64 ullPaletteSize = sizeof(XMFLOAT3) * static_cast<UINT64>(header.uNumColors);
+        if (errorCode
+            || ullFileSize < sizeof(header) + ullPaletteSize
+            || ullNumColumns > (ullFileSize - sizeof(header) - ullPaletteSize) / sizeof(VoxelRun))
+        {
+            return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+        }
+
+        std::vector<XMFLOAT3> aPalette(header.uNumColors);
+        std::vector<VoxelRun> aColumns(static_cast<size_t>(ullNumColumns));
+        inputFile.read(reinterpret_cast<CHAR*>(aPalette.data()), static_cast<std::streamsize>(sizeof(XMFLOAT3) * aPalette.size()));
+        inputFile.read(reinterpret_cast<CHAR*>(aColumns.data()), static_cast<std::streamsize>(sizeof(VoxelRun) * aColumns.size()));
+
+        std::unordered_map<UINT, std::vector<VoxelRun>> multiRunColumns;
+        multiRunColumns.reserve(header.uNumMultiRunColumns);
+        for (UINT uMultiRunColumn = 0u; uMultiRunColumn < header.uNumMultiRunColumns && !inputFile.fail(); ++uMultiRunColumn)
+        {
+            UINT auColumnAndNumRuns[2];
+            inputFile.read(reinterpret_cast<CHAR*>(auColumnAndNumRuns), sizeof(auColumnAndNumRuns));
+            if (inputFile.fail()
+                || auColumnAndNumRuns[0] >= aColumns.size()
+                || aColumns[auColumnAndNumRuns[0]].blockType != MULTI_RUN_COLUMN
+                || auColumnAndNumRuns[1] > aColumns[auColumnAndNumRuns[0]].uLength
+                || multiRunColumns.contains(auColumnAndNumRuns[0]))
+            {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+
+            std::vector<VoxelRun>& aRuns = multiRunColumns[auColumnAndNumRuns[0]];
+            aRuns.resize(auColumnAndNumRuns[1]);
+            inputFile.read(reinterpret_cast<CHAR*>(aRuns.data()), static_cast<std::streamsize>(sizeof(VoxelRun) * aRuns.size()));
+        }
+
+        if (inputFile.fail())
+        {
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        // Every column must fit in the map and a single run must be
+        // in the palette or empty. Every column marked as multi-run
+        // must come with runs that reach its top
+        for (size_t uColumn = 0u; uColumn < aColumns.size(); ++uColumn)
+        {
+            if (aColumns[uColumn].uLength > header.uHeight)
+            {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+            if (aColumns[uColumn].blockType != MULTI_RUN_COLUMN)
+            {
+                if (aColumns[uColumn].blockType >= header.uNumColors && aColumns[uColumn].blockType != EMPTY_BLOCK)
+                {
+                    return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+                }
+                continue;
+            }
+
+            auto it = multiRunColumns.find(static_cast<UINT>(uColumn));
+            if (it == multiRunColumns.end())
+            {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+
+            UINT uTop = 0u;
+            for (const VoxelRun& run : it->second)
+            {
+                if (run.blockType >= header.uNumColors && run.blockType != EMPTY_BLOCK)
+                {
+                    return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+                }
+                uTop += run.uLength;
+            }
+            if (uTop != aColumns[uColumn].uLength)
+            {
+                return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            }
+        }
+
+        m_uWidth = header.uWidth;
+        m_uHeight = header.uHeight;
+        m_uDepth = header.uDepth;
+        m_aPalette = std::move(aPalette);
+        m_aColumns = std::move(aColumns);
+        m_multiRunColumns = std::move(multiRunColumns);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::Save
+
+      Summary:  Writes the store to a binary column store file, the
+                multi-run columns in column order
+
+      Args:     const std::filesystem::path& filePath
+                  Path to the file
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelColumnStore::Save(_In_ const std::filesystem::path& filePath) const
+    {
+        std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            return E_FAIL;
+        }
+
+        VoxelColumnStoreFileHeader header =
+        {
+            .dwMagic = MAGIC,
+            .dwVersion = VERSION,
+            .uWidth = m_uWidth,
+            .uHeight = m_uHeight,
+            .uDepth = m_uDepth,
+            .uNumColors = static_cast<UINT>(m_aPalette.size()),
+            .uNumMultiRunColumns = static_cast<UINT>(m_multiRunColumns.size()),
+        };
+
+        outputFile.write(reinterpret_cast<const CHAR*>(&header), sizeof(header));
+        outputFile.write(reinterpret_cast<const CHAR*>(m_aPalette.data()), static_cast<std::streamsize>(sizeof(XMFLOAT3) * m_aPalette.size()));
+        outputFile.write(reinterpret_cast<const CHAR*>(m_aColumns.data()), static_cast<std::streamsize>(sizeof(VoxelRun) * m_aColumns.size()));
+
+        std::vector<UINT> auMultiRunColumns;
+        auMultiRunColumns.reserve(m_multiRunColumns.size());
+        for (const auto& [uColumn, aRuns] : m_multiRunColumns)
+        {
+            auMultiRunColumns.push_back(uColumn);
+        }
+        std::sort(auMultiRunColumns.begin(), auMultiRunColumns.end());
+
+        for (UINT uColumn : auMultiRunColumns)
+        {
+            const std::vector<VoxelRun>& aRuns = m_multiRunColumns.at(uColumn);
+            const UINT auColumnAndNumRuns[2] = { uColumn, static_cast<UINT>(aRuns.size()) };
+            outputFile.write(reinterpret_cast<const CHAR*>(auColumnAndNumRuns), sizeof(auColumnAndNumRuns));
+            outputFile.write(reinterpret_cast<const CHAR*>(aRuns.data()), static_cast<std::streamsize>(sizeof(VoxelRun) * aRuns.size()));
+        }
+
+        if (outputFile.fail())
+        {
+            return E_FAIL;
+        }
+
+        outputFile.close();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::SetBlock
+
+      Summary:  Sets the block type of a voxel by splitting the run that
+                holds it, merging it with equal neighbouring runs and
+                dropping the air on top of the column. A column that
+                ends up as one run from the floor goes back into the
+                column array
+
+      Args:     UINT x
+                  Column of the voxel along the width
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column of the voxel along the depth
+                BYTE blockType
+                  Index of the block type in the palette, EMPTY_BLOCK
+                  to remove the voxel
+
+      Modifies: [m_aColumns, m_multiRunColumns].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the voxel is outside
+                  the volume or the block type is not in the palette
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelColumnStore::SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE blockType)
+    {
+        if (x >= m_uWidth || y >= m_uHeight || z >= m_uDepth || (blockType >= m_aPalette.size() && blockType != EMPTY_BLOCK))
+        {
+            return E_INVALIDARG;
+        }
+
+        const UINT uColumn = z * m_uWidth + x;
+        std::vector<VoxelRun> aRuns;
+        GetRuns(x, z, aRuns);
+
+        const UINT uTop = m_aColumns[uColumn].uLength;
+        if (y >= uTop)
+        {
+            if (blockType == EMPTY_BLOCK)
+            {
+                return S_OK;
+            }
+
+            aRuns.push_back(VoxelRun{ .blockType = EMPTY_BLOCK, .reserved = 0u, .uLength = static_cast<WORD>(y - uTop) });
+            aRuns.push_back(VoxelRun{ .blockType = blockType, .reserved = 0u, .uLength = 1u });
+        }
+        else
+        {
+            UINT uRunBegin = 0u;
+            auto it = aRuns.begin();
+            while (uRunBegin + it->uLength <= y)
+            {
+                uRunBegin += it->uLength;
+                ++it;
+            }
+
+            if (it->blockType == blockType)
+            {
+                return S_OK;
+            }
+
+            const VoxelRun run = *it;
+            const VoxelRun aSplitRuns[3] =
+            {
+                VoxelRun{ .blockType = run.blockType, .reserved = 0u, .uLength = static_cast<WORD>(y - uRunBegin) },
+                VoxelRun{ .blockType = blockType, .reserved = 0u, .uLength = 1u },
+                VoxelRun{ .blockType = run.blockType, .reserved = 0u, .uLength = static_cast<WORD>(uRunBegin + run.uLength - y - 1u) },
+            };
+            it = aRuns.erase(it);
+            aRuns.insert(it, std::begin(aSplitRuns), std::end(aSplitRuns));
+        }
+
+        mergeRuns(aRuns);
+
+        UINT uNewTop = 0u;
+        for (const VoxelRun& run : aRuns)
+        {
+            uNewTop += run.uLength;
+        }
+
+        if (aRuns.size() <= 1u)
+        {
+            m_aColumns[uColumn] = aRuns.empty() ? VoxelRun{ .blockType = EMPTY_BLOCK, .reserved = 0u, .uLength = 0u } : aRuns[0];
+            m_multiRunColumns.erase(uColumn);
+        }
+        else
+        {
+            m_aColumns[uColumn] = VoxelRun{ .blockType = MULTI_RUN_COLUMN, .reserved = 0u, .uLength = static_cast<WORD>(uNewTop) };
+            m_multiRunColumns[uColumn] = std::move(aRuns);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetBlockType
+
+      Summary:  Returns the block type of a voxel
+
+      Args:     UINT x
+                  Column of the voxel along the width
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column of the voxel along the depth
+
+      Returns:  BYTE
+                  Block type, EMPTY_BLOCK for air and voxels outside
+                  the volume
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE VoxelColumnStore::GetBlockType(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        if (x >= m_uWidth || z >= m_uDepth)
+        {
+            return EMPTY_BLOCK;
+        }
+
+        const UINT uColumn = z * m_uWidth + x;
+        const VoxelRun& column = m_aColumns[uColumn];
+        if (y >= column.uLength)
+        {
+            return EMPTY_BLOCK;
+        }
+        if (column.blockType != MULTI_RUN_COLUMN)
+        {
+            return column.blockType;
+        }
+
+        UINT uRunBegin = 0u;
+        for (const VoxelRun& run : m_multiRunColumns.at(uColumn))
+        {
+            uRunBegin += run.uLength;
+            if (y < uRunBegin)
+            {
+                return run.blockType;
+            }
+        }
+
+        return EMPTY_BLOCK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::IsSolid
+
+      Summary:  Returns whether a voxel is solid. Takes signed
+                coordinates so neighbours past the edges can be asked
+                for directly
+
+      Args:     INT x
+                  Column of the voxel along the width
+                INT y
+                  Layer of the voxel
+                INT z
+                  Column of the voxel along the depth
+
+      Returns:  BOOL
+                  TRUE if the voxel holds a block, FALSE for air and
+                  voxels outside the volume
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelColumnStore::IsSolid(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (x < 0 || y < 0 || z < 0)
+        {
+            return FALSE;
+        }
+
+        return GetBlockType(static_cast<UINT>(x), static_cast<UINT>(y), static_cast<UINT>(z)) != EMPTY_BLOCK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::IsExposed
+
+      Summary:  Returns whether a solid voxel has a face exposed to
+                air. Voxels past the edges of the map count as air and
+                the bottom faces of the lowest layer count as covered,
+                as in VoxelBuilder
+
+      Args:     UINT x
+                  Column of the voxel along the width
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column of the voxel along the depth
+
+      Returns:  BOOL
+                  TRUE if the voxel is solid and has an exposed face
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelColumnStore::IsExposed(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        const INT iX = static_cast<INT>(x);
+        const INT iY = static_cast<INT>(y);
+        const INT iZ = static_cast<INT>(z);
+        if (!IsSolid(iX, iY, iZ))
+        {
+            return FALSE;
+        }
+
+        return !IsSolid(iX, iY + 1, iZ)
+            || (iY > 0 && !IsSolid(iX, iY - 1, iZ))
+            || !IsSolid(iX - 1, iY, iZ)
+            || !IsSolid(iX + 1, iY, iZ)
+            || !IsSolid(iX, iY, iZ - 1)
+            || !IsSolid(iX, iY, iZ + 1);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetColumnHeight
+
+      Summary:  Returns the top of the solid layers of a column
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  WORD
+                  Layer above the highest solid voxel, zero for an
+                  empty column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WORD VoxelColumnStore::GetColumnHeight(_In_ UINT x, _In_ UINT z) const
+    {
+        return m_aColumns[static_cast<size_t>(z) * m_uWidth + x].uLength;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetRuns
+
+      Summary:  Returns the runs of a column from the floor up. The last
+                run is always solid
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+                std::vector<VoxelRun>& aOutRuns
+                  Runs of the column, empty for an empty column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelColumnStore::GetRuns(_In_ UINT x, _In_ UINT z, _Out_ std::vector<VoxelRun>& aOutRuns) const
+    {
+        aOutRuns.clear();
+
+        const UINT uColumn = z * m_uWidth + x;
+        const VoxelRun& column = m_aColumns[uColumn];
+        if (column.blockType == MULTI_RUN_COLUMN)
+        {
+            aOutRuns = m_multiRunColumns.at(uColumn);
+        }
+        else if (column.uLength > 0u)
+        {
+            aOutRuns.push_back(column);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::IsSingleRun
+
+      Summary:  Returns whether a column is empty or a single solid run
+                from the floor, like every column of a height map
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  BOOL
+                  TRUE if the column has at most one run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelColumnStore::IsSingleRun(_In_ UINT x, _In_ UINT z) const
+    {
+        return m_aColumns[static_cast<size_t>(z) * m_uWidth + x].blockType != MULTI_RUN_COLUMN;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetSurface
+
+      Summary:  Returns the block type of the top run and the height of
+                every column, the height map the store looks like from
+                above
+
+      Args:     std::vector<BYTE>& aOutBlockTypes
+                  Block type of the top run of every column, zero for
+                  empty columns
+                std::vector<WORD>& aOutColumnHeights
+                  Height of every column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelColumnStore::GetSurface(_Out_ std::vector<BYTE>& aOutBlockTypes, _Out_ std::vector<WORD>& aOutColumnHeights) const
+    {
+        aOutBlockTypes.resize(m_aColumns.size());
+        aOutColumnHeights.resize(m_aColumns.size());
+        for (size_t uColumn = 0u; uColumn < m_aColumns.size(); ++uColumn)
+        {
+            const VoxelRun& column = m_aColumns[uColumn];
+            if (column.uLength == 0u)
+            {
+                aOutBlockTypes[uColumn] = 0u;
+            }
+            else if (column.blockType == MULTI_RUN_COLUMN)
+            {
+                aOutBlockTypes[uColumn] = m_multiRunColumns.at(static_cast<UINT>(uColumn)).back().blockType;
+            }
+            else
+            {
+                aOutBlockTypes[uColumn] = column.blockType;
+            }
+            aOutColumnHeights[uColumn] = column.uLength;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetWidth
+
+      Summary:  Returns the number of columns along x
+
+      Returns:  UINT
+                  Width of the store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelColumnStore::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetHeight
+
+      Summary:  Returns the number of layers
+
+      Returns:  UINT
+                  Height of the store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelColumnStore::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetDepth
+
+      Summary:  Returns the number of columns along z
+
+      Returns:  UINT
+                  Depth of the store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelColumnStore::GetDepth() const
+    {
+        return m_uDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetNumColors
+
+      Summary:  Returns the number of block types
+
+      Returns:  UINT
+                  Number of palette entries
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelColumnStore::GetNumColors() const
+    {
+        return static_cast<UINT>(m_aPalette.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetPalette
+
+      Summary:  Returns the color of every block type
+
+      Returns:  const XMFLOAT3*
+                  Palette, GetNumColors() entries
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT3* VoxelColumnStore::GetPalette() const
+    {
+        return m_aPalette.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetNumMultiRunColumns
+
+      Summary:  Returns the number of columns of more than one run
+
+      Returns:  size_t
+                  Number of columns in the side table
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelColumnStore::GetNumMultiRunColumns() const
+    {
+        return m_multiRunColumns.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::GetMemoryUsage
+
+      Summary:  Returns the bytes taken by the runs, not counting the
+                bookkeeping of the side table
+
+      Returns:  size_t
+                  Size of the column array and the multi-run columns
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelColumnStore::GetMemoryUsage() const
+    {
+        size_t uNumBytes = m_aColumns.size() * sizeof(VoxelRun);
+        for (const auto& [uColumn, aRuns] : m_multiRunColumns)
+        {
+            uNumBytes += sizeof(uColumn) + aRuns.size() * sizeof(VoxelRun);
+        }
+
+        return uNumBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelColumnStore::mergeRuns
+
+      Summary:  Drops empty runs, merges neighbouring runs of the same
+                block type and drops the air on top of the column
+
+      Args:     std::vector<VoxelRun>& aRuns
+                  Runs of a column from the floor up
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelColumnStore::mergeRuns(_Inout_ std::vector<VoxelRun>& aRuns)
+    {
+        size_t uNumMergedRuns = 0u;
+        for (const VoxelRun& run : aRuns)
+        {
+            if (run.uLength == 0u)
+            {
+                continue;
+            }
+
+            if (uNumMergedRuns > 0u && aRuns[uNumMergedRuns - 1u].blockType == run.blockType)
+            {
+                aRuns[uNumMergedRuns - 1u].uLength = static_cast<WORD>(aRuns[uNumMergedRuns - 1u].uLength + run.uLength);
+            }
+            else
+            {
+                aRuns[uNumMergedRuns++] = run;
+            }
+        }
+
+        while (uNumMergedRuns > 0u && aRuns[uNumMergedRuns - 1u].blockType == EMPTY_BLOCK)
+        {
+            --uNumMergedRuns;
+        }
+
+        aRuns.resize(uNumMergedRuns);
+    }
+}
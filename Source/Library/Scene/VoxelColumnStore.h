@@ -0,0 +1,158 @@
+/*+===================================================================
+  File:      VOXELCOLUMNSTORE.H
+
+  Summary:   VoxelColumnStore header file contains declarations of the
+             VoxelColumnStore class that holds the voxels of a terrain
+             as run-length encoded columns for the lab samples of Game
+             Graphics Programming course.
+
+  Classes: VoxelColumnStore
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelRun
+
+      Summary:  Layers of a column of a single block type, EMPTY_BLOCK
+                for air
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRun
+    {
+        BYTE blockType;
+        BYTE reserved;
+        WORD uLength;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelColumnStoreFileHeader
+
+      Summary:  Header of the binary column store file. The palette and
+                the first run of every column follow it, then every
+                column of more than one run as its index, its number of
+                runs and the runs themselves
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelColumnStoreFileHeader
+    {
+        DWORD dwMagic;
+        DWORD dwVersion;
+        UINT uWidth;
+        UINT uHeight;
+        UINT uDepth;
+        UINT uNumColors;
+        UINT uNumMultiRunColumns;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelColumnStore
+
+      Summary:  Canonical in-memory terrain. Every column is a list of
+                runs from the floor up. A column that is a single solid
+                run from the floor, as every column of a height map is,
+                takes one 32-bit run in the column array and nothing
+                else, so a 4096 x 4096 map takes 64 MiB. A column that
+                edits split into more runs keeps the top of its solid
+                layers in the column array and its runs in a side
+                table. Queries, edits and the file format work on the
+                runs without expanding them into voxels
+
+      Methods:  Create
+                  Fills the store from a height map
+                Load
+                  Reads the store from a binary file
+                Save
+                  Writes the store to a binary file
+                SetBlock
+                  Sets the block type of a voxel
+                GetBlockType
+                  Returns the block type of a voxel
+                IsSolid
+                  Returns whether a voxel is solid
+                IsExposed
+                  Returns whether a solid voxel has a face exposed to
+                  air
+                GetColumnHeight
+                  Returns the top of the solid layers of a column
+                GetRuns
+                  Returns the runs of a column
+                IsSingleRun
+                  Returns whether a column is one run from the floor
+                GetSurface
+                  Returns the top block type and height of every
+                  column
+                GetWidth
+                  Returns the number of columns along x
+                GetHeight
+                  Returns the number of layers
+                GetDepth
+                  Returns the number of columns along z
+                GetNumColors
+                  Returns the number of block types
+                GetPalette
+                  Returns the color of every block type
+                GetNumMultiRunColumns
+                  Returns the number of columns of more than one run
+                GetMemoryUsage
+                  Returns the bytes taken by the runs
+                VoxelColumnStore
+                  Constructor.
+                ~VoxelColumnStore
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelColumnStore final
+    {
+    public:
+        static constexpr const DWORD MAGIC = 0x4C4F4356u; // "VCOL"
+        static constexpr const DWORD VERSION = 1u;
+        static constexpr const BYTE EMPTY_BLOCK = 0xFFu;
+
+        VoxelColumnStore();
+        VoxelColumnStore(const VoxelColumnStore& other) = delete;
+        VoxelColumnStore(VoxelColumnStore&& other) = delete;
+        VoxelColumnStore& operator=(const VoxelColumnStore& other) = delete;
+        VoxelColumnStore& operator=(VoxelColumnStore&& other) = delete;
+        ~VoxelColumnStore() = default;
+
+        HRESULT Create(_In_ const HeightMapDesc& heightMap);
+        HRESULT Load(_In_ const std::filesystem::path& filePath);
+        HRESULT Save(_In_ const std::filesystem::path& filePath) const;
+
+        HRESULT SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE blockType);
+
+        BYTE GetBlockType(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        BOOL IsSolid(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        BOOL IsExposed(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        WORD GetColumnHeight(_In_ UINT x, _In_ UINT z) const;
+        void GetRuns(_In_ UINT x, _In_ UINT z, _Out_ std::vector<VoxelRun>& aOutRuns) const;
+        BOOL IsSingleRun(_In_ UINT x, _In_ UINT z) const;
+        void GetSurface(_Out_ std::vector<BYTE>& aOutBlockTypes, _Out_ std::vector<WORD>& aOutColumnHeights) const;
+
+        UINT GetWidth() const;
+        UINT GetHeight() const;
+        UINT GetDepth() const;
+        UINT GetNumColors() const;
+        const XMFLOAT3* GetPalette() const;
+        size_t GetNumMultiRunColumns() const;
+        size_t GetMemoryUsage() const;
+
+    private:
+        static constexpr const BYTE MULTI_RUN_COLUMN = 0xFEu;
+
+        static void mergeRuns(_Inout_ std::vector<VoxelRun>& aRuns);
+
+    private:
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uDepth;
+        std::vector<XMFLOAT3> m_aPalette;
+        std::vector<VoxelRun> m_aColumns;
+        std::unordered_map<UINT, std::vector<VoxelRun>> m_multiRunColumns;
+    };
+}
@@ -0,0 +1,323 @@
+#include "Scene/VoxelEditor.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::VoxelEditor
+
+      Summary:  Constructor
+
+      Args:     VoxelColumnStore& columnStore
+                  Voxels to edit. The store must outlive the editor
+                BOOL bCullHiddenVoxels
+                  Whether voxels without a face exposed to air are
+                  left out of the rebuilt chunks
+                UINT uChunkSize
+                  Number of columns along a chunk side, the same as the
+                  chunks being drawn
+                VoxelLightField* pLightField
+                  Light of the store to update with every edit, or
+                  null. The field must outlive the editor
+
+      Modifies: [m_columnStore, m_voxelBuilder, m_pLightField,
+                 m_abDirtyChunks, m_auDirtyChunks, m_aQueuedEdits,
+                 m_statistics, m_buildQueue].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelEditor::VoxelEditor(_In_ VoxelColumnStore& columnStore, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize, _In_opt_ VoxelLightField* pLightField)
+        : m_columnStore(columnStore)
+        , m_voxelBuilder(columnStore, bCullHiddenVoxels, uChunkSize)
+        , m_pLightField(pLightField)
+        , m_abDirtyChunks(static_cast<size_t>(m_voxelBuilder.GetNumChunksX()) * m_voxelBuilder.GetNumChunksZ(), FALSE)
+        , m_auDirtyChunks()
+        , m_aQueuedEdits()
+        , m_statistics{ .uNumQueuedEdits = 0u, .uNumPendingBuilds = 0u, .uNumUploadedChunks = 0u, .ullNumUploadedInstances = 0u }
+        , m_buildQueue(m_voxelBuilder)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::SetBlock
+
+      Summary:  Sets the block type of a voxel and marks the chunks it
+                touches dirty. While rebuilds are in flight the edit is
+                queued until the next update after they finish
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+                BYTE blockType
+                  Index of the block type in the palette, EMPTY_BLOCK
+                  to remove the voxel
+
+      Modifies: [m_columnStore, m_abDirtyChunks, m_auDirtyChunks,
+                 m_aQueuedEdits, m_statistics].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the voxel is outside the
+                  store or the block type is not in the palette
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelEditor::SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE blockType)
+    {
+        if (x >= m_columnStore.GetWidth() || y >= m_columnStore.GetHeight() || z >= m_columnStore.GetDepth())
+        {
+            return E_INVALIDARG;
+        }
+        if (blockType != VoxelColumnStore::EMPTY_BLOCK && blockType >= m_columnStore.GetNumColors())
+        {
+            return E_INVALIDARG;
+        }
+
+        // Only this thread schedules builds, so none can start before
+        // the edit is applied
+        const VoxelEdit edit = { .x = x, .y = y, .z = z, .blockType = blockType };
+        if (m_buildQueue.GetNumPendingBuilds() > 0u)
+        {
+            m_aQueuedEdits.push_back(edit);
+            m_statistics.uNumQueuedEdits = static_cast<UINT>(m_aQueuedEdits.size());
+            return S_OK;
+        }
+
+        applyEdit(edit);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::Update
+
+      Summary:  Once the rebuilds in flight finished, applies the edits
+                queued meanwhile and schedules a rebuild of every dirty
+                chunk on the thread pool. Called once per frame on the
+                thread that edits
+
+      Modifies: [m_columnStore, m_abDirtyChunks, m_auDirtyChunks,
+                 m_aQueuedEdits, m_statistics, m_buildQueue].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelEditor::Update()
+    {
+        m_statistics.uNumPendingBuilds = m_buildQueue.GetNumPendingBuilds();
+        if (m_statistics.uNumPendingBuilds > 0u)
+        {
+            return;
+        }
+
+        for (const VoxelEdit& edit : m_aQueuedEdits)
+        {
+            applyEdit(edit);
+        }
+        m_aQueuedEdits.clear();
+        m_statistics.uNumQueuedEdits = 0u;
+
+        if (m_auDirtyChunks.empty())
+        {
+            return;
+        }
+
+        for (UINT uChunk : m_auDirtyChunks)
+        {
+            m_abDirtyChunks[uChunk] = FALSE;
+            m_buildQueue.Enqueue(uChunk);
+        }
+        m_statistics.uNumPendingBuilds += static_cast<UINT>(m_auDirtyChunks.size());
+        m_auDirtyChunks.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::UploadFinishedChunks
+
+      Summary:  Hands every rebuilt chunk to the full resolution level
+                of its chunk in the selector. An existing chunk uploads
+                only its changed instances; a chunk that was empty
+                before the edit is created. The coarser levels no
+                longer match the chunk, so it is drawn at every level.
+                Block types double as voxel indices. Called on the
+                thread that owns the device. Uploaded chunks are marked
+                for baking in the light field, since their instances
+                moved
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to upload the instances
+                VoxelLodSelector& lodSelector
+                  Levels of detail of the chunks, in chunk order
+                BOOL& bOutChunksChanged
+                  TRUE if a chunk was created or replaced one of its
+                  coarser levels, so the chunks to draw must be
+                  collected again
+
+      Modifies: [m_pLightField, m_statistics, m_buildQueue].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelEditor::UploadFinishedChunks(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _Inout_ VoxelLodSelector& lodSelector, _Out_ BOOL& bOutChunksChanged)
+    {
+        bOutChunksChanged = FALSE;
+        m_statistics.uNumUploadedChunks = 0u;
+        m_statistics.ullNumUploadedInstances = 0u;
+
+        for (;;)
+        {
+            VoxelChunkData chunkData;
+            if (!m_buildQueue.PopFinishedChunk(chunkData))
+            {
+                break;
+            }
+
+            const UINT uNumInstances = static_cast<UINT>(chunkData.pInstances->size());
+            std::shared_ptr<VoxelChunk> voxelChunk = lodSelector.GetChunk(chunkData.uChunk, 0u);
+            if (voxelChunk)
+            {
+                // The first edit of a chunk replaces its coarser levels
+                if (voxelChunk != lodSelector.GetChunk(chunkData.uChunk, VoxelLodSelector::NUM_LODS - 1u))
+                {
+                    bOutChunksChanged = TRUE;
+                }
+
+                UINT uNumUploadedInstances = 0u;
+                HRESULT hr = voxelChunk->UpdateInstances(
+                    pDevice,
+                    pImmediateContext,
+                    chunkData.pInstances,
+                    std::move(chunkData.aInstanceRanges),
+                    chunkData.boundingBox,
+                    uNumUploadedInstances
+                );
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                m_statistics.ullNumUploadedInstances += uNumUploadedInstances;
+            }
+            else
+            {
+                if (uNumInstances == 0u)
+                {
+                    continue;
+                }
+
+                voxelChunk = std::make_shared<VoxelChunk>(
+                    chunkData.pInstances,
+                    0u,
+                    uNumInstances,
+                    std::move(chunkData.aInstanceRanges),
+                    chunkData.boundingBox,
+                    chunkData.origin,
+                    1.0f
+                );
+
+                HRESULT hr = voxelChunk->Initialize(pDevice);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                m_statistics.ullNumUploadedInstances += uNumInstances;
+                bOutChunksChanged = TRUE;
+            }
+
+            for (UINT uLod = 0u; uLod < VoxelLodSelector::NUM_LODS; ++uLod)
+            {
+                lodSelector.SetChunk(chunkData.uChunk, uLod, voxelChunk);
+            }
+            if (m_pLightField)
+            {
+                m_pLightField->MarkChunkDirty(chunkData.uChunk);
+            }
+            ++m_statistics.uNumUploadedChunks;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::GetStatistics
+
+      Summary:  Returns the edits and rebuilds of the last frame
+
+      Returns:  const VoxelEditStatistics&
+                  Queued edits, pending builds and uploads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelEditStatistics& VoxelEditor::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::applyEdit
+
+      Summary:  Writes an edit to the store and marks the chunks of the
+                column and of its four neighbours dirty, which covers
+                the chunk across a border. Edits that change nothing
+                are dropped. The light field floods the change right
+                away, since no build reads it
+
+      Args:     const VoxelEdit& edit
+                  Voxel and its new block type
+
+      Modifies: [m_columnStore, m_pLightField, m_abDirtyChunks,
+                 m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelEditor::applyEdit(_In_ const VoxelEdit& edit)
+    {
+        const BYTE oldBlockType = m_columnStore.GetBlockType(edit.x, edit.y, edit.z);
+        if (oldBlockType == edit.blockType)
+        {
+            return;
+        }
+        if (FAILED(m_columnStore.SetBlock(edit.x, edit.y, edit.z, edit.blockType)))
+        {
+            return;
+        }
+        if (m_pLightField)
+        {
+            m_pLightField->OnBlockChanged(edit.x, edit.y, edit.z, oldBlockType);
+        }
+
+        markDirty(edit.x, edit.z);
+        if (edit.x > 0u)
+        {
+            markDirty(edit.x - 1u, edit.z);
+        }
+        if (edit.x + 1u < m_columnStore.GetWidth())
+        {
+            markDirty(edit.x + 1u, edit.z);
+        }
+        if (edit.z > 0u)
+        {
+            markDirty(edit.x, edit.z - 1u);
+        }
+        if (edit.z + 1u < m_columnStore.GetDepth())
+        {
+            markDirty(edit.x, edit.z + 1u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelEditor::markDirty
+
+      Summary:  Marks the chunk of a column dirty
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Modifies: [m_abDirtyChunks, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelEditor::markDirty(_In_ UINT x, _In_ UINT z)
+    {
+        const UINT uChunkSize = m_voxelBuilder.GetChunkSize();
+        const UINT uChunk = (z / uChunkSize) * m_voxelBuilder.GetNumChunksX() + x / uChunkSize;
+        if (!m_abDirtyChunks[uChunk])
+        {
+            m_abDirtyChunks[uChunk] = TRUE;
+            m_auDirtyChunks.push_back(uChunk);
+        }
+    }
+}
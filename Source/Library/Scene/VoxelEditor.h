@@ -0,0 +1,109 @@
+/*+===================================================================
+  File:      VOXELEDITOR.H
+
+  Summary:   VoxelEditor header file contains declarations of the
+             VoxelEditor class that edits the voxels of a terrain and
+             rebuilds the chunks it touched for the lab samples of Game
+             Graphics Programming course.
+
+  Classes: VoxelEditor
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/VoxelBuilder.h"
+#include "Scene/VoxelChunkBuildQueue.h"
+#include "Scene/VoxelColumnStore.h"
+#include "Scene/VoxelLightField.h"
+#include "Scene/VoxelLodSelector.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelEditStatistics
+
+      Summary:  Edits waiting for the rebuilds in flight, the chunks
+                being rebuilt, and the chunks and instances the last
+                frame uploaded
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelEditStatistics
+    {
+        UINT uNumQueuedEdits;
+        UINT uNumPendingBuilds;
+        UINT uNumUploadedChunks;
+        UINT64 ullNumUploadedInstances;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelEditor
+
+      Summary:  Sets voxels of a column store and rebuilds only the
+                chunks an edit touched: the chunk of the voxel, and the
+                chunk across the border when the voxel lies on one,
+                since hidden voxel culling looks at the neighbouring
+                columns. Dirty chunks are rebuilt on the thread pool.
+                The builds read the store, so edits made while they run
+                are queued and applied once they all finished, and an
+                edit reaches the GPU within one or two frames. Only
+                the full resolution level of a chunk is rebuilt; it
+                takes the place of the coarser levels of the chunk so
+                the edit shows at any distance. Applied edits update
+                the light field, if any, which bakes the light of the
+                chunks it marked
+
+      Methods:  SetBlock
+                  Sets the block type of a voxel
+                Update
+                  Applies queued edits and schedules the rebuilds
+                UploadFinishedChunks
+                  Uploads the changed instances of the rebuilt chunks
+                GetStatistics
+                  Returns the state of the last frame
+                VoxelEditor
+                  Constructor.
+                ~VoxelEditor
+                  Destructor. Waits for the scheduled builds
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelEditor final
+    {
+    public:
+        VoxelEditor() = delete;
+        VoxelEditor(_In_ VoxelColumnStore& columnStore, _In_ BOOL bCullHiddenVoxels, _In_ UINT uChunkSize, _In_opt_ VoxelLightField* pLightField = nullptr);
+        VoxelEditor(const VoxelEditor& other) = delete;
+        VoxelEditor(VoxelEditor&& other) = delete;
+        VoxelEditor& operator=(const VoxelEditor& other) = delete;
+        VoxelEditor& operator=(VoxelEditor&& other) = delete;
+        ~VoxelEditor() = default;
+
+        HRESULT SetBlock(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE blockType);
+        void Update();
+        HRESULT UploadFinishedChunks(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _Inout_ VoxelLodSelector& lodSelector, _Out_ BOOL& bOutChunksChanged);
+
+        const VoxelEditStatistics& GetStatistics() const;
+
+    private:
+        struct VoxelEdit
+        {
+            UINT x;
+            UINT y;
+            UINT z;
+            BYTE blockType;
+        };
+
+        void applyEdit(_In_ const VoxelEdit& edit);
+        void markDirty(_In_ UINT x, _In_ UINT z);
+
+    private:
+        VoxelColumnStore& m_columnStore;
+        VoxelBuilder m_voxelBuilder;
+        VoxelLightField* m_pLightField;
+        std::vector<BOOL> m_abDirtyChunks;
+        std::vector<UINT> m_auDirtyChunks;
+        std::vector<VoxelEdit> m_aQueuedEdits;
+        VoxelEditStatistics m_statistics;
+        VoxelChunkBuildQueue m_buildQueue;
+    };
+}
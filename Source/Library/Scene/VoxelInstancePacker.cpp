@@ -0,0 +1,75 @@
+#include "Scene/VoxelInstancePacker.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstancePacker::CanPack
+
+      Summary:  Returns whether a voxel fits into the encoding
+
+      Args:     UINT x
+                  Column x relative to the chunk origin
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column z relative to the chunk origin
+                UINT uBlockType
+                  Index of the block type in the palette
+
+      Returns:  BOOL
+                  TRUE if every field is in range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelInstancePacker::CanPack(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uBlockType)
+    {
+        return x < MAX_CHUNK_SIZE && z < MAX_CHUNK_SIZE && y < MAX_NUM_LAYERS && uBlockType < MAX_NUM_BLOCK_TYPES;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstancePacker::Pack
+
+      Summary:  Encodes a voxel. The fields must pass CanPack
+
+      Args:     UINT x
+                  Column x relative to the chunk origin
+                UINT y
+                  Layer of the voxel
+                UINT z
+                  Column z relative to the chunk origin
+                UINT uBlockType
+                  Index of the block type in the palette
+
+      Returns:  PackedVoxelInstance
+                  Encoded voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedVoxelInstance VoxelInstancePacker::Pack(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uBlockType)
+    {
+        assert(CanPack(x, y, z, uBlockType));
+
+        return PackedVoxelInstance
+        {
+            .Packed = x | (z << Z_SHIFT) | (y << Y_SHIFT) | (uBlockType << BLOCK_TYPE_SHIFT)
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelInstancePacker::Unpack
+
+      Summary:  Decodes a voxel
+
+      Args:     const PackedVoxelInstance& instance
+                  Encoded voxel
+                XMUINT3& outGrid
+                  Grid coordinates relative to the chunk origin
+                UINT& uOutBlockType
+                  Index of the block type in the palette
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelInstancePacker::Unpack(_In_ const PackedVoxelInstance& instance, _Out_ XMUINT3& outGrid, _Out_ UINT& uOutBlockType)
+    {
+        outGrid = XMUINT3(
+            instance.Packed & (MAX_CHUNK_SIZE - 1u),
+            (instance.Packed >> Y_SHIFT) & (MAX_NUM_LAYERS - 1u),
+            (instance.Packed >> Z_SHIFT) & (MAX_CHUNK_SIZE - 1u)
+        );
+        uOutBlockType = instance.Packed >> BLOCK_TYPE_SHIFT;
+    }
+}
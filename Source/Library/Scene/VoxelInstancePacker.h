@@ -0,0 +1,64 @@
+/*+===================================================================
+  File:      VOXELINSTANCEPACKER.H
+
+  Summary:   VoxelInstancePacker header file contains declarations of
+             the VoxelInstancePacker class that encodes voxel instances
+             into 32 bits for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: VoxelInstancePacker
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelInstancePacker
+
+      Summary:  Encodes the grid coordinates of a voxel relative to the
+                origin of its chunk and its block type into one 32-bit
+                word, 16 times smaller than a translation matrix.
+                Bits 0-5 hold x, bits 6-11 z, bits 12-23 the layer y
+                and bits 24-31 the block type. VSVoxelPacked in
+                VoxelShaders.fxh decodes the same layout
+
+      Methods:  CanPack
+                  Returns whether a voxel fits into the encoding
+                Pack
+                  Encodes a voxel
+                Unpack
+                  Decodes a voxel
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelInstancePacker final
+    {
+    public:
+        static constexpr const UINT NUM_X_BITS = 6u;
+        static constexpr const UINT NUM_Z_BITS = 6u;
+        static constexpr const UINT NUM_Y_BITS = 12u;
+        static constexpr const UINT NUM_BLOCK_TYPE_BITS = 8u;
+
+        static constexpr const UINT Z_SHIFT = NUM_X_BITS;
+        static constexpr const UINT Y_SHIFT = Z_SHIFT + NUM_Z_BITS;
+        static constexpr const UINT BLOCK_TYPE_SHIFT = Y_SHIFT + NUM_Y_BITS;
+
+        // Largest chunk side and column height the encoding can address
+        static constexpr const UINT MAX_CHUNK_SIZE = 1u << NUM_X_BITS;
+        static constexpr const UINT MAX_NUM_LAYERS = 1u << NUM_Y_BITS;
+        static constexpr const UINT MAX_NUM_BLOCK_TYPES = 1u << NUM_BLOCK_TYPE_BITS;
+
+        static_assert(BLOCK_TYPE_SHIFT + NUM_BLOCK_TYPE_BITS == 32u, "Packed voxel instance must fill exactly 32 bits");
+        static_assert(sizeof(PackedVoxelInstance) * 16u == sizeof(InstanceData), "Packed voxel instance must be 16 times smaller than a matrix");
+
+        VoxelInstancePacker() = delete;
+
+        static BOOL CanPack(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uBlockType);
+        static PackedVoxelInstance Pack(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uBlockType);
+        static void Unpack(_In_ const PackedVoxelInstance& instance, _Out_ XMUINT3& outGrid, _Out_ UINT& uOutBlockType);
+    };
+}
@@ -0,0 +1,1055 @@
+#include "Scene/VoxelLightField.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::VoxelLightField
+
+      Summary:  Constructor. The field is dark until it is created
+
+      Args:     const VoxelColumnStore& columnStore
+                  Voxels the light floods through. The store must
+                  outlive the field
+                UINT uChunkSize
+                  Number of columns along a chunk side, the same as the
+                  chunks being drawn
+
+      Modifies: [m_columnStore, m_uChunkSize, m_uNumChunksX,
+                 m_uNumSectionsX, m_uNumSectionsY, m_uNumSectionsZ,
+                 m_aBlockEmissions, m_auSkyHeights, m_apSections,
+                 m_aEmitters, m_emitterCells, m_aRemovalQueues,
+                 m_aPropagationQueues, m_abDirtyChunks, m_auDirtyChunks,
+                 m_statistics, m_updateStartingTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelLightField::VoxelLightField(_In_ const VoxelColumnStore& columnStore, _In_ UINT uChunkSize)
+        : m_columnStore(columnStore)
+        , m_uChunkSize(uChunkSize)
+        , m_uNumChunksX((columnStore.GetWidth() + uChunkSize - 1u) / uChunkSize)
+        , m_uNumSectionsX((columnStore.GetWidth() + SECTION_SIZE - 1u) / SECTION_SIZE)
+        , m_uNumSectionsY((columnStore.GetHeight() + SECTION_SIZE - 1u) / SECTION_SIZE)
+        , m_uNumSectionsZ((columnStore.GetDepth() + SECTION_SIZE - 1u) / SECTION_SIZE)
+        , m_aBlockEmissions()
+        , m_auSkyHeights(static_cast<size_t>(columnStore.GetWidth()) * columnStore.GetDepth(), 0u)
+        , m_apSections()
+        , m_aEmitters()
+        , m_emitterCells()
+        , m_aRemovalQueues()
+        , m_aPropagationQueues()
+        , m_abDirtyChunks(static_cast<size_t>(m_uNumChunksX) * ((columnStore.GetDepth() + uChunkSize - 1u) / uChunkSize), FALSE)
+        , m_auDirtyChunks()
+        , m_statistics{ .uNumEmitters = 0u, .uNumSections = 0u, .ullNumVisitedCells = 0u, .updateMilliseconds = 0.0 }
+        , m_updateStartingTime()
+    {
+        m_apSections.resize(static_cast<size_t>(m_uNumSectionsX) * m_uNumSectionsY * m_uNumSectionsZ);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::Create
+
+      Summary:  Floods the light of the whole store from scratch. The
+                sky reaches air below the skyline only through the
+                columns edits split into runs, so only those seed the
+                sky fill. Every voxel of an emissive block type and
+                every emitter seeds the block fill. Every chunk is
+                marked for baking
+
+      Modifies: [m_auSkyHeights, m_apSections, m_aRemovalQueues,
+                 m_aPropagationQueues, m_abDirtyChunks, m_auDirtyChunks,
+                 m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::Create()
+    {
+        beginUpdate();
+
+        const UINT uWidth = m_columnStore.GetWidth();
+        const UINT uDepth = m_columnStore.GetDepth();
+
+        for (std::unique_ptr<BYTE[]>& pSection : m_apSections)
+        {
+            pSection.reset();
+        }
+        m_statistics.uNumSections = 0u;
+        for (std::deque<LightNode>& queue : m_aRemovalQueues)
+        {
+            queue.clear();
+        }
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                m_auSkyHeights[static_cast<size_t>(z) * uWidth + x] = m_columnStore.GetColumnHeight(x, z);
+            }
+        }
+
+        const BOOL bHasEmissiveBlocks = std::any_of(std::begin(m_aBlockEmissions), std::end(m_aBlockEmissions), [](BYTE level) { return level > 0u; });
+        std::deque<LightNode>& skyQueue = m_aPropagationQueues[0];
+        std::deque<LightNode>& blockQueue = m_aPropagationQueues[1];
+        std::vector<VoxelRun> aRuns;
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                const BOOL bSingleRun = m_columnStore.IsSingleRun(x, z);
+                if (bSingleRun && !bHasEmissiveBlocks)
+                {
+                    continue;
+                }
+
+                m_columnStore.GetRuns(x, z, aRuns);
+                UINT uRunBegin = 0u;
+                for (const VoxelRun& run : aRuns)
+                {
+                    const UINT uRunEnd = uRunBegin + run.uLength;
+                    if (run.blockType == VoxelColumnStore::EMPTY_BLOCK)
+                    {
+                        // Lit neighbours of air below the skyline are
+                        // the only sources of its sky light
+                        for (UINT y = uRunBegin; y < uRunEnd; ++y)
+                        {
+                            for (UINT uFace = 0u; uFace < 6u; ++uFace)
+                            {
+                                const INT iX = static_cast<INT>(x) + ms_aaiNeighbourOffsets[uFace][0];
+                                const INT iZ = static_cast<INT>(z) + ms_aaiNeighbourOffsets[uFace][2];
+                                if (ms_aaiNeighbourOffsets[uFace][1] == 0 && iX >= 0 && iZ >= 0 && iX < static_cast<INT>(uWidth) && iZ < static_cast<INT>(uDepth)
+                                    && y >= m_auSkyHeights[static_cast<size_t>(iZ) * uWidth + static_cast<UINT>(iX)])
+                                {
+                                    skyQueue.push_back(LightNode{ .x = static_cast<UINT>(iX), .y = y, .z = static_cast<UINT>(iZ), .level = MAX_LIGHT_LEVEL });
+                                }
+                            }
+                        }
+                    }
+                    else if (m_aBlockEmissions[run.blockType] > 0u)
+                    {
+                        for (UINT y = uRunBegin; y < uRunEnd; ++y)
+                        {
+                            setLevel(x, y, z, BLOCK_SHIFT, m_aBlockEmissions[run.blockType]);
+                            blockQueue.push_back(LightNode{ .x = x, .y = y, .z = z, .level = m_aBlockEmissions[run.blockType] });
+                        }
+                    }
+                    uRunBegin = uRunEnd;
+                }
+            }
+        }
+
+        for (const Emitter& emitter : m_aEmitters)
+        {
+            if (emitter.bActive && emitter.level > ((GetLight(static_cast<INT>(emitter.cell.x), static_cast<INT>(emitter.cell.y), static_cast<INT>(emitter.cell.z)) >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL))
+            {
+                setLevel(emitter.cell.x, emitter.cell.y, emitter.cell.z, BLOCK_SHIFT, emitter.level);
+                blockQueue.push_back(LightNode{ .x = emitter.cell.x, .y = emitter.cell.y, .z = emitter.cell.z, .level = emitter.level });
+            }
+        }
+
+        propagateLight(SKY_SHIFT);
+        propagateLight(BLOCK_SHIFT);
+
+        for (UINT uChunk = 0u; uChunk < m_abDirtyChunks.size(); ++uChunk)
+        {
+            MarkChunkDirty(uChunk);
+        }
+
+        endUpdate();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::SetBlockEmission
+
+      Summary:  Sets the light level the exposed voxels of a block type
+                emit. Takes effect with the next Create for the voxels
+                already in the store, and right away for placed ones
+
+      Args:     BYTE blockType
+                  Index of the block type in the palette
+                BYTE level
+                  Light level from 0 to MAX_LIGHT_LEVEL
+
+      Modifies: [m_aBlockEmissions].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the block type is not in
+                  the palette or the level is too high
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelLightField::SetBlockEmission(_In_ BYTE blockType, _In_ BYTE level)
+    {
+        if (blockType >= m_columnStore.GetNumColors() || level > MAX_LIGHT_LEVEL)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_aBlockEmissions[blockType] = level;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::OnBlockChanged
+
+      Summary:  Updates the light after a voxel of the store changed. A
+                placed block takes away the light of its cell and the
+                sky of the air it covers, which is removed and flooded
+                back in from around; an emissive block then lights its
+                cell. A removed block takes its emission away, uncovers
+                the sky of the air below it if it was the top of its
+                column, and lets the light of its neighbours in
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+                BYTE oldBlockType
+                  Block type of the voxel before the change
+
+      Modifies: [m_auSkyHeights, m_apSections, m_aRemovalQueues,
+                 m_aPropagationQueues, m_abDirtyChunks, m_auDirtyChunks,
+                 m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::OnBlockChanged(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE oldBlockType)
+    {
+        UNREFERENCED_PARAMETER(oldBlockType);
+
+        if (x >= m_columnStore.GetWidth() || y >= m_columnStore.GetHeight() || z >= m_columnStore.GetDepth())
+        {
+            return;
+        }
+
+        beginUpdate();
+
+        const size_t uColumn = static_cast<size_t>(z) * m_columnStore.GetWidth() + x;
+        const UINT uOldSkyHeight = m_auSkyHeights[uColumn];
+        const UINT uNewSkyHeight = m_columnStore.GetColumnHeight(x, z);
+        const BYTE light = GetLight(static_cast<INT>(x), static_cast<INT>(y), static_cast<INT>(z));
+        const BYTE skyLevel = (light >> SKY_SHIFT) & MAX_LIGHT_LEVEL;
+        const BYTE blockLevel = (light >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL;
+
+        std::deque<LightNode>& skyRemovalQueue = m_aRemovalQueues[0];
+        std::deque<LightNode>& blockRemovalQueue = m_aRemovalQueues[1];
+        m_auSkyHeights[uColumn] = static_cast<WORD>(uNewSkyHeight);
+        markCellDirty(x, z);
+
+        if (blockLevel > 0u)
+        {
+            setLevel(x, y, z, BLOCK_SHIFT, 0u);
+            blockRemovalQueue.push_back(LightNode{ .x = x, .y = y, .z = z, .level = blockLevel });
+        }
+
+        if (m_columnStore.GetBlockType(x, y, z) != VoxelColumnStore::EMPTY_BLOCK)
+        {
+            // The air the block covers no longer sees the sky
+            for (UINT uLayer = uOldSkyHeight; uLayer < uNewSkyHeight; ++uLayer)
+            {
+                setLevel(x, uLayer, z, SKY_SHIFT, 0u);
+                skyRemovalQueue.push_back(LightNode{ .x = x, .y = uLayer, .z = z, .level = MAX_LIGHT_LEVEL });
+            }
+            if (y < uOldSkyHeight && skyLevel > 0u)
+            {
+                setLevel(x, y, z, SKY_SHIFT, 0u);
+                skyRemovalQueue.push_back(LightNode{ .x = x, .y = y, .z = z, .level = skyLevel });
+            }
+
+            removeLight(SKY_SHIFT);
+            removeLight(BLOCK_SHIFT);
+
+            const BYTE emission = getEmission(x, y, z);
+            if (emission > 0u)
+            {
+                setLevel(x, y, z, BLOCK_SHIFT, emission);
+                m_aPropagationQueues[1].push_back(LightNode{ .x = x, .y = y, .z = z, .level = emission });
+            }
+        }
+        else
+        {
+            removeLight(BLOCK_SHIFT);
+
+            // The air below a removed top block sees the sky
+            for (UINT uLayer = uNewSkyHeight; uLayer < uOldSkyHeight; ++uLayer)
+            {
+                setLevel(x, uLayer, z, SKY_SHIFT, MAX_LIGHT_LEVEL);
+                m_aPropagationQueues[0].push_back(LightNode{ .x = x, .y = uLayer, .z = z, .level = MAX_LIGHT_LEVEL });
+            }
+
+            const BYTE emission = getEmission(x, y, z);
+            if (emission > ((GetLight(static_cast<INT>(x), static_cast<INT>(y), static_cast<INT>(z)) >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL))
+            {
+                setLevel(x, y, z, BLOCK_SHIFT, emission);
+            }
+            m_aPropagationQueues[1].push_back(LightNode{ .x = x, .y = y, .z = z, .level = emission });
+            pushBrightNeighbours(x, y, z);
+        }
+
+        propagateLight(SKY_SHIFT);
+        propagateLight(BLOCK_SHIFT);
+
+        endUpdate();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::AddEmitter
+
+      Summary:  Places a light emitter that is not a block, such as a
+                torch or a light carried around, and floods its light
+
+      Args:     const XMUINT3& cell
+                  Voxel coordinates of the emitter
+                BYTE level
+                  Light level from 1 to MAX_LIGHT_LEVEL
+                UINT& uOutEmitter
+                  Handle of the emitter
+
+      Modifies: [m_aEmitters, m_emitterCells, m_apSections,
+                 m_aPropagationQueues, m_abDirtyChunks, m_auDirtyChunks,
+                 m_statistics].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the cell is outside the
+                  store or the level is out of range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelLightField::AddEmitter(_In_ const XMUINT3& cell, _In_ BYTE level, _Out_ UINT& uOutEmitter)
+    {
+        uOutEmitter = 0u;
+        if (cell.x >= m_columnStore.GetWidth() || cell.y >= m_columnStore.GetHeight() || cell.z >= m_columnStore.GetDepth()
+            || level == 0u || level > MAX_LIGHT_LEVEL)
+        {
+            return E_INVALIDARG;
+        }
+
+        beginUpdate();
+
+        uOutEmitter = static_cast<UINT>(m_aEmitters.size());
+        m_aEmitters.push_back(Emitter{ .cell = cell, .level = level, .bActive = TRUE });
+        m_emitterCells.emplace(getCellKey(cell.x, cell.y, cell.z), uOutEmitter);
+        ++m_statistics.uNumEmitters;
+        addEmitterLight(cell, level);
+
+        endUpdate();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::MoveEmitter
+
+      Summary:  Moves a light emitter. Only the light around its old
+                and new cells is flooded again
+
+      Args:     UINT uEmitter
+                  Handle of the emitter
+                const XMUINT3& cell
+                  New voxel coordinates of the emitter
+
+      Modifies: [m_aEmitters, m_emitterCells, m_apSections,
+                 m_aRemovalQueues, m_aPropagationQueues, m_abDirtyChunks,
+                 m_auDirtyChunks, m_statistics].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the emitter was removed
+                  or the cell is outside the store
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelLightField::MoveEmitter(_In_ UINT uEmitter, _In_ const XMUINT3& cell)
+    {
+        if (uEmitter >= m_aEmitters.size() || !m_aEmitters[uEmitter].bActive
+            || cell.x >= m_columnStore.GetWidth() || cell.y >= m_columnStore.GetHeight() || cell.z >= m_columnStore.GetDepth())
+        {
+            return E_INVALIDARG;
+        }
+
+        Emitter& emitter = m_aEmitters[uEmitter];
+        if (emitter.cell.x == cell.x && emitter.cell.y == cell.y && emitter.cell.z == cell.z)
+        {
+            return S_OK;
+        }
+
+        beginUpdate();
+
+        eraseEmitterCell(uEmitter);
+        removeEmitterLight(emitter.cell);
+
+        emitter.cell = cell;
+        m_emitterCells.emplace(getCellKey(cell.x, cell.y, cell.z), uEmitter);
+        addEmitterLight(cell, emitter.level);
+
+        endUpdate();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::RemoveEmitter
+
+      Summary:  Removes a light emitter and the light only it gave
+
+      Args:     UINT uEmitter
+                  Handle of the emitter
+
+      Modifies: [m_aEmitters, m_emitterCells, m_apSections,
+                 m_aRemovalQueues, m_aPropagationQueues, m_abDirtyChunks,
+                 m_auDirtyChunks, m_statistics].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the emitter was already
+                  removed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelLightField::RemoveEmitter(_In_ UINT uEmitter)
+    {
+        if (uEmitter >= m_aEmitters.size() || !m_aEmitters[uEmitter].bActive)
+        {
+            return E_INVALIDARG;
+        }
+
+        beginUpdate();
+
+        eraseEmitterCell(uEmitter);
+        m_aEmitters[uEmitter].bActive = FALSE;
+        --m_statistics.uNumEmitters;
+        removeEmitterLight(m_aEmitters[uEmitter].cell);
+
+        endUpdate();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::GetLight
+
+      Summary:  Returns the light of a cell. Takes signed coordinates
+                so neighbours past the edges can be asked for directly:
+                past the sides and the top of the store is open sky,
+                below the floor is dark
+
+      Args:     INT x
+                  Column x
+                INT y
+                  Layer
+                INT z
+                  Column z
+
+      Returns:  BYTE
+                  Sky level in the high four bits and block level in
+                  the low four bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE VoxelLightField::GetLight(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (y < 0)
+        {
+            return 0u;
+        }
+        if (x < 0 || z < 0 || x >= static_cast<INT>(m_columnStore.GetWidth()) || y >= static_cast<INT>(m_columnStore.GetHeight()) || z >= static_cast<INT>(m_columnStore.GetDepth()))
+        {
+            return FULL_SKY;
+        }
+
+        const UINT uX = static_cast<UINT>(x);
+        const UINT uY = static_cast<UINT>(y);
+        const UINT uZ = static_cast<UINT>(z);
+        const BYTE* pSection = m_apSections[(static_cast<size_t>(uY / SECTION_SIZE) * m_uNumSectionsZ + uZ / SECTION_SIZE) * m_uNumSectionsX + uX / SECTION_SIZE].get();
+        if (!pSection)
+        {
+            return getDefaultLight(uX, uY, uZ);
+        }
+
+        return pSection[((uY % SECTION_SIZE) * SECTION_SIZE + uZ % SECTION_SIZE) * SECTION_SIZE + uX % SECTION_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::BakeInstances
+
+      Summary:  Returns the light every face of packed instances sees,
+                the light of the cell across the face. The first word
+                holds the faces -x, +x, -y and +y, the second one -z
+                and +z, eight bits each in face order. VSVoxelPacked in
+                VoxelShaders.fxh decodes the same layout
+
+      Args:     const PackedVoxelInstance* pInstances
+                  Instances of a full resolution chunk
+                size_t uNumInstances
+                  Number of instances
+                UINT uChunk
+                  Index of the chunk the instances are relative to
+                PackedVoxelLight* pOutLights
+                  Receives the light of every instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::BakeInstances(
+        _In_reads_(uNumInstances) const PackedVoxelInstance* pInstances,
+        _In_ size_t uNumInstances,
+        _In_ UINT uChunk,
+        _Out_writes_(uNumInstances) PackedVoxelLight* pOutLights
+    ) const
+    {
+        const INT iOriginX = static_cast<INT>((uChunk % m_uNumChunksX) * m_uChunkSize);
+        const INT iOriginZ = static_cast<INT>((uChunk / m_uNumChunksX) * m_uChunkSize);
+
+        XMUINT3 grid;
+        UINT uBlockType;
+        BYTE aFaceLights[6];
+        for (size_t i = 0u; i < uNumInstances; ++i)
+        {
+            VoxelInstancePacker::Unpack(pInstances[i], grid, uBlockType);
+            const INT iX = iOriginX + static_cast<INT>(grid.x);
+            const INT iY = static_cast<INT>(grid.y);
+            const INT iZ = iOriginZ + static_cast<INT>(grid.z);
+            for (UINT uFace = 0u; uFace < 6u; ++uFace)
+            {
+                aFaceLights[uFace] = GetLight(iX + ms_aaiNeighbourOffsets[uFace][0], iY + ms_aaiNeighbourOffsets[uFace][1], iZ + ms_aaiNeighbourOffsets[uFace][2]);
+            }
+
+            pOutLights[i].Packed = XMUINT2(
+                static_cast<UINT>(aFaceLights[0]) | (static_cast<UINT>(aFaceLights[1]) << 8u) | (static_cast<UINT>(aFaceLights[2]) << 16u) | (static_cast<UINT>(aFaceLights[3]) << 24u),
+                static_cast<UINT>(aFaceLights[4]) | (static_cast<UINT>(aFaceLights[5]) << 8u)
+            );
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::MarkChunkDirty
+
+      Summary:  Marks a chunk for baking, such as one whose instances
+                were rebuilt
+
+      Args:     UINT uChunk
+                  Index of the chunk, z * number of chunks along x + x
+
+      Modifies: [m_abDirtyChunks, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::MarkChunkDirty(_In_ UINT uChunk)
+    {
+        if (uChunk < m_abDirtyChunks.size() && !m_abDirtyChunks[uChunk])
+        {
+            m_abDirtyChunks[uChunk] = TRUE;
+            m_auDirtyChunks.push_back(uChunk);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::CollectDirtyChunks
+
+      Summary:  Returns the chunks marked for baking and clears the
+                marks
+
+      Args:     std::vector<UINT>& auOutChunks
+                  Indices of the chunks to bake
+
+      Modifies: [m_abDirtyChunks, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::CollectDirtyChunks(_Out_ std::vector<UINT>& auOutChunks)
+    {
+        auOutChunks.clear();
+        auOutChunks.swap(m_auDirtyChunks);
+        for (UINT uChunk : auOutChunks)
+        {
+            m_abDirtyChunks[uChunk] = FALSE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::GetStatistics
+
+      Summary:  Returns the emitters, the stored sections and the cost
+                of the last change
+
+      Returns:  const VoxelLightStatistics&
+                  Statistics of the field
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelLightStatistics& VoxelLightField::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::isSolid
+
+      Summary:  Returns whether a voxel inside the store blocks light.
+                Everything at or above the skyline of a column is air
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+
+      Returns:  BOOL
+                  TRUE if the voxel holds a block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelLightField::isSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        if (y >= m_auSkyHeights[static_cast<size_t>(z) * m_columnStore.GetWidth() + x])
+        {
+            return FALSE;
+        }
+
+        return m_columnStore.GetBlockType(x, y, z) != VoxelColumnStore::EMPTY_BLOCK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::getDefaultLight
+
+      Summary:  Returns the light of a cell outside the allocated
+                sections: the full sky at or above the skyline of its
+                column, dark below it
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+
+      Returns:  BYTE
+                  Sky and block light of the cell
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE VoxelLightField::getDefaultLight(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        return y >= m_auSkyHeights[static_cast<size_t>(z) * m_columnStore.GetWidth() + x] ? FULL_SKY : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::getCellKey
+
+      Summary:  Returns the key emitters are looked up by in a cell
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+
+      Returns:  UINT64
+                  Linear index of the cell
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 VoxelLightField::getCellKey(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        return (static_cast<UINT64>(y) * m_columnStore.GetDepth() + z) * m_columnStore.GetWidth() + x;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::eraseEmitterCell
+
+      Summary:  Takes an emitter out of the lookup of its cell
+
+      Args:     UINT uEmitter
+                  Handle of the emitter
+
+      Modifies: [m_emitterCells].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::eraseEmitterCell(_In_ UINT uEmitter)
+    {
+        const XMUINT3& cell = m_aEmitters[uEmitter].cell;
+        const auto [begin, end] = m_emitterCells.equal_range(getCellKey(cell.x, cell.y, cell.z));
+        for (auto it = begin; it != end; ++it)
+        {
+            if (it->second == uEmitter)
+            {
+                m_emitterCells.erase(it);
+                break;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::getEmission
+
+      Summary:  Returns the block light a cell emits on its own, the
+                brightest of its emissive block and the emitters in it
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+
+      Returns:  BYTE
+                  Light level the cell emits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE VoxelLightField::getEmission(_In_ UINT x, _In_ UINT y, _In_ UINT z) const
+    {
+        BYTE level = 0u;
+        if (isSolid(x, y, z))
+        {
+            level = m_aBlockEmissions[m_columnStore.GetBlockType(x, y, z)];
+        }
+
+        const auto [begin, end] = m_emitterCells.equal_range(getCellKey(x, y, z));
+        for (auto it = begin; it != end; ++it)
+        {
+            level = std::max<BYTE>(level, m_aEmitters[it->second].level);
+        }
+
+        return level;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::setLevel
+
+      Summary:  Sets the sky or block level of a cell. The section of
+                the cell is allocated, filled with the default light,
+                only once the cell differs from the default. Chunks
+                whose faces see the cell are marked for baking
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+                UINT uShift
+                  SKY_SHIFT or BLOCK_SHIFT
+                BYTE level
+                  New level
+
+      Modifies: [m_apSections, m_abDirtyChunks, m_auDirtyChunks,
+                 m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::setLevel(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uShift, _In_ BYTE level)
+    {
+        const BYTE mask = static_cast<BYTE>(MAX_LIGHT_LEVEL << uShift);
+        std::unique_ptr<BYTE[]>& pSection = m_apSections[(static_cast<size_t>(y / SECTION_SIZE) * m_uNumSectionsZ + z / SECTION_SIZE) * m_uNumSectionsX + x / SECTION_SIZE];
+        if (!pSection)
+        {
+            const BYTE light = getDefaultLight(x, y, z);
+            if (static_cast<BYTE>((light & ~mask) | (level << uShift)) == light)
+            {
+                return;
+            }
+
+            pSection = std::make_unique<BYTE[]>(SECTION_SIZE * SECTION_SIZE * SECTION_SIZE);
+            const UINT uBeginX = x - x % SECTION_SIZE;
+            const UINT uBeginY = y - y % SECTION_SIZE;
+            const UINT uBeginZ = z - z % SECTION_SIZE;
+            const UINT uEndX = std::min<UINT>(uBeginX + SECTION_SIZE, m_columnStore.GetWidth());
+            const UINT uEndZ = std::min<UINT>(uBeginZ + SECTION_SIZE, m_columnStore.GetDepth());
+            for (UINT uZ = uBeginZ; uZ < uEndZ; ++uZ)
+            {
+                for (UINT uX = uBeginX; uX < uEndX; ++uX)
+                {
+                    const UINT uSkyHeight = m_auSkyHeights[static_cast<size_t>(uZ) * m_columnStore.GetWidth() + uX];
+                    for (UINT uY = 0u; uY < SECTION_SIZE; ++uY)
+                    {
+                        pSection[(uY * SECTION_SIZE + uZ % SECTION_SIZE) * SECTION_SIZE + uX % SECTION_SIZE] = uBeginY + uY >= uSkyHeight ? FULL_SKY : 0u;
+                    }
+                }
+            }
+            ++m_statistics.uNumSections;
+        }
+
+        BYTE& light = pSection[((y % SECTION_SIZE) * SECTION_SIZE + z % SECTION_SIZE) * SECTION_SIZE + x % SECTION_SIZE];
+        const BYTE newLight = static_cast<BYTE>((light & ~mask) | (level << uShift));
+        if (newLight != light)
+        {
+            light = newLight;
+            markCellDirty(x, z);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::markCellDirty
+
+      Summary:  Marks the chunk of a column for baking, and the chunk
+                across a border the column lies on, whose faces see
+                the column too
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Modifies: [m_abDirtyChunks, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::markCellDirty(_In_ UINT x, _In_ UINT z)
+    {
+        const UINT uChunkX = x / m_uChunkSize;
+        const UINT uChunkZ = z / m_uChunkSize;
+        MarkChunkDirty(uChunkZ * m_uNumChunksX + uChunkX);
+
+        if (x % m_uChunkSize == 0u && uChunkX > 0u)
+        {
+            MarkChunkDirty(uChunkZ * m_uNumChunksX + uChunkX - 1u);
+        }
+        if (x % m_uChunkSize == m_uChunkSize - 1u && uChunkX + 1u < m_uNumChunksX)
+        {
+            MarkChunkDirty(uChunkZ * m_uNumChunksX + uChunkX + 1u);
+        }
+        if (z % m_uChunkSize == 0u && uChunkZ > 0u)
+        {
+            MarkChunkDirty((uChunkZ - 1u) * m_uNumChunksX + uChunkX);
+        }
+        if (z % m_uChunkSize == m_uChunkSize - 1u && (uChunkZ + 1u) * m_uNumChunksX < m_abDirtyChunks.size())
+        {
+            MarkChunkDirty((uChunkZ + 1u) * m_uNumChunksX + uChunkX);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::removeLight
+
+      Summary:  Floods darkness out from the cells in the removal queue
+                of a channel, which already hold zero and remember the
+                level they lost. A neighbour dimmer than that level got
+                its light from them and goes dark as well; a neighbour
+                as bright or brighter is lit from elsewhere and is
+                queued to flood its light back in. Emitters reached by
+                the darkness are lit again right away
+
+      Args:     UINT uShift
+                  SKY_SHIFT or BLOCK_SHIFT
+
+      Modifies: [m_apSections, m_aRemovalQueues, m_aPropagationQueues,
+                 m_abDirtyChunks, m_auDirtyChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::removeLight(_In_ UINT uShift)
+    {
+        const UINT uQueue = uShift == SKY_SHIFT ? 0u : 1u;
+        std::deque<LightNode>& removalQueue = m_aRemovalQueues[uQueue];
+        std::deque<LightNode>& propagationQueue = m_aPropagationQueues[uQueue];
+        const INT iWidth = static_cast<INT>(m_columnStore.GetWidth());
+        const INT iHeight = static_cast<INT>(m_columnStore.GetHeight());
+        const INT iDepth = static_cast<INT>(m_columnStore.GetDepth());
+
+        while (!removalQueue.empty())
+        {
+            const LightNode node = removalQueue.front();
+            removalQueue.pop_front();
+            ++m_statistics.ullNumVisitedCells;
+
+            for (UINT uFace = 0u; uFace < 6u; ++uFace)
+            {
+                const INT iX = static_cast<INT>(node.x) + ms_aaiNeighbourOffsets[uFace][0];
+                const INT iY = static_cast<INT>(node.y) + ms_aaiNeighbourOffsets[uFace][1];
+                const INT iZ = static_cast<INT>(node.z) + ms_aaiNeighbourOffsets[uFace][2];
+                if (iX < 0 || iY < 0 || iZ < 0 || iX >= iWidth || iY >= iHeight || iZ >= iDepth)
+                {
+                    continue;
+                }
+
+                const UINT uX = static_cast<UINT>(iX);
+                const UINT uY = static_cast<UINT>(iY);
+                const UINT uZ = static_cast<UINT>(iZ);
+                const BYTE level = (GetLight(iX, iY, iZ) >> uShift) & MAX_LIGHT_LEVEL;
+                if (level == 0u)
+                {
+                    continue;
+                }
+
+                // Only emitters hold light inside solid voxels
+                if (level >= node.level || isSolid(uX, uY, uZ))
+                {
+                    propagationQueue.push_back(LightNode{ .x = uX, .y = uY, .z = uZ, .level = level });
+                    continue;
+                }
+
+                setLevel(uX, uY, uZ, uShift, 0u);
+                removalQueue.push_back(LightNode{ .x = uX, .y = uY, .z = uZ, .level = level });
+
+                if (uShift == BLOCK_SHIFT)
+                {
+                    const BYTE emission = getEmission(uX, uY, uZ);
+                    if (emission > 0u)
+                    {
+                        setLevel(uX, uY, uZ, uShift, emission);
+                        propagationQueue.push_back(LightNode{ .x = uX, .y = uY, .z = uZ, .level = emission });
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::propagateLight
+
+      Summary:  Floods light out from the cells in the propagation
+                queue of a channel. A neighbour of air more than one
+                level dimmer than the cell takes the level of the cell
+                minus one and is queued in turn
+
+      Args:     UINT uShift
+                  SKY_SHIFT or BLOCK_SHIFT
+
+      Modifies: [m_apSections, m_aPropagationQueues, m_abDirtyChunks,
+                 m_auDirtyChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::propagateLight(_In_ UINT uShift)
+    {
+        std::deque<LightNode>& propagationQueue = m_aPropagationQueues[uShift == SKY_SHIFT ? 0u : 1u];
+        const INT iWidth = static_cast<INT>(m_columnStore.GetWidth());
+        const INT iHeight = static_cast<INT>(m_columnStore.GetHeight());
+        const INT iDepth = static_cast<INT>(m_columnStore.GetDepth());
+
+        while (!propagationQueue.empty())
+        {
+            const LightNode node = propagationQueue.front();
+            propagationQueue.pop_front();
+            ++m_statistics.ullNumVisitedCells;
+
+            const BYTE level = (GetLight(static_cast<INT>(node.x), static_cast<INT>(node.y), static_cast<INT>(node.z)) >> uShift) & MAX_LIGHT_LEVEL;
+            if (level <= 1u)
+            {
+                continue;
+            }
+
+            for (UINT uFace = 0u; uFace < 6u; ++uFace)
+            {
+                const INT iX = static_cast<INT>(node.x) + ms_aaiNeighbourOffsets[uFace][0];
+                const INT iY = static_cast<INT>(node.y) + ms_aaiNeighbourOffsets[uFace][1];
+                const INT iZ = static_cast<INT>(node.z) + ms_aaiNeighbourOffsets[uFace][2];
+                if (iX < 0 || iY < 0 || iZ < 0 || iX >= iWidth || iY >= iHeight || iZ >= iDepth)
+                {
+                    continue;
+                }
+
+                const UINT uX = static_cast<UINT>(iX);
+                const UINT uY = static_cast<UINT>(iY);
+                const UINT uZ = static_cast<UINT>(iZ);
+                if (((GetLight(iX, iY, iZ) >> uShift) & MAX_LIGHT_LEVEL) + 1u >= level || isSolid(uX, uY, uZ))
+                {
+                    continue;
+                }
+
+                setLevel(uX, uY, uZ, uShift, level - 1u);
+                propagationQueue.push_back(LightNode{ .x = uX, .y = uY, .z = uZ, .level = static_cast<BYTE>(level - 1u) });
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::pushBrightNeighbours
+
+      Summary:  Queues the lit neighbours of a cell that turned into
+                air, so their light floods into it. An emissive block
+                next to it was buried until now and starts to emit
+
+      Args:     UINT x
+                  Column x
+                UINT y
+                  Layer
+                UINT z
+                  Column z
+
+      Modifies: [m_apSections, m_aPropagationQueues, m_abDirtyChunks,
+                 m_auDirtyChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::pushBrightNeighbours(_In_ UINT x, _In_ UINT y, _In_ UINT z)
+    {
+        for (UINT uFace = 0u; uFace < 6u; ++uFace)
+        {
+            const INT iX = static_cast<INT>(x) + ms_aaiNeighbourOffsets[uFace][0];
+            const INT iY = static_cast<INT>(y) + ms_aaiNeighbourOffsets[uFace][1];
+            const INT iZ = static_cast<INT>(z) + ms_aaiNeighbourOffsets[uFace][2];
+            if (iX < 0 || iY < 0 || iZ < 0 || iX >= static_cast<INT>(m_columnStore.GetWidth()) || iY >= static_cast<INT>(m_columnStore.GetHeight()) || iZ >= static_cast<INT>(m_columnStore.GetDepth()))
+            {
+                continue;
+            }
+
+            const UINT uX = static_cast<UINT>(iX);
+            const UINT uY = static_cast<UINT>(iY);
+            const UINT uZ = static_cast<UINT>(iZ);
+            const BYTE light = GetLight(iX, iY, iZ);
+            const BYTE emission = isSolid(uX, uY, uZ) ? getEmission(uX, uY, uZ) : 0u;
+            if (emission > ((light >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL))
+            {
+                setLevel(uX, uY, uZ, BLOCK_SHIFT, emission);
+            }
+
+            const LightNode node = { .x = uX, .y = uY, .z = uZ, .level = 0u };
+            if (((light >> SKY_SHIFT) & MAX_LIGHT_LEVEL) > 1u)
+            {
+                m_aPropagationQueues[0].push_back(node);
+            }
+            if (std::max<BYTE>((light >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL, emission) > 1u)
+            {
+                m_aPropagationQueues[1].push_back(node);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::addEmitterLight
+
+      Summary:  Records an emitter in a cell and floods its light if it
+                is brighter than the cell
+
+      Args:     const XMUINT3& cell
+                  Voxel coordinates of the emitter
+                BYTE level
+                  Light level of the emitter
+
+      Modifies: [m_apSections, m_aPropagationQueues, m_abDirtyChunks,
+                 m_auDirtyChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::addEmitterLight(_In_ const XMUINT3& cell, _In_ BYTE level)
+    {
+        if (level <= ((GetLight(static_cast<INT>(cell.x), static_cast<INT>(cell.y), static_cast<INT>(cell.z)) >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL))
+        {
+            return;
+        }
+
+        setLevel(cell.x, cell.y, cell.z, BLOCK_SHIFT, level);
+        m_aPropagationQueues[1].push_back(LightNode{ .x = cell.x, .y = cell.y, .z = cell.z, .level = level });
+        propagateLight(BLOCK_SHIFT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::removeEmitterLight
+
+      Summary:  Removes the block light of a cell whose emitter left
+                and the light that came from it, then floods back in
+                the light of the emitters that remain
+
+      Args:     const XMUINT3& cell
+                  Voxel coordinates the emitter left
+
+      Modifies: [m_apSections, m_aRemovalQueues, m_aPropagationQueues,
+                 m_abDirtyChunks, m_auDirtyChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::removeEmitterLight(_In_ const XMUINT3& cell)
+    {
+        const BYTE level = (GetLight(static_cast<INT>(cell.x), static_cast<INT>(cell.y), static_cast<INT>(cell.z)) >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL;
+        if (level > 0u)
+        {
+            setLevel(cell.x, cell.y, cell.z, BLOCK_SHIFT, 0u);
+            m_aRemovalQueues[1].push_back(LightNode{ .x = cell.x, .y = cell.y, .z = cell.z, .level = level });
+            removeLight(BLOCK_SHIFT);
+        }
+
+        const BYTE emission = getEmission(cell.x, cell.y, cell.z);
+        if (emission > ((GetLight(static_cast<INT>(cell.x), static_cast<INT>(cell.y), static_cast<INT>(cell.z)) >> BLOCK_SHIFT) & MAX_LIGHT_LEVEL))
+        {
+            setLevel(cell.x, cell.y, cell.z, BLOCK_SHIFT, emission);
+            m_aPropagationQueues[1].push_back(LightNode{ .x = cell.x, .y = cell.y, .z = cell.z, .level = emission });
+        }
+        propagateLight(BLOCK_SHIFT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::beginUpdate
+
+      Summary:  Starts timing a change of the light
+
+      Modifies: [m_statistics, m_updateStartingTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::beginUpdate()
+    {
+        m_statistics.ullNumVisitedCells = 0u;
+        QueryPerformanceCounter(&m_updateStartingTime);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLightField::endUpdate
+
+      Summary:  Stops timing a change of the light
+
+      Modifies: [m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLightField::endUpdate()
+    {
+        LARGE_INTEGER endingTime, frequency;
+        QueryPerformanceCounter(&endingTime);
+        QueryPerformanceFrequency(&frequency);
+
+        m_statistics.updateMilliseconds = static_cast<DOUBLE>(endingTime.QuadPart - m_updateStartingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart);
+    }
+}
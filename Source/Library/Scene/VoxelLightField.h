@@ -0,0 +1,181 @@
+/*+===================================================================
+  File:      VOXELLIGHTFIELD.H
+
+  Summary:   VoxelLightField header file contains declarations of the
+             VoxelLightField class that floods sky and block light
+             through the voxels of a terrain for the lab samples of
+             Game Graphics Programming course.
+
+  Classes: VoxelLightField
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <deque>
+
+#include "Renderer/DataTypes.h"
+#include "Scene/VoxelColumnStore.h"
+#include "Scene/VoxelInstancePacker.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelLightStatistics
+
+      Summary:  Light emitters placed, sections of stored light, and
+                the cells the flood fills of the last change visited
+                and the time they took
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelLightStatistics
+    {
+        UINT uNumEmitters;
+        UINT uNumSections;
+        UINT64 ullNumVisitedCells;
+        DOUBLE updateMilliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelLightField
+
+      Summary:  Sky and block light of every cell of a column store,
+                four bits each, computed with breadth-first flood fills
+                that lose one level per step and stop at solid voxels.
+                Air at or above the highest solid voxel of its column
+                sees the sky at the full level and needs no storage;
+                everything else lives in sections of 16^3 cells that
+                are only allocated once a cell differs from that, so a
+                height map with no emitters stores nothing. Edits and
+                emitters update the light incrementally: light that
+                lost its source is removed by a flood fill that stops
+                where brighter light from elsewhere takes over, and
+                that light is then flooded back in. Chunks whose faces
+                may see changed light are marked for baking
+
+      Methods:  Create
+                  Floods the light of the whole store
+                SetBlockEmission
+                  Sets the light level a block type emits
+                OnBlockChanged
+                  Updates the light after a voxel of the store changed
+                AddEmitter
+                  Places a light emitter that is not a block
+                MoveEmitter
+                  Moves a light emitter
+                RemoveEmitter
+                  Removes a light emitter
+                GetLight
+                  Returns the sky and block light of a cell
+                BakeInstances
+                  Returns the light each face of packed instances sees
+                MarkChunkDirty
+                  Marks a chunk for baking
+                CollectDirtyChunks
+                  Returns and clears the chunks marked for baking
+                GetStatistics
+                  Returns the state of the last change
+                VoxelLightField
+                  Constructor.
+                ~VoxelLightField
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelLightField final
+    {
+    public:
+        static constexpr const BYTE MAX_LIGHT_LEVEL = 15u;
+        static constexpr const UINT SKY_SHIFT = 4u;
+        static constexpr const UINT BLOCK_SHIFT = 0u;
+        static constexpr const BYTE FULL_SKY = MAX_LIGHT_LEVEL << SKY_SHIFT;
+        static constexpr const UINT SECTION_SIZE = 16u;
+
+        VoxelLightField() = delete;
+        VoxelLightField(_In_ const VoxelColumnStore& columnStore, _In_ UINT uChunkSize);
+        VoxelLightField(const VoxelLightField& other) = delete;
+        VoxelLightField(VoxelLightField&& other) = delete;
+        VoxelLightField& operator=(const VoxelLightField& other) = delete;
+        VoxelLightField& operator=(VoxelLightField&& other) = delete;
+        ~VoxelLightField() = default;
+
+        void Create();
+        HRESULT SetBlockEmission(_In_ BYTE blockType, _In_ BYTE level);
+        void OnBlockChanged(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ BYTE oldBlockType);
+
+        HRESULT AddEmitter(_In_ const XMUINT3& cell, _In_ BYTE level, _Out_ UINT& uOutEmitter);
+        HRESULT MoveEmitter(_In_ UINT uEmitter, _In_ const XMUINT3& cell);
+        HRESULT RemoveEmitter(_In_ UINT uEmitter);
+
+        BYTE GetLight(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        void BakeInstances(
+            _In_reads_(uNumInstances) const PackedVoxelInstance* pInstances,
+            _In_ size_t uNumInstances,
+            _In_ UINT uChunk,
+            _Out_writes_(uNumInstances) PackedVoxelLight* pOutLights
+        ) const;
+
+        void MarkChunkDirty(_In_ UINT uChunk);
+        void CollectDirtyChunks(_Out_ std::vector<UINT>& auOutChunks);
+        const VoxelLightStatistics& GetStatistics() const;
+
+    private:
+        struct LightNode
+        {
+            UINT x;
+            UINT y;
+            UINT z;
+            BYTE level;
+        };
+
+        struct Emitter
+        {
+            XMUINT3 cell;
+            BYTE level;
+            BOOL bActive;
+        };
+
+        UINT64 getCellKey(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        void eraseEmitterCell(_In_ UINT uEmitter);
+        BOOL isSolid(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        BYTE getDefaultLight(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        BYTE getEmission(_In_ UINT x, _In_ UINT y, _In_ UINT z) const;
+        void setLevel(_In_ UINT x, _In_ UINT y, _In_ UINT z, _In_ UINT uShift, _In_ BYTE level);
+        void markCellDirty(_In_ UINT x, _In_ UINT z);
+
+        void removeLight(_In_ UINT uShift);
+        void propagateLight(_In_ UINT uShift);
+        void pushBrightNeighbours(_In_ UINT x, _In_ UINT y, _In_ UINT z);
+        void addEmitterLight(_In_ const XMUINT3& cell, _In_ BYTE level);
+        void removeEmitterLight(_In_ const XMUINT3& cell);
+
+        void beginUpdate();
+        void endUpdate();
+
+    private:
+        // Faces in the order the baked light packs them: -x, +x, -y,
+        // +y, -z, +z
+        static constexpr const INT ms_aaiNeighbourOffsets[6][3] =
+        {
+            { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 },
+        };
+
+    private:
+        const VoxelColumnStore& m_columnStore;
+        UINT m_uChunkSize;
+        UINT m_uNumChunksX;
+        UINT m_uNumSectionsX;
+        UINT m_uNumSectionsY;
+        UINT m_uNumSectionsZ;
+        BYTE m_aBlockEmissions[VoxelInstancePacker::MAX_NUM_BLOCK_TYPES];
+        std::vector<WORD> m_auSkyHeights;
+        std::vector<std::unique_ptr<BYTE[]>> m_apSections;
+        std::vector<Emitter> m_aEmitters;
+        std::unordered_multimap<UINT64, UINT> m_emitterCells;
+        std::deque<LightNode> m_aRemovalQueues[2];
+        std::deque<LightNode> m_aPropagationQueues[2];
+        std::vector<BOOL> m_abDirtyChunks;
+        std::vector<UINT> m_auDirtyChunks;
+        VoxelLightStatistics m_statistics;
+        LARGE_INTEGER m_updateStartingTime;
+    };
+}
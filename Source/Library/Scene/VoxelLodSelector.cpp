@@ -0,0 +1,245 @@
+#include "Scene/VoxelLodSelector.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::VoxelLodSelector
+
+      Summary:  Constructor
+
+      Args:     const VoxelLodDesc& lodDesc
+                  Distances of the levels of detail
+
+      Modifies: [m_lodDesc, m_aChunks, m_statistics].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelLodSelector::VoxelLodSelector(_In_ const VoxelLodDesc& lodDesc)
+        : m_lodDesc(lodDesc)
+        , m_aChunks()
+        , m_statistics{ .auNumChunks = { 0u, }, .uNumTransitions = 0u, .ullNumInstances = 0u }
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::AddChunk
+
+      Summary:  Adds the levels of detail of a chunk. A level is null
+                when the chunk has no voxels at it. The chunk starts at
+                full resolution
+
+      Args:     const std::shared_ptr<VoxelChunk> (&apLods)[NUM_LODS]
+                  Chunk at every level of detail
+                const BoundingBox& boundingBox
+                  World space bounds the distance is measured to
+
+      Modifies: [m_aChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLodSelector::AddChunk(_In_ const std::shared_ptr<VoxelChunk> (&apLods)[NUM_LODS], _In_ const BoundingBox& boundingBox)
+    {
+        ChunkLods chunkLods =
+        {
+            .apLods = {},
+            .boundingBox = boundingBox,
+            .uLod = 0u,
+        };
+        std::copy(std::begin(apLods), std::end(apLods), chunkLods.apLods);
+
+        m_aChunks.push_back(std::move(chunkLods));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::Initialize
+
+      Summary:  Creates the buffers of every level of every chunk, so
+                switching levels never creates resources
+
+      Args:     ID3D11Device* pDevice
+                  Pointer to a Direct3D 11 device
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelLodSelector::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        for (ChunkLods& chunkLods : m_aChunks)
+        {
+            for (std::shared_ptr<VoxelChunk>& pLod : chunkLods.apLods)
+            {
+                if (!pLod)
+                {
+                    continue;
+                }
+
+                HRESULT hr = pLod->Initialize(pDevice);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::Update
+
+      Summary:  Selects the level of every chunk from the distance
+                between the eye and its bounds
+
+      Args:     const XMFLOAT3& eye
+                  World position of the camera
+
+      Modifies: [m_aChunks, m_statistics].
+
+      Returns:  BOOL
+                  TRUE if any chunk switched level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelLodSelector::Update(_In_ const XMFLOAT3& eye)
+    {
+        m_statistics = VoxelLodStatistics{ .auNumChunks = { 0u, }, .uNumTransitions = 0u, .ullNumInstances = 0u };
+
+        const XMVECTOR eyePosition = XMLoadFloat3(&eye);
+        for (ChunkLods& chunkLods : m_aChunks)
+        {
+            // Distance to the closest point of the bounds
+            XMVECTOR center = XMLoadFloat3(&chunkLods.boundingBox.Center);
+            XMVECTOR extents = XMLoadFloat3(&chunkLods.boundingBox.Extents);
+            XMVECTOR outside = XMVectorMax(XMVectorSubtract(XMVectorAbs(XMVectorSubtract(eyePosition, center)), extents), XMVectorZero());
+            FLOAT distance = XMVectorGetX(XMVector3Length(outside));
+
+            UINT uLod = SelectLod(chunkLods.uLod, distance, m_lodDesc);
+            if (uLod != chunkLods.uLod)
+            {
+                chunkLods.uLod = uLod;
+                ++m_statistics.uNumTransitions;
+            }
+
+            if (chunkLods.apLods[uLod])
+            {
+                ++m_statistics.auNumChunks[uLod];
+                m_statistics.ullNumInstances += chunkLods.apLods[uLod]->GetNumInstances();
+            }
+        }
+
+        return m_statistics.uNumTransitions > 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::GetSelectedChunks
+
+      Summary:  Returns the selected level of every chunk that has
+                voxels at it
+
+      Args:     std::vector<std::shared_ptr<VoxelChunk>>& outChunks
+                  Chunks to draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLodSelector::GetSelectedChunks(_Out_ std::vector<std::shared_ptr<VoxelChunk>>& outChunks) const
+    {
+        outChunks.clear();
+        outChunks.reserve(m_aChunks.size());
+        for (const ChunkLods& chunkLods : m_aChunks)
+        {
+            if (chunkLods.apLods[chunkLods.uLod])
+            {
+                outChunks.push_back(chunkLods.apLods[chunkLods.uLod]);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::GetChunk
+
+      Summary:  Returns a level of detail of a chunk
+
+      Args:     UINT uChunk
+                  Index of the chunk in the order it was added
+                UINT uLod
+                  Level of detail
+
+      Returns:  const std::shared_ptr<VoxelChunk>&
+                  Chunk at the level, null if it has no voxels there
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<VoxelChunk>& VoxelLodSelector::GetChunk(_In_ UINT uChunk, _In_ UINT uLod) const
+    {
+        assert(uChunk < m_aChunks.size() && uLod < NUM_LODS);
+
+        return m_aChunks[uChunk].apLods[uLod];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::SetChunk
+
+      Summary:  Replaces a level of detail of a chunk, such as the full
+                resolution level after an edit. The distance to the
+                chunk is measured to the bounds of its full resolution
+                level, so they follow it
+
+      Args:     UINT uChunk
+                  Index of the chunk in the order it was added
+                UINT uLod
+                  Level of detail
+                const std::shared_ptr<VoxelChunk>& pChunk
+                  Initialized chunk at the level
+
+      Modifies: [m_aChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelLodSelector::SetChunk(_In_ UINT uChunk, _In_ UINT uLod, _In_ const std::shared_ptr<VoxelChunk>& pChunk)
+    {
+        assert(uChunk < m_aChunks.size() && uLod < NUM_LODS);
+
+        ChunkLods& chunkLods = m_aChunks[uChunk];
+        chunkLods.apLods[uLod] = pChunk;
+        if (uLod == 0u && pChunk)
+        {
+            chunkLods.boundingBox = pChunk->GetBoundingBox();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::GetStatistics
+
+      Summary:  Returns the levels selected by the last update
+
+      Returns:  const VoxelLodStatistics&
+                  Chunks per level, instances and transitions
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const VoxelLodStatistics& VoxelLodSelector::GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelLodSelector::SelectLod
+
+      Summary:  Returns the level of detail of a chunk at a distance.
+                Level l > 0 starts at lodDistance * 2^(l - 1). A chunk
+                only moves to a coarser level once it is past the start
+                by the hysteresis fraction, and back to a finer one once
+                it is that far before it, so it does not flicker
+                between two levels on the boundary
+
+      Args:     UINT uCurrentLod
+                  Level of the chunk in the last frame
+                FLOAT distance
+                  Distance from the camera to the chunk
+                const VoxelLodDesc& lodDesc
+                  Distances of the levels of detail
+
+      Returns:  UINT
+                  Level of the chunk
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelLodSelector::SelectLod(_In_ UINT uCurrentLod, _In_ FLOAT distance, _In_ const VoxelLodDesc& lodDesc)
+    {
+        UINT uLod = std::min<UINT>(uCurrentLod, NUM_LODS - 1u);
+        while (uLod + 1u < NUM_LODS && distance > lodDesc.lodDistance * static_cast<FLOAT>(1u << uLod) * (1.0f + lodDesc.hysteresis))
+        {
+            ++uLod;
+        }
+        while (uLod > 0u && distance < lodDesc.lodDistance * static_cast<FLOAT>(1u << (uLod - 1u)) * (1.0f - lodDesc.hysteresis))
+        {
+            --uLod;
+        }
+
+        return uLod;
+    }
+}
@@ -0,0 +1,123 @@
+/*+===================================================================
+  File:      VOXELLODSELECTOR.H
+
+  Summary:   VoxelLodSelector header file contains declarations of the
+             VoxelLodSelector class that picks the level of detail of
+             every voxel chunk by its distance from the camera for the
+             lab samples of Game Graphics Programming course.
+
+  Classes: VoxelLodSelector
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/VoxelChunk.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelLodDesc
+
+      Summary:  Distance from the camera where the first downsampled
+                level starts, every further level starting at twice the
+                distance of the previous one, and the fraction of that
+                distance a chunk must move past it before it switches
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelLodDesc
+    {
+        FLOAT lodDistance;
+        FLOAT hysteresis;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelLodStatistics
+
+      Summary:  Number of chunks drawn at every level of detail, the
+                instances they hold and the number of chunks that
+                switched level in the last update
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelLodStatistics
+    {
+        UINT auNumChunks[4];
+        UINT uNumTransitions;
+        UINT64 ullNumInstances;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelLodSelector
+
+      Summary:  Holds every level of detail of every voxel chunk, from
+                full resolution to voxels 8 times larger, and selects
+                one level per chunk from the distance between the
+                camera and the bounds of the chunk. The distance where
+                a level starts doubles with every level, so the
+                instances of a chunk fall with the square of its
+                distance
+
+      Methods:  AddChunk
+                  Adds the levels of detail of a chunk
+                Initialize
+                  Creates the buffers of every level of every chunk
+                Update
+                  Selects the level of every chunk
+                GetSelectedChunks
+                  Returns the selected level of every chunk
+                GetChunk
+                  Returns a level of detail of a chunk
+                SetChunk
+                  Replaces a level of detail of a chunk
+                GetStatistics
+                  Returns the levels selected by the last update
+                SelectLod
+                  Returns the level for a distance
+                VoxelLodSelector
+                  Constructor.
+                ~VoxelLodSelector
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelLodSelector final
+    {
+    public:
+        static constexpr const UINT NUM_LODS = 4u;
+        static constexpr const VoxelLodDesc DEFAULT_LOD_DESC =
+        {
+            .lodDistance = 128.0f,
+            .hysteresis = 0.1f,
+        };
+
+        explicit VoxelLodSelector(_In_ const VoxelLodDesc& lodDesc);
+        VoxelLodSelector(const VoxelLodSelector& other) = delete;
+        VoxelLodSelector(VoxelLodSelector&& other) = delete;
+        VoxelLodSelector& operator=(const VoxelLodSelector& other) = delete;
+        VoxelLodSelector& operator=(VoxelLodSelector&& other) = delete;
+        ~VoxelLodSelector() = default;
+
+        void AddChunk(_In_ const std::shared_ptr<VoxelChunk> (&apLods)[NUM_LODS], _In_ const BoundingBox& boundingBox);
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        BOOL Update(_In_ const XMFLOAT3& eye);
+
+        void GetSelectedChunks(_Out_ std::vector<std::shared_ptr<VoxelChunk>>& outChunks) const;
+        const std::shared_ptr<VoxelChunk>& GetChunk(_In_ UINT uChunk, _In_ UINT uLod) const;
+        void SetChunk(_In_ UINT uChunk, _In_ UINT uLod, _In_ const std::shared_ptr<VoxelChunk>& pChunk);
+        const VoxelLodStatistics& GetStatistics() const;
+
+        static UINT SelectLod(_In_ UINT uCurrentLod, _In_ FLOAT distance, _In_ const VoxelLodDesc& lodDesc);
+
+    private:
+        struct ChunkLods
+        {
+            std::shared_ptr<VoxelChunk> apLods[NUM_LODS];
+            BoundingBox boundingBox;
+            UINT uLod;
+        };
+
+        VoxelLodDesc m_lodDesc;
+        std::vector<ChunkLods> m_aChunks;
+        VoxelLodStatistics m_statistics;
+    };
+
+    static_assert(sizeof(VoxelLodStatistics::auNumChunks) / sizeof(UINT) == VoxelLodSelector::NUM_LODS);
+}
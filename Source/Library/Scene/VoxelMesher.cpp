@@ -0,0 +1,418 @@
+#include "Scene/VoxelMesher.h"
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::VoxelMesher
+
+      Summary:  Constructor
+
+      Args:     const HeightMapDesc& heightMap
+                  View over the columns of the height map. The columns
+                  must stay valid while chunks are meshed
+                UINT uChunkSize
+                  Number of columns along a chunk side, clamped to
+                  [1, MAX_CHUNK_SIZE]
+
+      Modifies: [m_heightMap, m_uChunkSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelMesher::VoxelMesher(_In_ const HeightMapDesc& heightMap, _In_ UINT uChunkSize)
+        : m_heightMap(heightMap)
+        , m_uChunkSize(std::min<UINT>(std::max<UINT>(uChunkSize, 1u), MAX_CHUNK_SIZE))
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::MeshChunk
+
+      Summary:  Sweeps the faces between every pair of neighbouring
+                cells of the chunk along each axis. Faces between a
+                solid and an empty cell are masked per slice and merged
+                into the largest rectangles of one block type and
+                direction. Neighbours outside the chunk are read from
+                the height map, columns outside the map are empty and
+                the floor below the lowest layer is covered
+
+      Args:     UINT uChunkX
+                  Chunk index along x
+                UINT uChunkZ
+                  Chunk index along z
+                VoxelChunkMeshData& outMesh
+                  Merged quads of the chunk
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the chunk is outside the
+                  map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VoxelMesher::MeshChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_ VoxelChunkMeshData& outMesh) const
+    {
+        outMesh.uChunkX = uChunkX;
+        outMesh.uChunkZ = uChunkZ;
+        outMesh.aVertices.clear();
+        outMesh.aIndices.clear();
+        outMesh.aSections.clear();
+
+        if (uChunkX >= GetNumChunksX() || uChunkZ >= GetNumChunksZ())
+        {
+            return E_INVALIDARG;
+        }
+
+        const UINT uBeginX = uChunkX * m_uChunkSize;
+        const UINT uBeginZ = uChunkZ * m_uChunkSize;
+        const UINT uSizeX = std::min<UINT>(m_uChunkSize, m_heightMap.uWidth - uBeginX);
+        const UINT uSizeZ = std::min<UINT>(m_uChunkSize, m_heightMap.uDepth - uBeginZ);
+
+        outMesh.origin = XMFLOAT3(
+            2.0f * static_cast<FLOAT>(uBeginX) - static_cast<FLOAT>(m_heightMap.uWidth) - 1.0f,
+            -2.0f * static_cast<FLOAT>(m_heightMap.uHeight) + (static_cast<FLOAT>(m_heightMap.uHeight) * 0.75f) - 1.0f,
+            2.0f * static_cast<FLOAT>(uBeginZ) - static_cast<FLOAT>(m_heightMap.uDepth) - 1.0f
+        );
+
+        UINT uSizeY = 0u;
+        for (UINT z = uBeginZ; z < uBeginZ + uSizeZ; ++z)
+        {
+            for (UINT x = uBeginX; x < uBeginX + uSizeX; ++x)
+            {
+                uSizeY = std::max<UINT>(uSizeY, getColumnHeight(x, z));
+            }
+        }
+
+        if (uSizeY == 0u)
+        {
+            return S_OK;
+        }
+
+        struct Quad
+        {
+            UINT uAxis;
+            BOOL bPositive;
+            INT aCorner[3];
+            INT aExtent[3];
+        };
+        std::vector<std::vector<Quad>> aQuadsPerBlockType(m_heightMap.uNumColors);
+
+        const INT aBegin[3] = { static_cast<INT>(uBeginX), 0, static_cast<INT>(uBeginZ) };
+        const INT aSize[3] = { static_cast<INT>(uSizeX), static_cast<INT>(uSizeY), static_cast<INT>(uSizeZ) };
+
+        // Mask entries are the block type + 1 of a face, negated for
+        // faces that look down the axis
+        std::vector<INT> aMask;
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            const UINT u = (uAxis + 1u) % 3u;
+            const UINT v = (uAxis + 2u) % 3u;
+            aMask.resize(static_cast<size_t>(aSize[u]) * static_cast<size_t>(aSize[v]));
+
+            for (INT slice = 0; slice <= aSize[uAxis]; ++slice)
+            {
+                INT aCell[3];
+                aCell[uAxis] = aBegin[uAxis] + slice;
+                for (INT j = 0; j < aSize[v]; ++j)
+                {
+                    aCell[v] = aBegin[v] + j;
+                    for (INT i = 0; i < aSize[u]; ++i)
+                    {
+                        aCell[u] = aBegin[u] + i;
+
+                        INT aBehind[3] = { aCell[0], aCell[1], aCell[2] };
+                        --aBehind[uAxis];
+
+                        BOOL bBehindSolid = isSolid(aBehind[0], aBehind[1], aBehind[2]);
+                        BOOL bFrontSolid = isSolid(aCell[0], aCell[1], aCell[2]);
+
+                        INT& mask = aMask[static_cast<size_t>(j) * aSize[u] + i];
+                        mask = 0;
+                        if (bBehindSolid && !bFrontSolid && slice > 0)
+                        {
+                            mask = m_heightMap.pBlockTypes[static_cast<size_t>(aBehind[2]) * m_heightMap.uWidth + aBehind[0]] + 1;
+                        }
+                        else if (!bBehindSolid && bFrontSolid && slice < aSize[uAxis])
+                        {
+                            mask = -(m_heightMap.pBlockTypes[static_cast<size_t>(aCell[2]) * m_heightMap.uWidth + aCell[0]] + 1);
+                        }
+                    }
+                }
+
+                for (INT j = 0; j < aSize[v]; ++j)
+                {
+                    for (INT i = 0; i < aSize[u]; )
+                    {
+                        const INT mask = aMask[static_cast<size_t>(j) * aSize[u] + i];
+                        if (mask == 0)
+                        {
+                            ++i;
+                            continue;
+                        }
+
+                        INT width = 1;
+                        while (i + width < aSize[u] && aMask[static_cast<size_t>(j) * aSize[u] + i + width] == mask)
+                        {
+                            ++width;
+                        }
+
+                        INT height = 1;
+                        for (; j + height < aSize[v]; ++height)
+                        {
+                            BOOL bRowMatches = TRUE;
+                            for (INT k = 0; k < width && bRowMatches; ++k)
+                            {
+                                bRowMatches = aMask[static_cast<size_t>(j + height) * aSize[u] + i + k] == mask;
+                            }
+
+                            if (!bRowMatches)
+                            {
+                                break;
+                            }
+                        }
+
+                        Quad quad =
+                        {
+                            .uAxis = uAxis,
+                            .bPositive = mask > 0,
+                            .aCorner = { 0, 0, 0 },
+                            .aExtent = { 0, 0, 0 },
+                        };
+                        quad.aCorner[uAxis] = slice;
+                        quad.aCorner[u] = i;
+                        quad.aCorner[v] = j;
+                        quad.aExtent[u] = width;
+                        quad.aExtent[v] = height;
+                        aQuadsPerBlockType[static_cast<size_t>(mask > 0 ? mask : -mask) - 1u].push_back(quad);
+
+                        for (INT l = 0; l < height; ++l)
+                        {
+                            std::fill_n(aMask.begin() + static_cast<size_t>(j + l) * aSize[u] + i, width, 0);
+                        }
+                        i += width;
+                    }
+                }
+            }
+        }
+
+        size_t uNumQuads = 0u;
+        for (const std::vector<Quad>& aQuads : aQuadsPerBlockType)
+        {
+            uNumQuads += aQuads.size();
+        }
+        assert(uNumQuads * 4u <= 0x10000u);
+
+        outMesh.aVertices.reserve(uNumQuads * 4u);
+        outMesh.aIndices.reserve(uNumQuads * 6u);
+
+        for (UINT uBlockType = 0u; uBlockType < m_heightMap.uNumColors; ++uBlockType)
+        {
+            const std::vector<Quad>& aQuads = aQuadsPerBlockType[uBlockType];
+            if (aQuads.empty())
+            {
+                continue;
+            }
+
+            outMesh.aSections.push_back(
+                VoxelChunkMeshSection
+                {
+                    .uBlockType = uBlockType,
+                    .uBaseIndex = static_cast<UINT>(outMesh.aIndices.size()),
+                    .uNumIndices = static_cast<UINT>(aQuads.size() * 6u),
+                }
+            );
+
+            for (const Quad& quad : aQuads)
+            {
+                const UINT u = (quad.uAxis + 1u) % 3u;
+                const UINT v = (quad.uAxis + 2u) % 3u;
+
+                // Front faces wind clockwise, so the first edge runs
+                // along u for faces looking up the axis and along v
+                // for faces looking down it
+                INT aFirstEdge[3] = { 0, 0, 0 };
+                INT aSecondEdge[3] = { 0, 0, 0 };
+                aFirstEdge[quad.bPositive ? u : v] = quad.aExtent[quad.bPositive ? u : v];
+                aSecondEdge[quad.bPositive ? v : u] = quad.aExtent[quad.bPositive ? v : u];
+
+                XMFLOAT3 normal(0.0f, 0.0f, 0.0f);
+                (&normal.x)[quad.uAxis] = quad.bPositive ? 1.0f : -1.0f;
+
+                const WORD baseVertex = static_cast<WORD>(outMesh.aVertices.size());
+                for (UINT uCorner = 0u; uCorner < 4u; ++uCorner)
+                {
+                    INT aPosition[3] = { quad.aCorner[0], quad.aCorner[1], quad.aCorner[2] };
+                    for (UINT uComponent = 0u; uComponent < 3u; ++uComponent)
+                    {
+                        aPosition[uComponent] += (uCorner == 1u || uCorner == 2u ? aFirstEdge[uComponent] : 0)
+                            + (uCorner >= 2u ? aSecondEdge[uComponent] : 0);
+                    }
+
+                    outMesh.aVertices.push_back(
+                        SimpleVertex
+                        {
+                            .Position = XMFLOAT3(2.0f * static_cast<FLOAT>(aPosition[0]), 2.0f * static_cast<FLOAT>(aPosition[1]), 2.0f * static_cast<FLOAT>(aPosition[2])),
+                            .TexCoord = XMFLOAT2(static_cast<FLOAT>(aPosition[u] - quad.aCorner[u]), static_cast<FLOAT>(aPosition[v] - quad.aCorner[v])),
+                            .Normal = normal,
+                        }
+                    );
+                }
+
+                const WORD aQuadIndices[] = { 0u, 1u, 2u, 0u, 2u, 3u };
+                for (WORD index : aQuadIndices)
+                {
+                    outMesh.aIndices.push_back(static_cast<WORD>(baseVertex + index));
+                }
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::MeshAllChunks
+
+      Summary:  Meshes every chunk of the height map on the thread
+                pool. Chunks are stored row by row along x
+
+      Args:     std::vector<VoxelChunkMeshData>& aOutMeshes
+                  Meshes of all chunks, including empty ones
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelMesher::MeshAllChunks(_Out_ std::vector<VoxelChunkMeshData>& aOutMeshes) const
+    {
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&startingTime);
+
+        const UINT uNumChunksX = GetNumChunksX();
+        aOutMeshes.clear();
+        aOutMeshes.resize(static_cast<size_t>(uNumChunksX) * GetNumChunksZ());
+
+        ThreadPool::GetDefault().ParallelFor(
+            0u,
+            aOutMeshes.size(),
+            1u,
+            [this, &aOutMeshes, uNumChunksX](size_t uBeginChunk, size_t uEndChunk)
+            {
+                for (size_t uChunk = uBeginChunk; uChunk < uEndChunk; ++uChunk)
+                {
+                    MeshChunk(static_cast<UINT>(uChunk % uNumChunksX), static_cast<UINT>(uChunk / uNumChunksX), aOutMeshes[uChunk]);
+                }
+            }
+        );
+
+        QueryPerformanceCounter(&endingTime);
+
+        size_t uNumVertices = 0u;
+        size_t uNumIndices = 0u;
+        for (const VoxelChunkMeshData& mesh : aOutMeshes)
+        {
+            uNumVertices += mesh.aVertices.size();
+            uNumIndices += mesh.aIndices.size();
+        }
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "VoxelMesher: meshed %zu chunk(s) into %zu vertices and %zu indices in %.2f ms\n",
+            aOutMeshes.size(),
+            uNumVertices,
+            uNumIndices,
+            static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) * 1000.0 / static_cast<DOUBLE>(frequency.QuadPart)
+        );
+        OutputDebugStringA(szDebugMessage);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::GetChunkSize
+
+      Summary:  Returns the number of columns along a chunk side
+
+      Returns:  UINT
+                  Chunk size
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesher::GetChunkSize() const
+    {
+        return m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::GetNumChunksX
+
+      Summary:  Returns the number of chunks along x
+
+      Returns:  UINT
+                  Number of chunks along x
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesher::GetNumChunksX() const
+    {
+        return (m_heightMap.uWidth + m_uChunkSize - 1u) / m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::GetNumChunksZ
+
+      Summary:  Returns the number of chunks along z
+
+      Returns:  UINT
+                  Number of chunks along z
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT VoxelMesher::GetNumChunksZ() const
+    {
+        return (m_heightMap.uDepth + m_uChunkSize - 1u) / m_uChunkSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::isSolid
+
+      Summary:  Returns whether a cell holds a voxel. Cells below the
+                floor count as solid, cells outside the map as empty
+
+      Args:     INT x
+                  Cell x
+                INT y
+                  Cell y
+                INT z
+                  Cell z
+
+      Returns:  BOOL
+                  TRUE if the cell is solid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelMesher::isSolid(_In_ INT x, _In_ INT y, _In_ INT z) const
+    {
+        if (y < 0)
+        {
+            return TRUE;
+        }
+
+        if (x < 0 || z < 0 || x >= static_cast<INT>(m_heightMap.uWidth) || z >= static_cast<INT>(m_heightMap.uDepth))
+        {
+            return FALSE;
+        }
+
+        return y < getColumnHeight(static_cast<UINT>(x), static_cast<UINT>(z));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelMesher::getColumnHeight
+
+      Summary:  Returns the height of a column, zero if its block type
+                is not in the palette
+
+      Args:     UINT x
+                  Column x
+                UINT z
+                  Column z
+
+      Returns:  WORD
+                  Number of voxels in the column
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WORD VoxelMesher::getColumnHeight(_In_ UINT x, _In_ UINT z) const
+    {
+        size_t uColumnIdx = static_cast<size_t>(z) * m_heightMap.uWidth + x;
+        if (m_heightMap.pBlockTypes[uColumnIdx] >= m_heightMap.uNumColors)
+        {
+            return 0u;
+        }
+
+        return m_heightMap.pColumnHeights[uColumnIdx];
+    }
+}
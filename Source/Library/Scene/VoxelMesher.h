@@ -0,0 +1,113 @@
+/*+===================================================================
+  File:      VOXELMESHER.H
+
+  Summary:   VoxelMesher header file contains declarations of the
+             VoxelMesher class that greedy-meshes chunks of a height
+             map for the lab samples of Game Graphics Programming
+             course.
+
+  Classes: VoxelMesher
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Scene/HeightMap.h"
+
+namespace library
+{
+    enum class eVoxelMeshingMode : BYTE
+    {
+        INSTANCED_CUBES = 0,
+        GREEDY_MESH,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelChunkMeshSection
+
+      Summary:  Range of indices of one block type inside a chunk mesh
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelChunkMeshSection
+    {
+        UINT uBlockType;
+        UINT uBaseIndex;
+        UINT uNumIndices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelChunkMeshData
+
+      Summary:  Merged quads of one chunk. Vertex positions are relative
+                to the origin, the world position of the chunk's lowest
+                corner. Indices are grouped into one section per block
+                type
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelChunkMeshData
+    {
+        UINT uChunkX;
+        UINT uChunkZ;
+        XMFLOAT3 origin;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<WORD> aIndices;
+        std::vector<VoxelChunkMeshSection> aSections;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelMesher
+
+      Summary:  Splits a height map into square chunks of columns and
+                turns the exposed faces of every chunk into quads merged
+                per face direction and block type (greedy meshing).
+                Works on the CPU only, without a Direct3D device
+
+      Methods:  MeshChunk
+                  Meshes one chunk
+                MeshAllChunks
+                  Meshes every chunk on the thread pool
+                GetChunkSize
+                  Returns the number of columns along a chunk side
+                GetNumChunksX
+                  Returns the number of chunks along x
+                GetNumChunksZ
+                  Returns the number of chunks along z
+                VoxelMesher
+                  Constructor.
+                ~VoxelMesher
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelMesher final
+    {
+    public:
+        static constexpr const UINT DEFAULT_CHUNK_SIZE = 32u;
+
+        // A height map column exposes at most one top and four side
+        // quads, so 48x48 columns always fit in 16-bit indices
+        static constexpr const UINT MAX_CHUNK_SIZE = 48u;
+
+        VoxelMesher(_In_ const HeightMapDesc& heightMap, _In_ UINT uChunkSize);
+        VoxelMesher(const VoxelMesher& other) = delete;
+        VoxelMesher(VoxelMesher&& other) = delete;
+        VoxelMesher& operator=(const VoxelMesher& other) = delete;
+        VoxelMesher& operator=(VoxelMesher&& other) = delete;
+        ~VoxelMesher() = default;
+
+        HRESULT MeshChunk(_In_ UINT uChunkX, _In_ UINT uChunkZ, _Out_ VoxelChunkMeshData& outMesh) const;
+        void MeshAllChunks(_Out_ std::vector<VoxelChunkMeshData>& aOutMeshes) const;
+
+        UINT GetChunkSize() const;
+        UINT GetNumChunksX() const;
+        UINT GetNumChunksZ() const;
+
+    private:
+        BOOL isSolid(_In_ INT x, _In_ INT y, _In_ INT z) const;
+        WORD getColumnHeight(_In_ UINT x, _In_ UINT z) const;
+
+    private:
+        HeightMapDesc m_heightMap;
+        UINT m_uChunkSize;
+    };
+}
@@ -0,0 +1,381 @@
+#include "Scene/VoxelRaycaster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRaycaster::VoxelRaycaster
+
+      Summary:  Constructor. Voxel (x, y, z) is drawn as a cube of edge
+                two centered at (2x - W, 2y - 1.25H, 2z - D), so grid
+                coordinates are half of the world position moved by
+                the offset
+
+      Args:     const VoxelColumnStore& columnStore
+                  Voxels to cast rays against
+
+      Modifies: [m_columnStore, m_gridOffset].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelRaycaster::VoxelRaycaster(_In_ const VoxelColumnStore& columnStore)
+        : m_columnStore(columnStore)
+        , m_gridOffset(
+            static_cast<FLOAT>(columnStore.GetWidth()) + 1.0f,
+            static_cast<FLOAT>(columnStore.GetHeight()) * 1.25f + 1.0f,
+            static_cast<FLOAT>(columnStore.GetDepth()) + 1.0f
+        )
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRaycaster::Raycast
+
+      Summary:  Finds the first solid voxel along a world space ray.
+                The ray is clipped to the grid, then steps from cell to
+                cell through the nearest face; a cell above the top of
+                its column skips to the next column when the ray cannot
+                dip below the top before leaving it
+
+      Args:     const XMFLOAT3& origin
+                  World space origin of the ray
+                const XMFLOAT3& direction
+                  World space direction of the ray
+                FLOAT maxDistance
+                  Length of the ray in world units
+                VoxelRayHit& outHit
+                  First solid voxel, bHit is FALSE if there is none
+
+      Returns:  BOOL
+                  TRUE if the ray hits a solid voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL VoxelRaycaster::Raycast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& outHit) const
+    {
+        outHit = VoxelRayHit
+        {
+            .bHit = FALSE,
+            .voxel = XMUINT3(0u, 0u, 0u),
+            .blockType = VoxelColumnStore::EMPTY_BLOCK,
+            .distance = 0.0f,
+            .normal = XMINT3(0, 0, 0),
+        };
+
+        const FLOAT length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        if (length == 0.0f || !(maxDistance >= 0.0f))
+        {
+            return FALSE;
+        }
+
+        // Grid position at world distance t is afOrigin + afDirection * t
+        const FLOAT afOrigin[3] =
+        {
+            (origin.x + m_gridOffset.x) * 0.5f,
+            (origin.y + m_gridOffset.y) * 0.5f,
+            (origin.z + m_gridOffset.z) * 0.5f,
+        };
+        const FLOAT afDirection[3] =
+        {
+            direction.x / length * 0.5f,
+            direction.y / length * 0.5f,
+            direction.z / length * 0.5f,
+        };
+        const INT aiSize[3] =
+        {
+            static_cast<INT>(m_columnStore.GetWidth()),
+            static_cast<INT>(m_columnStore.GetHeight()),
+            static_cast<INT>(m_columnStore.GetDepth()),
+        };
+        if (aiSize[0] == 0 || aiSize[1] == 0 || aiSize[2] == 0)
+        {
+            return FALSE;
+        }
+
+        // Clip the ray to the grid
+        FLOAT tEnter = 0.0f;
+        FLOAT tExit = maxDistance;
+        INT iAxis = -1;
+        for (INT i = 0; i < 3; ++i)
+        {
+            if (afDirection[i] == 0.0f)
+            {
+                if (afOrigin[i] < 0.0f || afOrigin[i] >= static_cast<FLOAT>(aiSize[i]))
+                {
+                    return FALSE;
+                }
+                continue;
+            }
+
+            FLOAT tNear = (0.0f - afOrigin[i]) / afDirection[i];
+            FLOAT tFar = (static_cast<FLOAT>(aiSize[i]) - afOrigin[i]) / afDirection[i];
+            if (tNear > tFar)
+            {
+                std::swap(tNear, tFar);
+            }
+            if (tNear > tEnter)
+            {
+                tEnter = tNear;
+                iAxis = i;
+            }
+            tExit = std::min<FLOAT>(tExit, tFar);
+        }
+
+        if (tEnter > tExit)
+        {
+            return FALSE;
+        }
+
+        INT aiVoxel[3];
+        INT aiStep[3];
+        FLOAT aTMax[3];
+        FLOAT aTDelta[3];
+        for (INT i = 0; i < 3; ++i)
+        {
+            FLOAT position = std::floor(afOrigin[i] + afDirection[i] * tEnter);
+            aiVoxel[i] = static_cast<INT>(std::clamp<FLOAT>(position, 0.0f, static_cast<FLOAT>(aiSize[i] - 1)));
+            if (i == iAxis)
+            {
+                aiVoxel[i] = afDirection[i] > 0.0f ? 0 : aiSize[i] - 1;
+            }
+
+            if (afDirection[i] == 0.0f)
+            {
+                aiStep[i] = 0;
+                aTMax[i] = std::numeric_limits<FLOAT>::infinity();
+                aTDelta[i] = std::numeric_limits<FLOAT>::infinity();
+                continue;
+            }
+
+            aiStep[i] = afDirection[i] > 0.0f ? 1 : -1;
+            FLOAT boundary = static_cast<FLOAT>(afDirection[i] > 0.0f ? aiVoxel[i] + 1 : aiVoxel[i]);
+            aTMax[i] = (boundary - afOrigin[i]) / afDirection[i];
+            aTDelta[i] = std::abs(1.0f / afDirection[i]);
+        }
+
+        FLOAT t = tEnter;
+        for (;;)
+        {
+            const UINT x = static_cast<UINT>(aiVoxel[0]);
+            const UINT y = static_cast<UINT>(aiVoxel[1]);
+            const UINT z = static_cast<UINT>(aiVoxel[2]);
+            const FLOAT columnHeight = static_cast<FLOAT>(m_columnStore.GetColumnHeight(x, z));
+
+            if (static_cast<FLOAT>(y) < columnHeight)
+            {
+                BYTE blockType = m_columnStore.GetBlockType(x, y, z);
+                if (blockType != VoxelColumnStore::EMPTY_BLOCK)
+                {
+                    INT aiNormal[3] = { 0, 0, 0 };
+                    if (iAxis >= 0)
+                    {
+                        aiNormal[iAxis] = -aiStep[iAxis];
+                    }
+
+                    outHit = VoxelRayHit
+                    {
+                        .bHit = TRUE,
+                        .voxel = XMUINT3(x, y, z),
+                        .blockType = blockType,
+                        .distance = t,
+                        .normal = XMINT3(aiNormal[0], aiNormal[1], aiNormal[2]),
+                    };
+                    return TRUE;
+                }
+            }
+            else
+            {
+                // Above the column: if the ray is still above its top
+                // where it leaves the column, every cell up to there is
+                // air
+                const FLOAT tColumnExit = std::min<FLOAT>(aTMax[0], aTMax[2]);
+                const FLOAT tLeave = std::min<FLOAT>(tColumnExit, tExit);
+                if (afDirection[1] >= 0.0f || afOrigin[1] + afDirection[1] * tLeave >= columnHeight)
+                {
+                    if (tColumnExit > tExit)
+                    {
+                        return FALSE;
+                    }
+
+                    while (aTMax[1] < tColumnExit)
+                    {
+                        aiVoxel[1] += aiStep[1];
+                        aTMax[1] += aTDelta[1];
+                    }
+                    if (aiVoxel[1] < 0 || aiVoxel[1] >= aiSize[1])
+                    {
+                        return FALSE;
+                    }
+
+                    iAxis = aTMax[0] < aTMax[2] ? 0 : 2;
+                    t = aTMax[iAxis];
+                    aiVoxel[iAxis] += aiStep[iAxis];
+                    if (aiVoxel[iAxis] < 0 || aiVoxel[iAxis] >= aiSize[iAxis])
+                    {
+                        return FALSE;
+                    }
+                    aTMax[iAxis] += aTDelta[iAxis];
+                    continue;
+                }
+            }
+
+            // Step through the nearest face of the cell
+            iAxis = aTMax[0] < aTMax[1] ? (aTMax[0] < aTMax[2] ? 0 : 2) : (aTMax[1] < aTMax[2] ? 1 : 2);
+            t = aTMax[iAxis];
+            if (t > tExit)
+            {
+                return FALSE;
+            }
+
+            aiVoxel[iAxis] += aiStep[iAxis];
+            if (aiVoxel[iAxis] < 0 || aiVoxel[iAxis] >= aiSize[iAxis])
+            {
+                return FALSE;
+            }
+            aTMax[iAxis] += aTDelta[iAxis];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRaycaster::RaycastBatch
+
+      Summary:  Casts rays in batches across the worker threads of the
+                default thread pool
+
+      Args:     const VoxelRay* pRays
+                  Rays to cast
+                size_t uNumRays
+                  Number of rays
+                VoxelRayHit* pOutHits
+                  First solid voxel along every ray
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelRaycaster::RaycastBatch(_In_reads_(uNumRays) const VoxelRay* pRays, _In_ size_t uNumRays, _Out_writes_(uNumRays) VoxelRayHit* pOutHits) const
+    {
+        ThreadPool& threadPool = ThreadPool::GetDefault();
+        size_t uBatchSize = std::max<size_t>(uNumRays / ((threadPool.GetNumThreads() + 1u) * 4u), 1u);
+
+        threadPool.ParallelFor(0u, uNumRays, uBatchSize, [this, pRays, pOutHits](size_t uBegin, size_t uEnd)
+        {
+            for (size_t uRay = uBegin; uRay < uEnd; ++uRay)
+            {
+                Raycast(pRays[uRay].origin, pRays[uRay].direction, pRays[uRay].maxDistance, pOutHits[uRay]);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRaycaster::GetVoxelBounds
+
+      Summary:  Returns the world space bounds of a voxel, such as the
+                one a ray hit
+
+      Args:     const XMUINT3& voxel
+                  Voxel coordinates
+
+      Returns:  BoundingBox
+                  Cube the voxel is drawn as
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BoundingBox VoxelRaycaster::GetVoxelBounds(_In_ const XMUINT3& voxel) const
+    {
+        return BoundingBox(
+            XMFLOAT3(
+                2.0f * static_cast<FLOAT>(voxel.x) + 1.0f - m_gridOffset.x,
+                2.0f * static_cast<FLOAT>(voxel.y) + 1.0f - m_gridOffset.y,
+                2.0f * static_cast<FLOAT>(voxel.z) + 1.0f - m_gridOffset.z
+            ),
+            XMFLOAT3(1.0f, 1.0f, 1.0f)
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelRaycaster::MeasureThroughput
+
+      Summary:  Casts rays from a point in random directions one after
+                another and as one batch, and logs the time of both
+
+      Args:     const XMFLOAT3& origin
+                  World space origin of every ray
+                UINT uNumRays
+                  Number of rays
+                FLOAT maxDistance
+                  Length of every ray in world units
+
+      Returns:  VoxelRaycastStatistics
+                  Time per ray, time of the batch and number of hits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelRaycastStatistics VoxelRaycaster::MeasureThroughput(_In_ const XMFLOAT3& origin, _In_ UINT uNumRays, _In_ FLOAT maxDistance) const
+    {
+        std::vector<VoxelRay> aRays;
+        aRays.reserve(uNumRays);
+
+        std::mt19937 generator(0u);
+        std::normal_distribution<FLOAT> distribution(0.0f, 1.0f);
+        for (UINT uRay = 0u; uRay < uNumRays; ++uRay)
+        {
+            XMFLOAT3 direction(distribution(generator), distribution(generator), distribution(generator));
+            aRays.push_back(VoxelRay{ .origin = origin, .direction = direction, .maxDistance = maxDistance });
+        }
+
+        std::vector<VoxelRayHit> aSingleHits(uNumRays);
+        std::vector<VoxelRayHit> aBatchHits(uNumRays);
+
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER startingTime;
+        LARGE_INTEGER endingTime;
+        QueryPerformanceFrequency(&frequency);
+
+        QueryPerformanceCounter(&startingTime);
+        for (UINT uRay = 0u; uRay < uNumRays; ++uRay)
+        {
+            Raycast(aRays[uRay].origin, aRays[uRay].direction, aRays[uRay].maxDistance, aSingleHits[uRay]);
+        }
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE singleSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        QueryPerformanceCounter(&startingTime);
+        RaycastBatch(aRays.data(), aRays.size(), aBatchHits.data());
+        QueryPerformanceCounter(&endingTime);
+        DOUBLE batchSeconds = static_cast<DOUBLE>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<DOUBLE>(frequency.QuadPart);
+
+        UINT uNumHits = 0u;
+        UINT uNumMismatches = 0u;
+        for (UINT uRay = 0u; uRay < uNumRays; ++uRay)
+        {
+            const VoxelRayHit& singleHit = aSingleHits[uRay];
+            const VoxelRayHit& batchHit = aBatchHits[uRay];
+            if (singleHit.bHit)
+            {
+                ++uNumHits;
+            }
+            if (singleHit.bHit != batchHit.bHit || singleHit.voxel.x != batchHit.voxel.x || singleHit.voxel.y != batchHit.voxel.y || singleHit.voxel.z != batchHit.voxel.z)
+            {
+                ++uNumMismatches;
+            }
+        }
+
+        VoxelRaycastStatistics statistics =
+        {
+            .uNumRays = uNumRays,
+            .uNumHits = uNumHits,
+            .singleRayMicroseconds = uNumRays == 0u ? 0.0 : singleSeconds * 1.0e6 / static_cast<DOUBLE>(uNumRays),
+            .batchMilliseconds = batchSeconds * 1.0e3,
+        };
+
+        CHAR szDebugMessage[256];
+        sprintf_s(
+            szDebugMessage,
+            "VoxelRaycaster: %u ray(s) of %.0f unit(s), %u hit(s), %.2f us per ray, batch %.3f ms%s\n",
+            statistics.uNumRays,
+            maxDistance,
+            statistics.uNumHits,
+            statistics.singleRayMicroseconds,
+            statistics.batchMilliseconds,
+            uNumMismatches == 0u ? "" : ", batch DIFFERS"
+        );
+        OutputDebugStringA(szDebugMessage);
+
+        return statistics;
+    }
+}
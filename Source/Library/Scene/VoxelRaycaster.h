@@ -0,0 +1,111 @@
+/*+===================================================================
+  File:      VOXELRAYCASTER.H
+
+  Summary:   VoxelRaycaster header file contains declarations of the
+             VoxelRaycaster class that casts rays against the voxels
+             of a terrain for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: VoxelRaycaster
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Scene/VoxelColumnStore.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelRay
+
+      Summary:  World space ray of a batch, its direction need not be
+                normalized and its length is in world units
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRay
+    {
+        XMFLOAT3 origin;
+        XMFLOAT3 direction;
+        FLOAT maxDistance;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelRayHit
+
+      Summary:  First solid voxel along a ray, its block type, the world
+                distance to the face the ray entered it through and the
+                normal of that face. The normal is zero if the ray
+                starts inside the voxel
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRayHit
+    {
+        BOOL bHit;
+        XMUINT3 voxel;
+        BYTE blockType;
+        FLOAT distance;
+        XMINT3 normal;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelRaycastStatistics
+
+      Summary:  Time of casting a set of rays one after another and as
+                one batch, and how many of them hit
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelRaycastStatistics
+    {
+        UINT uNumRays;
+        UINT uNumHits;
+        DOUBLE singleRayMicroseconds;
+        DOUBLE batchMilliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelRaycaster
+
+      Summary:  Casts world space rays against the voxels of a column
+                store with a 3D-DDA (Amanatides and Woo) over the grid
+                the voxels are drawn on. A cell above the top of its
+                column is air, so the ray crosses the rest of the column
+                in one step instead of one step per layer. The store
+                must outlive the raycaster, and is not edited while
+                rays are cast
+
+      Methods:  Raycast
+                  Returns the first solid voxel along a ray
+                RaycastBatch
+                  Casts many rays across the worker threads
+                GetVoxelBounds
+                  Returns the world space bounds of a voxel
+                MeasureThroughput
+                  Times rays cast from a point in random directions
+                VoxelRaycaster
+                  Constructor.
+                ~VoxelRaycaster
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelRaycaster final
+    {
+    public:
+        VoxelRaycaster() = delete;
+        VoxelRaycaster(_In_ const VoxelColumnStore& columnStore);
+        VoxelRaycaster(const VoxelRaycaster& other) = delete;
+        VoxelRaycaster(VoxelRaycaster&& other) = delete;
+        VoxelRaycaster& operator=(const VoxelRaycaster& other) = delete;
+        VoxelRaycaster& operator=(VoxelRaycaster&& other) = delete;
+        ~VoxelRaycaster() = default;
+
+        BOOL Raycast(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT maxDistance, _Out_ VoxelRayHit& outHit) const;
+        void RaycastBatch(_In_reads_(uNumRays) const VoxelRay* pRays, _In_ size_t uNumRays, _Out_writes_(uNumRays) VoxelRayHit* pOutHits) const;
+
+        BoundingBox GetVoxelBounds(_In_ const XMUINT3& voxel) const;
+
+        VoxelRaycastStatistics MeasureThroughput(_In_ const XMFLOAT3& origin, _In_ UINT uNumRays, _In_ FLOAT maxDistance) const;
+
+    private:
+        const VoxelColumnStore& m_columnStore;
+        XMFLOAT3 m_gridOffset;
+    };
+}
@@ -0,0 +1,148 @@
+#include "Shader/PackedVoxelVertexShader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PackedVoxelVertexShader::PackedVoxelVertexShader
+
+      Summary:  Constructor
+
+      Args:     PCWSTR pszFileName
+                  Name of the file that contains the shader code
+                PCSTR pszEntryPoint
+                  Name of the shader entry point functino where shader
+                  execution begins
+                PCSTR pszShaderModel
+                  Specifies the shader target or set of shader features
+                  to compile against
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedVoxelVertexShader::PackedVoxelVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) 
+        :VertexShader(pszFileName, pszEntryPoint, pszShaderModel)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PackedVoxelVertexShader::Initialize
+
+      Summary:  Initializes the vertex shader and the input layout
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT PackedVoxelVertexShader::Initialize(_In_ ID3D11Device* pDevice) {
+
+        ComPtr<ID3DBlob> pVSBlob(nullptr);
+
+        HRESULT hr = compile(pVSBlob.GetAddressOf());
+        if (FAILED(hr)) {
+            MessageBox(
+                nullptr,
+                L"FX file cannot be commpiled. Please run this executable from the directory that contains the FX file.",
+                L"Error",
+                MB_OK
+            );
+            return hr;
+        }
+
+        hr = pDevice->CreateVertexShader(
+            pVSBlob->GetBufferPointer(),
+            pVSBlob->GetBufferSize(),
+            nullptr,
+            m_vertexShader.GetAddressOf()
+        );
+
+        if (FAILED(hr)) {
+            MessageBox(
+                nullptr,
+                L"FX file cannot be commpiled. Please run this executable from the directory that contains the FX file.",
+                L"Error",
+                MB_OK
+            );
+            return hr;
+        }
+
+        D3D11_INPUT_ELEMENT_DESC layout[] =
+        {
+            {
+                "POSITION",
+                0,
+                DXGI_FORMAT_R32G32B32_FLOAT,
+                0,
+                0,
+                D3D11_INPUT_PER_VERTEX_DATA,
+                0
+            },
+            {
+                "TEXCOORD",
+                0,
+                DXGI_FORMAT_R32G32_FLOAT,
+                0,
+                D3D11_APPEND_ALIGNED_ELEMENT,
+                D3D11_INPUT_PER_VERTEX_DATA,
+                0
+            },
+            {
+                "NORMAL",
+                0,
+                DXGI_FORMAT_R32G32B32_FLOAT,
+                0,
+                D3D11_APPEND_ALIGNED_ELEMENT,
+                D3D11_INPUT_PER_VERTEX_DATA,
+                0
+            },
+            {
+                "TANGENT",
+                0,
+                DXGI_FORMAT_R32G32B32_FLOAT,
+                1,
+                0,
+                D3D11_INPUT_PER_VERTEX_DATA,
+                0
+            },
+            {
+                "BITANGENT",
+                0,
+                DXGI_FORMAT_R32G32B32_FLOAT,
+                1,
+                12,
+                D3D11_INPUT_PER_VERTEX_DATA,
+                0
+            },
+            {
+                "INSTANCE_PACKED",
+                0,
+                DXGI_FORMAT_R32_UINT,
+                2,
+                0,
+                D3D11_INPUT_PER_INSTANCE_DATA,
+                1
+            },
+            {
+                "INSTANCE_LIGHT",
+                0,
+                DXGI_FORMAT_R32G32_UINT,
+                3,
+                0,
+                D3D11_INPUT_PER_INSTANCE_DATA,
+                1
+            },
+        };
+
+        UINT numElements = ARRAYSIZE(layout);
+
+        hr = pDevice->CreateInputLayout(
+            layout,
+            numElements,
+            pVSBlob->GetBufferPointer(),
+            pVSBlob->GetBufferSize(),
+            m_vertexLayout.GetAddressOf()
+        );
+
+        if (FAILED(hr)) return hr;
+
+        return S_OK;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "Thread/ThreadPool.h"
+
+#include <atomic>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetDefault
+
+      Summary:  Returns the pool shared by the library, sized to leave
+                the calling thread one core
+
+      Returns:  ThreadPool&
+                  Shared thread pool
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool& ThreadPool::GetDefault()
+    {
+        static ThreadPool s_threadPool(std::max<UINT>(std::thread::hardware_concurrency(), 2u) - 1u);
+
+        return s_threadPool;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ThreadPool
+
+      Summary:  Constructor. Starts the worker threads
+
+      Args:     UINT uNumThreads
+                  Number of worker threads
+
+      Modifies: [m_aWorkers, m_tasks, m_mutex, m_taskAvailable,
+                 m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::ThreadPool(_In_ UINT uNumThreads)
+        : m_aWorkers()
+        , m_tasks()
+        , m_mutex()
+        , m_taskAvailable()
+        , m_bStopping(FALSE)
+    {
+        m_aWorkers.reserve(uNumThreads);
+        for (UINT i = 0u; i < uNumThreads; ++i)
+        {
+            m_aWorkers.emplace_back(&ThreadPool::workerMain, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::~ThreadPool
+
+      Summary:  Destructor. Lets the workers drain the queue and joins
+                them
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStopping = TRUE;
+        }
+        m_taskAvailable.notify_all();
+
+        for (std::thread& worker : m_aWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::Enqueue
+
+      Summary:  Queues a task to run on a worker thread. Runs the task
+                on the calling thread if the pool has no workers
+
+      Args:     std::function<void()>&& task
+                  Task to run
+
+      Modifies: [m_tasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::Enqueue(_In_ std::function<void()>&& task)
+    {
+        if (m_aWorkers.empty())
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_taskAvailable.notify_one();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ParallelFor
+
+      Summary:  Splits [uBegin, uEnd) into batches of uBatchSize and
+                calls the function once per batch. The calling thread
+                takes batches as well and returns once all of them are
+                done
+
+      Args:     size_t uBegin
+                  First index of the range
+                size_t uEnd
+                  One past the last index of the range
+                size_t uBatchSize
+                  Number of indices per batch
+                const std::function<void(size_t, size_t)>& function
+                  Function called with the [begin, end) of a batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::ParallelFor(_In_ size_t uBegin, _In_ size_t uEnd, _In_ size_t uBatchSize, _In_ const std::function<void(size_t, size_t)>& function)
+    {
+        if (uBegin >= uEnd)
+        {
+            return;
+        }
+
+        uBatchSize = std::max<size_t>(uBatchSize, 1u);
+        size_t uNumBatches = (uEnd - uBegin + uBatchSize - 1u) / uBatchSize;
+        if (uNumBatches == 1u || m_aWorkers.empty())
+        {
+            function(uBegin, uEnd);
+            return;
+        }
+
+        // Helpers may start after the caller has run every batch, so the
+        // shared state outlives this call
+        struct BatchState
+        {
+            std::atomic<size_t> uNextBatch;
+            std::atomic<size_t> uNumDone;
+            std::mutex doneMutex;
+            std::condition_variable allDone;
+        };
+        std::shared_ptr<BatchState> pState = std::make_shared<BatchState>();
+        pState->uNextBatch = 0u;
+        pState->uNumDone = 0u;
+
+        auto runBatches = [pState, uBegin, uEnd, uBatchSize, uNumBatches, &function]()
+        {
+            size_t uBatch;
+            while ((uBatch = pState->uNextBatch.fetch_add(1u)) < uNumBatches)
+            {
+                size_t uBatchBegin = uBegin + uBatch * uBatchSize;
+                function(uBatchBegin, std::min<size_t>(uBatchBegin + uBatchSize, uEnd));
+
+                if (pState->uNumDone.fetch_add(1u) + 1u == uNumBatches)
+                {
+                    std::lock_guard<std::mutex> lock(pState->doneMutex);
+                    pState->allDone.notify_all();
+                }
+            }
+        };
+
+        size_t uNumHelpers = std::min<size_t>(m_aWorkers.size(), uNumBatches - 1u);
+        for (size_t i = 0u; i < uNumHelpers; ++i)
+        {
+            Enqueue(runBatches);
+        }
+
+        runBatches();
+
+        std::unique_lock<std::mutex> lock(pState->doneMutex);
+        pState->allDone.wait(lock, [&pState, uNumBatches]() { return pState->uNumDone.load() == uNumBatches; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetNumThreads
+
+      Summary:  Returns the number of worker threads
+
+      Returns:  UINT
+                  Number of worker threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ThreadPool::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aWorkers.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::workerMain
+
+      Summary:  Worker thread loop. Runs queued tasks until the pool is
+                stopped and the queue is empty
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::workerMain()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_taskAvailable.wait(lock, [this]() { return m_bStopping || !m_tasks.empty(); });
+
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+}
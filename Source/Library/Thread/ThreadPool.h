@@ -0,0 +1,71 @@
+/*+===================================================================
+  File:      THREADPOOL.H
+
+  Summary:   ThreadPool header file contains declarations of the
+             ThreadPool class that runs loading and building work on
+             worker threads for the lab samples of Game Graphics
+             Programming course.
+
+  Classes: ThreadPool
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ThreadPool
+
+      Summary:  Fixed set of worker threads consuming a task queue
+
+      Methods:  GetDefault
+                  Returns the pool shared by the library
+                Enqueue
+                  Queues a task to run on a worker thread
+                ParallelFor
+                  Splits a range into batches and runs them on the
+                  workers and the calling thread, then waits for them
+                GetNumThreads
+                  Returns the number of worker threads
+                ThreadPool
+                  Constructor.
+                ~ThreadPool
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ThreadPool final
+    {
+    public:
+        static ThreadPool& GetDefault();
+
+        explicit ThreadPool(_In_ UINT uNumThreads);
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+        ~ThreadPool();
+
+        void Enqueue(_In_ std::function<void()>&& task);
+        void ParallelFor(_In_ size_t uBegin, _In_ size_t uEnd, _In_ size_t uBatchSize, _In_ const std::function<void(size_t, size_t)>& function);
+
+        UINT GetNumThreads() const;
+
+    private:
+        void workerMain();
+
+    private:
+        std::vector<std::thread> m_aWorkers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskAvailable;
+        BOOL m_bStopping;
+    };
+}
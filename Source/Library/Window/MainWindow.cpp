@@ -140,6 +140,15 @@ namespace library
             }
             return 0;
 
+        case WM_LBUTTONDOWN:
+        case WM_RBUTTONDOWN:
+            // Kept until the game loop handles the click
+            m_mouseClick.bLeft |= uMsg == WM_LBUTTONDOWN;
+            m_mouseClick.bRight |= uMsg == WM_RBUTTONDOWN;
+            m_mouseClick.X = static_cast<SHORT>(LOWORD(lParam));
+            m_mouseClick.Y = static_cast<SHORT>(HIWORD(lParam));
+            return 0;
+
         case WM_CLOSE:
             if (MessageBox(m_hWnd, L"Really quit?", L"Game Graphic Programming", MB_OKCANCEL) == IDOK) {
                 DestroyWindow(m_hWnd);
@@ -193,4 +202,26 @@ namespace library
             .Y = 0
         };
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MainWindow::GetMouseClick
+
+      Summary:  Returns the mouse buttons pressed since the last reset
+
+      Returns:  const MouseClickInput&
+                  Pressed mouse buttons and cursor position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MouseClickInput& MainWindow::GetMouseClick() const {
+        return m_mouseClick;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MainWindow::ResetMouseClick
+
+      Summary:  Reset the pressed mouse buttons
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MainWindow::ResetMouseClick() {
+        m_mouseClick.bLeft = false;
+        m_mouseClick.bRight = false;
+    }
 }
@@ -35,6 +35,11 @@ namespace library
                   Returns the mouse relative movement
                 ResetMouseMovement
                   Reset the mouse relative movement to zero
+                GetMouseClick
+                  Returns the mouse buttons pressed since the last
+                  reset
+                ResetMouseClick
+                  Reset the pressed mouse buttons
                 MainWindow
                   Constructor.
                 ~MainWindow
@@ -57,10 +62,13 @@ namespace library
         const DirectionsInput& GetDirections() const;
         const MouseRelativeMovement& GetMouseRelativeMovement() const;
         void ResetMouseMovement();
+        const MouseClickInput& GetMouseClick() const;
+        void ResetMouseClick();
 
     private:
         DirectionsInput m_directions;
         MouseRelativeMovement m_mouseRelativeMovement;
+        MouseClickInput m_mouseClick;
     };
 }
 
@@ -0,0 +1,256 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLERTEST.CPP
+
+  Summary:   Standalone test and benchmark of the OcclusionCuller. It
+             needs no window or Direct3D device, only the culler and
+             DirectXMath, and is built and run by the CMakeLists.txt of
+             this directory. It exits with a non-zero code if a test
+             fails.
+
+  Functions: CheckVisibility, BoxAcrossPixels, RunTests,
+             ThreadedParallelFor, RunBenchmark, main
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Scene/OcclusionCuller.h"
+
+using namespace DirectX;
+
+// The camera stands at the origin looking down +z, so the view is the
+// identity and a pixel column is 64 x / z + 128 with these values
+constexpr const float FOV_Y = XM_PIDIV2;
+constexpr const float NEAR_PLANE = 0.01f;
+constexpr const float FAR_PLANE = 1000.0f;
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: CheckVisibility
+
+  Summary:  Compares the visibility of a box with the expected one and
+            reports a mismatch
+
+  Args:     const library::OcclusionCuller& culler
+              Culler holding the rendered occluders
+            const BoundingBox& box
+              Box to test
+            bool bExpected
+              Whether the box should be visible
+            const char* pszName
+              Name of the test
+
+  Returns:  int
+              Number of failures, zero or one
+-----------------------------------------------------------------F-F*/
+int CheckVisibility(const library::OcclusionCuller& culler, const BoundingBox& box, bool bExpected, const char* pszName)
+{
+    const bool bVisible = culler.IsVisible(box);
+    std::printf("%-40s %s\n", pszName, bVisible == bExpected ? "passed" : "FAILED");
+    return bVisible == bExpected ? 0 : 1;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: BoxAcrossPixels
+
+  Summary:  Builds a thin box at a view depth whose projection spans
+            the given pixel columns, close to the center row
+
+  Args:     const XMMATRIX& projection
+              Projection of the camera
+            float width
+              Width of the depth buffer
+            float minColumn
+              Leftmost pixel column of the projection
+            float maxColumn
+              Rightmost pixel column of the projection
+            float depth
+              Nearest view depth of the box
+
+  Returns:  BoundingBox
+              The box
+-----------------------------------------------------------------F-F*/
+BoundingBox BoxAcrossPixels(const XMMATRIX& projection, float width, float minColumn, float maxColumn, float depth)
+{
+    constexpr const float THICKNESS = 0.01f;
+
+    // Column c at depth z lies at x = (2 c / width - 1) z / P00, the
+    // near side bounds the right edge and the far side the left one
+    const float P00 = XMVectorGetX(projection.r[0]);
+    const float minX = (2.0f * minColumn / width - 1.0f) * (depth + THICKNESS) / P00;
+    const float maxX = (2.0f * maxColumn / width - 1.0f) * depth / P00;
+
+    BoundingBox box;
+    BoundingBox::CreateFromPoints(box, XMVectorSet(minX, -0.1f, depth, 0.0f), XMVectorSet(maxX, 0.1f, depth + THICKNESS, 0.0f));
+    return box;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RunTests
+
+  Summary:  Renders a wall in front of the camera and tests boxes
+            behind, beside and in front of it, a box seen through the
+            uncovered part of a pixel the wall edge crosses, measures
+            the coverage given up next to that edge, and tests a wall
+            too thin to be drawn
+
+  Returns:  int
+              Number of failed tests
+-----------------------------------------------------------------F-F*/
+int RunTests()
+{
+    library::OcclusionCuller culler(library::OcclusionCuller::DEFAULT_DESC);
+    const float width = static_cast<float>(culler.GetWidth());
+    const float aspectRatio = width / static_cast<float>(culler.GetHeight());
+    const XMMATRIX view = XMMatrixIdentity();
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(FOV_Y, aspectRatio, NEAR_PLANE, FAR_PLANE);
+
+    // The edge of the wall at x = 5 on its near side z = 9.5 projects
+    // to column 161.68, past the center of pixel 161
+    const BoundingBox wall(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(5.0f, 5.0f, 0.5f));
+    culler.RenderOccluders(&wall, 1u, view, projection);
+
+    int iNumFailures = 0;
+    iNumFailures += CheckVisibility(culler, BoundingBox(XMFLOAT3(0.0f, 0.0f, 20.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)), false, "box behind the wall");
+    iNumFailures += CheckVisibility(culler, BoundingBox(XMFLOAT3(20.0f, 0.0f, 20.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)), true, "box beside the wall");
+    iNumFailures += CheckVisibility(culler, BoundingBox(XMFLOAT3(0.0f, 0.0f, 5.0f), XMFLOAT3(0.5f, 0.5f, 0.5f)), true, "box in front of the wall");
+
+    // Sampling coverage at pixel centers alone would give pixel 161
+    // the depth of the wall, hiding this box
+    iNumFailures += CheckVisibility(culler, BoxAcrossPixels(projection, width, 161.75f, 161.95f, 20.0f), true, "box past the wall edge in its pixel");
+
+    // Shrinking the wall and sampling at pixel centers both give up
+    // coverage next to its edge instead, which only keeps boxes there
+    // visible. The error is the distance from the true edge to the
+    // first box found hidden, and should stay under two pixels
+    constexpr const float EDGE_COLUMN = 161.68f;
+    float hiddenColumn = EDGE_COLUMN;
+    while (hiddenColumn > 128.0f && culler.IsVisible(BoxAcrossPixels(projection, width, hiddenColumn - 0.3f, hiddenColumn - 0.1f, 20.0f)))
+    {
+        hiddenColumn -= 0.05f;
+    }
+    const float edgeError = EDGE_COLUMN - (hiddenColumn - 0.1f);
+    std::printf("%-40s %.2f pixels, %s\n", "coverage lost at the wall edge", edgeError, edgeError < 2.0f ? "passed" : "FAILED");
+    iNumFailures += edgeError < 2.0f ? 0 : 1;
+
+    // An occluder thinner than the footprint of a pixel at its depth
+    // has nothing left once shrunk, and is not drawn at all
+    const BoundingBox thinWall(XMFLOAT3(0.0f, 0.0f, 10.0f), XMFLOAT3(5.0f, 5.0f, 0.05f));
+    culler.RenderOccluders(&thinWall, 1u, view, projection);
+    iNumFailures += CheckVisibility(culler, BoundingBox(XMFLOAT3(0.0f, 0.0f, 20.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)), true, "box behind a wall thinner than a pixel");
+
+    return iNumFailures;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: ThreadedParallelFor
+
+  Summary:  Parallel for of the culler on plain threads, one contiguous
+            batch per hardware thread
+
+  Args:     size_t uBegin
+              First index
+            size_t uEnd
+              Index past the last one
+            size_t uMinBatchSize
+              Smallest number of indices worth a batch
+            const std::function<void(size_t, size_t)>& function
+              Function called on every batch
+-----------------------------------------------------------------F-F*/
+void ThreadedParallelFor(std::size_t uBegin, std::size_t uEnd, std::size_t uMinBatchSize, const std::function<void(std::size_t, std::size_t)>& function)
+{
+    const std::size_t uNumThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1u);
+    const std::size_t uBatchSize = std::max<std::size_t>((uEnd - uBegin + uNumThreads - 1u) / uNumThreads, std::max<std::size_t>(uMinBatchSize, 1u));
+
+    std::vector<std::thread> aThreads;
+    for (std::size_t uBatch = uBegin + uBatchSize; uBatch < uEnd; uBatch += uBatchSize)
+    {
+        aThreads.emplace_back(function, uBatch, std::min<std::size_t>(uBatch + uBatchSize, uEnd));
+    }
+    function(uBegin, std::min<std::size_t>(uBegin + uBatchSize, uEnd));
+
+    for (std::thread& thread : aThreads)
+    {
+        thread.join();
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: RunBenchmark
+
+  Summary:  Renders a field of columns and tests a box above every
+            one of them, printing the average time of both steps
+
+  Args:     const char* pszName
+              Name of the run
+            library::OcclusionCuller::ParallelForFunction parallelFor
+              Parallel for given to the culler
+-----------------------------------------------------------------F-F*/
+void RunBenchmark(const char* pszName, library::OcclusionCuller::ParallelForFunction parallelFor)
+{
+    constexpr const int GRID_SIZE = 64;
+    constexpr const int NUM_FRAMES = 100;
+
+    library::OcclusionCuller culler(library::OcclusionCuller::DEFAULT_DESC, std::move(parallelFor));
+    const float aspectRatio = static_cast<float>(culler.GetWidth()) / static_cast<float>(culler.GetHeight());
+    const XMMATRIX view = XMMatrixLookToLH(XMVectorSet(0.0f, 3.0f, -4.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(FOV_Y, aspectRatio, NEAR_PLANE, FAR_PLANE);
+
+    std::vector<BoundingBox> aOccluders;
+    std::vector<BoundingBox> aBoxes;
+    for (int z = 0; z < GRID_SIZE; ++z)
+    {
+        for (int x = 0; x < GRID_SIZE; ++x)
+        {
+            const float height = 2.0f + static_cast<float>((x * 7 + z * 13) % 5);
+            const XMFLOAT3 center(4.0f * static_cast<float>(x - GRID_SIZE / 2), 0.5f * height, 4.0f * static_cast<float>(z));
+            aOccluders.push_back(BoundingBox(center, XMFLOAT3(2.0f, 0.5f * height, 2.0f)));
+            aBoxes.push_back(BoundingBox(XMFLOAT3(center.x, height + 1.0f, center.z), XMFLOAT3(1.0f, 1.0f, 1.0f)));
+        }
+    }
+
+    std::vector<std::uint8_t> abVisible(aBoxes.size());
+    double rasterizationMilliseconds = 0.0;
+    double testMilliseconds = 0.0;
+    std::uint32_t uNumOccluded = 0u;
+    for (int i = 0; i < NUM_FRAMES; ++i)
+    {
+        culler.RenderOccluders(aOccluders.data(), aOccluders.size(), view, projection);
+        uNumOccluded = culler.TestBoxes(aBoxes.data(), aBoxes.size(), abVisible.data());
+        rasterizationMilliseconds += culler.GetStatistics().rasterizationMilliseconds;
+        testMilliseconds += culler.GetStatistics().testMilliseconds;
+    }
+
+    std::printf(
+        "%-10s %u occluders, %u triangles, %u / %zu boxes hidden, %.3f ms rasterization, %.3f ms test\n",
+        pszName,
+        culler.GetStatistics().uNumOccluders,
+        culler.GetStatistics().uNumTriangles,
+        uNumOccluded,
+        aBoxes.size(),
+        rasterizationMilliseconds / NUM_FRAMES,
+        testMilliseconds / NUM_FRAMES
+    );
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Runs the tests, then the benchmark on the calling thread
+            and on all hardware threads
+
+  Returns:  int
+              Number of failed tests
+-----------------------------------------------------------------F-F*/
+int main()
+{
+    const int iNumFailures = RunTests();
+
+    RunBenchmark("serial", library::OcclusionCuller::ParallelForFunction());
+    RunBenchmark("threaded", ThreadedParallelFor);
+
+    return iNumFailures;
+}